@@ -0,0 +1,1165 @@
+/*
+ * File Name: SpreaderDetector.c
+ * Related Files: "SpreaderDetector.h", "SpreaderDetectorInternal.h", "SpreaderDetectorParams.h"
+ *
+ * Purpose:
+ * 			Due to the Corona Virus pandemic spreading around the world in 2020, the Hebrew University
+ * 			was asked to create a program that will update people that were potentially infected, to
+ * 			the fact that they are in risk, and tell them what should they do next, according to that.
+ * 			This program Analayzes data about meetings of people, and outputs recommendation due to it.
+ * 			This file is the SpreaderDetector library (see SpreaderDetector.h): its errors, its file pipeline,
+ * 			its in-memory API and its stats. The engine is split into the modules of the library:
+ * 			SpreaderDetectorInput.c, SpreaderDetectorPeople.c, SpreaderDetectorMeetings.c,
+ * 			SpreaderDetectorGraph.c, SpreaderDetectorExternal.c, SpreaderDetectorOutput.c and
+ * 			SpreaderDetectorBatch.c, which share SpreaderDetectorInternal.h and the headers of the modules.
+ *
+ * Author's ID: 206174120
+ * Author's Name: Oren Kovartovsky
+ * University User Name: orenkov
+ *
+ * */
+
+#include "SpreaderDetectorInternal.h"
+#include "SpreaderDetectorOutput.h"
+#include "SpreaderDetectorInput.h"
+#include "SpreaderDetectorPeople.h"
+#include "SpreaderDetectorMeetings.h"
+#include "SpreaderDetectorGraph.h"
+
+
+/*
+ * ***********************
+ * 	DECLARATIONS
+ * ***********************
+ */
+//	****** FILE PIPELINE FUNCTIONS ******
+/**
+ * @brief A function that calculates the chances of infection for each person over sharded meetings, with the
+ * engine runOptions and statePaths select: a delta run (calculateSeveritiesDelta), the graph engine
+ * (calculateSeveritiesGraph), or the shards applied in order (calculateSeveritiesParallel). Shards which are
+ * meetings tables are used in place (see meetingShardsOpenTables).
+ *
+ * @param[in] meetingShards the shards of the meetings, in order.
+ * @param[in] shardCount number of shards.
+ * @param[in] peopleArray an array of all the people that were recorded.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] peopleCounter the amount of the people that were recorded.
+ * @param[in] statePaths the delta state files of the run. NULL - a stateless run.
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If calculation was succesfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode calculateSeveritiesShards(MeetingShard *meetingShards, unsigned int shardCount, Person *peopleArray,
+											const PeopleIndex *peopleIndex, unsigned int peopleCounter,
+											const StatePaths *statePaths, const RunOptions *runOptions);
+
+/**
+ * @brief a function that reads, processes and calculate data from meetingFile.
+ *
+ * @note The function OPENS and CLOSE meetingFile.
+ * @note peopleArray's memory is NOT released in that function, even in failure.
+ * @details With the graph engine, the meetingFile is mapped to memory (or read whole, if it isn't a regular
+ * file) and handled by calculateSeveritiesGraph - or, in a delta run, by calculateSeveritiesDelta. Otherwise,
+ * when more than one thread is requested and the meetingFile is a regular file, it is mapped and parsed by
+ * calculateSeveritiesParallel. Otherwise calculateSeverities reads it serially.
+ * @details A gzip or Zstandard meetingFile is decompressed on the fly (see inputFileOpen) - it is read as a
+ * pipe: whole for the graph engine and for more than one thread, serially otherwise.
+ * @details A meetings table (see writeMeetingsTable) is always mapped, and its blocks are used in place - by
+ * every engine but streaming.
+ * @details In streaming mode the meetingFile is always read serially, and the urgent tiers are written to
+ * stdout as the severities change (see UrgentTierEmitter). STDIN_PATH reads the meetings from stdin.
+ * @details If meetingFilePath is a directory, its files are the shards of the meetings (see
+ * meetingShardsListDirectory and meetingsProcessShards).
+ * @param[in] meetingFilePath argv path for the file.
+ * @param[in] peopleArray pointer to the array of people (The Data Structure being used).
+ * @param[in] peopleCounter number of people in the DS, used for calculation.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] nameArena the arena which holds the names of the people (for the streaming mode's lists).
+ * @param[in] statePaths the delta state files of the run (see calculateSeveritiesShards). NULL - a stateless run.
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If processing was successful.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode meetingsProcess(const char* meetingFilePath, Person **peopleArray, const unsigned int *peopleCounter,
+								  const PeopleIndex *peopleIndex, const NameArena *nameArena,
+								  const StatePaths *statePaths, const RunOptions *runOptions);
+
+/**
+ * @brief a function that reads, processes and calculate data from a sharded meetingFile - several files which
+ * together make up the meetings, in order (e.g. one per camera per day).
+ *
+ * @details The shards are loaded (meetingShardsLoad), and parsed together: the chunks of all the shards are
+ * parsed concurrently by one parallelIngest. The first line of the first non-empty shard is the verified
+ * carrier's. The results are merged with the rule of the engine in use (see calculateSeveritiesShards): the
+ * default engine applies the shards in order, exactly as it would apply their concatenation; the graph
+ * engine takes, for every person, the highest chance over his meetings in all the shards - so the shards'
+ * order doesn't matter. Streaming reads a single meetingFile, and isn't available.
+ * @note peopleArray's memory is NOT released in that function, even in failure.
+ * @param[in] shardPaths the paths of the shards, in order.
+ * @param[in] shardCount number of shards. 0 - there are no meetings, and nobody is infected.
+ * @param[in] peopleArray pointer to the array of people (The Data Structure being used).
+ * @param[in] peopleCounter number of people in the DS, used for calculation.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] statePaths the delta state files of the run (see calculateSeveritiesShards). NULL - a stateless run.
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If processing was successful.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode meetingsProcessShards(const char *const *shardPaths, unsigned int shardCount, Person **peopleArray,
+										const unsigned int *peopleCounter, const PeopleIndex *peopleIndex,
+										const StatePaths *statePaths, const RunOptions *runOptions);
+
+/**
+ * @brief The function that 'holds' all the relevant actions/functions together, in order to proccess
+ * and determine the order of the potential infected people.
+ *
+ * @details the reads data, sorts it and using calculations in order to create the expected output File.
+ * @note varible peopleArray - The DS being used in the program.
+ * The memory allocated to it is released in this func, even though it was allocated in a sub-function.
+ * peopleArray is being by other sub-functions as well.
+ * @param[in] peopleFilePath argv path for the peopleFile.
+ * @param[in] meetingFilePaths the paths of the meetingFile, or of its shards: files which together make up
+ * the meetings, in order. They are parsed concurrently, and merged as one meetingFile would be - by the
+ * default engine in order, by the graph engine with the highest chance of every person (in any order).
+ * @param[in] meetingFileCount number of meeting paths. A single path may be STDIN_PATH (stdin), or a directory
+ * of shards.
+ * @param[in] outputFilePath the path of the output file (the program writes OUTPUT_FILE).
+ * @param[in] statePaths the delta state files of the run (see calculateSeveritiesShards). NULL - a stateless run.
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If processing was successfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode pipelineRun(const char* peopleFilePath, const char *const *meetingFilePaths,
+							  unsigned int meetingFileCount, const char *outputFilePath, const StatePaths *statePaths,
+							  const RunOptions *runOptions);
+
+
+//	****** IN-MEMORY API FUNCTIONS ******
+/**
+ * @brief A function that starts an analysis of the in-memory API: copies the registry's people, whose
+ * severities are about to be calculated.
+ *
+ * @note The function ALLOCATES MEMORY being returned. released by the caller, with free.
+ * @param[in] registry the registry being analyzed. Must hold at least one person.
+ * @return the copy of the registry's People-Array, or NULL if memory allocation failed.
+ */
+static Person *registryJobPeople(const SpreaderDetectorRegistry *registry);
+
+/**
+ * @brief A function that finishes an analysis of the in-memory API: orders the people as the output file
+ * would (see orderPeopleForOutput), and collects them as results, most severe first.
+ *
+ * @note The function ALLOCATES MEMORY being stored in results. released by spreaderDetectorResultsFree.
+ * @param[in] registry the registry being analyzed.
+ * @param[in] jobPeople the analyzed copy of the registry's People-Array. Being reordered.
+ * @param[in] runOptions the options of the analysis.
+ * @param[in] results set to the results.
+ * @param[in] resultCount set to the number of results.
+ * @param[out] STATUS_CODE_SUCCESS If the results were collected.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+static StatusCode registryJobResults(const SpreaderDetectorRegistry *registry, Person *jobPeople,
+									 const RunOptions *runOptions, SpreaderDetectorResult **results,
+									 unsigned int *resultCount);
+
+
+/*
+ * ***********************
+ * 	DEFINITIONS
+ * ***********************
+ */
+/**
+ * @brief A function that writes errors to stderr.
+ * @details being used in the library at the moment error detected (as error()).
+ * @details the function holds many kinds of errors. according to the errorCode given to the function,
+ * the relevant message is written to stderr.
+ * @param[in] errorCode The relevant StatusCode, representing the error occurred.
+ */
+void spreaderDetectorError(StatusCode errorCode)
+{
+	switch (errorCode)
+	{
+		case STATUS_CODE_INPUT_ERROR:
+			fprintf(stderr, ERROR_INPUT);
+			break;
+		case STATUS_CODE_OUTPUT_ERROR:
+			fprintf(stderr, ERROR_OUTPUT);
+			break;
+		default:
+			fprintf(stderr, ERROR_DEAFULT);
+	}
+}
+
+
+/**
+ * @brief A function that calculates the chances of infection for each person over sharded meetings, with the
+ * engine runOptions and statePaths select: a delta run (calculateSeveritiesDelta), the graph engine
+ * (calculateSeveritiesGraph), or the shards applied in order (calculateSeveritiesParallel). Shards which are
+ * meetings tables are used in place (see meetingShardsOpenTables).
+ * @param[in] meetingShards the shards of the meetings, in order.
+ * @param[in] shardCount number of shards.
+ * @param[in] peopleArray an array of all the people that were recorded.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] peopleCounter the amount of the people that were recorded.
+ * @param[in] statePaths the delta state files of the run. NULL - a stateless run.
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If calculation was succesfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode calculateSeveritiesShards(MeetingShard *meetingShards, unsigned int shardCount, Person *peopleArray,
+											const PeopleIndex *peopleIndex, unsigned int peopleCounter,
+											const StatePaths *statePaths, const RunOptions *runOptions)
+{
+	unsigned int threadCount = resolveThreadCount(runOptions->threadCount);
+	if (meetingShardsOpenTables(meetingShards, shardCount) != STATUS_CODE_SUCCESS)
+	{
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	if ((statePaths != NULL) && (statePaths->deltaStatePath != NULL))
+	{
+		return calculateSeveritiesDelta(meetingShards, shardCount, peopleArray, peopleIndex, peopleCounter,
+										statePaths->deltaStatePath, threadCount, runOptions->runStats);
+	}
+	else if (runOptions->useGraphEngine)
+	{
+		return calculateSeveritiesGraph(meetingShards, shardCount, peopleArray, peopleIndex, peopleCounter,
+										(statePaths != NULL) ? statePaths->statePath : NULL, threadCount,
+										runOptions->runStats);
+	}
+	return calculateSeveritiesParallel(meetingShards, shardCount, peopleArray, peopleIndex, threadCount,
+									   runOptions->runStats);
+}
+
+
+/**
+ * @brief a function that reads, processes and calculate data from meetingFile.
+ *
+ * @note The function OPENS and CLOSE meetingFile.
+ * @note peopleArray's memory is NOT released in that function, even in failure.
+ * @details With the graph engine, the meetingFile is mapped to memory (or read whole, if it isn't a regular
+ * file) and handled by calculateSeveritiesGraph - or, in a delta run, by calculateSeveritiesDelta. Otherwise,
+ * when more than one thread is requested and the meetingFile is a regular file, it is mapped and parsed by
+ * calculateSeveritiesParallel. Otherwise calculateSeverities reads it serially.
+ * @details A gzip or Zstandard meetingFile is decompressed on the fly (see inputFileOpen) - it is read as a
+ * pipe: whole for the graph engine and for more than one thread, serially otherwise.
+ * @details A meetings table (see writeMeetingsTable) is always mapped, and its blocks are used in place - by
+ * every engine but streaming.
+ * @details In streaming mode the meetingFile is always read serially, and the urgent tiers are written to
+ * stdout as the severities change (see UrgentTierEmitter). STDIN_PATH reads the meetings from stdin.
+ * @details If meetingFilePath is a directory, its files are the shards of the meetings (see
+ * meetingShardsListDirectory and meetingsProcessShards).
+ * @param[in] meetingFilePath argv path for the file.
+ * @param[in] peopleArray pointer to the array of people (The Data Structure being used).
+ * @param[in] peopleCounter number of people in the DS, used for calculation.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] nameArena the arena which holds the names of the people (for the streaming mode's lists).
+ * @param[in] statePaths the delta state files of the run (see calculateSeveritiesShards). NULL - a stateless run.
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If processing was successful.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode meetingsProcess(const char* meetingFilePath, Person **peopleArray, const unsigned int *peopleCounter,
+								  const PeopleIndex *peopleIndex, const NameArena *nameArena,
+								  const StatePaths *statePaths, const RunOptions *runOptions)
+{
+	
+	// ## SHARDS DIRECTORY ## - its files are the shards of the meetings:
+	struct stat meetingPathStat;
+	if ((stat(meetingFilePath, &meetingPathStat) == 0) && S_ISDIR(meetingPathStat.st_mode))
+	{
+		char **shardPaths = NULL;
+		unsigned int shardCount = 0;
+		StatusCode retValShards = meetingShardsListDirectory(meetingFilePath, &shardPaths, &shardCount);
+		if (retValShards == STATUS_CODE_SUCCESS)
+		{
+			retValShards = meetingsProcessShards((const char *const *) shardPaths, shardCount, peopleArray,
+												 peopleCounter, peopleIndex, statePaths, runOptions);
+		}
+		meetingShardPathsFree(shardPaths, shardCount);
+		return retValShards;
+	}
+	
+	// ## OPEN INPUT FILE ## - Open meetingFile, decompressing it if it is compressed (or use stdin):
+	Decompressor decompressor = {0};
+	FILE* meetingFile = (strcmp(meetingFilePath, STDIN_PATH) == 0) ? stdin :
+						inputFileOpen(meetingFilePath, &decompressor);
+	if (meetingFile == NULL)
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	
+	//	## CALCULATE SEVERITIES ## - of Every Person in The People-Array:
+	StatusCode retValCalc = STATUS_CODE_SUCCESS;
+	struct stat meetingFileStat;
+	unsigned int threadCount = resolveThreadCount(runOptions->threadCount);
+	int isMappable = ((fstat(fileno(meetingFile), &meetingFileStat) == 0) && S_ISREG(meetingFileStat.st_mode) &&
+					  (meetingFileStat.st_size > 0));
+	int isTable = (isMappable && isMeetingsTable(fileno(meetingFile), (size_t) meetingFileStat.st_size));
+	if ((runOptions->streamInterval > 0) && isTable)
+	{
+		error(STATUS_CODE_INPUT_ERROR);	// A table isn't streamed.
+		retValCalc = STATUS_CODE_INPUT_ERROR;
+	}
+	else if (runOptions->streamInterval > 0)
+	{
+		UrgentTierEmitter tierEmitter = {0};
+		retValCalc = urgentTierEmitterInit(&tierEmitter, *peopleArray, *peopleCounter, nameArena, runOptions);
+		if (retValCalc == STATUS_CODE_SUCCESS)
+		{
+			retValCalc = calculateSeverities(meetingFile, *peopleArray, peopleIndex, &tierEmitter,
+											 runOptions->runStats);
+		}
+		if ((retValCalc == STATUS_CODE_SUCCESS) && (tierEmitter.pendingUpdates > 0))
+		{
+			retValCalc = urgentTierEmit(&tierEmitter);
+		}
+		urgentTierEmitterFree(&tierEmitter);
+	}
+	else if ((runOptions->useGraphEngine || (threadCount > SERIAL_THREAD_COUNT) || isTable) && isMappable)
+	{
+		size_t fileSize = (size_t) meetingFileStat.st_size;
+		char *mappedFile = (char *) mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fileno(meetingFile), 0);
+		if (mappedFile == MAP_FAILED)
+		{
+			error(STATUS_CODE_INPUT_ERROR);
+			retValCalc = STATUS_CODE_INPUT_ERROR;
+		}
+		else
+		{
+			MeetingShard meetingShard = {mappedFile, mappedFile + fileSize, NULL, 0, 0, NULL};
+			retValCalc = calculateSeveritiesShards(&meetingShard, 1, *peopleArray, peopleIndex, *peopleCounter,
+												   statePaths, runOptions);
+			munmap(mappedFile, fileSize);
+		}
+	}
+	else if (runOptions->useGraphEngine || ((threadCount > SERIAL_THREAD_COUNT) && decompressor.isStarted))
+	{
+		char *meetings = NULL;
+		size_t contentSize = 0;
+		retValCalc = readWholeFile(meetingFile, &meetings, &contentSize);
+		if (retValCalc == STATUS_CODE_SUCCESS)
+		{
+			MeetingShard meetingShard = {meetings, meetings + contentSize, NULL, 0, 0, NULL};
+			retValCalc = calculateSeveritiesShards(&meetingShard, 1, *peopleArray, peopleIndex, *peopleCounter,
+												   statePaths, runOptions);
+		}
+		free(meetings);
+	}
+	else
+	{
+		retValCalc = calculateSeverities(meetingFile, *peopleArray, peopleIndex, NULL, runOptions->runStats);
+	}
+	
+	if (retValCalc != STATUS_CODE_SUCCESS)
+	{
+		if (meetingFile != stdin)
+		{
+			inputFileClose(meetingFile, &decompressor);	// Already reported (a decompressor fails as well).
+		}
+		meetingFile = NULL;
+		return STATUS_CODE_FAIL;
+	}
+	
+	//	## CLOSE INPUT FILE ## - close meetingFile (stdin is left open) ##
+	if ((meetingFile != stdin) && (inputFileClose(meetingFile, &decompressor) != STATUS_CODE_SUCCESS))
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	meetingFile = NULL;
+	
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief a function that reads, processes and calculate data from a sharded meetingFile - several files which
+ * together make up the meetings, in order (e.g. one per camera per day).
+ * @details The shards are loaded (meetingShardsLoad), and parsed together: the chunks of all the shards are
+ * parsed concurrently by one parallelIngest. The first line of the first non-empty shard is the verified
+ * carrier's. The results are merged with the rule of the engine in use (see calculateSeveritiesShards): the
+ * default engine applies the shards in order, exactly as it would apply their concatenation; the graph
+ * engine takes, for every person, the highest chance over his meetings in all the shards - so the shards'
+ * order doesn't matter. Streaming reads a single meetingFile, and isn't available.
+ * @note peopleArray's memory is NOT released in that function, even in failure.
+ * @param[in] shardPaths the paths of the shards, in order.
+ * @param[in] shardCount number of shards. 0 - there are no meetings, and nobody is infected.
+ * @param[in] peopleArray pointer to the array of people (The Data Structure being used).
+ * @param[in] peopleCounter number of people in the DS, used for calculation.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] statePaths the delta state files of the run (see calculateSeveritiesShards). NULL - a stateless run.
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If processing was successful.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode meetingsProcessShards(const char *const *shardPaths, unsigned int shardCount, Person **peopleArray,
+										const unsigned int *peopleCounter, const PeopleIndex *peopleIndex,
+										const StatePaths *statePaths, const RunOptions *runOptions)
+{
+	if (runOptions->streamInterval > 0)
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	MeetingShard *meetingShards = NULL;
+	StatusCode retValCalc = meetingShardsLoad(shardPaths, shardCount, &meetingShards);
+	if (retValCalc == STATUS_CODE_SUCCESS)
+	{
+		retValCalc = calculateSeveritiesShards(meetingShards, shardCount, *peopleArray, peopleIndex, *peopleCounter,
+											   statePaths, runOptions);
+	}
+	meetingShardsFree(meetingShards, shardCount);
+	return retValCalc;
+}
+
+
+/**
+ * @brief The function that 'holds' all the relevant actions/functions together, in order to proccess
+ * and determine the order of the potential infected people.
+ * @details A single meetingFile - see spreaderDetectorShards.
+ * @param[in] peopleFilePath argv path for the peopleFile.
+ * @param[in] meetingFilePath argv path for the meetingFile (STDIN_PATH - stdin, or a directory of shards).
+ * @param[in] outputFilePath the path of the output file (the program writes OUTPUT_FILE).
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If processing was successfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetector(const char* peopleFilePath, const char* meetingFilePath, const char *outputFilePath,
+							const RunOptions *runOptions)
+{
+	return spreaderDetectorShards(peopleFilePath, &meetingFilePath, 1, outputFilePath, runOptions);
+}
+
+
+/**
+ * @brief The function that 'holds' all the relevant actions/functions together, in order to proccess
+ * and determine the order of the potential infected people.
+ * @details the reads data, sorts it and using calculations in order to create the expected output File.
+ * @note varible peopleArray - The DS being used in the program.
+ * The memory allocated to it is released in this func, even though it was allocated in a sub-function.
+ * peopleArray is being by other sub-functions as well.
+ * @param[in] peopleFilePath argv path for the peopleFile.
+ * @param[in] meetingFilePaths the paths of the meetingFile, or of its shards: files which together make up
+ * the meetings, in order. They are parsed concurrently, and merged as one meetingFile would be - by the
+ * default engine in order, by the graph engine with the highest chance of every person (in any order).
+ * @param[in] meetingFileCount number of meeting paths. A single path may be STDIN_PATH (stdin), or a directory
+ * of shards.
+ * @param[in] outputFilePath the path of the output file (the program writes OUTPUT_FILE).
+ * @param[in] statePaths the delta state files of the run (see calculateSeveritiesShards). NULL - a stateless run.
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If processing was successfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode pipelineRun(const char* peopleFilePath, const char *const *meetingFilePaths,
+							  unsigned int meetingFileCount, const char *outputFilePath, const StatePaths *statePaths,
+							  const RunOptions *runOptions)
+{
+	// ## INITIATE RESOURCES ##
+	unsigned int peopleCounter = 0;
+	Person *peopleArray = NULL;	// Will be dynamically allocated and used further in the program.
+	NameArena nameArena = {0};	// Will be dynamically allocated and used further in the program.
+	
+	// ## PROCESS PEOPLE ## - (PeopleFile READ) && (DataStruct Build) && (peopleArray SORT by ID)
+	runStatsPhaseStart(runOptions->runStats);
+	StatusCode retValPProcess = peopleProcessAndSort(peopleFilePath, &peopleArray, &peopleCounter, &nameArena,
+														runOptions);
+	
+	if (retValPProcess == STATUS_CODE_EMPTY_FILE)
+	{
+		runStatsPhaseEnd(runOptions->runStats, STATS_PHASE_PEOPLE);
+		nameArenaFree(&nameArena);
+		if (generateEmptyOutputFile(outputFilePath) != STATUS_CODE_SUCCESS)
+		{
+			return STATUS_CODE_FAIL;
+		}
+		return STATUS_CODE_SUCCESS;
+	}
+	else if (retValPProcess != STATUS_CODE_SUCCESS)
+	{
+		peopleArrayFree(peopleArray, &nameArena);
+		peopleArray = NULL;
+		nameArenaFree(&nameArena);
+		return STATUS_CODE_FAIL;
+	}
+	
+	// ## INDEX PEOPLE ## - (ID -> position hash table, used by the meetings pass)
+	PeopleIndex peopleIndex = {0};
+	if (peopleIndexBuild(&peopleIndex, peopleArray, peopleCounter, &nameArena.runArena) != STATUS_CODE_SUCCESS)
+	{
+		peopleArrayFree(peopleArray, &nameArena);
+		peopleArray = NULL;
+		nameArenaFree(&nameArena);
+		return STATUS_CODE_FAIL;
+	}
+	runStatsPhaseEnd(runOptions->runStats, STATS_PHASE_PEOPLE);
+	
+	// ## PROCESS MEETINGS ## - (MeetingFile READ) && (Chances Calculations)
+	runStatsPhaseStart(runOptions->runStats);
+	StatusCode retValMProcess = (meetingFileCount == 1) ?
+								meetingsProcess(meetingFilePaths[0], &peopleArray, &peopleCounter, &peopleIndex,
+												&nameArena, statePaths, runOptions) :
+								meetingsProcessShards(meetingFilePaths, meetingFileCount, &peopleArray,
+													  &peopleCounter, &peopleIndex, statePaths, runOptions);
+	peopleIndexFree(&peopleIndex);
+	if (retValMProcess != STATUS_CODE_SUCCESS)
+	{
+		peopleArrayFree(peopleArray, &nameArena);
+		peopleArray = NULL;
+		nameArenaFree(&nameArena);
+		return STATUS_CODE_FAIL;
+	}
+	runStatsPhaseEnd(runOptions->runStats, STATS_PHASE_MEETINGS);
+	
+	// ## ORDER PEOPLE ## - (peopleArray SORT by chances, or the urgent tiers / top people only)
+	runStatsPhaseStart(runOptions->runStats);
+	unsigned int outputCounter = orderPeopleForOutput(peopleArray, peopleCounter, runOptions);
+	runStatsCount(runOptions->runStats, STATS_PHASE_ORDER, 0, outputCounter, 0);
+	runStatsPhaseEnd(runOptions->runStats, STATS_PHASE_ORDER);
+	
+	//	## GENERATE OUTPUT FILE ##
+	runStatsPhaseStart(runOptions->runStats);
+	StatusCode retValOutput = generateSeverityFile(peopleArray, outputCounter, &nameArena, outputFilePath,
+												   runOptions->runStats);
+	runStatsPhaseEnd(runOptions->runStats, STATS_PHASE_OUTPUT);
+	if (retValOutput != STATUS_CODE_SUCCESS)
+	{
+		peopleArrayFree(peopleArray, &nameArena);
+		peopleArray = NULL;
+		nameArenaFree(&nameArena);
+		return STATUS_CODE_FAIL;
+	}
+	
+	//	## FREE Memory allocated in <peopleReadSort> function ##
+	peopleArrayFree(peopleArray, &nameArena);
+	peopleArray = NULL;
+	nameArenaFree(&nameArena);
+	
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief The function that 'holds' all the relevant actions/functions together, in order to proccess
+ * and determine the order of the potential infected people - see pipelineRun.
+ * @param[in] peopleFilePath argv path for the peopleFile.
+ * @param[in] meetingFilePaths the paths of the meetingFile, or of its shards.
+ * @param[in] meetingFileCount number of meeting paths.
+ * @param[in] outputFilePath the path of the output file (the program writes OUTPUT_FILE).
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If processing was successfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorShards(const char* peopleFilePath, const char *const *meetingFilePaths,
+								  unsigned int meetingFileCount, const char *outputFilePath,
+								  const RunOptions *runOptions)
+{
+	return pipelineRun(peopleFilePath, meetingFilePaths, meetingFileCount, outputFilePath, NULL, runOptions);
+}
+
+
+/**
+ * @brief The save-state mode: a graph engine run (see pipelineRun), which saves its delta state to statePath.
+ * @param[in] peopleFilePath argv path for the peopleFile.
+ * @param[in] meetingFilePaths the paths of the meetingFile, or of its shards.
+ * @param[in] meetingFileCount number of meeting paths.
+ * @param[in] outputFilePath the path of the output file (the program writes OUTPUT_FILE).
+ * @param[in] statePath where the delta state is saved.
+ * @param[in] runOptions the options the program was run with. The graph engine is used either way.
+ * @param[out] STATUS_CODE_SUCCESS If processing was successfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorSaveState(const char *peopleFilePath, const char *const *meetingFilePaths,
+									 unsigned int meetingFileCount, const char *outputFilePath,
+									 const char *statePath, const RunOptions *runOptions)
+{
+	RunOptions graphOptions = *runOptions;
+	graphOptions.useGraphEngine = 1;
+	StatePaths statePaths = {statePath, NULL};
+	return pipelineRun(peopleFilePath, meetingFilePaths, meetingFileCount, outputFilePath, &statePaths,
+					   &graphOptions);
+}
+
+
+/**
+ * @brief The delta mode: appends the meetings to the run saved in deltaStatePath (see calculateSeveritiesDelta),
+ * writes the output of the whole, and saves it back to deltaStatePath.
+ * @param[in] peopleFilePath argv path for the peopleFile - the one the state was saved with.
+ * @param[in] meetingFilePaths the paths of the new meetings, or of their shards.
+ * @param[in] meetingFileCount number of meeting paths.
+ * @param[in] outputFilePath the path of the output file (the program writes OUTPUT_FILE).
+ * @param[in] deltaStatePath the delta state the meetings are appended to.
+ * @param[in] runOptions the options the program was run with. The graph engine is used either way.
+ * @param[out] STATUS_CODE_SUCCESS If processing was successfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorDelta(const char *peopleFilePath, const char *const *meetingFilePaths,
+								 unsigned int meetingFileCount, const char *outputFilePath,
+								 const char *deltaStatePath, const RunOptions *runOptions)
+{
+	RunOptions graphOptions = *runOptions;
+	graphOptions.useGraphEngine = 1;
+	StatePaths statePaths = {NULL, deltaStatePath};
+	return pipelineRun(peopleFilePath, meetingFilePaths, meetingFileCount, outputFilePath, &statePaths,
+					   &graphOptions);
+}
+
+
+/**
+ * @brief The compile-people mode: reads the peopleFile, and writes its snapshot to snapshotPath.
+ * @details The snapshot can then be given to the program in place of the peopleFile.
+ * @param[in] peopleFilePath argv path for the peopleFile (a text file, or another snapshot).
+ * @param[in] snapshotPath the path of the snapshot.
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If the snapshot was written.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorCompilePeople(const char *peopleFilePath, const char *snapshotPath,
+										  const RunOptions *runOptions)
+{
+	unsigned int peopleCounter = 0;
+	Person *peopleArray = NULL;
+	NameArena nameArena = {0};
+	StatusCode retValPProcess = peopleProcessAndSort(peopleFilePath, &peopleArray, &peopleCounter, &nameArena,
+														runOptions);
+	if ((retValPProcess == STATUS_CODE_SUCCESS) || (retValPProcess == STATUS_CODE_EMPTY_FILE))
+	{
+		retValPProcess = writePeopleSnapshot(snapshotPath, peopleArray, peopleCounter, &nameArena);
+	}
+	peopleArrayFree(peopleArray, &nameArena);
+	nameArenaFree(&nameArena);
+	return retValPProcess;
+}
+
+
+/**
+ * @brief The compile-meetings mode: converts the meetingFile to a meetings table, written to
+ * tablePath (see writeMeetingsTable).
+ * @details The table can then be given to the program in place of the meetingFile (or of a shard), and is
+ * mapped and used in place - without parsing.
+ * @param[in] meetingFilePath argv path for the meetingFile (STDIN_PATH - stdin). May be compressed.
+ * @param[in] tablePath the path of the table.
+ * @param[out] STATUS_CODE_SUCCESS If the table was written.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorCompileMeetings(const char *meetingFilePath, const char *tablePath)
+{
+	Decompressor decompressor = {0};
+	FILE *meetingFile = (strcmp(meetingFilePath, STDIN_PATH) == 0) ? stdin :
+						inputFileOpen(meetingFilePath, &decompressor);
+	if (meetingFile == NULL)
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	StatusCode retValWrite = writeMeetingsTable(meetingFile, tablePath);
+	if ((meetingFile != stdin) && (inputFileClose(meetingFile, &decompressor) != STATUS_CODE_SUCCESS) &&
+		(retValWrite == STATUS_CODE_SUCCESS))
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		retValWrite = STATUS_CODE_INPUT_ERROR;
+	}
+	return retValWrite;
+}
+
+
+/**
+ * @brief A function that starts an analysis of the in-memory API: copies the registry's people, whose
+ * severities are about to be calculated.
+ * @note The function ALLOCATES MEMORY being returned. released by the caller, with free.
+ * @param[in] registry the registry being analyzed. Must hold at least one person.
+ * @return the copy of the registry's People-Array, or NULL if memory allocation failed.
+ */
+static Person *registryJobPeople(const SpreaderDetectorRegistry *registry)
+{
+	Person *jobPeople = (Person *) malloc((size_t) registry->peopleCounter * sizeof(Person));
+	if (jobPeople == NULL)
+	{
+		error(STATUS_CODE_FAIL);
+		return NULL;
+	}
+	memcpy(jobPeople, registry->peopleArray, (size_t) registry->peopleCounter * sizeof(Person));
+	return jobPeople;
+}
+
+
+/**
+ * @brief A function that finishes an analysis of the in-memory API: orders the people as the output file
+ * would (see orderPeopleForOutput), and collects them as results, most severe first.
+ * @note The function ALLOCATES MEMORY being stored in results. released by spreaderDetectorResultsFree.
+ * @param[in] registry the registry being analyzed.
+ * @param[in] jobPeople the analyzed copy of the registry's People-Array. Being reordered.
+ * @param[in] runOptions the options of the analysis.
+ * @param[in] results set to the results.
+ * @param[in] resultCount set to the number of results.
+ * @param[out] STATUS_CODE_SUCCESS If the results were collected.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+static StatusCode registryJobResults(const SpreaderDetectorRegistry *registry, Person *jobPeople,
+									 const RunOptions *runOptions, SpreaderDetectorResult **results,
+									 unsigned int *resultCount)
+{
+	runStatsPhaseStart(runOptions->runStats);
+	unsigned int outputCounter = orderPeopleForOutput(jobPeople, registry->peopleCounter, runOptions);
+	*results = (SpreaderDetectorResult *) malloc(((size_t) outputCounter + 1) * sizeof(SpreaderDetectorResult));
+	if (*results == NULL)
+	{
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	
+	//	The People-Array is ordered for writing backwards (see writeSeverityLines):
+	unsigned int resultIndex = 0;
+	for (resultIndex = 0; resultIndex < outputCounter; resultIndex++)
+	{
+		const Person *person = jobPeople + (outputCounter - 1 - resultIndex);
+		SpreaderDetectorResult *result = (*results) + resultIndex;
+		result->name = registry->nameArena.names + person->nameOffset;
+		result->nameLength = person->nameLength;
+		result->id = person->id;
+		result->severity = person->severity;
+	}
+	*resultCount = outputCounter;
+	runStatsCount(runOptions->runStats, STATS_PHASE_ORDER, 0, outputCounter, 0);
+	runStatsPhaseEnd(runOptions->runStats, STATS_PHASE_ORDER);
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that builds a people registry out of an array of people.
+ * @note The function ALLOCATES MEMORY being returned. released by spreaderDetectorRegistryFree.
+ * @param[in] people the people, in any order. Their names are copied.
+ * @param[in] peopleCount number of people.
+ * @param[in] runOptions the options to sort with (threadCount).
+ * @return the registry, or NULL on error (a person with ID 0, or memory allocation failure).
+ */
+SpreaderDetectorRegistry *spreaderDetectorRegistryCreate(const SpreaderDetectorPerson *people,
+														 unsigned int peopleCount, const RunOptions *runOptions)
+{
+	SpreaderDetectorRegistry *registry = (SpreaderDetectorRegistry *) calloc(1, sizeof(SpreaderDetectorRegistry));
+	if (registry == NULL)
+	{
+		error(STATUS_CODE_FAIL);
+		return NULL;
+	}
+	registry->peopleArray = (Person *) malloc(((size_t) peopleCount + 1) * sizeof(Person));
+	if (registry->peopleArray == NULL)
+	{
+		error(STATUS_CODE_FAIL);
+		spreaderDetectorRegistryFree(registry);
+		return NULL;
+	}
+	
+	//	Same checks as parsePersonLine - the ID can't be 0:
+	unsigned int personIndex = 0;
+	PeopleRuns peopleRuns = {1, 0, {0}};
+	for (personIndex = 0; personIndex < peopleCount; personIndex++)
+	{
+		Person *person = registry->peopleArray + personIndex;
+		person->id = people[personIndex].id;
+		person->severity = 0;
+		if ((person->id == 0) || (nameArenaAppend(&registry->nameArena, people[personIndex].name,
+												   strlen(people[personIndex].name), person) != STATUS_CODE_SUCCESS))
+		{
+			if (person->id == 0)
+			{
+				error(STATUS_CODE_INPUT_ERROR);
+			}
+			spreaderDetectorRegistryFree(registry);
+			return NULL;
+		}
+		peopleRunsTrack(&peopleRuns, person->id, personIndex);
+		registry->peopleCounter++;
+	}
+	
+	//	Sorted by ID (people given in ID order aren't) and indexed, as peopleProcessAndSort and spreaderDetector do:
+	sortPeopleRuns(registry->peopleArray, registry->peopleCounter, &peopleRuns,
+				   resolveThreadCount(runOptions->threadCount));
+	if ((registry->peopleCounter > 0) &&
+		(peopleIndexBuild(&registry->peopleIndex, registry->peopleArray, registry->peopleCounter, NULL) !=
+		 STATUS_CODE_SUCCESS))
+	{
+		spreaderDetectorRegistryFree(registry);
+		return NULL;
+	}
+	return registry;
+}
+
+
+/**
+ * @brief A function that loads a people registry from a peopleFile (a text file, or a snapshot).
+ * @note The function ALLOCATES MEMORY being returned. released by spreaderDetectorRegistryFree.
+ * @param[in] peopleFilePath the path of the peopleFile. An empty file gives an empty registry.
+ * @param[in] runOptions the options to read and sort with (threadCount). Its runStats get the people phase.
+ * @return the registry, or NULL on error.
+ */
+SpreaderDetectorRegistry *spreaderDetectorRegistryLoad(const char *peopleFilePath, const RunOptions *runOptions)
+{
+	SpreaderDetectorRegistry *registry = (SpreaderDetectorRegistry *) calloc(1, sizeof(SpreaderDetectorRegistry));
+	if (registry == NULL)
+	{
+		error(STATUS_CODE_FAIL);
+		return NULL;
+	}
+	runStatsPhaseStart(runOptions->runStats);
+	StatusCode retValPProcess = peopleProcessAndSort(peopleFilePath, &registry->peopleArray,
+														&registry->peopleCounter, &registry->nameArena, runOptions);
+	if (retValPProcess == STATUS_CODE_EMPTY_FILE)
+	{
+		runStatsPhaseEnd(runOptions->runStats, STATS_PHASE_PEOPLE);
+		return registry;
+	}
+	if ((retValPProcess != STATUS_CODE_SUCCESS) ||
+		(peopleIndexBuild(&registry->peopleIndex, registry->peopleArray, registry->peopleCounter,
+						  &registry->nameArena.runArena) != STATUS_CODE_SUCCESS))
+	{
+		spreaderDetectorRegistryFree(registry);
+		return NULL;
+	}
+	runStatsPhaseEnd(runOptions->runStats, STATS_PHASE_PEOPLE);
+	return registry;
+}
+
+
+/**
+ * @brief A function that releases a people registry.
+ * @note The results of its analyses point to its names, so they can't be used after it is released.
+ * @param[in] registry the registry to release. May be NULL.
+ */
+void spreaderDetectorRegistryFree(SpreaderDetectorRegistry *registry)
+{
+	if (registry == NULL)
+	{
+		return;
+	}
+	peopleArrayFree(registry->peopleArray, &registry->nameArena);
+	peopleIndexFree(&registry->peopleIndex);
+	nameArenaFree(&registry->nameArena);
+	free(registry);
+}
+
+
+/**
+ * @brief A function that analyzes an array of meetings against a registry.
+ * @details The meetings are applied in array order, exactly as calculateSeverities applies the lines of a
+ * meetingFile (the graph engine isn't used). The registry isn't changed, so analyses may run concurrently.
+ * @note The function ALLOCATES MEMORY being stored in results. released by spreaderDetectorResultsFree.
+ * @param[in] registry the people.
+ * @param[in] spreaderID the ID of the verified carrier (the first line of a meetingFile). 0 - no meetings.
+ * @param[in] meetings the meetings, in BFS batch order.
+ * @param[in] meetingCount number of meetings.
+ * @param[in] runOptions the options of the analysis (outputMode, topCount, threadCount, runStats).
+ * @param[in] results set to the ranked results, most severe first (as the lines of the output file).
+ * @param[in] resultCount set to the number of results.
+ * @param[out] STATUS_CODE_SUCCESS If the analysis was successful.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorAnalyze(const SpreaderDetectorRegistry *registry, int spreaderID,
+								   const SpreaderDetectorMeeting *meetings, size_t meetingCount,
+								   const RunOptions *runOptions, SpreaderDetectorResult **results,
+								   unsigned int *resultCount)
+{
+	*results = NULL;
+	*resultCount = 0;
+	if (registry->peopleCounter == 0)
+	{
+		return STATUS_CODE_SUCCESS;
+	}
+	Person *jobPeople = registryJobPeople(registry);
+	if (jobPeople == NULL)
+	{
+		return STATUS_CODE_FAIL;
+	}
+	runStatsPhaseStart(runOptions->runStats);
+	StatusCode retValJob = calculateSeveritiesFromMeetings(spreaderID, meetings, meetingCount, jobPeople,
+														   &registry->peopleIndex, runOptions->runStats);
+	if (retValJob == STATUS_CODE_SUCCESS)
+	{
+		runStatsPhaseEnd(runOptions->runStats, STATS_PHASE_MEETINGS);
+		retValJob = registryJobResults(registry, jobPeople, runOptions, results, resultCount);
+	}
+	free(jobPeople);
+	return retValJob;
+}
+
+
+/**
+ * @brief A function that analyzes the content of a meetingFile, held in memory, against a registry.
+ * @details Parsed in place, on the threads of runOptions - by calculateSeveritiesGraph with the graph engine,
+ * and by calculateSeveritiesParallel otherwise. The registry isn't changed.
+ * @note The function ALLOCATES MEMORY being stored in results. released by spreaderDetectorResultsFree.
+ * @param[in] registry the people.
+ * @param[in] meetings the content of the meetingFile (doesn't have to be '\0' terminated).
+ * @param[in] meetingsSize the size of the content.
+ * @param[in] runOptions the options of the analysis.
+ * @param[in] results set to the ranked results, most severe first (as the lines of the output file).
+ * @param[in] resultCount set to the number of results.
+ * @param[out] STATUS_CODE_SUCCESS If the analysis was successful.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorAnalyzeBuffer(const SpreaderDetectorRegistry *registry, const char *meetings,
+										 size_t meetingsSize, const RunOptions *runOptions,
+										 SpreaderDetectorResult **results, unsigned int *resultCount)
+{
+	*results = NULL;
+	*resultCount = 0;
+	if (registry->peopleCounter == 0)
+	{
+		return STATUS_CODE_SUCCESS;
+	}
+	Person *jobPeople = registryJobPeople(registry);
+	if (jobPeople == NULL)
+	{
+		return STATUS_CODE_FAIL;
+	}
+	StatusCode retValJob = STATUS_CODE_SUCCESS;
+	unsigned int threadCount = resolveThreadCount(runOptions->threadCount);
+	MeetingShard meetingShard = {meetings, meetings + meetingsSize, NULL, 0, 0, NULL};
+	runStatsPhaseStart(runOptions->runStats);
+	if (meetingShardsOpenTables(&meetingShard, 1) != STATUS_CODE_SUCCESS)
+	{
+		retValJob = STATUS_CODE_INPUT_ERROR;
+	}
+	else if (runOptions->useGraphEngine)
+	{
+		retValJob = calculateSeveritiesGraph(&meetingShard, 1, jobPeople, &registry->peopleIndex,
+											 registry->peopleCounter, NULL, threadCount, runOptions->runStats);
+	}
+	else
+	{
+		retValJob = calculateSeveritiesParallel(&meetingShard, 1, jobPeople, &registry->peopleIndex, threadCount,
+												runOptions->runStats);
+	}
+	if (retValJob == STATUS_CODE_SUCCESS)
+	{
+		runStatsPhaseEnd(runOptions->runStats, STATS_PHASE_MEETINGS);
+		retValJob = registryJobResults(registry, jobPeople, runOptions, results, resultCount);
+	}
+	free(jobPeople);
+	return retValJob;
+}
+
+
+/**
+ * @brief A function that analyzes a meetingFile against a registry.
+ * @details The meetingFile is read by meetingsProcess, with every option of runOptions (STDIN_PATH reads
+ * stdin). The registry isn't changed.
+ * @note The function ALLOCATES MEMORY being stored in results. released by spreaderDetectorResultsFree.
+ * @param[in] registry the people.
+ * @param[in] meetingFilePath the path of the meetingFile.
+ * @param[in] runOptions the options of the analysis.
+ * @param[in] results set to the ranked results, most severe first (as the lines of the output file).
+ * @param[in] resultCount set to the number of results.
+ * @param[out] STATUS_CODE_SUCCESS If the analysis was successful.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorAnalyzeFile(const SpreaderDetectorRegistry *registry, const char *meetingFilePath,
+									   const RunOptions *runOptions, SpreaderDetectorResult **results,
+									   unsigned int *resultCount)
+{
+	*results = NULL;
+	*resultCount = 0;
+	if (registry->peopleCounter == 0)
+	{
+		return STATUS_CODE_SUCCESS;
+	}
+	Person *jobPeople = registryJobPeople(registry);
+	if (jobPeople == NULL)
+	{
+		return STATUS_CODE_FAIL;
+	}
+	runStatsPhaseStart(runOptions->runStats);
+	StatusCode retValJob = meetingsProcess(meetingFilePath, &jobPeople, &registry->peopleCounter,
+										   &registry->peopleIndex, &registry->nameArena, NULL, runOptions);
+	if (retValJob == STATUS_CODE_SUCCESS)
+	{
+		runStatsPhaseEnd(runOptions->runStats, STATS_PHASE_MEETINGS);
+		retValJob = registryJobResults(registry, jobPeople, runOptions, results, resultCount);
+	}
+	free(jobPeople);
+	return retValJob;
+}
+
+
+/**
+ * @brief A function that writes results as the lines of the output file (see generateSeverityFile).
+ * @param[in] outputFd the descriptor to write to. Not closed.
+ * @param[in] results the results, as returned by an analysis.
+ * @param[in] resultCount the number of results.
+ * @param[out] STATUS_CODE_SUCCESS If the lines were written.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorWriteResults(int outputFd, const SpreaderDetectorResult *results,
+										unsigned int resultCount)
+{
+	OutputWriter outputWriter = {0};
+	if (outputWriterInit(&outputWriter, outputFd) != STATUS_CODE_SUCCESS)
+	{
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	StatusCode retValWrite = STATUS_CODE_SUCCESS;
+	unsigned int resultIndex = 0;
+	for (resultIndex = 0; (resultIndex < resultCount) && (retValWrite == STATUS_CODE_SUCCESS); resultIndex++)
+	{
+		const SpreaderDetectorResult *result = results + resultIndex;
+		retValWrite = outputWriterAppendLine(&outputWriter, result->severity, result->name, result->nameLength,
+											 result->id);
+	}
+	if (retValWrite == STATUS_CODE_SUCCESS)
+	{
+		retValWrite = outputWriterFlush(&outputWriter);
+	}
+	outputWriterFree(&outputWriter);
+	return retValWrite;
+}
+
+
+/**
+ * @brief A function that releases the results of an analysis.
+ * @param[in] results the results to release. May be NULL.
+ */
+void spreaderDetectorResultsFree(SpreaderDetectorResult *results)
+{
+	free(results);
+}
+
+
+/**
+ * @brief A function that marks the beginning of a phase of the run.
+ * @note Does nothing unless the run is measured (runStats isn't NULL).
+ * @param[in] runStats the measurements of the run (RunOptions.runStats).
+ */
+void runStatsPhaseStart(RunStats *runStats)
+{
+	if (runStats != NULL)
+	{
+		clock_gettime(CLOCK_MONOTONIC, &runStats->phaseStart);
+	}
+}
+
+
+/**
+ * @brief A function that marks the end of a phase of the run: adds its time, and records the memory
+ * high-water mark of the process so far.
+ * @note Does nothing unless the run is measured (runStats isn't NULL).
+ * @param[in] runStats the measurements of the run (RunOptions.runStats).
+ * @param[in] statsPhase the phase which ended.
+ */
+void runStatsPhaseEnd(RunStats *runStats, StatsPhase statsPhase)
+{
+	struct timespec phaseEnd;
+	struct rusage processUsage;
+	if (runStats == NULL)
+	{
+		return;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &phaseEnd);
+	runStats->phases[statsPhase].seconds += (double) (phaseEnd.tv_sec - runStats->phaseStart.tv_sec) +
+											(double) (phaseEnd.tv_nsec - runStats->phaseStart.tv_nsec) /
+											NANOSECONDS_IN_SECOND;
+	if (getrusage(RUSAGE_SELF, &processUsage) == 0)
+	{
+		runStats->phases[statsPhase].peakRssKilobytes = processUsage.ru_maxrss;
+	}
+}
+
+
+/**
+ * @brief A function that adds to the counters of a phase of the run.
+ * @details Hot loops count in local variables, and report them once they are done.
+ * @note Does nothing unless the run is measured (runStats isn't NULL).
+ * @param[in] runStats the measurements of the run (RunOptions.runStats).
+ * @param[in] statsPhase the phase being counted.
+ * @param[in] bytes bytes read (or written).
+ * @param[in] lines lines read (or people handled).
+ * @param[in] lookups PeopleIndex lookups made.
+ */
+void runStatsCount(RunStats *runStats, StatsPhase statsPhase, unsigned long long bytes, unsigned long long lines,
+				   unsigned long long lookups)
+{
+	if (runStats != NULL)
+	{
+		runStats->phases[statsPhase].bytes += bytes;
+		runStats->phases[statsPhase].lines += lines;
+		runStats->phases[statsPhase].lookups += lookups;
+	}
+}
+
+
+/**
+ * @brief A function that prints the RunStats of a run as a JSON object.
+ * @details The object holds the result of the run, the total time, and an object per phase (people,
+ * meetings, order, output) with its seconds, bytes, lines, lookups and peakRssKilobytes. Phases the run
+ * didn't reach are all 0.
+ * @param[in] statsFile the opened file to print to.
+ * @param[in] runStats the measurements of the run.
+ * @param[in] runStatus the StatusCode the run ended with.
+ */
+void runStatsPrint(FILE *statsFile, const RunStats *runStats, StatusCode runStatus)
+{
+	static const char *phaseNames[STATS_PHASE_COUNT] = {"people", "meetings", "order", "output"};
+	double totalSeconds = 0;
+	unsigned int phaseIndex = 0;
+	for (phaseIndex = 0; phaseIndex < STATS_PHASE_COUNT; phaseIndex++)
+	{
+		totalSeconds += runStats->phases[phaseIndex].seconds;
+	}
+	fprintf(statsFile, "{\n  \"status\": \"%s\",\n  \"totalSeconds\": %.6f,\n  \"phases\": {\n",
+			(runStatus == STATUS_CODE_SUCCESS) ? "success" : "fail", totalSeconds);
+	for (phaseIndex = 0; phaseIndex < STATS_PHASE_COUNT; phaseIndex++)
+	{
+		const PhaseStats *phaseStats = runStats->phases + phaseIndex;
+		fprintf(statsFile, "    \"%s\": {\"seconds\": %.6f, \"bytes\": %llu, \"lines\": %llu, \"lookups\": %llu, "
+				"\"peakRssKilobytes\": %ld}%s\n", phaseNames[phaseIndex], phaseStats->seconds, phaseStats->bytes,
+				phaseStats->lines, phaseStats->lookups, phaseStats->peakRssKilobytes,
+				((phaseIndex + 1) < STATS_PHASE_COUNT) ? "," : "");
+	}
+	fprintf(statsFile, "  }\n}");
+}
+
+
+/**
+ * @brief A function that writes the RunStats of the run as a JSON object (see runStatsPrint).
+ * @param[in] runStats the measurements of the run.
+ * @param[in] statsPath the file to write to, or STATS_TO_STDERR.
+ * @param[in] runStatus the StatusCode the run ended with.
+ * @param[out] STATUS_CODE_SUCCESS If the stats were written.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If the file couldn't be written.
+ */
+StatusCode spreaderDetectorWriteStats(const RunStats *runStats, const char *statsPath, StatusCode runStatus)
+{
+	FILE *statsFile = (strcmp(statsPath, STATS_TO_STDERR) == 0) ? stderr : fopen(statsPath, "w");
+	if (statsFile == NULL)
+	{
+		error(STATUS_CODE_OUTPUT_ERROR);
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	runStatsPrint(statsFile, runStats, runStatus);
+	fprintf(statsFile, "\n");
+	if ((statsFile == stderr) ? (EOF == fflush(statsFile)) : (EOF == fclose(statsFile)))
+	{
+		error(STATUS_CODE_OUTPUT_ERROR);
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that translates a requested number of threads to the number of threads to use.
+ * @param[in] threadCount the requested number of threads. ALL_ONLINE_CPUS means one per online CPU.
+ * @return the number of threads to use (at least 1).
+ */
+unsigned int resolveThreadCount(unsigned int threadCount)
+{
+	if (threadCount == ALL_ONLINE_CPUS)
+	{
+		long onlineCpus = sysconf(_SC_NPROCESSORS_ONLN);
+		threadCount = (onlineCpus > 0) ? (unsigned int) onlineCpus : SERIAL_THREAD_COUNT;
+	}
+	return ((threadCount > MAX_THREAD_COUNT) ? MAX_THREAD_COUNT : threadCount);
+}
+
+
@@ -0,0 +1,434 @@
+/*
+ * File Name: SpreaderDetector.h
+ * Related Files: "SpreaderDetector.c", "SpreaderDetectorParams.h"
+ *
+ * Purpose:
+ * 			The SpreaderDetector library. The file pipeline reads People.in and Meetings.in and writes the
+ * 			analysis file (as the SpreaderDetectorBackend program does). The in-memory API takes the people
+ * 			and the meetings as arrays or buffers, and returns the ranked results - so services can run
+ * 			analyses without writing files.
+ *
+ * Author's ID: 206174120
+ * Author's Name: Oren Kovartovsky
+ * University User Name: orenkov
+ *
+ * */
+
+#ifndef SPREADERDETECTOR_H
+#define SPREADERDETECTOR_H
+
+#include <stddef.h>
+#include <time.h>
+
+/**
+ * A meetingFilePath which reads the meetings from stdin.
+ */
+#define STDIN_PATH "-"
+
+/**
+ * A statsPath which writes the RunStats to stderr.
+ */
+#define STATS_TO_STDERR "-"
+
+/*
+ * ***************************
+ * 	STRUCTS AND ENUMS
+ * ***************************
+ */
+/**
+ * @brief Status Code Enum
+ *
+ * @details Used as: (1) Return Value all over the program, determines if the function succeeded it's action or not.
+ * if the function didn't success, the StatusCode Return Value will represent exactly why.
+ * @details (2) used by the function spreaderDetectorError(errorCode), in order to determine the kind of error
+ * needed to be printed to stderr.
+ */
+typedef enum _StatusCode
+{
+	STATUS_CODE_SUCCESS, 		/**< When a function Success it's action */
+	STATUS_CODE_FAIL,		/**< When a function Defaultly Fails it's action */
+	STATUS_CODE_ARGS_ERROR,		/**< When a function Fails on Arguments Error */
+	STATUS_CODE_INPUT_ERROR,	/**< When a function Fails on Input Error (open or close file) */
+	STATUS_CODE_OUTPUT_ERROR,	/**< When a function Fails on Output Error (open or close file) */
+	STATUS_CODE_EMPTY_FILE,		/**< When a function Detects an empty input file */
+	STATUS_CODE_END_OF_FILE		/**< When a reader has no more lines to return */
+	
+} StatusCode;
+
+/**
+ * @brief Output Mode Enum
+ *
+ * @details Determines which people are written to the output file, and how much of it is sorted.
+ */
+typedef enum _OutputMode
+{
+	OUTPUT_MODE_FULL,		/**< Everyone, sorted by severity */
+	OUTPUT_MODE_TIERS,		/**< Everyone, but the "No serious chance" tier is left in ID order */
+	OUTPUT_MODE_TOP			/**< Only the topCount most severe people */
+} OutputMode;
+
+/**
+ * @brief The phases of a run, in the order they run.
+ */
+typedef enum _StatsPhase
+{
+	STATS_PHASE_PEOPLE,		/**< peopleFile read, sorted by ID and indexed */
+	STATS_PHASE_MEETINGS,	/**< meetingFile parsed, and the severities propagated */
+	STATS_PHASE_ORDER,		/**< People-Array sorted (or partitioned / selected) for the output */
+	STATS_PHASE_OUTPUT,		/**< Output file written */
+	STATS_PHASE_COUNT
+} StatsPhase;
+
+/**
+ * @brief A struct represents the measurements of a single phase of a run.
+ */
+typedef struct _PhaseStats
+{
+	double seconds;				/**< Monotonic wall-clock time of the phase */
+	unsigned long long bytes;	/**< Bytes read (or written, by the output phase) */
+	unsigned long long lines;	/**< Lines read (or people ordered / written) */
+	unsigned long long lookups;	/**< ID lookups in the PeopleIndex */
+	long peakRssKilobytes;		/**< High-water mark of the process' resident memory, at the end of the phase */
+} PhaseStats;
+
+/**
+ * @brief A struct represents the measurements of a run, collected when --stats is given.
+ * @details Every run collects into its own RunStats (RunOptions.runStats), so concurrent runs don't mix.
+ */
+typedef struct _RunStats
+{
+	PhaseStats phases[STATS_PHASE_COUNT];	/**< The measurements of every phase */
+	struct timespec phaseStart;				/**< When the current phase started */
+} RunStats;
+
+/**
+ * @brief A struct represents the options of a run of the library.
+ */
+typedef struct _RunOptions
+{
+	unsigned int threadCount;	/**< Threads parsing the meetingFile. SERIAL_THREAD_COUNT - the serial path */
+	int useGraphEngine;		/**< Whether to propagate over a ContactGraph instead of in file order */
+	OutputMode outputMode;		/**< Which people are written, and how they are ordered */
+	unsigned long topCount;		/**< Number of people written in OUTPUT_MODE_TOP */
+	unsigned long streamInterval;	/**< Updates between emissions of the urgent tiers. 0 - not streaming */
+	char *statsPath;		/**< Where the RunStats are written (STATS_TO_STDERR - stderr). NULL - no stats */
+	RunStats *runStats;		/**< Collects the measurements of the run (zeroed by the caller). NULL - not measured */
+	unsigned long long memoryBudget;	/**< Bytes the external-memory mode may hold. 0 - the in-memory run */
+} RunOptions;
+
+/**
+ * @brief A struct represents a person given to the in-memory API (a line of People.in).
+ */
+typedef struct _SpreaderDetectorPerson
+{
+	const char *name;	/**< The name of the person, '\0' terminated */
+	int id;			/**< 9 digits number, represents ID of a person. Can't be 0 */
+} SpreaderDetectorPerson;
+
+/**
+ * @brief A struct represents a meeting given to the in-memory API (a line of Meetings.in).
+ */
+typedef struct _SpreaderDetectorMeeting
+{
+	int infectorID;		/**< ID of the potential infector */
+	int infectedID;		/**< ID of the potential infected */
+	float distance;		/**< The distance between them */
+	float time;		/**< The time they were together */
+} SpreaderDetectorMeeting;
+
+/**
+ * @brief A struct represents a ranked result of an analysis (a line of the output file).
+ */
+typedef struct _SpreaderDetectorResult
+{
+	const char *name;		/**< The name of the person, inside the registry (not '\0' terminated) */
+	unsigned int nameLength;	/**< Length of the name */
+	int id;				/**< 9 digits number, represents ID of a person */
+	float severity;			/**< Chance of infection, which determines the message (SpreaderDetectorParams.h) */
+} SpreaderDetectorResult;
+
+/**
+ * @brief The people registry of the in-memory API: loaded once, and analyzed any number of times.
+ * @details Opaque - created by spreaderDetectorRegistryCreate / spreaderDetectorRegistryLoad.
+ */
+typedef struct _SpreaderDetectorRegistry SpreaderDetectorRegistry;
+
+
+/*
+ * ***********************
+ * 	DECLARATIONS
+ * ***********************
+ */
+//	****** FILE PIPELINE FUNCTIONS ******
+/**
+ * @brief The function that 'holds' all the relevant actions/functions together, in order to proccess
+ * and determine the order of the potential infected people.
+ *
+ * @details A single meetingFile - see spreaderDetectorShards.
+ * @param[in] peopleFilePath argv path for the peopleFile.
+ * @param[in] meetingFilePath argv path for the meetingFile (STDIN_PATH - stdin, or a directory of shards).
+ * @param[in] outputFilePath the path of the output file (the program writes OUTPUT_FILE).
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If processing was successfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetector(const char* peopleFilePath, const char* meetingFilePath, const char *outputFilePath,
+							const RunOptions *runOptions);
+
+/**
+ * @brief The function that 'holds' all the relevant actions/functions together, in order to proccess
+ * and determine the order of the potential infected people.
+ *
+ * @details the reads data, sorts it and using calculations in order to create the expected output File.
+ * @note varible peopleArray - The DS being used in the program.
+ * The memory allocated to it is released in this func, even though it was allocated in a sub-function.
+ * peopleArray is being by other sub-functions as well.
+ * @param[in] peopleFilePath argv path for the peopleFile.
+ * @param[in] meetingFilePaths the paths of the meetingFile, or of its shards: files which together make up
+ * the meetings, in order. They are parsed concurrently, and merged as one meetingFile would be - by the
+ * default engine in order, by the graph engine with the highest chance of every person (in any order).
+ * @param[in] meetingFileCount number of meeting paths. A single path may be STDIN_PATH (stdin), or a directory
+ * of shards.
+ * @param[in] outputFilePath the path of the output file (the program writes OUTPUT_FILE).
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If processing was successfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorShards(const char* peopleFilePath, const char *const *meetingFilePaths,
+								  unsigned int meetingFileCount, const char *outputFilePath,
+								  const RunOptions *runOptions);
+
+/**
+ * @brief The save-state mode: a graph engine run (see spreaderDetectorShards), which saves its delta state to
+ * statePath.
+ *
+ * @details The state - the contact graph, the severities and the BFS levels of the run - lets a later
+ * spreaderDetectorDelta append new meetings without reading the old ones again.
+ * @param[in] peopleFilePath argv path for the peopleFile.
+ * @param[in] meetingFilePaths the paths of the meetingFile, or of its shards.
+ * @param[in] meetingFileCount number of meeting paths.
+ * @param[in] outputFilePath the path of the output file (the program writes OUTPUT_FILE).
+ * @param[in] statePath where the delta state is saved.
+ * @param[in] runOptions the options the program was run with. The graph engine is used either way.
+ * @param[out] STATUS_CODE_SUCCESS If processing was successfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorSaveState(const char *peopleFilePath, const char *const *meetingFilePaths,
+									 unsigned int meetingFileCount, const char *outputFilePath,
+									 const char *statePath, const RunOptions *runOptions);
+
+/**
+ * @brief The delta mode: appends new meetings to the run saved in deltaStatePath, writes the output of the
+ * whole, and saves it back to deltaStatePath.
+ *
+ * @param[in] peopleFilePath argv path for the peopleFile - the one the state was saved with.
+ * @param[in] meetingFilePaths the paths of the new meetings, or of their shards.
+ * @param[in] meetingFileCount number of meeting paths.
+ * @param[in] outputFilePath the path of the output file (the program writes OUTPUT_FILE).
+ * @param[in] deltaStatePath the delta state the meetings are appended to.
+ * @param[in] runOptions the options the program was run with. The graph engine is used either way.
+ * @param[out] STATUS_CODE_SUCCESS If processing was successfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorDelta(const char *peopleFilePath, const char *const *meetingFilePaths,
+								 unsigned int meetingFileCount, const char *outputFilePath,
+								 const char *deltaStatePath, const RunOptions *runOptions);
+
+/**
+ * @brief The compile-people mode: reads the peopleFile, and writes its snapshot to snapshotPath.
+ *
+ * @details The snapshot can then be given to the program in place of the peopleFile.
+ * @param[in] peopleFilePath argv path for the peopleFile (a text file, or another snapshot).
+ * @param[in] snapshotPath the path of the snapshot.
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If the snapshot was written.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorCompilePeople(const char *peopleFilePath, const char *snapshotPath,
+										  const RunOptions *runOptions);
+
+/**
+ * @brief The compile-meetings mode: converts the meetingFile to a meetings table, written to
+ * tablePath.
+ *
+ * @details The table - int32 ID columns and float32 distance / time columns, in blocks, with a block index - can
+ * then be given to the program in place of the meetingFile (or of a shard), and is mapped and used in place,
+ * without parsing.
+ * @param[in] meetingFilePath argv path for the meetingFile (STDIN_PATH - stdin). May be compressed.
+ * @param[in] tablePath the path of the table.
+ * @param[out] STATUS_CODE_SUCCESS If the table was written.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorCompileMeetings(const char *meetingFilePath, const char *tablePath);
+
+/**
+ * @brief The external-memory mode: processes the peopleFile and the meetingFile within runOptions->memoryBudget
+ * bytes, however large they are, and writes the same output file the in-memory run does.
+ *
+ * @details Nothing is indexed in memory: the people are sorted by ID with an external merge sort, and the IDs
+ * the meetings refer to are resolved by a sort-merge join against them (see externalJoinReferences). The
+ * meetings are then applied in file order, holding only the severities of the people met, and the output is
+ * written by the final merge of an external sort in output order. The sorted runs are unlinked temporary files
+ * in the directory of the output file.
+ * @param[in] peopleFilePath argv path for the peopleFile. May be compressed.
+ * @param[in] meetingFilePath argv path for the meetingFile (STDIN_PATH - stdin). May be compressed.
+ * @param[in] outputFilePath the path of the output file (the program writes OUTPUT_FILE).
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If processing was successfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorExternal(const char *peopleFilePath, const char *meetingFilePath,
+									const char *outputFilePath, const RunOptions *runOptions);
+
+/**
+ * @brief The batch mode: runs the jobs of a manifest - (peopleFile, meetingFile, output file) triples -
+ * concurrently, on a work-stealing pool of threads.
+ *
+ * @details Every line of the manifest holds a job - the paths of its peopleFile, its meetingFile and its output
+ * file, separated by spaces or tabs; blank lines and lines starting with '#' are skipped. The jobs are grouped
+ * by their peopleFile - the same file, under any of its paths - which is loaded once for all of them, and the
+ * groups are dealt to the workers as contiguous ranges, so each worker keeps to few peopleFiles; a worker which
+ * ran out of jobs steals from the others. Every job runs on a single thread, with the other options of
+ * runOptions, and its output file is the one spreaderDetector writes for it alone. A failed job doesn't stop
+ * the others, and its output file isn't written. With a statsPath, every job is measured on its own, and the
+ * stats are written as a JSON array of the objects spreaderDetectorWriteStats writes - one per job, in manifest order.
+ * @param[in] manifestPath the path of the manifest (STDIN_PATH - stdin).
+ * @param[in] runOptions the options the program was run with. threadCount is the number of workers (0 - one per
+ * online CPU). runStats is ignored.
+ * @param[out] STATUS_CODE_SUCCESS If every job was successful.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorBatch(const char *manifestPath, const RunOptions *runOptions);
+
+/**
+ * @brief A function that writes the RunStats of the run as a JSON object.
+ *
+ * @details The object holds the result of the run, the total time, and an object per phase (people,
+ * meetings, order, output) with its seconds, bytes, lines, lookups and peakRssKilobytes. Phases the run
+ * didn't reach are all 0.
+ * @param[in] runStats the measurements of the run.
+ * @param[in] statsPath the file to write to, or STATS_TO_STDERR.
+ * @param[in] runStatus the StatusCode the run ended with.
+ * @param[out] STATUS_CODE_SUCCESS If the stats were written.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If the file couldn't be written.
+ */
+StatusCode spreaderDetectorWriteStats(const RunStats *runStats, const char *statsPath, StatusCode runStatus);
+
+/**
+ * @brief A function that writes the message of an error to stderr, as the library does when it detects one.
+ *
+ * @param[in] errorCode The relevant StatusCode, representing the error occurred.
+ */
+void spreaderDetectorError(StatusCode errorCode);
+
+
+//	****** IN-MEMORY API FUNCTIONS ******
+/**
+ * @brief A function that builds a people registry out of an array of people.
+ *
+ * @note The function ALLOCATES MEMORY being returned. released by spreaderDetectorRegistryFree.
+ * @param[in] people the people, in any order. Their names are copied.
+ * @param[in] peopleCount number of people.
+ * @param[in] runOptions the options to sort with (threadCount).
+ * @return the registry, or NULL on error (a person with ID 0, or memory allocation failure).
+ */
+SpreaderDetectorRegistry *spreaderDetectorRegistryCreate(const SpreaderDetectorPerson *people,
+														 unsigned int peopleCount, const RunOptions *runOptions);
+
+/**
+ * @brief A function that loads a people registry from a peopleFile (a text file, or a snapshot).
+ *
+ * @note The function ALLOCATES MEMORY being returned. released by spreaderDetectorRegistryFree.
+ * @param[in] peopleFilePath the path of the peopleFile. An empty file gives an empty registry.
+ * @param[in] runOptions the options to read and sort with (threadCount). Its runStats get the people phase.
+ * @return the registry, or NULL on error.
+ */
+SpreaderDetectorRegistry *spreaderDetectorRegistryLoad(const char *peopleFilePath, const RunOptions *runOptions);
+
+/**
+ * @brief A function that releases a people registry.
+ *
+ * @note The results of its analyses point to its names, so they can't be used after it is released.
+ * @param[in] registry the registry to release. May be NULL.
+ */
+void spreaderDetectorRegistryFree(SpreaderDetectorRegistry *registry);
+
+/**
+ * @brief A function that analyzes an array of meetings against a registry.
+ *
+ * @details The meetings are applied in array order, exactly as calculateSeverities applies the lines of a
+ * meetingFile (the graph engine isn't used). The registry isn't changed, so analyses may run concurrently.
+ * @note The function ALLOCATES MEMORY being stored in results. released by spreaderDetectorResultsFree.
+ * @param[in] registry the people.
+ * @param[in] spreaderID the ID of the verified carrier (the first line of a meetingFile). 0 - no meetings.
+ * @param[in] meetings the meetings, in BFS batch order.
+ * @param[in] meetingCount number of meetings.
+ * @param[in] runOptions the options of the analysis (outputMode, topCount, threadCount, runStats).
+ * @param[in] results set to the ranked results, most severe first (as the lines of the output file).
+ * @param[in] resultCount set to the number of results.
+ * @param[out] STATUS_CODE_SUCCESS If the analysis was successful.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorAnalyze(const SpreaderDetectorRegistry *registry, int spreaderID,
+								   const SpreaderDetectorMeeting *meetings, size_t meetingCount,
+								   const RunOptions *runOptions, SpreaderDetectorResult **results,
+								   unsigned int *resultCount);
+
+/**
+ * @brief A function that analyzes the content of a meetingFile, held in memory, against a registry.
+ *
+ * @details Parsed in place, on the threads of runOptions - by calculateSeveritiesGraph with the graph engine,
+ * and by calculateSeveritiesParallel otherwise. The registry isn't changed.
+ * @note The function ALLOCATES MEMORY being stored in results. released by spreaderDetectorResultsFree.
+ * @param[in] registry the people.
+ * @param[in] meetings the content of the meetingFile (doesn't have to be '\0' terminated).
+ * @param[in] meetingsSize the size of the content.
+ * @param[in] runOptions the options of the analysis.
+ * @param[in] results set to the ranked results, most severe first (as the lines of the output file).
+ * @param[in] resultCount set to the number of results.
+ * @param[out] STATUS_CODE_SUCCESS If the analysis was successful.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorAnalyzeBuffer(const SpreaderDetectorRegistry *registry, const char *meetings,
+										 size_t meetingsSize, const RunOptions *runOptions,
+										 SpreaderDetectorResult **results, unsigned int *resultCount);
+
+/**
+ * @brief A function that analyzes a meetingFile against a registry.
+ *
+ * @details The meetingFile is read by meetingsProcess, with every option of runOptions (STDIN_PATH reads
+ * stdin). The registry isn't changed.
+ * @note The function ALLOCATES MEMORY being stored in results. released by spreaderDetectorResultsFree.
+ * @param[in] registry the people.
+ * @param[in] meetingFilePath the path of the meetingFile.
+ * @param[in] runOptions the options of the analysis.
+ * @param[in] results set to the ranked results, most severe first (as the lines of the output file).
+ * @param[in] resultCount set to the number of results.
+ * @param[out] STATUS_CODE_SUCCESS If the analysis was successful.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorAnalyzeFile(const SpreaderDetectorRegistry *registry, const char *meetingFilePath,
+									   const RunOptions *runOptions, SpreaderDetectorResult **results,
+									   unsigned int *resultCount);
+
+/**
+ * @brief A function that writes results as the lines of the output file (see generateSeverityFile).
+ *
+ * @param[in] outputFd the descriptor to write to. Not closed.
+ * @param[in] results the results, as returned by an analysis.
+ * @param[in] resultCount the number of results.
+ * @param[out] STATUS_CODE_SUCCESS If the lines were written.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorWriteResults(int outputFd, const SpreaderDetectorResult *results,
+										unsigned int resultCount);
+
+/**
+ * @brief A function that releases the results of an analysis.
+ *
+ * @param[in] results the results to release. May be NULL.
+ */
+void spreaderDetectorResultsFree(SpreaderDetectorResult *results);
+
+
+#endif //SPREADERDETECTOR_H
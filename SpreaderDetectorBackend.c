@@ -1,12 +1,14 @@
 /*
  * File Name: SpreaderDetectorBackend.c
- * Related Files: "SpreaderDetectorParams.h"
+ * Related Files: "SpreaderDetector.h", "SpreaderDetectorParams.h"
  *
  * Purpose:
  * 			Due to the Corona Virus pandemic spreading around the world in 2020, the Hebrew University
  * 			was asked to create a program that will update people that were potentially infected, to
  * 			the fact that they are in risk, and tell them what should they do next, according to that.
  * 			This program Analayzes data about meetings of people, and outputs recommendation due to it.
+ * 			The analysis itself is done by the SpreaderDetector library (SpreaderDetector.c) - this file
+ * 			parses the command line, and runs the daemon mode.
  *
  * Author's ID: 206174120
  * Author's Name: Oren Kovartovsky
@@ -14,79 +16,94 @@
  *
  * */
 
+#define _POSIX_C_SOURCE 200809L
+
+#include "SpreaderDetector.h"
 #include "SpreaderDetectorParams.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 
 #define ARGS_COUNT 3
 #define FILE_DO_NOT_EXIST -1
 
-#define ERROR_ARGS "Usage: ./SpreaderDetectorBackend <Path to People.in> <Path to Meetings.in>\n"
-#define ERROR_INPUT "Error in input files.\n"
-#define ERROR_OUTPUT "Error in output file.\n"
-#define ERROR_DEAFULT "Standard library error.\n"
-
-#define INPUT_MAX_LINE_LEN 1024
-
-#define PEOPLE_ID_INDEX 0
-#define PEOPLE_NAME_INDEX 1
-
-#define MEET_FIRST_ID_INDEX 0
-#define MEET_SECOND_ID_INDEX 1
-#define MEET_DISTANCE_INDEX 2
-#define MEET_TIME_INDEX 3
-#define INFECTOR_OLD 0
-#define INFECTOR_NEW 1
-#define MAX_SEVERITY 1
+#define OPTION_PREFIX "--"
+#define OPTION_THREADS "--threads"
+#define OPTION_GRAPH "--graph"
+#define OPTION_TIERS "--tiers"
+#define OPTION_TOP "--top"
+#define OPTION_STREAM "--stream"
+#define OPTION_SERVE "--serve"
+#define DAEMON_LISTEN_BACKLOG 64
+#define DAEMON_MAX_REQUEST_LEN 4096
+#define DAEMON_REQUEST_TIMEOUT_MS 5000	// A client has this long to send its whole request.
+#define DAEMON_SEND_TIMEOUT_SECONDS 30	// A client which reads nothing for this long fails its job.
+#define MILLISECONDS_IN_SECOND 1000
+#define NANOSECONDS_IN_MILLISECOND 1000000
+#define DAEMON_JOB_ERROR "Error in input files.\n"
+#define OPTION_COMPILE_PEOPLE "--compile-people"
+#define OPTION_COMPILE_MEETINGS "--compile-meetings"
+#define OPTION_STATS "--stats"
+#define OPTION_SAVE_STATE "--save-state"
+#define OPTION_DELTA "--delta"
+#define OPTION_MEMORY_BUDGET "--memory-budget"
+#define OPTION_BATCH "--batch"
+
+#define SERIAL_THREAD_COUNT 1
+#define ALL_ONLINE_CPUS 0
+#define MAX_THREAD_COUNT 1024
+#define MIN_MEMORY_BUDGET_MB 16
+#define MEGABYTE_SHIFT 20
+
+#define ERROR_ARGS "Usage: ./SpreaderDetectorBackend [--threads <N>] [--graph] [--tiers | --top <K>] [--stats <Path | ->] <Path to People.in> <Path to Meetings.in | Meetings Directory | -> [More Meetings Shards...]\n" \
+				   "       ./SpreaderDetectorBackend --stream <N> [--tiers | --top <K>] [--stats <Path | ->] <Path to People.in> <Path to Meetings.in | ->\n" \
+				   "       ./SpreaderDetectorBackend [--threads <N>] [--tiers | --top <K>] [--stats <Path | ->] --save-state <State Path> <Path to People.in> <Path to Meetings.in>\n" \
+				   "       ./SpreaderDetectorBackend [--threads <N>] [--tiers | --top <K>] [--stats <Path | ->] --delta <State Path> <Path to People.in> <Path to New Meetings>\n" \
+				   "       ./SpreaderDetectorBackend [--tiers | --top <K>] [--stats <Path | ->] --memory-budget <MB> <Path to People.in> <Path to Meetings.in | ->\n" \
+				   "       ./SpreaderDetectorBackend [--threads <N>] [--graph] [--tiers | --top <K>] --serve <Socket Path> <Path to People.in>\n" \
+				   "       ./SpreaderDetectorBackend [--threads <N>] [--graph] [--tiers | --top <K>] [--stats <Path | ->] --batch <Manifest Path | ->\n" \
+				   "       ./SpreaderDetectorBackend --compile-people <Snapshot Path> <Path to People.in>\n" \
+				   "       ./SpreaderDetectorBackend --compile-meetings <Table Path> <Path to Meetings.in | ->\n" \
+				   "Options come before the paths. --stream is mutually exclusive with --threads and --graph.\n"
 
 /*
  * ***************************
- * 	STRUCTS AND ENUMS
+ * 	STRUCTS
  * ***************************
  */
 /**
- * @brief Status Code Enum
- *
- * @details Used as: (1) Return Value all over the program, determines if the function succeeded it's action or not.
- * if the function didn't success, the StatusCode Return Value will represent exactly why.
- * @details (2) used by the function error(errorCode), in order to determine the kind of error needed to be
- * printed to stderr.
+ * @brief A struct represents the mode the program was run in, and the paths it needs - the options of the
+ * command line which aren't options of the library (RunOptions).
  */
-typedef enum _StatusCode
+typedef struct _ModeOptions
 {
-	STATUS_CODE_SUCCESS, 		/**< When a function Success it's action */
-	STATUS_CODE_FAIL,		/**< When a function Defaultly Fails it's action */
-	STATUS_CODE_ARGS_ERROR,		/**< When a function Fails on Arguments Error */
-	STATUS_CODE_INPUT_ERROR,	/**< When a function Fails on Input Error (open or close file) */
-	STATUS_CODE_OUTPUT_ERROR,	/**< When a function Fails on Output Error (open or close file) */
-	STATUS_CODE_EMPTY_FILE		/**< When a function Detects an empty input file */
-	
-} StatusCode;
+	char *socketPath;		/**< The Unix socket of the daemon mode. NULL - not a daemon */
+	char *snapshotPath;		/**< The snapshot to compile the peopleFile to. NULL - not compiling */
+	char *tablePath;		/**< The meetings table to compile the meetingFile to. NULL - not compiling */
+	char *statePath;		/**< Where a graph run saves its delta state. NULL - it isn't saved */
+	char *deltaStatePath;	/**< The delta state the meetingFile is appended to. NULL - not a delta run */
+	char *manifestPath;		/**< The manifest of the batch mode's jobs. NULL - not a batch */
+} ModeOptions;
 
-/**
- * @brief A struct represents a Person which might be a coronavirus carrier.
- * @details Used to store relevant data about the person.
- */
-typedef struct _Person
-{
-	int id; 				/**< 9 digits number, represents ID of a person */
-	float severity;				/**< Severity, value between 0 to 1 (included) */
-	char name[INPUT_MAX_LINE_LEN];		/**< Person's Name */
-} Person;
 
+/*
+ * ***************************
+ * 	GLOBALS
+ * ***************************
+ */
 /**
- * @brief A struct represents a Meeting between 2 people that might have coronavirus.
- * @details Used to store the data conveniently during the program.
+ * @brief Set by daemonStopHandler, when the daemon is asked to stop.
  */
-typedef struct _Meeting
-{
-	int infectorID;		/**< 9 digits number, represents ID of the potential infector */
-	int infectedID;		/**< 9 digits number, represents ID of the potential infected */
-	float distance;		/**< distance measured between them. bounded by MIN_DISTANCE */
-	float time;		/**< time measured in which they were next to each other. bounded by MAX_TIME. */
-} Meeting;
+static volatile sig_atomic_t daemonStopRequested = 0;
 
 
 /*
@@ -94,164 +111,114 @@ typedef struct _Meeting
  * 	DECLARATIONS
  * ***********************
  */
-//	****** GENERATING FILES or MESSAGES FUNCTIONS ******
-/**
- * @brief A function that generates an empty output file.
- * @details output file name is: OUTPUT_FILE.
- * @details used whenever input is valid - but people's input file is empty.
- * @param[out] STATUS_CODE_SUCCESS if file was generated successfully.
- * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
- */
-StatusCode generateEmptyOutputFile();
-
-/**
- * @brief A function that determines which message a person should get, according to the chances
- * of him being a carrier.
- * @note uses a #define statements from "SpreaderDetectorParams.h" file
- * @return The relevant message
- */
-const char* severityToMessage(float severityLevel);
-
-/**
- * @brief A function that generates an output file of the potential carriers, sorted by urgency of treatment.
- * @details output file name is: OUTPUT_FILE.
- * @details output file is divided to 3 sections: Hospitalization needed, Quarantine needed, No serious.
- * @details each of the section is sorted by severity level.
- * @param[in] peopleArray a pointer to the peopleArray, which contains the relevant data about them.
- * @param[in] peopleCounter number of different people which were recorded, and appears in the array.
- * @param[out] STATUS_CODE_SUCCESS if file was generated successfully.
- * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
- */
-StatusCode generateSeverityFile(Person *peopleArray, unsigned int peopleCounter);
-
-/**
- * @brief A function that writes errors to stderr.
- * @details being used in the program at the moment error detected.
- * @details the function holds many kinds of errors. according to the errorCode given to the function,
- * the relevant message is written to stderr.
- * @param[in] errorCode The relevant StatusCode, representing the error occurred.
- */
-void error(StatusCode errorCode);
-
-
-//	****** COMPARISON FUNCTIONS ******
+//	****** DAEMON FUNCTIONS ******
 /**
- * @brief compares between 2 Person objects, according to their ID.
+ * @brief The handler of SIGINT and SIGTERM in daemon mode: asks the accept loop to stop.
  *
- * @details ID is 9 digits unsigned int, and the comparision uses the order theory '<'.
- * @param[in] personA a void pointer, represents pointer to 1st person to compare.
- * @param[in] personB personA a void pointer, represents pointer to 2nd person to compare.
- * @return integer: 0 if equal, negative integer if personA has bigger ID than personB,
- * and positive integer if personA has smaller ID than personB.
+ * @param[in] signalNumber the signal which was received.
  */
-int personCompareByID(const void* personA, const void* personB);
+static void daemonStopHandler(int signalNumber);
 
 /**
- * @brief compares between 2 Person objects, according to their severity field.
+ * @brief A function that creates the listening Unix socket of the daemon.
  *
- * @details the severity field is a **float** one.
- * @param[in] personA a void pointer, represents pointer to 1st person to compare.
- * @param[in] personB personA a void pointer, represents pointer to 2nd person to compare.
- * @return integer: 0 if equal, negative integer if personA has bigger ID than personB,
- * and positive integer if personA has smaller ID than personB.
- */
-int personCompareBySeverity(const void* personA, const void* personB);
-
-
-//	****** PARSING / CALCULATING / PROCESSING DATA FUNCTIONS ******
-/**
- * @brief A function that parsing the lines from the input peopleFile.
- *
- * @note The function handle with a certain given input (Extracting 2 arguments only from the line,
- * in a certain order). Therefor, if the format or the needed details are to be changed, more tokens-handling
- * will be needed.
- * @param[in] personReceiver holds all the variables that gonna be 'fed' with the data in the line.
- * @param[in] lineToRead a pointer to the beginning of the line gonna be parsed by the function.
- * @param[out] STATUS_CODE_SUCCESS If data was stored successfully.
- * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
- */
-StatusCode parsePersonLine(Person *personReceiver, char *lineToRead);
-
-/**
- * @brief A function that parsing the lines from the input meetingsFile.
- *
- * @param[in] meetingReceiver holds all the variables that gonna be 'fed' with the data in the line.
- * @param[in] lineToRead a pointer to the beginning of the line gonna be parsed by the function.
- * @param[in] infectorStatus a pointer to a varible that holds the status of the current infector (NEW or OLD).
- * if it is old, it won't be searched again in the array.
- * @param[in] curInfector the ID of the current infector examined by the program.
- * @param[out] STATUS_CODE_SUCCESS If data was stored successfully.
+ * @details A stale socket file at socketPath (left by a daemon which was killed) is replaced.
+ * @param[in] socketPath the path of the socket.
+ * @param[in] listenFd set to the listening socket.
+ * @param[out] STATUS_CODE_SUCCESS If the socket is listening.
  * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
  */
-StatusCode parseMeetingLine(Meeting *meetingReceiver, char *lineToRead, unsigned int *infectorStatus, int *curInfector);
+static StatusCode daemonOpenSocket(const char *socketPath, int *listenFd);
 
 /**
- * @brief calculates the chances of infection in coronavirus between 2 people, according to given data.
+ * @brief A function that reads the request of a client: one line, holding the path of a meetingFile.
  *
- * @details Special function, was developed by one of the staff members of Emzeti-Shem University in the US.
- * @details Using data given about a meeting of 2 people, and determines the chances of infection in corona.
- * @param[in] distance distance measured between the people.
- * @param[in] time measured in which they were next to each other.
- * @return float value between 0 to 1, represents the chances.
+ * @details The reads wait for the client with poll(), up to a deadline - so a client which never sends its
+ * line can't hold the daemon (which serves one client at a time) for longer than DAEMON_REQUEST_TIMEOUT_MS.
+ * @param[in] clientFd the connected client.
+ * @param[in] request receives the path, '\0' terminated (without the '\n').
+ * @param[in] requestCapacity the size of request.
+ * @param[out] STATUS_CODE_SUCCESS If a non-empty line was read.
+ * @param[out] STATUS_CODE_INPUT_ERROR If the client closed the connection early, sent a too long line, or
+ * didn't send the whole line within DAEMON_REQUEST_TIMEOUT_MS.
  */
-float crna(float distance, float time);
+static StatusCode daemonReadRequest(int clientFd, char *request, size_t requestCapacity);
 
 /**
- * @brief A function that calculates the chances of infection for each person.
+ * @brief A function that runs one job of the daemon, and writes its analysis to the client.
  *
- * @details the function uses previous data about the people, if exists - in order to make the calculations
- * faster.
- * @param[in] meetingFile the files that contains the data about meetings, used to calculate
- * infection chances.
- * @param[in] peopleArray an array of all the people that were recorded.
- * @param[in] peopleCounter the amount of the people that were recorded.
- * @param[out] STATUS_CODE_SUCCESS If calculation was succesfull.
+ * @details The meetingFile is analyzed by spreaderDetectorAnalyzeFile (the registry isn't changed), and
+ * the results are written exactly as generateSeverityFile would. Only a regular file is analyzed: STDIN_PATH
+ * (the daemon's own stdin) or a pipe would block the daemon, and every client queued behind the job. A failed
+ * or rejected job is answered with DAEMON_JOB_ERROR.
+ * @param[in] clientFd the connected client.
+ * @param[in] meetingFilePath the path of the job's meetingFile.
+ * @param[in] registry the people.
+ * @param[in] runOptions the options of the jobs.
+ * @param[out] STATUS_CODE_SUCCESS If the analysis was written.
  * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
  */
-StatusCode calculateSeverities(FILE *meetingFile, Person *peopleArray, unsigned int peopleCounter);
+static StatusCode daemonRunJob(int clientFd, const char *meetingFilePath, const SpreaderDetectorRegistry *registry,
+							   const RunOptions *runOptions);
 
 /**
- * @brief The function reads, process, and sorts (By ID) the peopleFile.
+ * @brief The daemon mode: loads the peopleFile once, and serves meetingFile jobs over a Unix socket.
  *
- * @note Including OPEN and CLOSE of the file.
- * @note The function ALLOCATES MEMORY being stored in peopleArray - a var declared outside, and being used
- * later in the program.
- * @note peopleArray's memory is NOT released in that function, even in failure.
- * @details Using Dynamic Array Method while allocating new memory, to save running time complexity.
- * @param[in] meetingFilePath argv path for the file.
- * @param[in] peopleArray pointer to the array of people (The Data Structure being used). Being allocated.
- * @param[in] peopleCounter number of people in the DS, used for sorting, calculation, and later in program.
- * @param[out] STATUS_CODE_SUCCESS If processing was successful.
- * @param[out] STATUS_CODE_EMPTY_FILE If the people's file is empty.
+ * @details Every client sends one line - the path of a meetingFile - and receives the analysis (the content
+ * generateSeverityFile would write), after which the connection is closed. Jobs are served one at a time,
+ * each with the threads of runOptions, so a client is disconnected if it doesn't send its line within
+ * DAEMON_REQUEST_TIMEOUT_MS, or stops reading its analysis for DAEMON_SEND_TIMEOUT_SECONDS. SIGINT / SIGTERM
+ * stop the daemon and remove the socket.
+ * @param[in] peopleFilePath argv path for the peopleFile.
+ * @param[in] socketPath the path of the socket.
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If the daemon was stopped by a signal.
  * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
  */
-StatusCode peopleProcessAndSort(char* peopleFilePath, Person **peopleArray, unsigned int *peopleCounter);
+static StatusCode daemonServe(const char *peopleFilePath, const char *socketPath, const RunOptions *runOptions);
 
-/**
- * @brief a function that reads, processes and calculate data from meetingFile.
- *
- * @note The function OPENS and CLOSE meetingFile.
- * @note peopleArray's memory is NOT released in that function, even in failure.
- * @param[in] meetingFilePath argv path for the file.
- * @param[in] peopleArray pointer to the array of people (The Data Structure being used).
- * @param[in] peopleCounter number of people in the DS, used for sorting and calculation.
- * @param[out] STATUS_CODE_SUCCESS If processing was successful.
- * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
- */
-StatusCode meetingsProcess(char* meetingFilePath, Person **peopleArray, const unsigned int *peopleCounter);
 
+//	****** COMMAND LINE FUNCTIONS ******
 /**
- * @brief The function that 'holds' all the relevant actions/functions together, in order to proccess
- * and determine the order of the potential infected people.
+ * @brief A function that parses the command line arguments.
  *
- * @details the reads data, sorts it and using calculations in order to create the expected output File.
- * @note varible peopleArray - The DS being used in the program.
- * The memory allocated to it is released in this func, even though it was allocated in a sub-function.
- * peopleArray is being by other sub-functions as well.
- * @param[out] STATUS_CODE_SUCCESS If processing was successfull.
- * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
- */
-StatusCode spreaderDetector(char* peopleFile, char* meetingFile);
+ * @details Options come before the paths (an option after them is an error): the peopleFile's, and then the
+ * meetingFile's - or the paths of several meeting shards, in order (see spreaderDetectorShards). Supported options:
+ * --threads <N> - parse the meetingsFile on N threads (0 = one per online CPU). Default is 1 (serial).
+ * --graph - propagate the severities over an in-memory contact graph (see calculateSeveritiesGraph).
+ * --tiers - sort only the urgent tiers; the "No serious chance" tier is written in descending ID order.
+ * --top <K> - write only the K most severe people. The last of --tiers / --top wins.
+ * --stream <N> - read the meetings as they arrive, and write the urgent tiers to stdout every N updates
+ * (and whenever the input is idle). The meetingFilePath may be STDIN_PATH. Serial: not with --threads / --graph.
+ * --serve <Socket Path> - run as a daemon (see daemonServe). Only the peopleFilePath is given, and
+ * meetingFilePaths is set to NULL.
+ * --compile-people <Snapshot Path> - write a snapshot of the peopleFile (see spreaderDetectorCompilePeople).
+ * Only the peopleFilePath is given, and meetingFilePaths is set to NULL.
+ * --compile-meetings <Table Path> - convert the meetingFile to a meetings table (see
+ * spreaderDetectorCompileMeetings). Only the meetingFilePath is given, and peopleFilePath is set to NULL.
+ * --stats <Path | -> - write the RunStats of the run as JSON to the file (or to stderr). Not with --serve or
+ * --compile-people / --compile-meetings.
+ * --save-state <State Path> - a graph run (implies --graph), which saves its delta state.
+ * --delta <State Path> - a delta run (implies --graph): the meetingFile holds only the meetings appended since
+ * the state was saved (see calculateSeveritiesDelta), and the state is updated. Not with --save-state.
+ * Neither is available with --stream, --serve or --compile-people / --compile-meetings.
+ * --memory-budget <MB> - process the files within MB megabytes (at least MIN_MEMORY_BUDGET_MB), sorting on disk
+ * (see spreaderDetectorExternal). A single meetingFile, on the serial path, with --tiers / --top / --stats only.
+ * --batch <Manifest Path | -> - run the jobs of the manifest on a pool of --threads workers (see
+ * spreaderDetectorBatch). No paths are given, and by default a worker runs per online CPU. Only --threads /
+ * --graph / --tiers / --top / --stats apply.
+ * @param[in] argc number of arguments.
+ * @param[in] argv the arguments.
+ * @param[in] runOptions receives the options of the library. Options which weren't given keep their default value.
+ * @param[in] modeOptions receives the mode of the run, and the paths it needs.
+ * @param[in] peopleFilePath set to the path of the peopleFile.
+ * @param[in] meetingFilePaths set to the paths of the meetingFile (or its shards).
+ * @param[in] meetingFileCount set to the number of meeting paths.
+ * @param[out] STATUS_CODE_SUCCESS If the arguments are valid.
+ * @param[out] STATUS_CODE_ARGS_ERROR If the arguments are invalid.
+ */
+static StatusCode parseArguments(int argc, char *argv[], RunOptions *runOptions, ModeOptions *modeOptions,
+								 char **peopleFilePath, char ***meetingFilePaths, unsigned int *meetingFileCount);
 
 
 /*
@@ -260,553 +227,451 @@ StatusCode spreaderDetector(char* peopleFile, char* meetingFile);
  * ***********************
  */
 /**
- * @brief A function that generates an empty output file.
- *
- * @details output file name is: OUTPUT_FILE.
- * @details used whenever input is valid - but people's input file is empty.
- * @param[out] STATUS_CODE_SUCCESS if file was generated successfully.
- * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ * @brief The handler of SIGINT and SIGTERM in daemon mode: asks the accept loop to stop.
+ * @param[in] signalNumber the signal which was received.
  */
-StatusCode generateEmptyOutputFile()
+static void daemonStopHandler(int signalNumber)
 {
-	FILE* outputFile = fopen(OUTPUT_FILE, "w");
-	if (outputFile == NULL)
-	{
-		error(STATUS_CODE_OUTPUT_ERROR);
-		return STATUS_CODE_OUTPUT_ERROR;
-	}
-	
-	if (EOF == fclose(outputFile))
-	{
-		error(STATUS_CODE_OUTPUT_ERROR);
-		return STATUS_CODE_OUTPUT_ERROR;
-	}
-	return STATUS_CODE_SUCCESS;
+	(void) signalNumber;
+	daemonStopRequested = 1;
 }
 
 
 /**
- * @brief A function that determines which message a person should get, according to the chances
- * of him being a carrier.
- * @note uses a #define statements from "SpreaderDetectorParams.h" file
- * @return The relevant message
+ * @brief A function that creates the listening Unix socket of the daemon.
+ * @details A stale socket file at socketPath (left by a daemon which was killed) is replaced.
+ * @param[in] socketPath the path of the socket.
+ * @param[in] listenFd set to the listening socket.
+ * @param[out] STATUS_CODE_SUCCESS If the socket is listening.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
  */
-const char* severityToMessage(float severityLevel)
+static StatusCode daemonOpenSocket(const char *socketPath, int *listenFd)
 {
-	// Higest Risk:
-	if (severityLevel >= MEDICAL_SUPERVISION_THRESHOLD)
+	struct sockaddr_un socketAddress;
+	if (strlen(socketPath) >= sizeof(socketAddress.sun_path))
 	{
-		return (MEDICAL_SUPERVISION_THRESHOLD_MSG);
+		spreaderDetectorError(STATUS_CODE_ARGS_ERROR);
+		return STATUS_CODE_ARGS_ERROR;
 	}
+	memset(&socketAddress, 0, sizeof(socketAddress));
+	socketAddress.sun_family = AF_UNIX;
+	strcpy(socketAddress.sun_path, socketPath);
 	
-	// Med-Level Risk:
-	else if ((severityLevel < MEDICAL_SUPERVISION_THRESHOLD) &&
-			 (severityLevel) >= REGULAR_QUARANTINE_THRESHOLD)
+	*listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (*listenFd < 0)
 	{
-		return (REGULAR_QUARANTINE_MSG);
+		spreaderDetectorError(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
 	}
-	
-	// Low-Level Risk:
-	else
+	unlink(socketPath);
+	if ((bind(*listenFd, (struct sockaddr *) &socketAddress, sizeof(socketAddress)) != 0) ||
+		(listen(*listenFd, DAEMON_LISTEN_BACKLOG) != 0))
 	{
-		return (CLEAN_MSG);
+		close(*listenFd);
+		*listenFd = -1;
+		spreaderDetectorError(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
 	}
+	return STATUS_CODE_SUCCESS;
 }
 
+
 /**
- * @brief A function that generates an output file of the potential carriers, sorted by urgency of treatment.
- * @details output file name is: OUTPUT_FILE.
- * @details output file is divided to 3 sections: Hospitalization needed, Quarantine needed, No serious.
- * @details each of the section is sorted by severity level
- * @param[in] peopleArray a pointer to the peopleArray, which contains the relevant data about them.
- * @param[in] peopleCounter number of different people which were recorded, and appears in the array.
- * @param[out] STATUS_CODE_SUCCESS if file was generated successfully.
- * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
- */
-StatusCode generateSeverityFile(Person *peopleArray, const unsigned int peopleCounter)
+ * @brief A function that reads the request of a client: one line, holding the path of a meetingFile.
+ * @details The reads wait for the client with poll(), up to a deadline - so a client which never sends its
+ * line can't hold the daemon (which serves one client at a time) for longer than DAEMON_REQUEST_TIMEOUT_MS.
+ * @param[in] clientFd the connected client.
+ * @param[in] request receives the path, '\0' terminated (without the '\n').
+ * @param[in] requestCapacity the size of request.
+ * @param[out] STATUS_CODE_SUCCESS If a non-empty line was read.
+ * @param[out] STATUS_CODE_INPUT_ERROR If the client closed the connection early, sent a too long line, or
+ * didn't send the whole line within DAEMON_REQUEST_TIMEOUT_MS.
+ */
+static StatusCode daemonReadRequest(int clientFd, char *request, size_t requestCapacity)
 {
-	//	Create an empty file:
-	FILE* outputFile = fopen(OUTPUT_FILE, "w");
-	if (outputFile == NULL)
+	struct timespec deadline, now;
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+	deadline.tv_sec += DAEMON_REQUEST_TIMEOUT_MS / MILLISECONDS_IN_SECOND;
+	deadline.tv_nsec += (DAEMON_REQUEST_TIMEOUT_MS % MILLISECONDS_IN_SECOND) * NANOSECONDS_IN_MILLISECOND;
+	size_t requestLength = 0;
+	while (requestLength < (requestCapacity - 1))
 	{
-		error(STATUS_CODE_OUTPUT_ERROR);
-		return STATUS_CODE_OUTPUT_ERROR;
-	}
-	
-	// Initialize resources to iterate over the People-Array:
-	int index = ((int) peopleCounter - 1);
-	Person curPerson = {0};
-	while (index >= 0)
-	{
-		curPerson = *(peopleArray + index);
-		
-		if (0 > fprintf(outputFile, severityToMessage(curPerson.severity),
-			curPerson.name, (unsigned long) curPerson.id))
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		long long timeLeft = ((long long) (deadline.tv_sec - now.tv_sec) * MILLISECONDS_IN_SECOND) +
+							 ((deadline.tv_nsec - now.tv_nsec) / NANOSECONDS_IN_MILLISECOND);
+		if (timeLeft <= 0)
 		{
-			fclose(outputFile);
-			error(STATUS_CODE_FAIL);
-			return STATUS_CODE_FAIL;
+			return STATUS_CODE_INPUT_ERROR;
+		}
+		struct pollfd clientPoll = {.fd = clientFd, .events = POLLIN, .revents = 0};
+		int pollResult = poll(&clientPoll, 1, (int) timeLeft);
+		if ((pollResult < 0) && (errno == EINTR) && (!daemonStopRequested))
+		{
+			continue;
+		}
+		if (pollResult <= 0)
+		{
+			return STATUS_CODE_INPUT_ERROR;
+		}
+		ssize_t readSize = read(clientFd, request + requestLength, (requestCapacity - 1) - requestLength);
+		if ((readSize < 0) && (errno == EINTR) && (!daemonStopRequested))
+		{
+			continue;
+		}
+		if (readSize <= 0)
+		{
+			return STATUS_CODE_INPUT_ERROR;
+		}
+		char *newLine = (char *) memchr(request + requestLength, '\n', (size_t) readSize);
+		requestLength += (size_t) readSize;
+		if (newLine != NULL)
+		{
+			*newLine = '\0';
+			return ((newLine == request) ? STATUS_CODE_INPUT_ERROR : STATUS_CODE_SUCCESS);
 		}
-		index--;
-	}
-	
-	if (EOF == fclose(outputFile))
-	{
-		error(STATUS_CODE_OUTPUT_ERROR);
-		return STATUS_CODE_OUTPUT_ERROR;
 	}
-	return STATUS_CODE_SUCCESS;
+	return STATUS_CODE_INPUT_ERROR;
 }
 
 
 /**
- * @brief A function that writes errors to stderr.
- * @details being used in the program at the moment error detected.
- * @details the function holds many kinds of errors. according to the errorCode given to the function,
- * the relevant message is written to stderr.
- * @param[in] errorCode The relevant StatusCode, representing the error occurred.
+ * @brief A function that runs one job of the daemon, and writes its analysis to the client.
+ * @details The meetingFile is analyzed by spreaderDetectorAnalyzeFile (the registry isn't changed), and
+ * the results are written exactly as generateSeverityFile would. Only a regular file is analyzed: STDIN_PATH
+ * (the daemon's own stdin) or a pipe would block the daemon, and every client queued behind the job. A failed
+ * or rejected job is answered with DAEMON_JOB_ERROR.
+ * @param[in] clientFd the connected client.
+ * @param[in] meetingFilePath the path of the job's meetingFile.
+ * @param[in] registry the people.
+ * @param[in] runOptions the options of the jobs.
+ * @param[out] STATUS_CODE_SUCCESS If the analysis was written.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
  */
-void error(StatusCode errorCode)
+static StatusCode daemonRunJob(int clientFd, const char *meetingFilePath, const SpreaderDetectorRegistry *registry,
+							   const RunOptions *runOptions)
 {
-	switch (errorCode)
-	{
-		case STATUS_CODE_ARGS_ERROR:
-			fprintf(stderr, ERROR_ARGS);
-			break;
-		case STATUS_CODE_INPUT_ERROR:
-			fprintf(stderr, ERROR_INPUT);
-			break;
-		case STATUS_CODE_OUTPUT_ERROR:
-			fprintf(stderr, ERROR_OUTPUT);
-			break;
-		default:
-			fprintf(stderr, ERROR_DEAFULT);
+	SpreaderDetectorResult *results = NULL;
+	unsigned int resultCount = 0;
+	struct stat meetingFileStat;
+	StatusCode retValJob = STATUS_CODE_SUCCESS;
+	if ((strcmp(meetingFilePath, STDIN_PATH) == 0) || (stat(meetingFilePath, &meetingFileStat) != 0) ||
+		!S_ISREG(meetingFileStat.st_mode))
+	{
+		spreaderDetectorError(STATUS_CODE_INPUT_ERROR);
+		retValJob = STATUS_CODE_INPUT_ERROR;
 	}
-}
-
-
-/**
- * @brief compares between 2 Person objects, according to their ID.
- * @details ID is 9 digits unsigned int, and the comparision uses the order theory '<'.
- * @param[in] personA a void pointer, represents pointer to 1st person to compare.
- * @param[in] personB personA a void pointer, represents pointer to 2nd person to compare.
- * @return integer: 0 if equal, negative integer if personA has bigger ID than personB,
- * and positive integer if personA has smaller ID than personB.
- */
-int personCompareByID(const void* personA, const void* personB)
-{
-	const Person *pA = (Person*) personA;
-	const Person *pB = (Person*) personB;
-	return ((pA->id) - (pB->id));
-}
-
-
-/**
- * @brief compares between 2 Person objects, according to their severity field.
- * @details the severity field is a **float** one.
- * @param[in] personA a void pointer, represents pointer to 1st person to compare.
- * @param[in] personB personA a void pointer, represents pointer to 2nd person to compare.
- * @return integer: 0 if equal, negative integer if personA has bigger ID than personB,
- * and positive integer if personA has smaller ID than personB.
- */
-int personCompareBySeverity(const void* personA, const void* personB)
-{
-	const Person *pA = (Person*) personA;
-	const Person *pB = (Person*) personB;
-	float severityA = pA->severity;
-	float severityB = pB->severity;
-	if (severityA < severityB)
+	else
 	{
-		return -1;
+		retValJob = spreaderDetectorAnalyzeFile(registry, meetingFilePath, runOptions, &results, &resultCount);
 	}
-	else if (severityA > severityB)
+	StatusCode retValWrite = STATUS_CODE_SUCCESS;
+	if (retValJob == STATUS_CODE_SUCCESS)
 	{
-		return 1;
+		retValWrite = spreaderDetectorWriteResults(clientFd, results, resultCount);
 	}
-	return 0;
+	else if (write(clientFd, DAEMON_JOB_ERROR, sizeof(DAEMON_JOB_ERROR) - 1) != (ssize_t) (sizeof(DAEMON_JOB_ERROR) - 1))
+	{
+		retValWrite = STATUS_CODE_OUTPUT_ERROR;
+	}
+	spreaderDetectorResultsFree(results);
+	return ((retValJob != STATUS_CODE_SUCCESS) ? retValJob : retValWrite);
 }
 
 
-
 /**
- * @brief A function that parsing the lines from the input peopleFile.
- * @note The function handle with a certain given input (Extracting 2 arguments only from the line,
- * in a certain order). Therefor, if the format or the needed details are to be changed, more tokens-handling
- * will be needed.
- * @param[in] personReceiver holds all the variables that gonna be 'fed' with the data in the line.
- * @param[in] lineToRead a pointer to the beginning of the line gonna be parsed by the function.
- * @param[out] STATUS_CODE_SUCCESS If data was stored successfully.
+ * @brief The daemon mode: loads the peopleFile once, and serves meetingFile jobs over a Unix socket.
+ * @details Every client sends one line - the path of a meetingFile - and receives the analysis (the content
+ * generateSeverityFile would write), after which the connection is closed. Jobs are served one at a time,
+ * each with the threads of runOptions, so a client is disconnected if it doesn't send its line within
+ * DAEMON_REQUEST_TIMEOUT_MS, or stops reading its analysis for DAEMON_SEND_TIMEOUT_SECONDS. SIGINT / SIGTERM
+ * stop the daemon and remove the socket.
+ * @param[in] peopleFilePath argv path for the peopleFile.
+ * @param[in] socketPath the path of the socket.
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If the daemon was stopped by a signal.
  * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
  */
-StatusCode parsePersonLine(Person *personReceiver, char *lineToRead)
+static StatusCode daemonServe(const char *peopleFilePath, const char *socketPath, const RunOptions *runOptions)
 {
-	short index = 0;
-	char *checkPtr = NULL;
-	char *chunk = strtok(lineToRead, " ");
-	while (chunk != NULL)
+	// ## LOAD THE REGISTRY ## - (PeopleFile READ) && (peopleArray SORT by ID) && (ID INDEX)
+	SpreaderDetectorRegistry *registry = spreaderDetectorRegistryLoad(peopleFilePath, runOptions);
+	if (registry == NULL)
 	{
-		if (index == PEOPLE_ID_INDEX)
-		{
-			strncpy(personReceiver->name, chunk, sizeof(personReceiver->name));
-		}
-		
-		else if (index == PEOPLE_NAME_INDEX)
+		return STATUS_CODE_FAIL;
+	}
+	
+	// ## OPEN THE SOCKET ##
+	RunOptions jobOptions = *runOptions;
+	jobOptions.streamInterval = 0;	// The jobs' lists go to the client, not to stdout.
+	struct sigaction stopAction;
+	memset(&stopAction, 0, sizeof(stopAction));
+	stopAction.sa_handler = daemonStopHandler;	// No SA_RESTART - so accept() returns on a signal.
+	sigaction(SIGINT, &stopAction, NULL);
+	sigaction(SIGTERM, &stopAction, NULL);
+	signal(SIGPIPE, SIG_IGN);	// A client which left fails its own job, not the daemon.
+	int listenFd = -1;
+	StatusCode retValServe = daemonOpenSocket(socketPath, &listenFd);
+	
+	// ## SERVE JOBS ##
+	char request[DAEMON_MAX_REQUEST_LEN];
+	while ((retValServe == STATUS_CODE_SUCCESS) && (!daemonStopRequested))
+	{
+		int clientFd = accept(listenFd, NULL, NULL);
+		if (clientFd < 0)
 		{
-			personReceiver->id = (int) strtol(chunk, &checkPtr, 10);
-			if (personReceiver->id == 0) // Input can't be 0 by assumption.
+			if ((errno != EINTR) && (errno != ECONNABORTED))
 			{
-				error(STATUS_CODE_FAIL);
-				return STATUS_CODE_FAIL;
+				spreaderDetectorError(STATUS_CODE_FAIL);
+				retValServe = STATUS_CODE_FAIL;
 			}
+			continue;
 		}
-		chunk = strtok(NULL, " ");
-		index ++;
+		struct timeval sendTimeout = {.tv_sec = DAEMON_SEND_TIMEOUT_SECONDS, .tv_usec = 0};
+		setsockopt(clientFd, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+		if (daemonReadRequest(clientFd, request, sizeof(request)) == STATUS_CODE_SUCCESS)
+		{
+			daemonRunJob(clientFd, request, registry, &jobOptions);
+		}
+		close(clientFd);
 	}
-	return STATUS_CODE_SUCCESS;
+	
+	// ## FREE RESOURCES ##
+	if (listenFd >= 0)
+	{
+		close(listenFd);
+		unlink(socketPath);
+	}
+	spreaderDetectorRegistryFree(registry);
+	return retValServe;
 }
 
 
 /**
- * @brief A function that parsing the lines from the input meetingsFile.
- * @param[in] meetingReceiver holds all the variables that gonna be 'fed' with the data in the line.
- * @param[in] lineToRead a pointer to the beginning of the line gonna be parsed by the function.
- * @param[in] infectorStatus a pointer to a varible that holds the status of the current infector (NEW or OLD).
- * if it is old, it won't be searched again in the array.
- * @param[in] curInfector the ID of the current infector examined by the program.
- * @param[out] STATUS_CODE_SUCCESS If data was stored successfully.
- * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
- */
-StatusCode parseMeetingLine(Meeting *meetingReceiver, char *lineToRead,
-							unsigned int *infectorStatus, int *curInfector)
+ * @brief A function that parses the command line arguments.
+ * @details Options come before the paths (an option after them is an error): the peopleFile's, and then the
+ * meetingFile's - or the paths of several meeting shards, in order (see spreaderDetectorShards). Supported options:
+ * --threads <N> - parse the meetingsFile on N threads (0 = one per online CPU). Default is 1 (serial).
+ * --graph - propagate the severities over an in-memory contact graph (see calculateSeveritiesGraph).
+ * --tiers - sort only the urgent tiers; the "No serious chance" tier is written in descending ID order.
+ * --top <K> - write only the K most severe people. The last of --tiers / --top wins.
+ * --stream <N> - read the meetings as they arrive, and write the urgent tiers to stdout every N updates
+ * (and whenever the input is idle). The meetingFilePath may be STDIN_PATH. Serial: not with --threads / --graph.
+ * --serve <Socket Path> - run as a daemon (see daemonServe). Only the peopleFilePath is given, and
+ * meetingFilePaths is set to NULL.
+ * --compile-people <Snapshot Path> - write a snapshot of the peopleFile (see spreaderDetectorCompilePeople).
+ * Only the peopleFilePath is given, and meetingFilePaths is set to NULL.
+ * --compile-meetings <Table Path> - convert the meetingFile to a meetings table (see
+ * spreaderDetectorCompileMeetings). Only the meetingFilePath is given, and peopleFilePath is set to NULL.
+ * --stats <Path | -> - write the RunStats of the run as JSON to the file (or to stderr). Not with --serve or
+ * --compile-people / --compile-meetings.
+ * --save-state <State Path> - a graph run (implies --graph), which saves its delta state.
+ * --delta <State Path> - a delta run (implies --graph): the meetingFile holds only the meetings appended since
+ * the state was saved (see calculateSeveritiesDelta), and the state is updated. Not with --save-state.
+ * Neither is available with --stream, --serve or --compile-people / --compile-meetings.
+ * --memory-budget <MB> - process the files within MB megabytes (at least MIN_MEMORY_BUDGET_MB), sorting on disk
+ * (see spreaderDetectorExternal). A single meetingFile, on the serial path, with --tiers / --top / --stats only.
+ * --batch <Manifest Path | -> - run the jobs of the manifest on a pool of --threads workers (see
+ * spreaderDetectorBatch). No paths are given, and by default a worker runs per online CPU. Only --threads /
+ * --graph / --tiers / --top / --stats apply.
+ * @param[in] argc number of arguments.
+ * @param[in] argv the arguments.
+ * @param[in] runOptions receives the options of the library. Options which weren't given keep their default value.
+ * @param[in] modeOptions receives the mode of the run, and the paths it needs.
+ * @param[in] peopleFilePath set to the path of the peopleFile.
+ * @param[in] meetingFilePaths set to the paths of the meetingFile (or its shards).
+ * @param[in] meetingFileCount set to the number of meeting paths.
+ * @param[out] STATUS_CODE_SUCCESS If the arguments are valid.
+ * @param[out] STATUS_CODE_ARGS_ERROR If the arguments are invalid.
+ */
+static StatusCode parseArguments(int argc, char *argv[], RunOptions *runOptions, ModeOptions *modeOptions,
+								 char **peopleFilePath, char ***meetingFilePaths, unsigned int *meetingFileCount)
 {
-	short index = 0;
+	int argIndex = 1;
 	char *checkPtr = NULL;
-	char *chunk = strtok(lineToRead, " ");
+	runOptions->threadCount = SERIAL_THREAD_COUNT;
+	runOptions->useGraphEngine = 0;
+	runOptions->outputMode = OUTPUT_MODE_FULL;
+	runOptions->topCount = 0;
+	runOptions->streamInterval = 0;
+	runOptions->statsPath = NULL;
+	runOptions->memoryBudget = 0;
+	modeOptions->socketPath = NULL;
+	modeOptions->snapshotPath = NULL;
+	modeOptions->tablePath = NULL;
+	modeOptions->statePath = NULL;
+	modeOptions->deltaStatePath = NULL;
+	modeOptions->manifestPath = NULL;
+	int isThreadCountGiven = 0;
 	
-	//	Reading the line using tokens, assigning values to Meeting struct.
-	while (chunk != NULL)
+	while ((argIndex < argc) && (strncmp(argv[argIndex], OPTION_PREFIX, strlen(OPTION_PREFIX)) == 0))
 	{
-		if (index == MEET_FIRST_ID_INDEX)
+		if ((strcmp(argv[argIndex], OPTION_THREADS) == 0) && ((argIndex + 1) < argc))
 		{
-			meetingReceiver->infectorID = (int) strtol(chunk, &checkPtr, 10);
-			if (meetingReceiver->infectorID == 0)	// Input can't be 0 by assumption.
+			long threadCount = strtol(argv[argIndex + 1], &checkPtr, 10);
+			if ((*checkPtr != '\0') || (checkPtr == argv[argIndex + 1]) || (threadCount < 0) ||
+				(threadCount > MAX_THREAD_COUNT))
 			{
-				error(STATUS_CODE_FAIL);
-				return STATUS_CODE_FAIL;
+				return STATUS_CODE_ARGS_ERROR;
 			}
-			checkPtr = NULL;
-			
-			//	Check if Infector is NEW:
-			if (*curInfector != meetingReceiver->infectorID)
+			runOptions->threadCount = (unsigned int) threadCount;
+			isThreadCountGiven = 1;
+			argIndex += 2;
+		}
+		else if (strcmp(argv[argIndex], OPTION_GRAPH) == 0)
+		{
+			runOptions->useGraphEngine = 1;
+			argIndex++;
+		}
+		else if (strcmp(argv[argIndex], OPTION_TIERS) == 0)
+		{
+			runOptions->outputMode = OUTPUT_MODE_TIERS;
+			argIndex++;
+		}
+		else if ((strcmp(argv[argIndex], OPTION_TOP) == 0) && ((argIndex + 1) < argc))
+		{
+			long topCount = strtol(argv[argIndex + 1], &checkPtr, 10);
+			if ((*checkPtr != '\0') || (checkPtr == argv[argIndex + 1]) || (topCount <= 0))
 			{
-				*curInfector = meetingReceiver->infectorID;
-				*infectorStatus = INFECTOR_NEW;
+				return STATUS_CODE_ARGS_ERROR;
 			}
+			runOptions->outputMode = OUTPUT_MODE_TOP;
+			runOptions->topCount = (unsigned long) topCount;
+			argIndex += 2;
 		}
-		
-		else if (index == MEET_SECOND_ID_INDEX)
+		else if ((strcmp(argv[argIndex], OPTION_STREAM) == 0) && ((argIndex + 1) < argc))
 		{
-			meetingReceiver->infectedID = (int) strtol(chunk, &checkPtr, 10);
-			if (meetingReceiver->infectedID == 0)	// Input can't be 0 by assumption.
+			long streamInterval = strtol(argv[argIndex + 1], &checkPtr, 10);
+			if ((*checkPtr != '\0') || (checkPtr == argv[argIndex + 1]) || (streamInterval <= 0))
 			{
-				error(STATUS_CODE_FAIL);
-				return STATUS_CODE_FAIL;
+				return STATUS_CODE_ARGS_ERROR;
 			}
-			checkPtr = NULL;
+			runOptions->streamInterval = (unsigned long) streamInterval;
+			argIndex += 2;
 		}
-		
-		else if (index == MEET_DISTANCE_INDEX)
+		else if ((strcmp(argv[argIndex], OPTION_SERVE) == 0) && ((argIndex + 1) < argc))
 		{
-			meetingReceiver->distance = strtof(chunk, &checkPtr);
+			modeOptions->socketPath = argv[argIndex + 1];
+			argIndex += 2;
 		}
-		
-		else if (index == MEET_TIME_INDEX)
+		else if ((strcmp(argv[argIndex], OPTION_COMPILE_PEOPLE) == 0) && ((argIndex + 1) < argc))
 		{
-			meetingReceiver->time = strtof(chunk, &checkPtr);
+			modeOptions->snapshotPath = argv[argIndex + 1];
+			argIndex += 2;
 		}
-		chunk = strtok(NULL, " ");
-		index++;
-	}
-	return STATUS_CODE_SUCCESS;
-}
-
-
-
-
-/**
- * @brief calculates the chances of infection in coronavirus between 2 people, according to given data.
- * @details Special function, was developed by one of the staff members of Emzeti-Shem University in the US.
- * @details Using data given about a meeting of 2 people, and determines the chances of infection in corona.
- * @param[in] distance distance measured between the people.
- * @param[in] time measured in which they were next to each other.
- * @return float value between 0 to 1, represents the chances.
- */
-float crna(float distance, float time)
-{
-	float maxTime = MAX_TIME;
-	float minDistance = MIN_DISTANCE;
-	return ((time * minDistance) / (distance * maxTime));
-}
-
-/**
- * @brief A function that calculates the chances of infection for each person.
- * @details the function uses previous data about the people, if exists - in order to make the calculations
- * faster.
- * @param[in] meetingFile the files that contains the data about meetings, used to calculate
- * infection chances.
- * @param[in] peopleArray an array of all the people that were recorded.
- * @param[in] peopleCounter the amount of the people that were recorded.
- * @param[out] STATUS_CODE_SUCCESS If calculation was succesfull.
- * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
- */
-StatusCode calculateSeverities(FILE *meetingFile, Person *peopleArray, unsigned int peopleCounter)
-{
-	//	Initialize Resources:
-	char lineToRead[INPUT_MAX_LINE_LEN] = {0};
-	char *ptr = NULL;
-	unsigned int infectorStatus = INFECTOR_OLD;		// Used to determine when new search needed.
-	Meeting meetingReceiver = {0};				// Used to receive data from each line.
-	Person personKey = {0};					// Used for binary search on People's Array.
-	
-	//	Read First Line (of the verified carrier). if file is empty, EXIT with no error.
-	if (fgets(lineToRead, INPUT_MAX_LINE_LEN, meetingFile) == NULL)
-	{
-		return STATUS_CODE_SUCCESS;
-	}
-	
-	lineToRead[strlen(lineToRead) - 1] = '\0';
-	int infectorID = (int) strtol(lineToRead, &ptr, 10);
-	personKey.id = infectorID;
-	memset(lineToRead, 0, sizeof(lineToRead));
-	
-	// Searching the carrier and initializing his severity level:
-	Person *infector = (Person*) bsearch(&personKey, peopleArray, peopleCounter, sizeof(Person), personCompareByID);
-	infector->severity = MAX_SEVERITY;
-	Person *infected = NULL;
-	
-	//	Parsing Line by Line
-	while (fgets(lineToRead, INPUT_MAX_LINE_LEN, meetingFile))
-	{
-		if (parseMeetingLine(&meetingReceiver, lineToRead, &infectorStatus, &infectorID) == STATUS_CODE_FAIL)
+		else if ((strcmp(argv[argIndex], OPTION_COMPILE_MEETINGS) == 0) && ((argIndex + 1) < argc))
 		{
-			return STATUS_CODE_FAIL;
+			modeOptions->tablePath = argv[argIndex + 1];
+			argIndex += 2;
 		}
-		
-		personKey.id = meetingReceiver.infectedID;
-		infected = (Person*) bsearch(&personKey, peopleArray, peopleCounter, sizeof(Person), personCompareByID);
-		
-		//	If The Infector changed, search for the new one in the array:
-		if (infectorStatus == INFECTOR_NEW)
+		else if ((strcmp(argv[argIndex], OPTION_STATS) == 0) && ((argIndex + 1) < argc))
 		{
-			personKey.id = meetingReceiver.infectorID;
-			infector = (Person*) bsearch(&personKey, peopleArray, peopleCounter, sizeof(Person), personCompareByID);
-			infectorStatus = INFECTOR_OLD;
+			runOptions->statsPath = argv[argIndex + 1];
+			argIndex += 2;
 		}
-		
-		//	Calculating Severity of the infected person:
-		infected->severity = ((infector->severity) * (crna(meetingReceiver.distance, meetingReceiver.time)));
-		
-		memset(&meetingReceiver, 0, sizeof(meetingReceiver));
-		memset(lineToRead, 0, sizeof(lineToRead));
-	}
-	
-	return STATUS_CODE_SUCCESS;
-}
-
-
-/**
- * @brief The function reads, process, and sorts (By ID) the peopleFile.
- * @note Including OPEN and CLOSE of the file.
- * @note The function ALLOCATES MEMORY being stored in peopleArray - a var declared outside, and being used
- * later in the program.
- * @note peopleArray's memory is NOT released in that function, even in failure.
- * @details Using Dynamic Array Method while allocating new memory, to save running time complexity.
- * @param[in] meetingFilePath argv path for the file.
- * @param[in] peopleArray pointer to the array of people (The Data Structure being used). Being allocated.
- * @param[in] peopleCounter number of people in the DS, used for sorting, calculation, and later in program.
- * @param[out] STATUS_CODE_SUCCESS If processing was successful.
- * @param[out] STATUS_CODE_EMPTY_FILE If the people's file is empty.
- * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
- */
-StatusCode peopleProcessAndSort(char* peopleFilePath, Person **peopleArray, unsigned int *peopleCounter)
-{
-	// ## OPEN INPUT FILE ## - Open peopleFile & Checking Existence:
-	FILE* peopleFile = fopen(peopleFilePath, "r");
-	if (peopleFile == NULL)
-	{
-		error(STATUS_CODE_INPUT_ERROR);
-		return STATUS_CODE_INPUT_ERROR;
-	}
-	
-	// ## INITIATION OF RESOURCES ##
-	char lineToRead[INPUT_MAX_LINE_LEN] = {0};
-	Person personReceiver = {0};
-	Person *temporaryArrayPointer = NULL;
-	long arrSize = 0, arrSizeWithBuffer = 0;
-	
-	// ## PROCCESSING INPUT ## - Start reading line by line, allocating Data in an dynamic array:
-	while (fgets(lineToRead, INPUT_MAX_LINE_LEN, peopleFile))
-	{
-		// Replace the 'new line' from the string :
-		lineToRead[strlen(lineToRead) - 1] = '\0';
-		if (parsePersonLine(&personReceiver, lineToRead) != STATUS_CODE_SUCCESS)
+		else if ((strcmp(argv[argIndex], OPTION_SAVE_STATE) == 0) && ((argIndex + 1) < argc))
 		{
-			if (EOF == fclose(peopleFile))
-			{
-				error(STATUS_CODE_INPUT_ERROR);
-			}
-			peopleFile = NULL;
-			return STATUS_CODE_FAIL;
+			modeOptions->statePath = argv[argIndex + 1];
+			runOptions->useGraphEngine = 1;
+			argIndex += 2;
+		}
+		else if ((strcmp(argv[argIndex], OPTION_DELTA) == 0) && ((argIndex + 1) < argc))
+		{
+			modeOptions->deltaStatePath = argv[argIndex + 1];
+			runOptions->useGraphEngine = 1;
+			argIndex += 2;
 		}
-		(*peopleCounter)++;
-		
-		// ## MEMORY ALLOCATION ## - (Dynamic Array)
-		arrSize = (((long)*peopleCounter) * ((long)sizeof(Person)));
-		if (arrSize >= arrSizeWithBuffer) // '>' only at first iteration.
+		else if ((strcmp(argv[argIndex], OPTION_MEMORY_BUDGET) == 0) && ((argIndex + 1) < argc))
 		{
-			arrSizeWithBuffer = (2 * arrSize);
-			temporaryArrayPointer = (Person *) realloc(*peopleArray, arrSizeWithBuffer);
-			if (temporaryArrayPointer == NULL)
+			long memoryBudget = strtol(argv[argIndex + 1], &checkPtr, 10);
+			if ((*checkPtr != '\0') || (checkPtr == argv[argIndex + 1]) || (memoryBudget < MIN_MEMORY_BUDGET_MB))
 			{
-				error(STATUS_CODE_FAIL);
-				if (EOF == fclose(peopleFile))
-				{
-					error(STATUS_CODE_INPUT_ERROR);
-				}
-				peopleFile = NULL;
-				return STATUS_CODE_FAIL;
+				return STATUS_CODE_ARGS_ERROR;
 			}
-			(*peopleArray) = temporaryArrayPointer;
-			temporaryArrayPointer = NULL;
+			runOptions->memoryBudget = ((unsigned long long) memoryBudget) << MEGABYTE_SHIFT;
+			argIndex += 2;
+		}
+		else if ((strcmp(argv[argIndex], OPTION_BATCH) == 0) && ((argIndex + 1) < argc))
+		{
+			modeOptions->manifestPath = argv[argIndex + 1];
+			argIndex += 2;
+		}
+		else
+		{
+			return STATUS_CODE_ARGS_ERROR;
 		}
-		
-		(*peopleArray)[(*peopleCounter) - 1] = personReceiver;
-		
-		memset(&personReceiver, 0, sizeof(personReceiver));
-		memset(lineToRead, 0, sizeof(lineToRead));
 	}
 	
-	//	## CLOSE INPUT FILE ## - Open peopleFile & Checking Existence:
-	if (EOF == fclose(peopleFile))
+	//	No option after the paths, and the streaming emitter is serial:
+	int pathIndex = 0;
+	for (pathIndex = argIndex; pathIndex < argc; pathIndex++)
 	{
-		error(STATUS_CODE_INPUT_ERROR);
-		return STATUS_CODE_INPUT_ERROR;
+		if (strncmp(argv[pathIndex], OPTION_PREFIX, strlen(OPTION_PREFIX)) == 0)
+		{
+			return STATUS_CODE_ARGS_ERROR;
+		}
 	}
-	peopleFile = NULL;
-	
-	//	## EMPTY PEOPLE FILE SCENARIO ##
-	if ((*peopleCounter) == 0)
+	if ((runOptions->streamInterval > 0) &&
+		(runOptions->useGraphEngine || (runOptions->threadCount != SERIAL_THREAD_COUNT)))
 	{
-		return STATUS_CODE_EMPTY_FILE;
+		return STATUS_CODE_ARGS_ERROR;
 	}
 	
-	//	## SORT 1 ## -  Array of People by ID:
-	qsort(*peopleArray, *peopleCounter, sizeof(Person), personCompareByID);
-	
-	return STATUS_CODE_SUCCESS;
-}
-
-/**
- * @brief a function that reads, processes and calculate data from meetingFile.
- *
- * @note The function OPENS and CLOSE meetingFile.
- * @note peopleArray's memory is NOT released in that function, even in failure.
- * @param[in] meetingFilePath argv path for the file.
- * @param[in] peopleArray pointer to the array of people (The Data Structure being used).
- * @param[in] peopleCounter number of people in the DS, used for sorting and calculation.
- * @param[out] STATUS_CODE_SUCCESS If processing was successful.
- * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
- */
-StatusCode meetingsProcess(char* meetingFilePath, Person **peopleArray, const unsigned int *peopleCounter)
-{
-	
-	// ## OPEN INPUT FILE ## - Open meetingFile:
-	FILE* meetingFile = fopen(meetingFilePath, "r");
-	if (meetingFile == NULL)
+	//	2 paths or more after the options (a single one for a daemon, or when compiling a snapshot or a table):
+	int isPeopleOnly = ((modeOptions->socketPath != NULL) || (modeOptions->snapshotPath != NULL));
+	int isMeetingsOnly = (modeOptions->tablePath != NULL);
+	int isStateful = ((modeOptions->statePath != NULL) || (modeOptions->deltaStatePath != NULL));
+	int pathCount = argc - argIndex;
+	if (modeOptions->manifestPath != NULL)
 	{
-		error(STATUS_CODE_INPUT_ERROR);
-		return STATUS_CODE_INPUT_ERROR;
-	}
-	
-	//	## CALCULATE SEVERITIES ## - of Every Person in The People-Array:
-	if (calculateSeverities(meetingFile, *peopleArray, *peopleCounter) != STATUS_CODE_SUCCESS)
-	{
-		if (EOF == fclose(meetingFile))
+		if ((pathCount > 0) || isPeopleOnly || isMeetingsOnly || isStateful || (runOptions->streamInterval > 0) ||
+			(runOptions->memoryBudget > 0))
 		{
-			error(STATUS_CODE_INPUT_ERROR);
+			return STATUS_CODE_ARGS_ERROR;
 		}
-		meetingFile = NULL;
-		return STATUS_CODE_FAIL;
+		runOptions->threadCount = isThreadCountGiven ? runOptions->threadCount : ALL_ONLINE_CPUS;
+		*peopleFilePath = NULL;
+		*meetingFilePaths = NULL;
+		*meetingFileCount = 0;
+		return STATUS_CODE_SUCCESS;
 	}
-	
-	//	## CLOSE INPUT FILE ## - close meetingFile ##
-	if (EOF == fclose(meetingFile))
+	if ((runOptions->memoryBudget > 0) &&
+		((pathCount != (ARGS_COUNT - 1)) || isPeopleOnly || isMeetingsOnly || isStateful ||
+		 runOptions->useGraphEngine || (runOptions->streamInterval > 0) ||
+		 (runOptions->threadCount != SERIAL_THREAD_COUNT)))
 	{
-		error(STATUS_CODE_INPUT_ERROR);
-		return STATUS_CODE_INPUT_ERROR;
+		return STATUS_CODE_ARGS_ERROR;
 	}
-	meetingFile = NULL;
-	
-	//	## SORT 2 ## -  Array of People by Severity:
-	qsort(*peopleArray, *peopleCounter, sizeof(Person), personCompareBySeverity);
-	
-	return STATUS_CODE_SUCCESS;
-}
-
-/**
- * @brief The function that 'holds' all the relevant actions/functions together, in order to proccess
- * and determine the order of the potential infected people.
- * @details the reads data, sorts it and using calculations in order to create the expected output File.
- * @note varible peopleArray - The DS being used in the program.
- * The memory allocated to it is released in this func, even though it was allocated in a sub-function.
- * peopleArray is being by other sub-functions as well.
- * @param[out] STATUS_CODE_SUCCESS If processing was successfull.
- * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
- */
-StatusCode spreaderDetector(char* peopleFilePath, char* meetingFilePath)
-{
-	// ## INITIATE RESOURCES ##
-	unsigned int peopleCounter = 0;
-	Person *peopleArray = NULL;	// Will be dynamically allocated and used further in the program.
-	
-	// ## PROCESS PEOPLE ## - (PeopleFile READ) && (DataStruct Build) && (peopleArray SORT by ID)
-	StatusCode retValPProcess = peopleProcessAndSort(peopleFilePath, &peopleArray, &peopleCounter);
-	
-	if (retValPProcess == STATUS_CODE_EMPTY_FILE)
+	if (isMeetingsOnly)
 	{
-		if (generateEmptyOutputFile() != STATUS_CODE_SUCCESS)
+		if ((pathCount != (ARGS_COUNT - 2)) || isPeopleOnly || isStateful || (runOptions->statsPath != NULL))
 		{
-			return STATUS_CODE_FAIL;
+			return STATUS_CODE_ARGS_ERROR;
 		}
+		*peopleFilePath = NULL;
+		*meetingFilePaths = argv + argIndex;
+		*meetingFileCount = 1;
 		return STATUS_CODE_SUCCESS;
 	}
-	else if (retValPProcess != STATUS_CODE_SUCCESS)
-	{
-		free(peopleArray);
-		peopleArray = NULL;
-		return STATUS_CODE_FAIL;
-	}
-	
-	// ## PROCESS MEETINGS ## - (MeetingFile READ) && (Chances Calculations) && (peopleArray SORT by chances)
-	if (meetingsProcess(meetingFilePath, &peopleArray, &peopleCounter) != STATUS_CODE_SUCCESS)
+	if ((isPeopleOnly ? (pathCount != (ARGS_COUNT - 2)) : (pathCount < (ARGS_COUNT - 1))) ||
+		(isPeopleOnly && (runOptions->statsPath != NULL)) ||
+		((modeOptions->statePath != NULL) && (modeOptions->deltaStatePath != NULL)) ||
+		(isStateful && (isPeopleOnly || (runOptions->streamInterval > 0))))
 	{
-		free(peopleArray);
-		peopleArray = NULL;
-		return STATUS_CODE_FAIL;
+		return STATUS_CODE_ARGS_ERROR;
 	}
 	
-	//	## GENERATE OUTPUT FILE ##
-	if (generateSeverityFile(peopleArray, peopleCounter) != STATUS_CODE_SUCCESS)
+	//	Several meeting shards are mapped together - not streamed, and not read from stdin:
+	int shardIndex = 0;
+	for (shardIndex = argIndex + 1; (pathCount > (ARGS_COUNT - 1)) && (shardIndex < argc); shardIndex++)
 	{
-		free(peopleArray);
-		peopleArray = NULL;
-		return STATUS_CODE_FAIL;
+		if ((runOptions->streamInterval > 0) || (strcmp(argv[shardIndex], STDIN_PATH) == 0))
+		{
+			return STATUS_CODE_ARGS_ERROR;
+		}
 	}
-	
-	//	## FREE Memory allocated in <peopleReadSort> function ##
-	free(peopleArray);
-	peopleArray = NULL;
-	
+	*peopleFilePath = argv[argIndex];
+	*meetingFilePaths = isPeopleOnly ? NULL : (argv + argIndex + 1);
+	*meetingFileCount = isPeopleOnly ? 0 : (unsigned int) (pathCount - 1);
 	return STATUS_CODE_SUCCESS;
 }
 
@@ -816,22 +681,80 @@ StatusCode spreaderDetector(char* peopleFilePath, char* meetingFilePath)
  */
 int main(int argc, char *argv[])
 {
-	//	Check for Number of Arguments:
-	if (argc != ARGS_COUNT)
+	//	Check the Arguments (Options, and Number of Paths):
+	RunOptions runOptions = {0};
+	ModeOptions modeOptions = {0};
+	char *peopleFilePath = NULL, **meetingFilePaths = NULL;
+	unsigned int meetingFileCount = 0, meetingFileIndex = 0;
+	if (parseArguments(argc, argv, &runOptions, &modeOptions, &peopleFilePath, &meetingFilePaths,
+					   &meetingFileCount) != STATUS_CODE_SUCCESS)
 	{
-		error(STATUS_CODE_ARGS_ERROR);
+		fprintf(stderr, ERROR_ARGS);
 		return EXIT_FAILURE;
 	}
 	
-	//	Check if Input Files exists:
-	if ((access(argv[1], F_OK) == FILE_DO_NOT_EXIST) || (access(argv[2], F_OK) == FILE_DO_NOT_EXIST))
+	//	Check if Input Files exists (the meetings may come from stdin, or - for a daemon - from its jobs):
+	int isInputMissing = ((peopleFilePath != NULL) && (access(peopleFilePath, F_OK) == FILE_DO_NOT_EXIST));
+	for (meetingFileIndex = 0; meetingFileIndex < meetingFileCount; meetingFileIndex++)
+	{
+		isInputMissing |= ((strcmp(meetingFilePaths[meetingFileIndex], STDIN_PATH) != 0) &&
+						   (access(meetingFilePaths[meetingFileIndex], F_OK) == FILE_DO_NOT_EXIST));
+	}
+	if (isInputMissing)
 	{
-		error(STATUS_CODE_INPUT_ERROR);
+		spreaderDetectorError(STATUS_CODE_INPUT_ERROR);
 		return EXIT_FAILURE;
 	}
 	
 	//	Execute the Main Part of The Program:
-	if 	(spreaderDetector(argv[1], argv[2]) != STATUS_CODE_SUCCESS)
+	if (modeOptions.snapshotPath != NULL)
+	{
+		return ((spreaderDetectorCompilePeople(peopleFilePath, modeOptions.snapshotPath, &runOptions) ==
+				 STATUS_CODE_SUCCESS) ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+	if (modeOptions.tablePath != NULL)
+	{
+		return ((spreaderDetectorCompileMeetings(meetingFilePaths[0], modeOptions.tablePath) == STATUS_CODE_SUCCESS) ?
+				EXIT_SUCCESS : EXIT_FAILURE);
+	}
+	if (modeOptions.socketPath != NULL)
+	{
+		return ((daemonServe(peopleFilePath, modeOptions.socketPath, &runOptions) == STATUS_CODE_SUCCESS) ?
+				EXIT_SUCCESS : EXIT_FAILURE);
+	}
+	if (modeOptions.manifestPath != NULL)
+	{
+		return ((spreaderDetectorBatch(modeOptions.manifestPath, &runOptions) == STATUS_CODE_SUCCESS) ?
+				EXIT_SUCCESS : EXIT_FAILURE);
+	}
+	RunStats runStats = {0};
+	runOptions.runStats = (runOptions.statsPath != NULL) ? &runStats : NULL;
+	const char *const *meetingPaths = (const char *const *) meetingFilePaths;
+	StatusCode retValRun = STATUS_CODE_SUCCESS;
+	if (runOptions.memoryBudget > 0)
+	{
+		retValRun = spreaderDetectorExternal(peopleFilePath, meetingFilePaths[0], OUTPUT_FILE, &runOptions);
+	}
+	else if (modeOptions.statePath != NULL)
+	{
+		retValRun = spreaderDetectorSaveState(peopleFilePath, meetingPaths, meetingFileCount, OUTPUT_FILE,
+											  modeOptions.statePath, &runOptions);
+	}
+	else if (modeOptions.deltaStatePath != NULL)
+	{
+		retValRun = spreaderDetectorDelta(peopleFilePath, meetingPaths, meetingFileCount, OUTPUT_FILE,
+										  modeOptions.deltaStatePath, &runOptions);
+	}
+	else
+	{
+		retValRun = spreaderDetectorShards(peopleFilePath, meetingPaths, meetingFileCount, OUTPUT_FILE, &runOptions);
+	}
+	if ((runOptions.runStats != NULL) &&
+		(spreaderDetectorWriteStats(runOptions.runStats, runOptions.statsPath, retValRun) != STATUS_CODE_SUCCESS))
+	{
+		return EXIT_FAILURE;
+	}
+	if (retValRun != STATUS_CODE_SUCCESS)
 	{
 		return EXIT_FAILURE;
 	}
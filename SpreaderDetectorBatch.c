@@ -0,0 +1,699 @@
+/*
+ * File Name: SpreaderDetectorBatch.c
+ * Related Files: "SpreaderDetector.h", "SpreaderDetectorInternal.h"
+ *
+ * Purpose:
+ * 			This file is the batch mode of the SpreaderDetector library: a manifest of jobs run on a
+ * 			work-stealing pool (see spreaderDetectorBatch).
+ *
+ * Author's ID: 206174120
+ * Author's Name: Oren Kovartovsky
+ * University User Name: orenkov
+ *
+ * */
+
+#include "SpreaderDetectorInternal.h"
+
+
+/*
+ * ***********************
+ * 	DECLARATIONS
+ * ***********************
+ */
+//	****** BATCH FUNCTIONS ******
+/**
+ * @brief A function that reads the whole manifest of a batch into a '\0' terminated buffer.
+ *
+ * @note The function ALLOCATES MEMORY being stored in content. The caller releases it, even in failure.
+ * @param[in] manifestPath the path of the manifest (STDIN_PATH - stdin).
+ * @param[in] content set to the content of the manifest.
+ * @param[out] STATUS_CODE_SUCCESS If the manifest was read.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode batchReadManifest(const char *manifestPath, char **content);
+
+/**
+ * @brief A function that parses the manifest of a batch into its jobs, in place.
+ *
+ * @details Every line holds a job - the paths of its peopleFile, its meetingFile and its output file,
+ * separated by spaces or tabs. Blank lines, and lines starting with BATCH_COMMENT_PREFIX, are skipped. The
+ * paths are '\0' terminated inside the manifest, and the jobs point to them.
+ * @note The function ALLOCATES MEMORY being stored in jobs. The caller releases it, even in failure.
+ * @param[in] manifest the content of the manifest. Changed.
+ * @param[in] jobs set to the jobs, in the order of the manifest.
+ * @param[in] jobCount set to the number of jobs.
+ * @param[out] STATUS_CODE_SUCCESS If every line was a valid job.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode batchParseManifest(char *manifest, BatchJob **jobs, unsigned int *jobCount);
+
+/**
+ * @brief compares between the peopleFiles of 2 BatchJob objects: by their device and inode, so every path of a
+ * file (relative or absolute, through links) is the same peopleFile. Files which can't be stat()ed come last,
+ * by their path.
+ *
+ * @param[in] jobA pointer to 1st job to compare.
+ * @param[in] jobB pointer to 2nd job to compare.
+ * @return integer: 0 if it is the same peopleFile, negative integer if jobA's comes before jobB's,
+ * and positive integer if jobA's comes after jobB's.
+ */
+static int batchPeopleCompare(const BatchJob *jobA, const BatchJob *jobB);
+
+/**
+ * @brief compares between 2 BatchJob objects, according to their peopleFile (see batchPeopleCompare), and then
+ * their line in the manifest.
+ *
+ * @param[in] jobA a void pointer, represents pointer to 1st job to compare.
+ * @param[in] jobB a void pointer, represents pointer to 2nd job to compare.
+ * @return integer: 0 if equal, negative integer if jobA comes before jobB,
+ * and positive integer if jobA comes after jobB.
+ */
+static int batchJobCompare(const void* jobA, const void* jobB);
+
+/**
+ * @brief A function that groups the jobs of a batch by their peopleFile: the peopleFiles are stat()ed, the jobs
+ * are sorted by them, and each group of jobs gets one (not loaded yet) BatchPeople.
+ *
+ * @note The function ALLOCATES MEMORY being stored in people. released by batchPeopleFree, even in failure.
+ * @param[in] jobs the jobs. Being sorted, and pointed to their people.
+ * @param[in] jobCount number of jobs.
+ * @param[in] people set to the peopleFiles.
+ * @param[in] peopleCount set to the number of peopleFiles.
+ * @param[out] STATUS_CODE_SUCCESS If the jobs were grouped.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+static StatusCode batchGroupPeople(BatchJob *jobs, unsigned int jobCount, BatchPeople **people,
+								   unsigned int *peopleCount);
+
+/**
+ * @brief A function that releases the peopleFiles of a batch.
+ *
+ * @param[in] people the peopleFiles. May be NULL.
+ * @param[in] peopleCount number of peopleFiles (whose mutex was initiated).
+ */
+static void batchPeopleFree(BatchPeople *people, unsigned int peopleCount);
+
+/**
+ * @brief A function that runs one job of a batch, and writes its analysis to its output file.
+ *
+ * @details The first job of a peopleFile loads its registry (the other jobs of the peopleFile wait for it), and
+ * the last one releases it. The meetingFile is analyzed by spreaderDetectorAnalyzeFile, and the results are
+ * written exactly as generateSeverityFile would. The output file of a failed job isn't written. When the batch
+ * is measured (jobOptions->statsPath), the job is measured into its own RunStats - the people phase by the job
+ * which loaded the peopleFile. A job which names STDIN_PATH (as its peopleFile or its meetingFile) fails with an
+ * input error: stdin isn't a job's - it may hold the manifest, and is shared by every job.
+ * @param[in] job the job. Its status (and runStats) are set.
+ * @param[in] jobOptions the options of the jobs.
+ * @param[out] STATUS_CODE_SUCCESS If the analysis was written.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode batchRunJob(BatchJob *job, const RunOptions *jobOptions);
+
+/**
+ * @brief A function that takes the next job for a worker of a batch: the head of its own deque, or - once it
+ * is empty - a job stolen from the tail of another worker's deque.
+ *
+ * @details No jobs are added once the batch started, so a worker which finds every deque empty is done.
+ * @param[in] pool the pool of the batch.
+ * @param[in] workerIndex the worker.
+ * @param[in] jobIndex set to the job to run.
+ * @return 1 if a job was taken, 0 if there are no jobs left.
+ */
+static int batchTakeJob(BatchPool *pool, unsigned int workerIndex, unsigned int *jobIndex);
+
+/**
+ * @brief The thread function of a worker of a batch: runs jobs until there are none left.
+ *
+ * @param[in] workerArg a BatchWorker. Its failedJobCount is set.
+ * @return NULL.
+ */
+static void *batchWorkerRun(void *workerArg);
+
+/**
+ * @brief compares between 2 BatchJob objects, according to their line in the manifest.
+ *
+ * @param[in] jobA a void pointer, represents pointer to 1st job to compare.
+ * @param[in] jobB a void pointer, represents pointer to 2nd job to compare.
+ * @return integer: 0 if equal, negative integer if jobA comes before jobB,
+ * and positive integer if jobA comes after jobB.
+ */
+static int batchJobLineCompare(const void* jobA, const void* jobB);
+
+/**
+ * @brief A function that writes the RunStats of the jobs of a batch, as a JSON array of the objects
+ * runStatsPrint prints - one per job, in the order of the manifest.
+ *
+ * @param[in] jobs the jobs, once they ran. Being sorted by their line in the manifest.
+ * @param[in] jobCount number of jobs.
+ * @param[in] statsPath the file to write to, or STATS_TO_STDERR.
+ * @param[out] STATUS_CODE_SUCCESS If the stats were written.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If the file couldn't be written.
+ */
+static StatusCode batchWriteStats(BatchJob *jobs, unsigned int jobCount, const char *statsPath);
+
+
+/*
+ * ***********************
+ * 	DEFINITIONS
+ * ***********************
+ */
+/**
+ * @brief A function that reads the whole manifest of a batch into a '\0' terminated buffer.
+ * @note The function ALLOCATES MEMORY being stored in content. The caller releases it, even in failure.
+ * @param[in] manifestPath the path of the manifest (STDIN_PATH - stdin).
+ * @param[in] content set to the content of the manifest.
+ * @param[out] STATUS_CODE_SUCCESS If the manifest was read.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode batchReadManifest(const char *manifestPath, char **content)
+{
+	FILE *manifestFile = (strcmp(manifestPath, STDIN_PATH) == 0) ? stdin : fopen(manifestPath, "r");
+	if (manifestFile == NULL)
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	size_t contentSize = 0, capacity = 0, readSize = 0;
+	StatusCode retValRead = STATUS_CODE_SUCCESS;
+	do
+	{
+		if ((capacity - contentSize) < BATCH_MANIFEST_READ_SIZE)
+		{
+			capacity = (capacity > 0) ? (2 * capacity) : (2 * BATCH_MANIFEST_READ_SIZE);
+			char *grownContent = (char *) realloc(*content, capacity);
+			if (grownContent == NULL)
+			{
+				error(STATUS_CODE_FAIL);
+				retValRead = STATUS_CODE_FAIL;
+				break;
+			}
+			*content = grownContent;
+		}
+		readSize = fread(*content + contentSize, 1, (capacity - contentSize) - 1, manifestFile);
+		contentSize += readSize;
+	} while (readSize > 0);
+	if ((retValRead == STATUS_CODE_SUCCESS) && ferror(manifestFile))
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		retValRead = STATUS_CODE_INPUT_ERROR;
+	}
+	if (retValRead == STATUS_CODE_SUCCESS)
+	{
+		(*content)[contentSize] = '\0';
+	}
+	if (manifestFile != stdin)
+	{
+		fclose(manifestFile);
+	}
+	return retValRead;
+}
+
+
+/**
+ * @brief A function that parses the manifest of a batch into its jobs, in place.
+ * @details Every line holds a job - the paths of its peopleFile, its meetingFile and its output file,
+ * separated by spaces or tabs. Blank lines, and lines starting with BATCH_COMMENT_PREFIX, are skipped. The
+ * paths are '\0' terminated inside the manifest, and the jobs point to them.
+ * @note The function ALLOCATES MEMORY being stored in jobs. The caller releases it, even in failure.
+ * @param[in] manifest the content of the manifest. Changed.
+ * @param[in] jobs set to the jobs, in the order of the manifest.
+ * @param[in] jobCount set to the number of jobs.
+ * @param[out] STATUS_CODE_SUCCESS If every line was a valid job.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode batchParseManifest(char *manifest, BatchJob **jobs, unsigned int *jobCount)
+{
+	unsigned int jobCapacity = 0, lineNumber = 0;
+	char *lineStart = manifest;
+	*jobCount = 0;
+	while (*lineStart != '\0')
+	{
+		char *lineEnd = strchr(lineStart, '\n');
+		char *nextLine = (lineEnd != NULL) ? (lineEnd + 1) : (lineStart + strlen(lineStart));
+		if (lineEnd != NULL)
+		{
+			*lineEnd = '\0';
+		}
+		lineNumber++;
+		
+		//	Split the line into its fields:
+		char *fields[BATCH_FIELD_COUNT + 1] = {NULL};
+		unsigned int fieldCount = 0;
+		char *field = strtok(lineStart, BATCH_FIELD_SEPARATORS);
+		if ((field == NULL) || (strncmp(field, BATCH_COMMENT_PREFIX, strlen(BATCH_COMMENT_PREFIX)) == 0))
+		{
+			lineStart = nextLine;
+			continue;
+		}
+		while ((field != NULL) && (fieldCount <= BATCH_FIELD_COUNT))
+		{
+			fields[fieldCount++] = field;
+			field = strtok(NULL, BATCH_FIELD_SEPARATORS);
+		}
+		if (fieldCount != BATCH_FIELD_COUNT)
+		{
+			error(STATUS_CODE_INPUT_ERROR);
+			return STATUS_CODE_INPUT_ERROR;
+		}
+		if (*jobCount == jobCapacity)
+		{
+			jobCapacity = (jobCapacity > 0) ? (2 * jobCapacity) : BATCH_JOBS_INITIAL_CAPACITY;
+			BatchJob *grownJobs = (BatchJob *) realloc(*jobs, (size_t) jobCapacity * sizeof(BatchJob));
+			if (grownJobs == NULL)
+			{
+				error(STATUS_CODE_FAIL);
+				return STATUS_CODE_FAIL;
+			}
+			*jobs = grownJobs;
+		}
+		BatchJob *job = (*jobs) + (*jobCount)++;
+		job->peopleFilePath = fields[BATCH_FIELD_PEOPLE];
+		job->meetingFilePath = fields[BATCH_FIELD_MEETINGS];
+		job->outputFilePath = fields[BATCH_FIELD_OUTPUT];
+		job->lineNumber = lineNumber;
+		job->people = NULL;
+		job->status = STATUS_CODE_SUCCESS;
+		memset(&job->runStats, 0, sizeof(RunStats));
+		lineStart = nextLine;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief compares between the peopleFiles of 2 BatchJob objects: by their device and inode, so every path of a
+ * file (relative or absolute, through links) is the same peopleFile. Files which can't be stat()ed come last,
+ * by their path.
+ * @param[in] jobA pointer to 1st job to compare.
+ * @param[in] jobB pointer to 2nd job to compare.
+ * @return integer: 0 if it is the same peopleFile, negative integer if jobA's comes before jobB's,
+ * and positive integer if jobA's comes after jobB's.
+ */
+static int batchPeopleCompare(const BatchJob *jobA, const BatchJob *jobB)
+{
+	if (jobA->isPeopleFound != jobB->isPeopleFound)
+	{
+		return (jobB->isPeopleFound - jobA->isPeopleFound);
+	}
+	if (!jobA->isPeopleFound)
+	{
+		return strcmp(jobA->peopleFilePath, jobB->peopleFilePath);
+	}
+	if (jobA->peopleDevice != jobB->peopleDevice)
+	{
+		return ((jobA->peopleDevice > jobB->peopleDevice) - (jobA->peopleDevice < jobB->peopleDevice));
+	}
+	return ((jobA->peopleInode > jobB->peopleInode) - (jobA->peopleInode < jobB->peopleInode));
+}
+
+
+/**
+ * @brief compares between 2 BatchJob objects, according to their peopleFile (see batchPeopleCompare), and then
+ * their line in the manifest.
+ * @param[in] jobA a void pointer, represents pointer to 1st job to compare.
+ * @param[in] jobB a void pointer, represents pointer to 2nd job to compare.
+ * @return integer: 0 if equal, negative integer if jobA comes before jobB,
+ * and positive integer if jobA comes after jobB.
+ */
+static int batchJobCompare(const void* jobA, const void* jobB)
+{
+	const BatchJob *jA = (const BatchJob *) jobA;
+	const BatchJob *jB = (const BatchJob *) jobB;
+	int peopleOrder = batchPeopleCompare(jA, jB);
+	if (peopleOrder != 0)
+	{
+		return peopleOrder;
+	}
+	return ((jA->lineNumber > jB->lineNumber) - (jA->lineNumber < jB->lineNumber));
+}
+
+
+/**
+ * @brief A function that groups the jobs of a batch by their peopleFile: the peopleFiles are stat()ed, the jobs
+ * are sorted by them, and each group of jobs gets one (not loaded yet) BatchPeople.
+ * @note The function ALLOCATES MEMORY being stored in people. released by batchPeopleFree, even in failure.
+ * @param[in] jobs the jobs. Being sorted, and pointed to their people.
+ * @param[in] jobCount number of jobs.
+ * @param[in] people set to the peopleFiles.
+ * @param[in] peopleCount set to the number of peopleFiles.
+ * @param[out] STATUS_CODE_SUCCESS If the jobs were grouped.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+static StatusCode batchGroupPeople(BatchJob *jobs, unsigned int jobCount, BatchPeople **people,
+								   unsigned int *peopleCount)
+{
+	*peopleCount = 0;
+	unsigned int jobIndex = 0;
+	for (jobIndex = 0; jobIndex < jobCount; jobIndex++)
+	{
+		struct stat peopleStat;
+		jobs[jobIndex].isPeopleFound = (stat(jobs[jobIndex].peopleFilePath, &peopleStat) == 0);
+		jobs[jobIndex].peopleDevice = jobs[jobIndex].isPeopleFound ? peopleStat.st_dev : 0;
+		jobs[jobIndex].peopleInode = jobs[jobIndex].isPeopleFound ? peopleStat.st_ino : 0;
+	}
+	qsort(jobs, jobCount, sizeof(BatchJob), batchJobCompare);
+	*people = (BatchPeople *) calloc((jobCount > 0) ? jobCount : 1, sizeof(BatchPeople));
+	if (*people == NULL)
+	{
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	for (jobIndex = 0; jobIndex < jobCount; jobIndex++)
+	{
+		if ((jobIndex == 0) || (batchPeopleCompare(jobs + jobIndex, jobs + jobIndex - 1) != 0))
+		{
+			BatchPeople *groupPeople = (*people) + *peopleCount;
+			if (pthread_mutex_init(&groupPeople->mutex, NULL) != 0)
+			{
+				error(STATUS_CODE_FAIL);
+				return STATUS_CODE_FAIL;
+			}
+			groupPeople->peopleFilePath = jobs[jobIndex].peopleFilePath;
+			(*peopleCount)++;
+		}
+		jobs[jobIndex].people = (*people) + (*peopleCount - 1);
+		jobs[jobIndex].people->pendingJobCount++;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that releases the peopleFiles of a batch.
+ * @param[in] people the peopleFiles. May be NULL.
+ * @param[in] peopleCount number of peopleFiles (whose mutex was initiated).
+ */
+static void batchPeopleFree(BatchPeople *people, unsigned int peopleCount)
+{
+	unsigned int peopleIndex = 0;
+	for (peopleIndex = 0; (people != NULL) && (peopleIndex < peopleCount); peopleIndex++)
+	{
+		spreaderDetectorRegistryFree(people[peopleIndex].registry);
+		pthread_mutex_destroy(&people[peopleIndex].mutex);
+	}
+	free(people);
+}
+
+
+/**
+ * @brief A function that runs one job of a batch, and writes its analysis to its output file.
+ * @details The first job of a peopleFile loads its registry (the other jobs of the peopleFile wait for it), and
+ * the last one releases it. The meetingFile is analyzed by spreaderDetectorAnalyzeFile, and the results are
+ * written exactly as generateSeverityFile would. The output file of a failed job isn't written. When the batch
+ * is measured (jobOptions->statsPath), the job is measured into its own RunStats - the people phase by the job
+ * which loaded the peopleFile. A job which names STDIN_PATH (as its peopleFile or its meetingFile) fails with an
+ * input error: stdin isn't a job's - it may hold the manifest, and is shared by every job.
+ * @param[in] job the job. Its status (and runStats) are set.
+ * @param[in] jobOptions the options of the jobs.
+ * @param[out] STATUS_CODE_SUCCESS If the analysis was written.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode batchRunJob(BatchJob *job, const RunOptions *jobOptions)
+{
+	// ## LOAD THE PEOPLE ## - once, by the first job of the peopleFile:
+	RunOptions runOptions = *jobOptions;
+	runOptions.runStats = (jobOptions->statsPath != NULL) ? &job->runStats : NULL;
+	int isStdinJob = ((strcmp(job->peopleFilePath, STDIN_PATH) == 0) ||
+					  (strcmp(job->meetingFilePath, STDIN_PATH) == 0));
+	BatchPeople *people = job->people;
+	pthread_mutex_lock(&people->mutex);
+	if (!people->isLoadAttempted && !isStdinJob)
+	{
+		people->isLoadAttempted = 1;
+		people->registry = spreaderDetectorRegistryLoad(people->peopleFilePath, &runOptions);
+	}
+	const SpreaderDetectorRegistry *registry = people->registry;
+	pthread_mutex_unlock(&people->mutex);
+	
+	// ## ANALYZE ##
+	SpreaderDetectorResult *results = NULL;
+	unsigned int resultCount = 0;
+	StatusCode retValJob = STATUS_CODE_FAIL;
+	if (isStdinJob)
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		retValJob = STATUS_CODE_INPUT_ERROR;
+	}
+	else if (registry != NULL)
+	{
+		retValJob = spreaderDetectorAnalyzeFile(registry, job->meetingFilePath, &runOptions, &results, &resultCount);
+	}
+	
+	//	## WRITE THE OUTPUT FILE ##
+	if (retValJob == STATUS_CODE_SUCCESS)
+	{
+		runStatsPhaseStart(runOptions.runStats);
+		int outputFd = open(job->outputFilePath, O_WRONLY | O_CREAT | O_TRUNC, OUTPUT_FILE_MODE);
+		if ((outputFd < 0) || (spreaderDetectorWriteResults(outputFd, results, resultCount) != STATUS_CODE_SUCCESS))
+		{
+			retValJob = STATUS_CODE_OUTPUT_ERROR;
+		}
+		off_t outputSize = (retValJob == STATUS_CODE_SUCCESS) ? lseek(outputFd, 0, SEEK_CUR) : 0;
+		if ((outputFd >= 0) && (close(outputFd) != 0))
+		{
+			retValJob = STATUS_CODE_OUTPUT_ERROR;
+		}
+		if (retValJob == STATUS_CODE_SUCCESS)
+		{
+			runStatsCount(runOptions.runStats, STATS_PHASE_OUTPUT,
+						  (outputSize > 0) ? (unsigned long long) outputSize : 0, resultCount, 0);
+			runStatsPhaseEnd(runOptions.runStats, STATS_PHASE_OUTPUT);
+		}
+		else
+		{
+			error(STATUS_CODE_OUTPUT_ERROR);
+		}
+	}
+	spreaderDetectorResultsFree(results);
+	
+	//	## RELEASE THE PEOPLE ## - by the last job of the peopleFile (the results pointed to its names):
+	pthread_mutex_lock(&people->mutex);
+	if (--people->pendingJobCount == 0)
+	{
+		spreaderDetectorRegistryFree(people->registry);
+		people->registry = NULL;
+	}
+	pthread_mutex_unlock(&people->mutex);
+	job->status = retValJob;
+	return retValJob;
+}
+
+
+/**
+ * @brief A function that takes the next job for a worker of a batch: the head of its own deque, or - once it
+ * is empty - a job stolen from the tail of another worker's deque.
+ * @details No jobs are added once the batch started, so a worker which finds every deque empty is done.
+ * @param[in] pool the pool of the batch.
+ * @param[in] workerIndex the worker.
+ * @param[in] jobIndex set to the job to run.
+ * @return 1 if a job was taken, 0 if there are no jobs left.
+ */
+static int batchTakeJob(BatchPool *pool, unsigned int workerIndex, unsigned int *jobIndex)
+{
+	BatchDeque *deque = pool->deques + workerIndex;
+	int isJobTaken = 0;
+	pthread_mutex_lock(&deque->mutex);
+	if (deque->head < deque->tail)
+	{
+		*jobIndex = deque->head++;
+		isJobTaken = 1;
+	}
+	pthread_mutex_unlock(&deque->mutex);
+	
+	//	Steal - the tail of a victim is the farthest from the jobs (and the peopleFile) it runs now:
+	unsigned int victimOffset = 0;
+	for (victimOffset = 1; (!isJobTaken) && (victimOffset < pool->workerCount); victimOffset++)
+	{
+		BatchDeque *victimDeque = pool->deques + ((workerIndex + victimOffset) % pool->workerCount);
+		pthread_mutex_lock(&victimDeque->mutex);
+		if (victimDeque->head < victimDeque->tail)
+		{
+			*jobIndex = --victimDeque->tail;
+			isJobTaken = 1;
+		}
+		pthread_mutex_unlock(&victimDeque->mutex);
+	}
+	return isJobTaken;
+}
+
+
+/**
+ * @brief The thread function of a worker of a batch: runs jobs until there are none left.
+ * @param[in] workerArg a BatchWorker. Its failedJobCount is set.
+ * @return NULL.
+ */
+static void *batchWorkerRun(void *workerArg)
+{
+	BatchWorker *worker = (BatchWorker *) workerArg;
+	unsigned int jobIndex = 0;
+	while (batchTakeJob(worker->pool, worker->workerIndex, &jobIndex))
+	{
+		if (batchRunJob(worker->pool->jobs + jobIndex, worker->pool->jobOptions) != STATUS_CODE_SUCCESS)
+		{
+			worker->failedJobCount++;
+		}
+	}
+	return NULL;
+}
+
+
+/**
+ * @brief compares between 2 BatchJob objects, according to their line in the manifest.
+ * @param[in] jobA a void pointer, represents pointer to 1st job to compare.
+ * @param[in] jobB a void pointer, represents pointer to 2nd job to compare.
+ * @return integer: 0 if equal, negative integer if jobA comes before jobB,
+ * and positive integer if jobA comes after jobB.
+ */
+static int batchJobLineCompare(const void* jobA, const void* jobB)
+{
+	const BatchJob *jA = (const BatchJob *) jobA;
+	const BatchJob *jB = (const BatchJob *) jobB;
+	return ((jA->lineNumber > jB->lineNumber) - (jA->lineNumber < jB->lineNumber));
+}
+
+
+/**
+ * @brief A function that writes the RunStats of the jobs of a batch, as a JSON array of the objects
+ * runStatsPrint prints - one per job, in the order of the manifest.
+ * @param[in] jobs the jobs, once they ran. Being sorted by their line in the manifest.
+ * @param[in] jobCount number of jobs.
+ * @param[in] statsPath the file to write to, or STATS_TO_STDERR.
+ * @param[out] STATUS_CODE_SUCCESS If the stats were written.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If the file couldn't be written.
+ */
+static StatusCode batchWriteStats(BatchJob *jobs, unsigned int jobCount, const char *statsPath)
+{
+	FILE *statsFile = (strcmp(statsPath, STATS_TO_STDERR) == 0) ? stderr : fopen(statsPath, "w");
+	if (statsFile == NULL)
+	{
+		error(STATUS_CODE_OUTPUT_ERROR);
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	qsort(jobs, jobCount, sizeof(BatchJob), batchJobLineCompare);
+	fprintf(statsFile, "[");
+	unsigned int jobIndex = 0;
+	for (jobIndex = 0; jobIndex < jobCount; jobIndex++)
+	{
+		fprintf(statsFile, (jobIndex > 0) ? ",\n" : "\n");
+		runStatsPrint(statsFile, &jobs[jobIndex].runStats, jobs[jobIndex].status);
+	}
+	fprintf(statsFile, "\n]\n");
+	if ((statsFile == stderr) ? (EOF == fflush(statsFile)) : (EOF == fclose(statsFile)))
+	{
+		error(STATUS_CODE_OUTPUT_ERROR);
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief The batch mode: runs the jobs of a manifest - (peopleFile, meetingFile, output file) triples -
+ * concurrently, on a work-stealing pool of threads.
+ * @details The jobs are grouped by their peopleFile, which is loaded once for all of them (see batchRunJob),
+ * and the groups are dealt to the workers as contiguous ranges, so each worker keeps to few peopleFiles; a
+ * worker which ran out of jobs steals from the others. Every job runs on a single thread, with the other
+ * options of runOptions, and its output file is the one spreaderDetector writes for it alone. A failed job
+ * doesn't stop the others. With a statsPath, every job is measured on its own (see batchWriteStats).
+ * @param[in] manifestPath the path of the manifest (STDIN_PATH - stdin). See batchParseManifest.
+ * @param[in] runOptions the options the program was run with. threadCount is the number of workers
+ * (ALL_ONLINE_CPUS - one per online CPU). runStats is ignored.
+ * @param[out] STATUS_CODE_SUCCESS If every job was successful.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorBatch(const char *manifestPath, const RunOptions *runOptions)
+{
+	// ## READ THE MANIFEST ##
+	char *manifest = NULL;
+	BatchJob *jobs = NULL;
+	BatchPeople *people = NULL;
+	unsigned int jobCount = 0, peopleCount = 0;
+	StatusCode retValBatch = batchReadManifest(manifestPath, &manifest);
+	if (retValBatch == STATUS_CODE_SUCCESS)
+	{
+		retValBatch = batchParseManifest(manifest, &jobs, &jobCount);
+	}
+	if (retValBatch == STATUS_CODE_SUCCESS)
+	{
+		retValBatch = batchGroupPeople(jobs, jobCount, &people, &peopleCount);
+	}
+	
+	// ## DEAL THE JOBS ## - a contiguous range of the grouped jobs per worker:
+	unsigned int workerCount = resolveThreadCount(runOptions->threadCount);
+	workerCount = (workerCount < jobCount) ? workerCount : ((jobCount > 0) ? jobCount : 1);
+	RunOptions jobOptions = *runOptions;
+	jobOptions.threadCount = SERIAL_THREAD_COUNT;
+	BatchPool pool = {jobs, NULL, workerCount, &jobOptions};
+	BatchWorker *workers = NULL;
+	pthread_t *threads = NULL;
+	unsigned int workerIndex = 0, dequeCount = 0, threadCount = 0;
+	if (retValBatch == STATUS_CODE_SUCCESS)
+	{
+		pool.deques = (BatchDeque *) calloc(workerCount, sizeof(BatchDeque));
+		workers = (BatchWorker *) calloc(workerCount, sizeof(BatchWorker));
+		threads = (pthread_t *) calloc(workerCount, sizeof(pthread_t));
+		if ((pool.deques == NULL) || (workers == NULL) || (threads == NULL))
+		{
+			error(STATUS_CODE_FAIL);
+			retValBatch = STATUS_CODE_FAIL;
+		}
+	}
+	for (dequeCount = 0; (retValBatch == STATUS_CODE_SUCCESS) && (dequeCount < workerCount); dequeCount++)
+	{
+		BatchDeque *deque = pool.deques + dequeCount;
+		if (pthread_mutex_init(&deque->mutex, NULL) != 0)
+		{
+			error(STATUS_CODE_FAIL);
+			retValBatch = STATUS_CODE_FAIL;
+			break;
+		}
+		deque->head = (unsigned int) (((unsigned long long) jobCount * dequeCount) / workerCount);
+		deque->tail = (unsigned int) (((unsigned long long) jobCount * (dequeCount + 1)) / workerCount);
+		workers[dequeCount].pool = &pool;
+		workers[dequeCount].workerIndex = dequeCount;
+	}
+	
+	// ## RUN THE JOBS ## - this thread is worker 0. Deques whose thread failed to start are stolen from:
+	if (retValBatch == STATUS_CODE_SUCCESS)
+	{
+		for (threadCount = 1; threadCount < workerCount; threadCount++)
+		{
+			if (pthread_create(threads + threadCount, NULL, batchWorkerRun, workers + threadCount) != 0)
+			{
+				break;
+			}
+		}
+		batchWorkerRun(workers);
+		for (workerIndex = 1; workerIndex < threadCount; workerIndex++)
+		{
+			pthread_join(threads[workerIndex], NULL);
+		}
+		for (workerIndex = 0; workerIndex < workerCount; workerIndex++)
+		{
+			if (workers[workerIndex].failedJobCount > 0)
+			{
+				retValBatch = STATUS_CODE_FAIL;
+			}
+		}
+		if ((runOptions->statsPath != NULL) &&
+			(batchWriteStats(jobs, jobCount, runOptions->statsPath) != STATUS_CODE_SUCCESS))
+		{
+			retValBatch = STATUS_CODE_OUTPUT_ERROR;
+		}
+	}
+	
+	//	## FREE RESOURCES ##
+	for (workerIndex = 0; (pool.deques != NULL) && (workerIndex < dequeCount); workerIndex++)
+	{
+		pthread_mutex_destroy(&pool.deques[workerIndex].mutex);
+	}
+	free(pool.deques);
+	free(workers);
+	free(threads);
+	batchPeopleFree(people, peopleCount);
+	free(jobs);
+	free(manifest);
+	return retValBatch;
+}
+
+
@@ -0,0 +1,1514 @@
+/*
+ * File Name: SpreaderDetectorExternal.c
+ * Related Files: "SpreaderDetector.h", "SpreaderDetectorInternal.h"
+ *
+ * Purpose:
+ * 			This file is the external-memory mode of the SpreaderDetector library: external merge sorts on disk,
+ * 			and the sort-merge join of the meetings with the people (see spreaderDetectorExternal).
+ *
+ * Author's ID: 206174120
+ * Author's Name: Oren Kovartovsky
+ * University User Name: orenkov
+ *
+ * */
+
+#include "SpreaderDetectorInternal.h"
+#include "SpreaderDetectorOutput.h"
+#include "SpreaderDetectorInput.h"
+#include "SpreaderDetectorPeople.h"
+#include "SpreaderDetectorMeetings.h"
+
+
+/*
+ * ***********************
+ * 	DECLARATIONS
+ * ***********************
+ */
+//	****** COMPARISON FUNCTIONS ******
+/**
+ * @brief compares between 2 ExternalRecord objects, according to their key, and then their value.
+ *
+ * @param[in] recordA a void pointer, represents pointer to 1st record to compare.
+ * @param[in] recordB a void pointer, represents pointer to 2nd record to compare.
+ * @return integer: 0 if equal, negative integer if recordA comes before recordB,
+ * and positive integer if recordA comes after recordB.
+ */
+static int externalRecordCompare(const void* recordA, const void* recordB);
+
+
+//	****** EXTERNAL MEMORY FUNCTIONS ******
+/**
+ * @brief A function that creates a temporary file for a run, in the given directory.
+ *
+ * @details The file is unlinked as soon as it is created, so it is removed when its descriptor is closed -
+ * even if the program is killed.
+ * @param[in] directory the directory of the file.
+ * @return the descriptor of the file (opened for reading and writing), or -1 if it couldn't be created.
+ */
+static int externalRunCreate(const char *directory);
+
+/**
+ * @brief A function that appends a record and its payload to a run being written.
+ *
+ * @param[in] outputWriter the writer of the run.
+ * @param[in] record the record.
+ * @param[in] payload the payload of the record (record->payloadLength bytes). May be NULL if there is none.
+ * @param[out] STATUS_CODE_SUCCESS If the record was appended.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If a flush failed.
+ */
+static StatusCode externalRunAppend(OutputWriter *outputWriter, const ExternalRecord *record, const char *payload);
+
+/**
+ * @brief A function that initializes an ExternalRunReader over a run, from its beginning.
+ *
+ * @note The function ALLOCATES MEMORY being stored in runReader. released by externalRunReaderFree, even in
+ * failure.
+ * @param[in] runReader the reader to initialize.
+ * @param[in] runFd the run. Not closed by the reader.
+ * @param[out] STATUS_CODE_SUCCESS If the reader was initialized.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+static StatusCode externalRunReaderInit(ExternalRunReader *runReader, int runFd);
+
+/**
+ * @brief A function that copies the next bytes of a run out of the buffer of an ExternalRunReader, reading the
+ * next blocks as needed.
+ *
+ * @param[in] runReader the reader.
+ * @param[in] destination where to copy the bytes.
+ * @param[in] size the number of bytes.
+ * @param[out] STATUS_CODE_SUCCESS If the bytes were copied.
+ * @param[out] STATUS_CODE_END_OF_FILE If the run ended before the first byte.
+ * @param[out] STATUS_CODE_FAIL If reading failed, or the run ended in the middle.
+ */
+static StatusCode externalRunReaderFill(ExternalRunReader *runReader, void *destination, size_t size);
+
+/**
+ * @brief A function that reads the next record of a run (and its payload) into an ExternalRunReader.
+ *
+ * @param[in] runReader the reader. Its record and payload are set to the next record.
+ * @param[out] STATUS_CODE_SUCCESS If a record was read.
+ * @param[out] STATUS_CODE_END_OF_FILE If there are no more records.
+ * @param[out] STATUS_CODE_FAIL If reading failed, or memory allocation failed.
+ */
+static StatusCode externalRunReaderNext(ExternalRunReader *runReader);
+
+/**
+ * @brief A function that releases the memory held by an ExternalRunReader.
+ *
+ * @param[in] runReader the reader to release. May be empty.
+ */
+static void externalRunReaderFree(ExternalRunReader *runReader);
+
+/**
+ * @brief A function that checks whether the current record of one reader of a merge comes before the current
+ * record of another: by externalRecordCompare, and then by the order of the runs.
+ *
+ * @param[in] merge the merge.
+ * @param[in] readerA the 1st reader.
+ * @param[in] readerB the 2nd reader.
+ * @return 1 if the record of readerA comes first, 0 otherwise.
+ */
+static int externalMergeLess(const ExternalMerge *merge, unsigned int readerA, unsigned int readerB);
+
+/**
+ * @brief A function that restores the min-heap order below one node of the heap of a merge.
+ *
+ * @param[in] merge the merge.
+ * @param[in] nodeIndex the node to sift down.
+ */
+static void externalMergeSiftDown(ExternalMerge *merge, unsigned int nodeIndex);
+
+/**
+ * @brief A function that starts a k-way merge of sorted runs: reads the first record of every run.
+ *
+ * @note The function ALLOCATES MEMORY being stored in merge. released by externalMergeFree, even in failure.
+ * @param[in] merge the merge to start.
+ * @param[in] runFds the runs. Not closed by the merge.
+ * @param[in] runCount number of runs.
+ * @param[out] STATUS_CODE_SUCCESS If the merge was started.
+ * @param[out] STATUS_CODE_FAIL If reading a run, or memory allocation, failed.
+ */
+static StatusCode externalMergeStart(ExternalMerge *merge, const int *runFds, unsigned int runCount);
+
+/**
+ * @brief A function that returns the next record of a merge, in the order of the records.
+ *
+ * @note The returned record and payload are valid until the next call.
+ * @param[in] merge the merge.
+ * @param[in] record set to the record.
+ * @param[in] payload set to the payload of the record.
+ * @param[out] STATUS_CODE_SUCCESS If a record was returned.
+ * @param[out] STATUS_CODE_END_OF_FILE If there are no more records.
+ * @param[out] STATUS_CODE_FAIL If reading a run failed.
+ */
+static StatusCode externalMergeNext(ExternalMerge *merge, const ExternalRecord **record, const char **payload);
+
+/**
+ * @brief A function that releases the memory held by a merge. The runs aren't closed.
+ *
+ * @param[in] merge the merge to release. May be partially started.
+ */
+static void externalMergeFree(ExternalMerge *merge);
+
+/**
+ * @brief A function that initiates an ExternalSorter, whose collected records and payloads fit a memory budget.
+ *
+ * @details A third of the budget holds the records of a run, a third their payloads, and the rest is left to
+ * qsort's scratch. The runs are merged EXTERNAL_RUN_BUFFER_SIZE buffers at a time, up to half the budget.
+ * @note The function ALLOCATES MEMORY being stored in sorter. released by externalSorterFree, even in failure.
+ * @param[in] sorter the sorter to initiate.
+ * @param[in] memoryBudget the number of bytes the sorter may hold.
+ * @param[in] directory the directory the runs are written to. Must outlive the sorter.
+ * @param[out] STATUS_CODE_SUCCESS If the sorter was initiated.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+static StatusCode externalSorterInit(ExternalSorter *sorter, unsigned long long memoryBudget, const char *directory);
+
+/**
+ * @brief A function that sorts the records an ExternalSorter collected, and writes them to disk as a run.
+ *
+ * @param[in] sorter the sorter. Its collected records are emptied.
+ * @param[out] STATUS_CODE_SUCCESS If the run was written.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalSorterSpill(ExternalSorter *sorter);
+
+/**
+ * @brief A function that adds a record to an ExternalSorter. When the budget is full, the records collected
+ * so far are written as a run first (externalSorterSpill).
+ *
+ * @param[in] sorter the sorter.
+ * @param[in] record the record. Its payloadOffset is ignored.
+ * @param[in] payload the payload of the record (record->payloadLength bytes). May be NULL if there is none.
+ * @param[out] STATUS_CODE_SUCCESS If the record was added.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalSorterAdd(ExternalSorter *sorter, const ExternalRecord *record, const char *payload);
+
+/**
+ * @brief A function that merges the first runs of an ExternalSorter into a single run, which replaces them (at
+ * the end of its runs).
+ *
+ * @param[in] sorter the sorter.
+ * @param[in] mergeCount number of runs to merge. At most runCount.
+ * @param[out] STATUS_CODE_SUCCESS If the runs were merged.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalSorterMergeRuns(ExternalSorter *sorter, unsigned int mergeCount);
+
+/**
+ * @brief A function that finishes adding records to an ExternalSorter: the last records are written as a run,
+ * the memory of the collected records is released, and runs are merged until at most maxRunCount are left.
+ *
+ * @details Each merge pass merges up to fanIn runs - only as many as needed to get down to maxRunCount. A sorter
+ * with no records has a single (empty) run. The runs are then read through an ExternalMerge (or, if there is a
+ * single one, an ExternalRunReader).
+ * @param[in] sorter the sorter.
+ * @param[in] maxRunCount the maximal number of runs to leave. At least 1.
+ * @param[out] STATUS_CODE_SUCCESS If the runs were written and merged.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalSorterFinish(ExternalSorter *sorter, unsigned int maxRunCount);
+
+/**
+ * @brief A function that releases the memory held by an ExternalSorter, and closes (so removes) its runs.
+ *
+ * @param[in] sorter the sorter to release. May be empty.
+ */
+static void externalSorterFree(ExternalSorter *sorter);
+
+/**
+ * @brief A function that reads the peopleFile into an ExternalSorter, which sorts the people by ID.
+ *
+ * @details Every person is a record: its key is the ID (as personRadixKey orders it), its value the person's
+ * line - so people of the same ID keep their file order, as in the stable in-memory sort - and its payload
+ * the name. The lines are parsed and blank lines skipped as peopleReadMapped does. A compressed peopleFile is
+ * decompressed on the fly (see inputFileOpen).
+ * @param[in] peopleFilePath argv path for the peopleFile.
+ * @param[in] peopleSorter the sorter to add the people to.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If the peopleFile was read.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalSortPeople(const char *peopleFilePath, ExternalSorter *peopleSorter, RunStats *runStats);
+
+/**
+ * @brief A function that adds the ID references of a block of meetings to the reference sorter.
+ *
+ * @details Meeting number k (from 1) refers to its infector at position 2k - 1, and to its infected at 2k (the
+ * verified carrier is position 0). The chances are calculated here by crnaBatch, and carried by the infected's
+ * references.
+ * @param[in] referenceSorter the sorter of the references.
+ * @param[in] meetingBlock the meetings: their IDs, distances and times.
+ * @param[in] meetingCount number of meetings in the block.
+ * @param[in] position the position of the last reference added. Advanced past the block.
+ * @param[out] STATUS_CODE_SUCCESS If the references were added.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalAddMeetingReferences(ExternalSorter *referenceSorter, const Meeting *meetingBlock,
+											   unsigned int meetingCount, unsigned long long *position);
+
+/**
+ * @brief A function that reads the meetingFile once, and adds every ID it refers to (with the position of the
+ * reference, see externalAddMeetingReferences) to the reference sorter.
+ *
+ * @details The lines are parsed as calculateSeverities parses them. An empty meetingFile has no references.
+ * @param[in] meetingFilePath argv path for the meetingFile (STDIN_PATH - stdin). May be compressed.
+ * @param[in] referenceSorter the sorter to add the references to.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If the meetingFile was read.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalCollectReferences(const char *meetingFilePath, ExternalSorter *referenceSorter,
+											RunStats *runStats);
+
+/**
+ * @brief A function that resolves the ID references of the meetings with a sort-merge join: the references,
+ * merged in ID order, are matched against the people run (sorted by ID).
+ *
+ * @details Every referenced ID gets a dense index, in ID order. A resolution record (its key - the position of
+ * the reference, its value - the dense index, and the chance the reference carries) is added to the
+ * resolution sorter, and the referenced IDs (key, dense index) are written to their own run, in ID order. An
+ * ID no person has is an input error, as in calculateSeverities.
+ * @param[in] peopleRunFd the people, sorted by ID, as a single run.
+ * @param[in] referenceSorter the sorter of the references. Finished.
+ * @param[in] resolutionSorter the sorter to add the resolutions to.
+ * @param[in] referencedRunFd set to the run of the referenced IDs. -1 if it wasn't created.
+ * @param[in] referencedCount set to the number of referenced IDs.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If every reference was resolved.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalJoinReferences(int peopleRunFd, ExternalSorter *referenceSorter,
+										 ExternalSorter *resolutionSorter, int *referencedRunFd,
+										 unsigned long long *referencedCount, RunStats *runStats);
+
+/**
+ * @brief A function that applies the meetings in file order, from their resolved references.
+ *
+ * @details The resolutions are merged in position order - the order of the meetingFile - so every meeting
+ * sets the infected's severity to the infector's current severity * chance, exactly as calculateSeverities
+ * does. Only the severities of the referenced people are held in memory.
+ * @param[in] resolutionSorter the sorter of the resolutions. Finished.
+ * @param[in] severities the severity of every referenced person, by dense index. Must be zeroed.
+ * @param[out] STATUS_CODE_SUCCESS If the meetings were applied.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalApplyMeetings(ExternalSorter *resolutionSorter, float *severities);
+
+/**
+ * @brief A function that attaches the severities to the people, and adds them to the output sorter in the
+ * order of the output file.
+ *
+ * @details The people run and the referenced IDs run are both in ID order, so they are read side by side. Only
+ * the first person of a referenced ID gets its severity, as the PeopleIndex finds the first. The key is the
+ * (severity, ID) order of the full output, descending - with the "No serious chance" people's severity
+ * ignored in OUTPUT_MODE_TIERS, so they come last in descending ID order - and the value is the person's
+ * position in the people run, descending: the order the in-memory sort gives when it is read backwards.
+ * @param[in] peopleRunFd the people, sorted by ID, as a single run.
+ * @param[in] referencedRunFd the run of the referenced IDs (see externalJoinReferences).
+ * @param[in] severities the severity of every referenced person, by dense index.
+ * @param[in] runOptions the options the program was run with.
+ * @param[in] outputSorter the sorter to add the people to.
+ * @param[out] STATUS_CODE_SUCCESS If the people were added.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalOrderPeople(int peopleRunFd, int referencedRunFd, const float *severities,
+									  const RunOptions *runOptions, ExternalSorter *outputSorter);
+
+/**
+ * @brief A function that writes the output file by the final merge of the output sorter's runs.
+ *
+ * @details In OUTPUT_MODE_TOP the merge stops after topCount people.
+ * @param[in] outputSorter the sorter of the output records. Finished.
+ * @param[in] runOptions the options the program was run with.
+ * @param[in] outputFilePath the path of the output file.
+ * @param[out] STATUS_CODE_SUCCESS if file was generated successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalWriteOutput(ExternalSorter *outputSorter, const RunOptions *runOptions,
+									  const char *outputFilePath);
+
+
+/*
+ * ***********************
+ * 	DEFINITIONS
+ * ***********************
+ */
+/**
+ * @brief compares between 2 ExternalRecord objects, according to their key, and then their value.
+ * @param[in] recordA a void pointer, represents pointer to 1st record to compare.
+ * @param[in] recordB a void pointer, represents pointer to 2nd record to compare.
+ * @return integer: 0 if equal, negative integer if recordA comes before recordB,
+ * and positive integer if recordA comes after recordB.
+ */
+static int externalRecordCompare(const void* recordA, const void* recordB)
+{
+	const ExternalRecord *rA = (const ExternalRecord *) recordA;
+	const ExternalRecord *rB = (const ExternalRecord *) recordB;
+	if (rA->key != rB->key)
+	{
+		return ((rA->key > rB->key) - (rA->key < rB->key));
+	}
+	return ((rA->value > rB->value) - (rA->value < rB->value));
+}
+
+
+/**
+ * @brief A function that creates a temporary file for a run, in the given directory.
+ * @details The file is unlinked as soon as it is created, so it is removed when its descriptor is closed -
+ * even if the program is killed.
+ * @param[in] directory the directory of the file.
+ * @return the descriptor of the file (opened for reading and writing), or -1 if it couldn't be created.
+ */
+static int externalRunCreate(const char *directory)
+{
+	size_t directoryLength = strlen(directory);
+	char *runPath = (char *) malloc(directoryLength + sizeof(EXTERNAL_RUN_TEMPLATE));
+	if (runPath == NULL)
+	{
+		return -1;
+	}
+	memcpy(runPath, directory, directoryLength);
+	memcpy(runPath + directoryLength, EXTERNAL_RUN_TEMPLATE, sizeof(EXTERNAL_RUN_TEMPLATE));
+	int runFd = mkstemp(runPath);
+	if (runFd >= 0)
+	{
+		unlink(runPath);
+	}
+	free(runPath);
+	return runFd;
+}
+
+
+/**
+ * @brief A function that appends a record and its payload to a run being written.
+ * @param[in] outputWriter the writer of the run.
+ * @param[in] record the record.
+ * @param[in] payload the payload of the record (record->payloadLength bytes). May be NULL if there is none.
+ * @param[out] STATUS_CODE_SUCCESS If the record was appended.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If a flush failed.
+ */
+static StatusCode externalRunAppend(OutputWriter *outputWriter, const ExternalRecord *record, const char *payload)
+{
+	if (outputWriterAppendBytes(outputWriter, record, sizeof(ExternalRecord)) != STATUS_CODE_SUCCESS)
+	{
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	return (record->payloadLength > 0) ? outputWriterAppendBytes(outputWriter, payload, record->payloadLength) :
+		   STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that initializes an ExternalRunReader over a run, from its beginning.
+ * @note The function ALLOCATES MEMORY being stored in runReader. released by externalRunReaderFree, even in
+ * failure.
+ * @param[in] runReader the reader to initialize.
+ * @param[in] runFd the run. Not closed by the reader.
+ * @param[out] STATUS_CODE_SUCCESS If the reader was initialized.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+static StatusCode externalRunReaderInit(ExternalRunReader *runReader, int runFd)
+{
+	memset(runReader, 0, sizeof(*runReader));
+	runReader->runFd = runFd;
+	runReader->buffer = (char *) malloc(EXTERNAL_RUN_BUFFER_SIZE);
+	if (runReader->buffer == NULL)
+	{
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that copies the next bytes of a run out of the buffer of an ExternalRunReader, reading the
+ * next blocks as needed.
+ * @param[in] runReader the reader.
+ * @param[in] destination where to copy the bytes.
+ * @param[in] size the number of bytes.
+ * @param[out] STATUS_CODE_SUCCESS If the bytes were copied.
+ * @param[out] STATUS_CODE_END_OF_FILE If the run ended before the first byte.
+ * @param[out] STATUS_CODE_FAIL If reading failed, or the run ended in the middle.
+ */
+static StatusCode externalRunReaderFill(ExternalRunReader *runReader, void *destination, size_t size)
+{
+	char *cursor = (char *) destination;
+	while (size > 0)
+	{
+		if (runReader->start == runReader->end)
+		{
+			ssize_t bytesRead = pread(runReader->runFd, runReader->buffer, EXTERNAL_RUN_BUFFER_SIZE,
+									  (off_t) runReader->offset);
+			if ((bytesRead < 0) && (errno == EINTR))
+			{
+				continue;
+			}
+			if (bytesRead <= 0)
+			{
+				return ((bytesRead == 0) && (cursor == (char *) destination)) ? STATUS_CODE_END_OF_FILE :
+					   STATUS_CODE_FAIL;
+			}
+			runReader->offset += (unsigned long long) bytesRead;
+			runReader->start = 0;
+			runReader->end = (size_t) bytesRead;
+		}
+		size_t copySize = runReader->end - runReader->start;
+		copySize = (copySize < size) ? copySize : size;
+		memcpy(cursor, runReader->buffer + runReader->start, copySize);
+		runReader->start += copySize;
+		cursor += copySize;
+		size -= copySize;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that reads the next record of a run (and its payload) into an ExternalRunReader.
+ * @param[in] runReader the reader. Its record and payload are set to the next record.
+ * @param[out] STATUS_CODE_SUCCESS If a record was read.
+ * @param[out] STATUS_CODE_END_OF_FILE If there are no more records.
+ * @param[out] STATUS_CODE_FAIL If reading failed, or memory allocation failed.
+ */
+static StatusCode externalRunReaderNext(ExternalRunReader *runReader)
+{
+	StatusCode retValRead = externalRunReaderFill(runReader, &runReader->record, sizeof(ExternalRecord));
+	if (retValRead != STATUS_CODE_SUCCESS)
+	{
+		if (retValRead != STATUS_CODE_END_OF_FILE)
+		{
+			error(STATUS_CODE_FAIL);
+		}
+		return retValRead;
+	}
+	if (runReader->record.payloadLength > runReader->payloadCapacity)
+	{
+		char *grownPayload = (char *) realloc(runReader->payload, runReader->record.payloadLength);
+		if (grownPayload == NULL)
+		{
+			error(STATUS_CODE_FAIL);
+			return STATUS_CODE_FAIL;
+		}
+		runReader->payload = grownPayload;
+		runReader->payloadCapacity = runReader->record.payloadLength;
+	}
+	if ((runReader->record.payloadLength > 0) &&
+		(externalRunReaderFill(runReader, runReader->payload, runReader->record.payloadLength) !=
+		 STATUS_CODE_SUCCESS))
+	{
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that releases the memory held by an ExternalRunReader.
+ * @param[in] runReader the reader to release. May be empty.
+ */
+static void externalRunReaderFree(ExternalRunReader *runReader)
+{
+	free(runReader->buffer);
+	free(runReader->payload);
+	runReader->buffer = NULL;
+	runReader->payload = NULL;
+	runReader->payloadCapacity = 0;
+}
+
+
+/**
+ * @brief A function that checks whether the current record of one reader of a merge comes before the current
+ * record of another: by externalRecordCompare, and then by the order of the runs.
+ * @param[in] merge the merge.
+ * @param[in] readerA the 1st reader.
+ * @param[in] readerB the 2nd reader.
+ * @return 1 if the record of readerA comes first, 0 otherwise.
+ */
+static int externalMergeLess(const ExternalMerge *merge, unsigned int readerA, unsigned int readerB)
+{
+	int recordOrder = externalRecordCompare(&merge->readers[readerA].record, &merge->readers[readerB].record);
+	return (recordOrder != 0) ? (recordOrder < 0) : (readerA < readerB);
+}
+
+
+/**
+ * @brief A function that restores the min-heap order below one node of the heap of a merge.
+ * @param[in] merge the merge.
+ * @param[in] nodeIndex the node to sift down.
+ */
+static void externalMergeSiftDown(ExternalMerge *merge, unsigned int nodeIndex)
+{
+	unsigned int *heap = merge->heap;
+	while ((2 * nodeIndex + 1) < merge->heapSize)
+	{
+		unsigned int childIndex = 2 * nodeIndex + 1;
+		if (((childIndex + 1) < merge->heapSize) && externalMergeLess(merge, heap[childIndex + 1], heap[childIndex]))
+		{
+			childIndex++;
+		}
+		if (!externalMergeLess(merge, heap[childIndex], heap[nodeIndex]))
+		{
+			return;
+		}
+		unsigned int swapReader = heap[nodeIndex];
+		heap[nodeIndex] = heap[childIndex];
+		heap[childIndex] = swapReader;
+		nodeIndex = childIndex;
+	}
+}
+
+
+/**
+ * @brief A function that starts a k-way merge of sorted runs: reads the first record of every run.
+ * @note The function ALLOCATES MEMORY being stored in merge. released by externalMergeFree, even in failure.
+ * @param[in] merge the merge to start.
+ * @param[in] runFds the runs. Not closed by the merge.
+ * @param[in] runCount number of runs.
+ * @param[out] STATUS_CODE_SUCCESS If the merge was started.
+ * @param[out] STATUS_CODE_FAIL If reading a run, or memory allocation, failed.
+ */
+static StatusCode externalMergeStart(ExternalMerge *merge, const int *runFds, unsigned int runCount)
+{
+	memset(merge, 0, sizeof(*merge));
+	merge->readers = (ExternalRunReader *) calloc((runCount > 0) ? runCount : 1, sizeof(ExternalRunReader));
+	merge->heap = (unsigned int *) malloc(((runCount > 0) ? runCount : 1) * sizeof(unsigned int));
+	if ((merge->readers == NULL) || (merge->heap == NULL))
+	{
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	unsigned int runIndex = 0;
+	for (runIndex = 0; runIndex < runCount; runIndex++)
+	{
+		merge->readerCount++;
+		if (externalRunReaderInit(merge->readers + runIndex, runFds[runIndex]) != STATUS_CODE_SUCCESS)
+		{
+			return STATUS_CODE_FAIL;
+		}
+		StatusCode retValRead = externalRunReaderNext(merge->readers + runIndex);
+		if (retValRead == STATUS_CODE_SUCCESS)
+		{
+			merge->heap[merge->heapSize++] = runIndex;
+		}
+		else if (retValRead != STATUS_CODE_END_OF_FILE)
+		{
+			return STATUS_CODE_FAIL;
+		}
+	}
+	unsigned int nodeIndex = merge->heapSize / 2;
+	while (nodeIndex-- > 0)
+	{
+		externalMergeSiftDown(merge, nodeIndex);
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that returns the next record of a merge, in the order of the records.
+ * @note The returned record and payload are valid until the next call.
+ * @param[in] merge the merge.
+ * @param[in] record set to the record.
+ * @param[in] payload set to the payload of the record.
+ * @param[out] STATUS_CODE_SUCCESS If a record was returned.
+ * @param[out] STATUS_CODE_END_OF_FILE If there are no more records.
+ * @param[out] STATUS_CODE_FAIL If reading a run failed.
+ */
+static StatusCode externalMergeNext(ExternalMerge *merge, const ExternalRecord **record, const char **payload)
+{
+	if (merge->isAdvancePending)
+	{
+		merge->isAdvancePending = 0;
+		StatusCode retValRead = externalRunReaderNext(merge->readers + merge->heap[0]);
+		if (retValRead == STATUS_CODE_END_OF_FILE)
+		{
+			merge->heap[0] = merge->heap[--merge->heapSize];
+		}
+		else if (retValRead != STATUS_CODE_SUCCESS)
+		{
+			return STATUS_CODE_FAIL;
+		}
+		externalMergeSiftDown(merge, 0);
+	}
+	if (merge->heapSize == 0)
+	{
+		return STATUS_CODE_END_OF_FILE;
+	}
+	const ExternalRunReader *runReader = merge->readers + merge->heap[0];
+	*record = &runReader->record;
+	*payload = runReader->payload;
+	merge->isAdvancePending = 1;
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that releases the memory held by a merge. The runs aren't closed.
+ * @param[in] merge the merge to release. May be partially started.
+ */
+static void externalMergeFree(ExternalMerge *merge)
+{
+	unsigned int readerIndex = 0;
+	for (readerIndex = 0; (merge->readers != NULL) && (readerIndex < merge->readerCount); readerIndex++)
+	{
+		externalRunReaderFree(merge->readers + readerIndex);
+	}
+	free(merge->readers);
+	free(merge->heap);
+	memset(merge, 0, sizeof(*merge));
+}
+
+
+/**
+ * @brief A function that initiates an ExternalSorter, whose collected records and payloads fit a memory budget.
+ * @details A third of the budget holds the records of a run, a third their payloads, and the rest is left to
+ * qsort's scratch. The runs are merged EXTERNAL_RUN_BUFFER_SIZE buffers at a time, up to half the budget.
+ * @note The function ALLOCATES MEMORY being stored in sorter. released by externalSorterFree, even in failure.
+ * @param[in] sorter the sorter to initiate.
+ * @param[in] memoryBudget the number of bytes the sorter may hold.
+ * @param[in] directory the directory the runs are written to. Must outlive the sorter.
+ * @param[out] STATUS_CODE_SUCCESS If the sorter was initiated.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+static StatusCode externalSorterInit(ExternalSorter *sorter, unsigned long long memoryBudget, const char *directory)
+{
+	unsigned long long budgetShare = memoryBudget / EXTERNAL_BUDGET_SHARES;
+	unsigned long long recordCapacity = budgetShare / sizeof(ExternalRecord);
+	unsigned long long fanIn = memoryBudget / (2 * EXTERNAL_RUN_BUFFER_SIZE);
+	memset(sorter, 0, sizeof(*sorter));
+	sorter->directory = directory;
+	sorter->recordCapacity = (recordCapacity < UINT_MAX) ? (unsigned int) recordCapacity : UINT_MAX;
+	sorter->payloadCapacity = (budgetShare < UINT_MAX) ? (size_t) budgetShare : UINT_MAX;
+	sorter->fanIn = (fanIn < 2) ? 2 : ((fanIn > EXTERNAL_MAX_FAN_IN) ? EXTERNAL_MAX_FAN_IN : (unsigned int) fanIn);
+	sorter->records = (ExternalRecord *) malloc((size_t) sorter->recordCapacity * sizeof(ExternalRecord));
+	sorter->payloads = (char *) malloc(sorter->payloadCapacity);
+	if ((sorter->recordCapacity == 0) || (sorter->records == NULL) || (sorter->payloads == NULL))
+	{
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that sorts the records an ExternalSorter collected, and writes them to disk as a run.
+ * @param[in] sorter the sorter. Its collected records are emptied.
+ * @param[out] STATUS_CODE_SUCCESS If the run was written.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalSorterSpill(ExternalSorter *sorter)
+{
+	if (sorter->runCount == sorter->runCapacity)
+	{
+		unsigned int runCapacity = (sorter->runCapacity > 0) ? (2 * sorter->runCapacity) :
+								   EXTERNAL_RUNS_INITIAL_CAPACITY;
+		int *runFds = (int *) realloc(sorter->runFds, (size_t) runCapacity * sizeof(int));
+		if (runFds == NULL)
+		{
+			error(STATUS_CODE_FAIL);
+			return STATUS_CODE_FAIL;
+		}
+		sorter->runFds = runFds;
+		sorter->runCapacity = runCapacity;
+	}
+	qsort(sorter->records, sorter->recordCount, sizeof(ExternalRecord), externalRecordCompare);
+	
+	int runFd = externalRunCreate(sorter->directory);
+	OutputWriter outputWriter = {0};
+	if ((runFd < 0) || (outputWriterInit(&outputWriter, runFd) != STATUS_CODE_SUCCESS))
+	{
+		if (runFd >= 0)
+		{
+			close(runFd);
+		}
+		error(STATUS_CODE_OUTPUT_ERROR);
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	StatusCode retValWrite = STATUS_CODE_SUCCESS;
+	unsigned int recordIndex = 0;
+	for (recordIndex = 0; (recordIndex < sorter->recordCount) && (retValWrite == STATUS_CODE_SUCCESS); recordIndex++)
+	{
+		const ExternalRecord *record = sorter->records + recordIndex;
+		retValWrite = externalRunAppend(&outputWriter, record, sorter->payloads + record->payloadOffset);
+	}
+	if (retValWrite == STATUS_CODE_SUCCESS)
+	{
+		retValWrite = outputWriterFlush(&outputWriter);
+	}
+	outputWriterFree(&outputWriter);
+	if (retValWrite != STATUS_CODE_SUCCESS)
+	{
+		close(runFd);
+		error(STATUS_CODE_OUTPUT_ERROR);
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	sorter->runFds[sorter->runCount++] = runFd;
+	sorter->recordCount = 0;
+	sorter->payloadLength = 0;
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that adds a record to an ExternalSorter. When the budget is full, the records collected
+ * so far are written as a run first (externalSorterSpill).
+ * @param[in] sorter the sorter.
+ * @param[in] record the record. Its payloadOffset is ignored.
+ * @param[in] payload the payload of the record (record->payloadLength bytes). May be NULL if there is none.
+ * @param[out] STATUS_CODE_SUCCESS If the record was added.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalSorterAdd(ExternalSorter *sorter, const ExternalRecord *record, const char *payload)
+{
+	if ((sorter->recordCount == sorter->recordCapacity) ||
+		(record->payloadLength > (sorter->payloadCapacity - sorter->payloadLength)))
+	{
+		StatusCode retValSpill = externalSorterSpill(sorter);
+		if (retValSpill != STATUS_CODE_SUCCESS)
+		{
+			return retValSpill;
+		}
+	}
+	
+	//	A single payload larger than the budget's share grows the buffer (for it alone):
+	if (record->payloadLength > sorter->payloadCapacity)
+	{
+		char *grownPayloads = (char *) realloc(sorter->payloads, record->payloadLength);
+		if (grownPayloads == NULL)
+		{
+			error(STATUS_CODE_FAIL);
+			return STATUS_CODE_FAIL;
+		}
+		sorter->payloads = grownPayloads;
+		sorter->payloadCapacity = record->payloadLength;
+	}
+	ExternalRecord *storedRecord = sorter->records + sorter->recordCount;
+	*storedRecord = *record;
+	storedRecord->payloadOffset = (unsigned int) sorter->payloadLength;
+	if (record->payloadLength > 0)
+	{
+		memcpy(sorter->payloads + sorter->payloadLength, payload, record->payloadLength);
+	}
+	sorter->payloadLength += record->payloadLength;
+	sorter->recordCount++;
+	sorter->recordTotal++;
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that merges the first runs of an ExternalSorter into a single run, which replaces them (at
+ * the end of its runs).
+ * @param[in] sorter the sorter.
+ * @param[in] mergeCount number of runs to merge. At most runCount.
+ * @param[out] STATUS_CODE_SUCCESS If the runs were merged.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalSorterMergeRuns(ExternalSorter *sorter, unsigned int mergeCount)
+{
+	int runFd = externalRunCreate(sorter->directory);
+	OutputWriter outputWriter = {0};
+	if ((runFd < 0) || (outputWriterInit(&outputWriter, runFd) != STATUS_CODE_SUCCESS))
+	{
+		if (runFd >= 0)
+		{
+			close(runFd);
+		}
+		error(STATUS_CODE_OUTPUT_ERROR);
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	
+	ExternalMerge merge = {0};
+	const ExternalRecord *record = NULL;
+	const char *payload = NULL;
+	StatusCode retValMerge = externalMergeStart(&merge, sorter->runFds, mergeCount);
+	while ((retValMerge == STATUS_CODE_SUCCESS) &&
+		   ((retValMerge = externalMergeNext(&merge, &record, &payload)) == STATUS_CODE_SUCCESS))
+	{
+		if (externalRunAppend(&outputWriter, record, payload) != STATUS_CODE_SUCCESS)
+		{
+			error(STATUS_CODE_OUTPUT_ERROR);
+			retValMerge = STATUS_CODE_OUTPUT_ERROR;
+		}
+	}
+	externalMergeFree(&merge);
+	if ((retValMerge == STATUS_CODE_END_OF_FILE) && (outputWriterFlush(&outputWriter) != STATUS_CODE_SUCCESS))
+	{
+		error(STATUS_CODE_OUTPUT_ERROR);
+		retValMerge = STATUS_CODE_OUTPUT_ERROR;
+	}
+	outputWriterFree(&outputWriter);
+	if (retValMerge != STATUS_CODE_END_OF_FILE)
+	{
+		close(runFd);
+		return retValMerge;
+	}
+	
+	//	## REPLACE THE MERGED RUNS ##
+	unsigned int runIndex = 0;
+	for (runIndex = 0; runIndex < mergeCount; runIndex++)
+	{
+		close(sorter->runFds[runIndex]);
+	}
+	memmove(sorter->runFds, sorter->runFds + mergeCount, (size_t) (sorter->runCount - mergeCount) * sizeof(int));
+	sorter->runCount -= mergeCount;
+	sorter->runFds[sorter->runCount++] = runFd;
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that finishes adding records to an ExternalSorter: the last records are written as a run,
+ * the memory of the collected records is released, and runs are merged until at most maxRunCount are left.
+ * @details Each merge pass merges up to fanIn runs - only as many as needed to get down to maxRunCount. A sorter
+ * with no records has a single (empty) run. The runs are then read through an ExternalMerge (or, if there is a
+ * single one, an ExternalRunReader).
+ * @param[in] sorter the sorter.
+ * @param[in] maxRunCount the maximal number of runs to leave. At least 1.
+ * @param[out] STATUS_CODE_SUCCESS If the runs were written and merged.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalSorterFinish(ExternalSorter *sorter, unsigned int maxRunCount)
+{
+	if ((sorter->recordCount > 0) || (sorter->runCount == 0))
+	{
+		StatusCode retValSpill = externalSorterSpill(sorter);
+		if (retValSpill != STATUS_CODE_SUCCESS)
+		{
+			return retValSpill;
+		}
+	}
+	free(sorter->records);
+	free(sorter->payloads);
+	sorter->records = NULL;
+	sorter->payloads = NULL;
+	sorter->recordCapacity = 0;
+	sorter->payloadCapacity = 0;
+	
+	while (sorter->runCount > maxRunCount)
+	{
+		unsigned int mergeCount = sorter->runCount - maxRunCount + 1;
+		StatusCode retValMerge = externalSorterMergeRuns(sorter, (mergeCount < sorter->fanIn) ? mergeCount :
+														 sorter->fanIn);
+		if (retValMerge != STATUS_CODE_SUCCESS)
+		{
+			return retValMerge;
+		}
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that releases the memory held by an ExternalSorter, and closes (so removes) its runs.
+ * @param[in] sorter the sorter to release. May be empty.
+ */
+static void externalSorterFree(ExternalSorter *sorter)
+{
+	unsigned int runIndex = 0;
+	for (runIndex = 0; runIndex < sorter->runCount; runIndex++)
+	{
+		close(sorter->runFds[runIndex]);
+	}
+	free(sorter->runFds);
+	free(sorter->records);
+	free(sorter->payloads);
+	memset(sorter, 0, sizeof(*sorter));
+}
+
+
+/**
+ * @brief A function that reads the peopleFile into an ExternalSorter, which sorts the people by ID.
+ * @details Every person is a record: its key is the ID (as personRadixKey orders it), its value the person's
+ * line - so people of the same ID keep their file order, as in the stable in-memory sort - and its payload
+ * the name. The lines are parsed and blank lines skipped as peopleReadMapped does. A compressed peopleFile is
+ * decompressed on the fly (see inputFileOpen).
+ * @param[in] peopleFilePath argv path for the peopleFile.
+ * @param[in] peopleSorter the sorter to add the people to.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If the peopleFile was read.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalSortPeople(const char *peopleFilePath, ExternalSorter *peopleSorter, RunStats *runStats)
+{
+	Decompressor decompressor = {0};
+	FILE *peopleFile = inputFileOpen(peopleFilePath, &decompressor);
+	if (peopleFile == NULL)
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	LineReader lineReader = {0};
+	StatusCode retValRead = lineReaderInit(&lineReader, peopleFile);
+	
+	const char *lineStart = NULL, *lineEnd = NULL;
+	Person personReceiver = {0};
+	ExternalRecord personRecord;
+	memset(&personRecord, 0, sizeof(personRecord));
+	while ((retValRead == STATUS_CODE_SUCCESS) &&
+		   ((retValRead = lineReaderNextLine(&lineReader, &lineStart, &lineEnd)) == STATUS_CODE_SUCCESS))
+	{
+		//	Blank lines are skipped:
+		lineStart = peopleLineStart(lineStart, lineEnd);
+		if (lineStart == lineEnd)
+		{
+			continue;
+		}
+		if (parseMappedPersonLine(&personReceiver, lineStart, lineStart, lineEnd) != STATUS_CODE_SUCCESS)
+		{
+			retValRead = STATUS_CODE_FAIL;
+			break;
+		}
+		personRecord.key = personRadixKey(&personReceiver, PERSON_SORT_BY_ID);
+		personRecord.value = peopleSorter->recordTotal;
+		personRecord.id = personReceiver.id;
+		personRecord.payloadLength = personReceiver.nameLength;
+		retValRead = externalSorterAdd(peopleSorter, &personRecord, lineStart);
+	}
+	runStatsCount(runStats, STATS_PHASE_PEOPLE, lineReader.bytesRead, peopleSorter->recordTotal, 0);
+	lineReaderFree(&lineReader);
+	
+	if ((inputFileClose(peopleFile, &decompressor) != STATUS_CODE_SUCCESS) && (retValRead == STATUS_CODE_END_OF_FILE))
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		retValRead = STATUS_CODE_INPUT_ERROR;
+	}
+	return (retValRead == STATUS_CODE_END_OF_FILE) ? STATUS_CODE_SUCCESS : retValRead;
+}
+
+
+/**
+ * @brief A function that adds the ID references of a block of meetings to the reference sorter.
+ * @details Meeting number k (from 1) refers to its infector at position 2k - 1, and to its infected at 2k (the
+ * verified carrier is position 0). The chances are calculated here by crnaBatch, and carried by the infected's
+ * references.
+ * @param[in] referenceSorter the sorter of the references.
+ * @param[in] meetingBlock the meetings: their IDs, distances and times.
+ * @param[in] meetingCount number of meetings in the block.
+ * @param[in] position the position of the last reference added. Advanced past the block.
+ * @param[out] STATUS_CODE_SUCCESS If the references were added.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalAddMeetingReferences(ExternalSorter *referenceSorter, const Meeting *meetingBlock,
+											   unsigned int meetingCount, unsigned long long *position)
+{
+	//	Cleared, as crnaBatch (in another module) may seem to read past meetingCount:
+	float distances[MEETING_BLOCK_SIZE] = {0}, times[MEETING_BLOCK_SIZE] = {0}, chances[MEETING_BLOCK_SIZE];
+	unsigned int meetingIndex = 0;
+	for (meetingIndex = 0; meetingIndex < meetingCount; meetingIndex++)
+	{
+		distances[meetingIndex] = meetingBlock[meetingIndex].distance;
+		times[meetingIndex] = meetingBlock[meetingIndex].time;
+	}
+	crnaBatch(distances, times, chances, meetingCount);
+	
+	ExternalRecord referenceRecord;
+	memset(&referenceRecord, 0, sizeof(referenceRecord));
+	StatusCode retValAdd = STATUS_CODE_SUCCESS;
+	for (meetingIndex = 0; (meetingIndex < meetingCount) && (retValAdd == STATUS_CODE_SUCCESS); meetingIndex++)
+	{
+		referenceRecord.id = meetingBlock[meetingIndex].infectorID;
+		referenceRecord.key = ((unsigned int) referenceRecord.id) ^ RADIX_SIGN_BIT;
+		referenceRecord.value = ++(*position);
+		referenceRecord.severity = 0;
+		retValAdd = externalSorterAdd(referenceSorter, &referenceRecord, NULL);
+		if (retValAdd == STATUS_CODE_SUCCESS)
+		{
+			referenceRecord.id = meetingBlock[meetingIndex].infectedID;
+			referenceRecord.key = ((unsigned int) referenceRecord.id) ^ RADIX_SIGN_BIT;
+			referenceRecord.value = ++(*position);
+			referenceRecord.severity = chances[meetingIndex];
+			retValAdd = externalSorterAdd(referenceSorter, &referenceRecord, NULL);
+		}
+	}
+	return retValAdd;
+}
+
+
+/**
+ * @brief A function that reads the meetingFile once, and adds every ID it refers to (with the position of the
+ * reference, see externalAddMeetingReferences) to the reference sorter.
+ * @details The lines are parsed as calculateSeverities parses them. An empty meetingFile has no references.
+ * @param[in] meetingFilePath argv path for the meetingFile (STDIN_PATH - stdin). May be compressed.
+ * @param[in] referenceSorter the sorter to add the references to.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If the meetingFile was read.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalCollectReferences(const char *meetingFilePath, ExternalSorter *referenceSorter,
+											RunStats *runStats)
+{
+	Decompressor decompressor = {0};
+	FILE *meetingFile = (strcmp(meetingFilePath, STDIN_PATH) == 0) ? stdin :
+						inputFileOpen(meetingFilePath, &decompressor);
+	if (meetingFile == NULL)
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	LineReader lineReader = {0};
+	StatusCode retValRead = lineReaderInit(&lineReader, meetingFile);
+	const char *lineStart = NULL, *lineEnd = NULL;
+	unsigned int infectorStatus = INFECTOR_OLD, blockCount = 0;
+	int infectorID = 0;
+	Meeting meetingBlock[MEETING_BLOCK_SIZE];
+	unsigned long long position = 0, lineCount = 0;
+	
+	//	The verified carrier's line - position 0:
+	if ((retValRead == STATUS_CODE_SUCCESS) &&
+		((retValRead = lineReaderNextLine(&lineReader, &lineStart, &lineEnd)) == STATUS_CODE_SUCCESS))
+	{
+		ExternalRecord spreaderRecord;
+		memset(&spreaderRecord, 0, sizeof(spreaderRecord));
+		infectorID = (int) parseDecimalInteger(&lineStart, lineEnd);
+		spreaderRecord.id = infectorID;
+		spreaderRecord.key = ((unsigned int) infectorID) ^ RADIX_SIGN_BIT;
+		lineCount++;
+		retValRead = externalSorterAdd(referenceSorter, &spreaderRecord, NULL);
+	}
+	
+	//	Parsing Line by Line (a block of lines at a time):
+	while ((retValRead == STATUS_CODE_SUCCESS) &&
+		   ((retValRead = lineReaderNextLine(&lineReader, &lineStart, &lineEnd)) == STATUS_CODE_SUCCESS))
+	{
+		if (parseMeetingLine(meetingBlock + blockCount, lineStart, lineEnd, &infectorStatus, &infectorID) !=
+			STATUS_CODE_SUCCESS)
+		{
+			retValRead = STATUS_CODE_FAIL;
+			break;
+		}
+		lineCount++;
+		if (++blockCount == MEETING_BLOCK_SIZE)
+		{
+			retValRead = externalAddMeetingReferences(referenceSorter, meetingBlock, blockCount, &position);
+			blockCount = 0;
+		}
+	}
+	if (retValRead == STATUS_CODE_END_OF_FILE)
+	{
+		StatusCode retValAdd = externalAddMeetingReferences(referenceSorter, meetingBlock, blockCount, &position);
+		retValRead = (retValAdd == STATUS_CODE_SUCCESS) ? STATUS_CODE_END_OF_FILE : retValAdd;
+	}
+	runStatsCount(runStats, STATS_PHASE_MEETINGS, lineReader.bytesRead, lineCount, 0);
+	lineReaderFree(&lineReader);
+	
+	if ((meetingFile != stdin) && (inputFileClose(meetingFile, &decompressor) != STATUS_CODE_SUCCESS) &&
+		(retValRead == STATUS_CODE_END_OF_FILE))
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		retValRead = STATUS_CODE_INPUT_ERROR;
+	}
+	return (retValRead == STATUS_CODE_END_OF_FILE) ? STATUS_CODE_SUCCESS : retValRead;
+}
+
+
+/**
+ * @brief A function that resolves the ID references of the meetings with a sort-merge join: the references,
+ * merged in ID order, are matched against the people run (sorted by ID).
+ * @details Every referenced ID gets a dense index, in ID order. A resolution record (its key - the position of
+ * the reference, its value - the dense index, and the chance the reference carries) is added to the
+ * resolution sorter, and the referenced IDs (key, dense index) are written to their own run, in ID order. An
+ * ID no person has is an input error, as in calculateSeverities.
+ * @param[in] peopleRunFd the people, sorted by ID, as a single run.
+ * @param[in] referenceSorter the sorter of the references. Finished.
+ * @param[in] resolutionSorter the sorter to add the resolutions to.
+ * @param[in] referencedRunFd set to the run of the referenced IDs. -1 if it wasn't created.
+ * @param[in] referencedCount set to the number of referenced IDs.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If every reference was resolved.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalJoinReferences(int peopleRunFd, ExternalSorter *referenceSorter,
+										 ExternalSorter *resolutionSorter, int *referencedRunFd,
+										 unsigned long long *referencedCount, RunStats *runStats)
+{
+	//	## INITIATE RESOURCES ##
+	ExternalRunReader peopleReader = {0};
+	ExternalMerge referenceMerge = {0};
+	OutputWriter referencedWriter = {0};
+	*referencedRunFd = externalRunCreate(resolutionSorter->directory);
+	if ((*referencedRunFd < 0) || (outputWriterInit(&referencedWriter, *referencedRunFd) != STATUS_CODE_SUCCESS))
+	{
+		error(STATUS_CODE_OUTPUT_ERROR);
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	StatusCode retValJoin = externalRunReaderInit(&peopleReader, peopleRunFd);
+	if (retValJoin == STATUS_CODE_SUCCESS)
+	{
+		retValJoin = externalMergeStart(&referenceMerge, referenceSorter->runFds, referenceSorter->runCount);
+	}
+	StatusCode retValPeople = (retValJoin == STATUS_CODE_SUCCESS) ? externalRunReaderNext(&peopleReader) :
+							  STATUS_CODE_FAIL;
+	
+	// ## JOIN ## - Both sides are in ID order, so each is read once:
+	const ExternalRecord *referenceRecord = NULL;
+	const char *payload = NULL;
+	ExternalRecord joinedRecord;
+	memset(&joinedRecord, 0, sizeof(joinedRecord));
+	joinedRecord.key = ULLONG_MAX;	// No key of an ID.
+	unsigned long long lookupCount = 0;
+	while ((retValJoin == STATUS_CODE_SUCCESS) &&
+		   ((retValJoin = externalMergeNext(&referenceMerge, &referenceRecord, &payload)) == STATUS_CODE_SUCCESS))
+	{
+		//	The first reference to an ID - advance the people to it:
+		if (referenceRecord->key != joinedRecord.key)
+		{
+			while ((retValPeople == STATUS_CODE_SUCCESS) && (peopleReader.record.key < referenceRecord->key))
+			{
+				retValPeople = externalRunReaderNext(&peopleReader);
+			}
+			if ((retValPeople != STATUS_CODE_SUCCESS) || (peopleReader.record.key != referenceRecord->key))
+			{
+				if (retValPeople != STATUS_CODE_FAIL)
+				{
+					error(STATUS_CODE_INPUT_ERROR);
+				}
+				retValJoin = STATUS_CODE_FAIL;
+				break;
+			}
+			joinedRecord.key = referenceRecord->key;
+			joinedRecord.value = (*referencedCount)++;
+			joinedRecord.id = referenceRecord->id;
+			lookupCount++;
+			if (externalRunAppend(&referencedWriter, &joinedRecord, NULL) != STATUS_CODE_SUCCESS)
+			{
+				error(STATUS_CODE_OUTPUT_ERROR);
+				retValJoin = STATUS_CODE_OUTPUT_ERROR;
+				break;
+			}
+		}
+		ExternalRecord resolutionRecord;
+		memset(&resolutionRecord, 0, sizeof(resolutionRecord));
+		resolutionRecord.key = referenceRecord->value;
+		resolutionRecord.value = joinedRecord.value;
+		resolutionRecord.severity = referenceRecord->severity;
+		retValJoin = externalSorterAdd(resolutionSorter, &resolutionRecord, NULL);
+	}
+	runStatsCount(runStats, STATS_PHASE_MEETINGS, 0, 0, lookupCount);
+	
+	//	## FREE RESOURCES ##
+	if ((retValJoin == STATUS_CODE_END_OF_FILE) && (outputWriterFlush(&referencedWriter) != STATUS_CODE_SUCCESS))
+	{
+		error(STATUS_CODE_OUTPUT_ERROR);
+		retValJoin = STATUS_CODE_OUTPUT_ERROR;
+	}
+	outputWriterFree(&referencedWriter);
+	externalMergeFree(&referenceMerge);
+	externalRunReaderFree(&peopleReader);
+	return (retValJoin == STATUS_CODE_END_OF_FILE) ? STATUS_CODE_SUCCESS : retValJoin;
+}
+
+
+/**
+ * @brief A function that applies the meetings in file order, from their resolved references.
+ * @details The resolutions are merged in position order - the order of the meetingFile - so every meeting
+ * sets the infected's severity to the infector's current severity * chance, exactly as calculateSeverities
+ * does. Only the severities of the referenced people are held in memory.
+ * @param[in] resolutionSorter the sorter of the resolutions. Finished.
+ * @param[in] severities the severity of every referenced person, by dense index. Must be zeroed.
+ * @param[out] STATUS_CODE_SUCCESS If the meetings were applied.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalApplyMeetings(ExternalSorter *resolutionSorter, float *severities)
+{
+	ExternalMerge resolutionMerge = {0};
+	const ExternalRecord *resolutionRecord = NULL;
+	const char *payload = NULL;
+	unsigned long long infector = 0;
+	StatusCode retValMerge = externalMergeStart(&resolutionMerge, resolutionSorter->runFds,
+												resolutionSorter->runCount);
+	while ((retValMerge == STATUS_CODE_SUCCESS) &&
+		   ((retValMerge = externalMergeNext(&resolutionMerge, &resolutionRecord, &payload)) == STATUS_CODE_SUCCESS))
+	{
+		if (resolutionRecord->key == 0)
+		{
+			severities[resolutionRecord->value] = MAX_SEVERITY;
+		}
+		else if ((resolutionRecord->key % 2) == 1)
+		{
+			infector = resolutionRecord->value;
+		}
+		else
+		{
+			severities[resolutionRecord->value] = severities[infector] * resolutionRecord->severity;
+		}
+	}
+	externalMergeFree(&resolutionMerge);
+	return (retValMerge == STATUS_CODE_END_OF_FILE) ? STATUS_CODE_SUCCESS : retValMerge;
+}
+
+
+/**
+ * @brief A function that attaches the severities to the people, and adds them to the output sorter in the
+ * order of the output file.
+ * @details The people run and the referenced IDs run are both in ID order, so they are read side by side. Only
+ * the first person of a referenced ID gets its severity, as the PeopleIndex finds the first. The key is the
+ * (severity, ID) order of the full output, descending - with the "No serious chance" people's severity
+ * ignored in OUTPUT_MODE_TIERS, so they come last in descending ID order - and the value is the person's
+ * position in the people run, descending: the order the in-memory sort gives when it is read backwards.
+ * @param[in] peopleRunFd the people, sorted by ID, as a single run.
+ * @param[in] referencedRunFd the run of the referenced IDs (see externalJoinReferences).
+ * @param[in] severities the severity of every referenced person, by dense index.
+ * @param[in] runOptions the options the program was run with.
+ * @param[in] outputSorter the sorter to add the people to.
+ * @param[out] STATUS_CODE_SUCCESS If the people were added.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalOrderPeople(int peopleRunFd, int referencedRunFd, const float *severities,
+									  const RunOptions *runOptions, ExternalSorter *outputSorter)
+{
+	ExternalRunReader peopleReader = {0}, referencedReader = {0};
+	StatusCode retValPeople = externalRunReaderInit(&peopleReader, peopleRunFd);
+	StatusCode retValReferenced = externalRunReaderInit(&referencedReader, referencedRunFd);
+	if ((retValPeople == STATUS_CODE_SUCCESS) && (retValReferenced == STATUS_CODE_SUCCESS))
+	{
+		retValReferenced = externalRunReaderNext(&referencedReader);
+	}
+	ExternalRecord outputRecord;
+	memset(&outputRecord, 0, sizeof(outputRecord));
+	Person outputPerson = {0};
+	unsigned long long sequence = 0;
+	while (((retValReferenced == STATUS_CODE_SUCCESS) || (retValReferenced == STATUS_CODE_END_OF_FILE)) &&
+		   (retValPeople == STATUS_CODE_SUCCESS) &&
+		   ((retValPeople = externalRunReaderNext(&peopleReader)) == STATUS_CODE_SUCCESS))
+	{
+		outputPerson.id = peopleReader.record.id;
+		outputPerson.severity = 0;
+		if ((retValReferenced == STATUS_CODE_SUCCESS) && (referencedReader.record.key == peopleReader.record.key))
+		{
+			outputPerson.severity = severities[referencedReader.record.value];
+			retValReferenced = externalRunReaderNext(&referencedReader);
+		}
+		unsigned long long severityKey = personRadixKey(&outputPerson, PERSON_SORT_BY_SEVERITY);
+		if ((runOptions->outputMode == OUTPUT_MODE_TIERS) && (outputPerson.severity < REGULAR_QUARANTINE_THRESHOLD))
+		{
+			severityKey = 0;
+		}
+		outputRecord.key = ~((severityKey << 32) | personRadixKey(&outputPerson, PERSON_SORT_BY_ID));
+		outputRecord.value = ~(sequence++);
+		outputRecord.id = outputPerson.id;
+		outputRecord.severity = outputPerson.severity;
+		outputRecord.payloadLength = peopleReader.record.payloadLength;
+		if (externalSorterAdd(outputSorter, &outputRecord, peopleReader.payload) != STATUS_CODE_SUCCESS)
+		{
+			retValPeople = STATUS_CODE_FAIL;
+		}
+	}
+	runStatsCount(runOptions->runStats, STATS_PHASE_ORDER, 0, sequence, 0);
+	externalRunReaderFree(&peopleReader);
+	externalRunReaderFree(&referencedReader);
+	if ((retValReferenced != STATUS_CODE_SUCCESS) && (retValReferenced != STATUS_CODE_END_OF_FILE))
+	{
+		return retValReferenced;
+	}
+	return (retValPeople == STATUS_CODE_END_OF_FILE) ? STATUS_CODE_SUCCESS : retValPeople;
+}
+
+
+/**
+ * @brief A function that writes the output file by the final merge of the output sorter's runs.
+ * @details In OUTPUT_MODE_TOP the merge stops after topCount people.
+ * @param[in] outputSorter the sorter of the output records. Finished.
+ * @param[in] runOptions the options the program was run with.
+ * @param[in] outputFilePath the path of the output file.
+ * @param[out] STATUS_CODE_SUCCESS if file was generated successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode externalWriteOutput(ExternalSorter *outputSorter, const RunOptions *runOptions,
+									  const char *outputFilePath)
+{
+	//	Create an empty file:
+	int outputFd = open(outputFilePath, O_WRONLY | O_CREAT | O_TRUNC, OUTPUT_FILE_MODE);
+	if (outputFd < 0)
+	{
+		error(STATUS_CODE_OUTPUT_ERROR);
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	OutputWriter outputWriter = {0};
+	if (outputWriterInit(&outputWriter, outputFd) != STATUS_CODE_SUCCESS)
+	{
+		close(outputFd);
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	
+	// Write the people, from the most severe person:
+	ExternalMerge outputMerge = {0};
+	const ExternalRecord *outputRecord = NULL;
+	const char *name = NULL;
+	unsigned long long outputCount = 0;
+	unsigned long long outputLimit = (runOptions->outputMode == OUTPUT_MODE_TOP) ? runOptions->topCount : ULLONG_MAX;
+	StatusCode retValWrite = externalMergeStart(&outputMerge, outputSorter->runFds, outputSorter->runCount);
+	while ((retValWrite == STATUS_CODE_SUCCESS) && (outputCount < outputLimit) &&
+		   ((retValWrite = externalMergeNext(&outputMerge, &outputRecord, &name)) == STATUS_CODE_SUCCESS))
+	{
+		retValWrite = outputWriterAppendLine(&outputWriter, outputRecord->severity, name,
+											 outputRecord->payloadLength, outputRecord->id);
+		outputCount++;
+	}
+	externalMergeFree(&outputMerge);
+	if ((retValWrite == STATUS_CODE_SUCCESS) || (retValWrite == STATUS_CODE_END_OF_FILE))
+	{
+		retValWrite = outputWriterFlush(&outputWriter);
+	}
+	runStatsCount(runOptions->runStats, STATS_PHASE_OUTPUT, outputWriter.bytesWritten, outputCount, 0);
+	outputWriterFree(&outputWriter);
+	
+	if ((close(outputFd) != 0) || (retValWrite != STATUS_CODE_SUCCESS))
+	{
+		if (retValWrite != STATUS_CODE_FAIL)
+		{
+			error(STATUS_CODE_OUTPUT_ERROR);
+		}
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief The external-memory mode: processes the peopleFile and the meetingFile within runOptions->memoryBudget
+ * bytes, however large they are, and writes the same output file the in-memory run does.
+ * @details Nothing is indexed in memory: the people are sorted by ID with an external merge sort, and the IDs
+ * the meetings refer to are resolved by a sort-merge join against them (see externalJoinReferences). The
+ * meetings are then applied in file order, holding only the severities of the people met, and the output is
+ * written by the final merge of an external sort in output order. The sorted runs are unlinked temporary files
+ * in the directory of the output file.
+ * @param[in] peopleFilePath argv path for the peopleFile. May be compressed.
+ * @param[in] meetingFilePath argv path for the meetingFile (STDIN_PATH - stdin). May be compressed.
+ * @param[in] outputFilePath the path of the output file (the program writes OUTPUT_FILE).
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If processing was successfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode spreaderDetectorExternal(const char *peopleFilePath, const char *meetingFilePath,
+									const char *outputFilePath, const RunOptions *runOptions)
+{
+	// ## INITIATE RESOURCES ## - the runs are written next to the output file:
+	const char *directoryEnd = strrchr(outputFilePath, '/');
+	size_t directoryLength = (directoryEnd != NULL) ? (size_t) (directoryEnd - outputFilePath) : 1;
+	char *directory = (char *) malloc(directoryLength + 1);
+	if (directory == NULL)
+	{
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	memcpy(directory, (directoryEnd != NULL) ? outputFilePath : ".", directoryLength);
+	directory[directoryLength] = '\0';
+	unsigned long long memoryBudget = runOptions->memoryBudget, referencedCount = 0;
+	ExternalSorter peopleSorter = {0}, referenceSorter = {0}, resolutionSorter = {0}, outputSorter = {0};
+	int referencedRunFd = -1;
+	float *severities = NULL;
+	
+	// ## PROCESS PEOPLE ## - (PeopleFile READ) && (people SORT by ID, to a single run)
+	runStatsPhaseStart(runOptions->runStats);
+	StatusCode retValRun = externalSorterInit(&peopleSorter, memoryBudget, directory);
+	if (retValRun == STATUS_CODE_SUCCESS)
+	{
+		retValRun = externalSortPeople(peopleFilePath, &peopleSorter, runOptions->runStats);
+	}
+	if ((retValRun == STATUS_CODE_SUCCESS) && (peopleSorter.recordTotal == 0))
+	{
+		runStatsPhaseEnd(runOptions->runStats, STATS_PHASE_PEOPLE);
+		externalSorterFree(&peopleSorter);
+		free(directory);
+		return (generateEmptyOutputFile(outputFilePath) == STATUS_CODE_SUCCESS) ? STATUS_CODE_SUCCESS :
+			   STATUS_CODE_FAIL;
+	}
+	if (retValRun == STATUS_CODE_SUCCESS)
+	{
+		retValRun = externalSorterFinish(&peopleSorter, 1);
+	}
+	if (retValRun == STATUS_CODE_SUCCESS)
+	{
+		runStatsPhaseEnd(runOptions->runStats, STATS_PHASE_PEOPLE);
+		
+		// ## PROCESS MEETINGS ## - (MeetingFile READ) && (IDs JOIN) && (Chances Calculations, in file order)
+		runStatsPhaseStart(runOptions->runStats);
+		retValRun = externalSorterInit(&referenceSorter, memoryBudget, directory);
+	}
+	if (retValRun == STATUS_CODE_SUCCESS)
+	{
+		retValRun = externalCollectReferences(meetingFilePath, &referenceSorter, runOptions->runStats);
+	}
+	if (retValRun == STATUS_CODE_SUCCESS)
+	{
+		retValRun = externalSorterFinish(&referenceSorter, referenceSorter.fanIn / 2);
+	}
+	if (retValRun == STATUS_CODE_SUCCESS)
+	{
+		retValRun = externalSorterInit(&resolutionSorter, memoryBudget / 2, directory);
+	}
+	if (retValRun == STATUS_CODE_SUCCESS)
+	{
+		retValRun = externalJoinReferences(peopleSorter.runFds[0], &referenceSorter, &resolutionSorter,
+										   &referencedRunFd, &referencedCount, runOptions->runStats);
+	}
+	externalSorterFree(&referenceSorter);
+	if (retValRun == STATUS_CODE_SUCCESS)
+	{
+		retValRun = externalSorterFinish(&resolutionSorter, resolutionSorter.fanIn);
+	}
+	if (retValRun == STATUS_CODE_SUCCESS)
+	{
+		severities = (float *) calloc((referencedCount > 0) ? referencedCount : 1, sizeof(float));
+		if (severities == NULL)
+		{
+			error(STATUS_CODE_FAIL);
+			retValRun = STATUS_CODE_FAIL;
+		}
+	}
+	if (retValRun == STATUS_CODE_SUCCESS)
+	{
+		retValRun = externalApplyMeetings(&resolutionSorter, severities);
+	}
+	externalSorterFree(&resolutionSorter);
+	if (retValRun == STATUS_CODE_SUCCESS)
+	{
+		runStatsPhaseEnd(runOptions->runStats, STATS_PHASE_MEETINGS);
+		
+		// ## ORDER PEOPLE ## - (people SORT by chances, to at most fanIn runs)
+		runStatsPhaseStart(runOptions->runStats);
+		retValRun = externalSorterInit(&outputSorter, memoryBudget, directory);
+	}
+	if (retValRun == STATUS_CODE_SUCCESS)
+	{
+		retValRun = externalOrderPeople(peopleSorter.runFds[0], referencedRunFd, severities, runOptions,
+										&outputSorter);
+	}
+	free(severities);
+	externalSorterFree(&peopleSorter);
+	if (referencedRunFd >= 0)
+	{
+		close(referencedRunFd);
+	}
+	if (retValRun == STATUS_CODE_SUCCESS)
+	{
+		retValRun = externalSorterFinish(&outputSorter, outputSorter.fanIn);
+	}
+	if (retValRun == STATUS_CODE_SUCCESS)
+	{
+		runStatsPhaseEnd(runOptions->runStats, STATS_PHASE_ORDER);
+		
+		//	## GENERATE OUTPUT FILE ## - (the final merge)
+		runStatsPhaseStart(runOptions->runStats);
+		retValRun = externalWriteOutput(&outputSorter, runOptions, outputFilePath);
+	}
+	if (retValRun == STATUS_CODE_SUCCESS)
+	{
+		runStatsPhaseEnd(runOptions->runStats, STATS_PHASE_OUTPUT);
+	}
+	
+	//	## FREE RESOURCES ##
+	externalSorterFree(&outputSorter);
+	free(directory);
+	return (retValRun == STATUS_CODE_SUCCESS) ? STATUS_CODE_SUCCESS : STATUS_CODE_FAIL;
+}
+
+
@@ -0,0 +1,1147 @@
+/*
+ * File Name: SpreaderDetectorGraph.c
+ * Related Files: "SpreaderDetectorGraph.h", "SpreaderDetectorInternal.h"
+ *
+ * Purpose:
+ * 			This file is the graph engine of the SpreaderDetector library: the contact graph, the propagation of
+ * 			the severities level by level, and the delta state of graph runs.
+ *
+ * Author's ID: 206174120
+ * Author's Name: Oren Kovartovsky
+ * University User Name: orenkov
+ *
+ * */
+
+#include "SpreaderDetectorGraph.h"
+#include "SpreaderDetectorOutput.h"
+#include "SpreaderDetectorMeetings.h"
+
+
+/*
+ * ***********************
+ * 	DECLARATIONS
+ * ***********************
+ */
+//	****** COMPARISON FUNCTIONS ******
+/**
+ * @brief compares between 2 level keys - a level in the high 32 bits, and a person's position in the low ones.
+ *
+ * @param[in] keyA a void pointer, represents pointer to 1st unsigned long long key to compare.
+ * @param[in] keyB a void pointer, represents pointer to 2nd unsigned long long key to compare.
+ * @return integer: 0 if equal, negative integer if keyA is smaller than keyB,
+ * and positive integer if keyA is bigger than keyB.
+ */
+static int levelKeyCompare(const void* keyA, const void* keyB);
+
+
+//	****** CONTACT GRAPH FUNCTIONS ******
+/**
+ * @brief A function that builds the CSR contact graph out of the parsed meeting chunks.
+ *
+ * @details The out-edges of every person are grouped together (a counting sort by infector), keeping their
+ * file order. Each chunk's edges are released once they are copied.
+ * @note The function ALLOCATES MEMORY being stored in contactGraph. released by contactGraphFree.
+ * @param[in] contactGraph the graph to build.
+ * @param[in] parallelIngest the ingest whose chunks hold the edges.
+ * @param[in] peopleCounter the amount of the people that were recorded.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If the graph was built successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode contactGraphBuild(ContactGraph *contactGraph, ParallelIngest *parallelIngest,
+									unsigned int peopleCounter, RunStats *runStats);
+
+/**
+ * @brief A function that parses meeting lines into a contact graph, on a ParallelIngest.
+ *
+ * @note The function ALLOCATES MEMORY being stored in contactGraph. released by contactGraphFree, even in failure.
+ * @param[in] contactGraph the graph to build.
+ * @param[in] meetingShards the shards of meeting lines, in order. If all are empty, the graph has no edges.
+ * @param[in] shardCount number of shards.
+ * @param[in] peopleArray the array of people, sorted by ID.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] threadCount number of threads to parse with.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If the graph was built.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode contactGraphParse(ContactGraph *contactGraph, const MeetingShard *meetingShards,
+									unsigned int shardCount, Person *peopleArray, const PeopleIndex *peopleIndex,
+									unsigned int peopleCounter, unsigned int threadCount, RunStats *runStats);
+
+/**
+ * @brief A function that merges two contact graphs over the same people: the out-edges of every person are
+ * his edges in base, followed by his edges in added.
+ *
+ * @note The function ALLOCATES MEMORY being stored in mergedGraph. released by contactGraphFree, even in failure.
+ * @param[in] baseGraph the first graph.
+ * @param[in] addedGraph the second graph. Must have the same vertexCount.
+ * @param[in] mergedGraph the merged graph. Being allocated.
+ * @param[out] STATUS_CODE_SUCCESS If the graphs were merged.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed, or there are too many edges.
+ */
+static StatusCode contactGraphMerge(const ContactGraph *baseGraph, const ContactGraph *addedGraph,
+									ContactGraph *mergedGraph);
+
+/**
+ * @brief A function that builds the reverse of a contact graph: the out-edges of every person in the reverse
+ * graph are his in-edges in the graph, so its targets hold the infectors.
+ *
+ * @note The function ALLOCATES MEMORY being stored in reverseGraph. released by contactGraphFree, even in failure.
+ * @param[in] contactGraph the graph.
+ * @param[in] reverseGraph the reverse graph. Being allocated.
+ * @param[out] STATUS_CODE_SUCCESS If the graph was reversed.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+static StatusCode contactGraphReverse(const ContactGraph *contactGraph, ContactGraph *reverseGraph);
+
+/**
+ * @brief A function that releases the memory held by the ContactGraph.
+ *
+ * @param[in] contactGraph the graph to release. May be partially built.
+ */
+static void contactGraphFree(ContactGraph *contactGraph);
+
+/**
+ * @brief A function that expands one slice of the BFS frontier by one level.
+ *
+ * @details Every out-edge of the slice's people (at level nextLevel - 1) reaches a person who is either
+ * unvisited - and is claimed for nextLevel - or already at nextLevel. In both cases the person's severity is
+ * raised to the edge's infector severity * chance, if it is higher. Both updates are atomic, since the other
+ * slices of the level update the same arrays.
+ * @param[in] frontierSlice the slice to expand. Its nextFrontier receives the people it claimed.
+ */
+static void propagateFrontierSlice(FrontierSlice *frontierSlice);
+
+/**
+ * @brief The function run by each thread expanding a frontier slice.
+ *
+ * @param[in] frontierSlice a pointer to the FrontierSlice to expand.
+ * @return NULL.
+ */
+static void *propagateFrontierWorker(void *frontierSlice);
+
+/**
+ * @brief A function that propagates severities over the contact graph, one BFS level at a time.
+ *
+ * @details A person's level is his distance (in meetings) from the verified carrier, and his severity is the
+ * highest severity * crna over his meetings with people of the previous level. Each level's frontier is split
+ * across threads (when it is large enough to be worth it); the levels themselves run one after the other.
+ * The result doesn't depend on the order of the meetings in the file, or on the number of threads.
+ * @param[in] contactGraph the contact graph.
+ * @param[in] peopleArray the array of people. The severities are updated in place.
+ * @param[in] spreader the position of the verified carrier, whose severity is already set.
+ * @param[in] levels receives the level of every person (UNVISITED_LEVEL if he wasn't reached).
+ * @param[in] threadCount maximal number of threads to expand a frontier with.
+ * @param[out] STATUS_CODE_SUCCESS If propagation was successful.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode propagateSeveritiesByLevel(const ContactGraph *contactGraph, Person *peopleArray,
+											 unsigned int spreader, unsigned int *levels, unsigned int threadCount);
+
+
+//	****** DELTA STATE FUNCTIONS ******
+/**
+ * @brief A function that saves the result of a graph run as a delta state, which a later delta run
+ * continues from (see calculateSeveritiesDelta).
+ *
+ * @details Layout: a DeltaStateHeader, and the sections it describes. The file is written next to statePath
+ * and renamed over it only once complete.
+ * @param[in] statePath the path of the state.
+ * @param[in] contactGraph the contact graph of all the meetings so far.
+ * @param[in] peopleArray the array of people, sorted by ID, with their severities calculated.
+ * @param[in] levels the BFS level of every person.
+ * @param[in] spreader the position of the verified carrier. DELTA_STATE_NO_SPREADER - none.
+ * @param[out] STATUS_CODE_SUCCESS If the state was written.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode deltaStateWrite(const char *statePath, const ContactGraph *contactGraph, const Person *peopleArray,
+								  const unsigned int *levels, unsigned int spreader);
+
+/**
+ * @brief A function that maps a delta state (see deltaStateWrite), and validates it against the people.
+ *
+ * @details The mapping is private and writable, like a people snapshot's, and the state's arrays point
+ * straight into it. It must have been saved with the same people (the same IDs, in the same order).
+ * @note The function ALLOCATES MEMORY being stored in deltaState. released by deltaStateFree, even in failure.
+ * @param[in] statePath the path of the state.
+ * @param[in] peopleArray the array of people, sorted by ID.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] deltaState the loaded state.
+ * @param[out] STATUS_CODE_SUCCESS If the state was loaded.
+ * @param[out] STATUS_CODE_INPUT_ERROR If the state couldn't be mapped, is invalid, or is of other people.
+ */
+static StatusCode deltaStateLoad(const char *statePath, const Person *peopleArray, unsigned int peopleCounter,
+								 DeltaState *deltaState);
+
+/**
+ * @brief A function that releases a delta state loaded by deltaStateLoad.
+ *
+ * @param[in] deltaState the state to release. May be partially loaded.
+ */
+static void deltaStateFree(DeltaState *deltaState);
+
+/**
+ * @brief A function that recalculates the levels and severities of the people downstream of newly added
+ * meetings, leaving everybody else as they were.
+ *
+ * @details The region is every person reachable from a target of an added meeting (not through the verified
+ * carrier). Nobody outside it has a new meeting on any of his shortest paths from the carrier, so his level
+ * and severity can't change. The region is cleared, its people are seeded with the lowest level their
+ * infectors outside the region give them, and a BFS which merges the seeds (in level order) with its own
+ * queue settles their levels. The severities are then calculated in the order the BFS settled the people,
+ * as propagateSeveritiesByLevel would: the highest infector severity * chance over the in-meetings from
+ * the previous level.
+ * @param[in] contactGraph the contact graph of all the meetings, the added ones included.
+ * @param[in] reverseGraph the reverse of contactGraph (see contactGraphReverse).
+ * @param[in] addedGraph the contact graph of the added meetings only.
+ * @param[in] peopleArray the array of people, with the severities of the previous run. Updated in place.
+ * @param[in] levels the levels of the previous run. Updated in place.
+ * @param[in] spreader the position of the verified carrier.
+ * @param[in] regionSize set to the number of people who were recalculated.
+ * @param[out] STATUS_CODE_SUCCESS If the region was recalculated.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+static StatusCode repropagateDownstream(const ContactGraph *contactGraph, const ContactGraph *reverseGraph,
+										const ContactGraph *addedGraph, Person *peopleArray, unsigned int *levels,
+										unsigned int spreader, unsigned int *regionSize);
+
+
+/*
+ * ***********************
+ * 	DEFINITIONS
+ * ***********************
+ */
+/**
+ * @brief compares between 2 level keys - a level in the high 32 bits, and a person's position in the low ones.
+ * @param[in] keyA a void pointer, represents pointer to 1st unsigned long long key to compare.
+ * @param[in] keyB a void pointer, represents pointer to 2nd unsigned long long key to compare.
+ * @return integer: 0 if equal, negative integer if keyA is smaller than keyB,
+ * and positive integer if keyA is bigger than keyB.
+ */
+static int levelKeyCompare(const void* keyA, const void* keyB)
+{
+	unsigned long long kA = *(const unsigned long long *) keyA;
+	unsigned long long kB = *(const unsigned long long *) keyB;
+	return ((kA > kB) - (kA < kB));
+}
+
+
+/**
+ * @brief A function that builds the CSR contact graph out of the parsed meeting chunks.
+ * @details The out-edges of every person are grouped together (a counting sort by infector), keeping their
+ * file order. Each chunk's edges are released once they are copied.
+ * @note The function ALLOCATES MEMORY being stored in contactGraph. released by contactGraphFree.
+ * @param[in] contactGraph the graph to build.
+ * @param[in] parallelIngest the ingest whose chunks hold the edges.
+ * @param[in] peopleCounter the amount of the people that were recorded.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If the graph was built successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode contactGraphBuild(ContactGraph *contactGraph, ParallelIngest *parallelIngest,
+									unsigned int peopleCounter, RunStats *runStats)
+{
+	contactGraph->vertexCount = peopleCounter;
+	contactGraph->edgeOffsets = (unsigned int *) calloc((size_t) peopleCounter + 1, sizeof(unsigned int));
+	if (contactGraph->edgeOffsets == NULL)
+	{
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	
+	// ## COUNT OUT-DEGREES ## - (edgeOffsets[v + 1] holds the out-degree of v)
+	unsigned long edgeCount = 0;
+	unsigned int chunkIndex = 0, edgeIndex = 0;
+	for (chunkIndex = 0; chunkIndex < parallelIngest->chunkCount; chunkIndex++)
+	{
+		MeetingChunk *meetingChunk = parallelIngestWaitChunk(parallelIngest, chunkIndex);
+		if (meetingChunk->status != STATUS_CODE_SUCCESS)
+		{
+			error(meetingChunk->status);
+			return STATUS_CODE_FAIL;
+		}
+		runStatsCount(runStats, STATS_PHASE_MEETINGS, (unsigned long long) (meetingChunk->end - meetingChunk->start),
+					  meetingChunk->edgeCount, meetingChunk->lookupCount);
+		for (edgeIndex = 0; edgeIndex < meetingChunk->edgeCount; edgeIndex++)
+		{
+			contactGraph->edgeOffsets[meetingChunk->edges[edgeIndex].infector + 1]++;
+		}
+		edgeCount += meetingChunk->edgeCount;
+	}
+	if (edgeCount > UINT_MAX)
+	{
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	contactGraph->edgeCount = (unsigned int) edgeCount;
+	
+	// ## PREFIX SUM ## - (edgeOffsets[v] is now the first out-edge of v)
+	unsigned int vertex = 0;
+	for (vertex = 0; vertex < peopleCounter; vertex++)
+	{
+		contactGraph->edgeOffsets[vertex + 1] += contactGraph->edgeOffsets[vertex];
+	}
+	contactGraph->targets = (unsigned int *) malloc(((size_t) edgeCount + 1) * sizeof(unsigned int));
+	contactGraph->chances = (float *) malloc(((size_t) edgeCount + 1) * sizeof(float));
+	if ((contactGraph->targets == NULL) || (contactGraph->chances == NULL))
+	{
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	
+	// ## FILL ## - edgeOffsets[v] is used as the insertion cursor of v, ending at the first out-edge of v + 1:
+	for (chunkIndex = 0; chunkIndex < parallelIngest->chunkCount; chunkIndex++)
+	{
+		MeetingChunk *meetingChunk = parallelIngest->chunks + chunkIndex;
+		for (edgeIndex = 0; edgeIndex < meetingChunk->edgeCount; edgeIndex++)
+		{
+			const MeetingEdge *meetingEdge = meetingChunk->edges + edgeIndex;
+			unsigned int position = contactGraph->edgeOffsets[meetingEdge->infector]++;
+			contactGraph->targets[position] = meetingEdge->infected;
+			contactGraph->chances[position] = meetingEdge->chance;
+		}
+		free(meetingChunk->edges);
+		meetingChunk->edges = NULL;
+	}
+	for (vertex = peopleCounter; vertex > 0; vertex--)
+	{
+		contactGraph->edgeOffsets[vertex] = contactGraph->edgeOffsets[vertex - 1];
+	}
+	contactGraph->edgeOffsets[0] = 0;
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that parses meeting lines into a contact graph, on a ParallelIngest.
+ * @note The function ALLOCATES MEMORY being stored in contactGraph. released by contactGraphFree, even in failure.
+ * @param[in] contactGraph the graph to build.
+ * @param[in] meetingShards the shards of meeting lines, in order. If all are empty, the graph has no edges.
+ * @param[in] shardCount number of shards.
+ * @param[in] peopleArray the array of people, sorted by ID.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] threadCount number of threads to parse with.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If the graph was built.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode contactGraphParse(ContactGraph *contactGraph, const MeetingShard *meetingShards,
+									unsigned int shardCount, Person *peopleArray, const PeopleIndex *peopleIndex,
+									unsigned int peopleCounter, unsigned int threadCount, RunStats *runStats)
+{
+	ParallelIngest parallelIngest = {0};
+	if (parallelIngestStart(&parallelIngest, meetingShards, shardCount, peopleArray, peopleIndex, threadCount) !=
+		STATUS_CODE_SUCCESS)
+	{
+		return STATUS_CODE_FAIL;
+	}
+	StatusCode retValBuild = contactGraphBuild(contactGraph, &parallelIngest, peopleCounter, runStats);
+	parallelIngestStop(&parallelIngest);
+	return retValBuild;
+}
+
+
+/**
+ * @brief A function that merges two contact graphs over the same people: the out-edges of every person are
+ * his edges in base, followed by his edges in added.
+ * @note The function ALLOCATES MEMORY being stored in mergedGraph. released by contactGraphFree, even in failure.
+ * @param[in] baseGraph the first graph.
+ * @param[in] addedGraph the second graph. Must have the same vertexCount.
+ * @param[in] mergedGraph the merged graph. Being allocated.
+ * @param[out] STATUS_CODE_SUCCESS If the graphs were merged.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed, or there are too many edges.
+ */
+static StatusCode contactGraphMerge(const ContactGraph *baseGraph, const ContactGraph *addedGraph,
+									ContactGraph *mergedGraph)
+{
+	unsigned long edgeCount = (unsigned long) baseGraph->edgeCount + addedGraph->edgeCount;
+	mergedGraph->vertexCount = baseGraph->vertexCount;
+	mergedGraph->edgeOffsets = (unsigned int *) malloc(((size_t) baseGraph->vertexCount + 1) * sizeof(unsigned int));
+	mergedGraph->targets = (unsigned int *) malloc(((size_t) edgeCount + 1) * sizeof(unsigned int));
+	mergedGraph->chances = (float *) malloc(((size_t) edgeCount + 1) * sizeof(float));
+	if ((edgeCount > UINT_MAX) || (mergedGraph->edgeOffsets == NULL) || (mergedGraph->targets == NULL) ||
+		(mergedGraph->chances == NULL))
+	{
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	mergedGraph->edgeCount = (unsigned int) edgeCount;
+	
+	unsigned int vertex = 0, position = 0;
+	for (vertex = 0; vertex < baseGraph->vertexCount; vertex++)
+	{
+		unsigned int baseStart = baseGraph->edgeOffsets[vertex];
+		unsigned int baseCount = baseGraph->edgeOffsets[vertex + 1] - baseStart;
+		unsigned int addedStart = addedGraph->edgeOffsets[vertex];
+		unsigned int addedCount = addedGraph->edgeOffsets[vertex + 1] - addedStart;
+		mergedGraph->edgeOffsets[vertex] = position;
+		memcpy(mergedGraph->targets + position, baseGraph->targets + baseStart, baseCount * sizeof(unsigned int));
+		memcpy(mergedGraph->chances + position, baseGraph->chances + baseStart, baseCount * sizeof(float));
+		position += baseCount;
+		memcpy(mergedGraph->targets + position, addedGraph->targets + addedStart, addedCount * sizeof(unsigned int));
+		memcpy(mergedGraph->chances + position, addedGraph->chances + addedStart, addedCount * sizeof(float));
+		position += addedCount;
+	}
+	mergedGraph->edgeOffsets[baseGraph->vertexCount] = position;
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that builds the reverse of a contact graph: the out-edges of every person in the reverse
+ * graph are his in-edges in the graph, so its targets hold the infectors.
+ * @note The function ALLOCATES MEMORY being stored in reverseGraph. released by contactGraphFree, even in failure.
+ * @param[in] contactGraph the graph.
+ * @param[in] reverseGraph the reverse graph. Being allocated.
+ * @param[out] STATUS_CODE_SUCCESS If the graph was reversed.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+static StatusCode contactGraphReverse(const ContactGraph *contactGraph, ContactGraph *reverseGraph)
+{
+	unsigned int vertexCount = contactGraph->vertexCount;
+	reverseGraph->vertexCount = vertexCount;
+	reverseGraph->edgeCount = contactGraph->edgeCount;
+	reverseGraph->edgeOffsets = (unsigned int *) calloc((size_t) vertexCount + 1, sizeof(unsigned int));
+	reverseGraph->targets = (unsigned int *) malloc(((size_t) contactGraph->edgeCount + 1) * sizeof(unsigned int));
+	reverseGraph->chances = (float *) malloc(((size_t) contactGraph->edgeCount + 1) * sizeof(float));
+	if ((reverseGraph->edgeOffsets == NULL) || (reverseGraph->targets == NULL) || (reverseGraph->chances == NULL))
+	{
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	
+	// ## COUNT IN-DEGREES ## - then the same prefix sum and fill as contactGraphBuild:
+	unsigned int vertex = 0, edgeIndex = 0;
+	for (edgeIndex = 0; edgeIndex < contactGraph->edgeCount; edgeIndex++)
+	{
+		reverseGraph->edgeOffsets[contactGraph->targets[edgeIndex] + 1]++;
+	}
+	for (vertex = 0; vertex < vertexCount; vertex++)
+	{
+		reverseGraph->edgeOffsets[vertex + 1] += reverseGraph->edgeOffsets[vertex];
+	}
+	for (vertex = 0; vertex < vertexCount; vertex++)
+	{
+		for (edgeIndex = contactGraph->edgeOffsets[vertex]; edgeIndex < contactGraph->edgeOffsets[vertex + 1];
+			 edgeIndex++)
+		{
+			unsigned int position = reverseGraph->edgeOffsets[contactGraph->targets[edgeIndex]]++;
+			reverseGraph->targets[position] = vertex;
+			reverseGraph->chances[position] = contactGraph->chances[edgeIndex];
+		}
+	}
+	for (vertex = vertexCount; vertex > 0; vertex--)
+	{
+		reverseGraph->edgeOffsets[vertex] = reverseGraph->edgeOffsets[vertex - 1];
+	}
+	reverseGraph->edgeOffsets[0] = 0;
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that releases the memory held by the ContactGraph.
+ * @param[in] contactGraph the graph to release. May be partially built.
+ */
+static void contactGraphFree(ContactGraph *contactGraph)
+{
+	free(contactGraph->edgeOffsets);
+	free(contactGraph->targets);
+	free(contactGraph->chances);
+	contactGraph->edgeOffsets = NULL;
+	contactGraph->targets = NULL;
+	contactGraph->chances = NULL;
+	contactGraph->vertexCount = 0;
+	contactGraph->edgeCount = 0;
+}
+
+
+/**
+ * @brief A function that expands one slice of the BFS frontier by one level.
+ * @details Every out-edge of the slice's people (at level nextLevel - 1) reaches a person who is either
+ * unvisited - and is claimed for nextLevel - or already at nextLevel. In both cases the person's severity is
+ * raised to the edge's infector severity * chance, if it is higher. Both updates are atomic, since the other
+ * slices of the level update the same arrays.
+ * @param[in] frontierSlice the slice to expand. Its nextFrontier receives the people it claimed.
+ */
+static void propagateFrontierSlice(FrontierSlice *frontierSlice)
+{
+	const ContactGraph *contactGraph = frontierSlice->contactGraph;
+	Person *peopleArray = frontierSlice->peopleArray;
+	unsigned int frontierIndex = 0, edgeIndex = 0;
+	
+	frontierSlice->nextCount = 0;
+	frontierSlice->status = STATUS_CODE_SUCCESS;
+	for (frontierIndex = 0; frontierIndex < frontierSlice->frontierSize; frontierIndex++)
+	{
+		unsigned int infector = frontierSlice->frontier[frontierIndex];
+		float infectorSeverity = peopleArray[infector].severity;	// Final - set on the previous level.
+		for (edgeIndex = contactGraph->edgeOffsets[infector]; edgeIndex < contactGraph->edgeOffsets[infector + 1];
+			 edgeIndex++)
+		{
+			unsigned int infected = contactGraph->targets[edgeIndex];
+			unsigned int infectedLevel = UNVISITED_LEVEL;
+			if (__atomic_compare_exchange_n(frontierSlice->levels + infected, &infectedLevel,
+											frontierSlice->nextLevel, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			{
+				// ## MEMORY ALLOCATION ## - (Dynamic Array)
+				if (frontierSlice->nextCount == frontierSlice->nextCapacity)
+				{
+					unsigned int newCapacity = (frontierSlice->nextCapacity == 0) ? FRONTIER_INITIAL_CAPACITY :
+											   (2 * frontierSlice->nextCapacity);
+					unsigned int *temporaryFrontierPointer =
+						(unsigned int *) realloc(frontierSlice->nextFrontier, newCapacity * sizeof(unsigned int));
+					if (temporaryFrontierPointer == NULL)
+					{
+						frontierSlice->status = STATUS_CODE_FAIL;
+						return;
+					}
+					frontierSlice->nextFrontier = temporaryFrontierPointer;
+					frontierSlice->nextCapacity = newCapacity;
+				}
+				frontierSlice->nextFrontier[frontierSlice->nextCount++] = infected;
+			}
+			else if (infectedLevel != frontierSlice->nextLevel)
+			{
+				continue;	// Reached on an earlier level.
+			}
+			
+			//	Atomic max of the infected severity:
+			float candidate = infectorSeverity * contactGraph->chances[edgeIndex];
+			float current = 0;
+			__atomic_load(&peopleArray[infected].severity, &current, __ATOMIC_RELAXED);
+			while ((candidate > current) &&
+				   !__atomic_compare_exchange(&peopleArray[infected].severity, &current, &candidate, 0,
+											  __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			{
+				continue;
+			}
+		}
+	}
+}
+
+
+/**
+ * @brief The function run by each thread expanding a frontier slice.
+ * @param[in] frontierSlice a pointer to the FrontierSlice to expand.
+ * @return NULL.
+ */
+static void *propagateFrontierWorker(void *frontierSlice)
+{
+	propagateFrontierSlice((FrontierSlice *) frontierSlice);
+	return NULL;
+}
+
+
+/**
+ * @brief A function that propagates severities over the contact graph, one BFS level at a time.
+ * @details A person's level is his distance (in meetings) from the verified carrier, and his severity is the
+ * highest severity * crna over his meetings with people of the previous level. Each level's frontier is split
+ * across threads (when it is large enough to be worth it); the levels themselves run one after the other.
+ * The result doesn't depend on the order of the meetings in the file, or on the number of threads.
+ * @param[in] contactGraph the contact graph.
+ * @param[in] peopleArray the array of people. The severities are updated in place.
+ * @param[in] spreader the position of the verified carrier, whose severity is already set.
+ * @param[in] levels receives the level of every person (UNVISITED_LEVEL if he wasn't reached).
+ * @param[in] threadCount maximal number of threads to expand a frontier with.
+ * @param[out] STATUS_CODE_SUCCESS If propagation was successful.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode propagateSeveritiesByLevel(const ContactGraph *contactGraph, Person *peopleArray,
+											 unsigned int spreader, unsigned int *levels, unsigned int threadCount)
+{
+	// ## INITIATE RESOURCES ##
+	StatusCode retValPropagate = STATUS_CODE_SUCCESS;
+	unsigned int *frontier = (unsigned int *) malloc(sizeof(unsigned int));
+	unsigned int frontierSize = 1, frontierCapacity = 1, level = 0;
+	FrontierSlice *frontierSlices = (FrontierSlice *) calloc(threadCount, sizeof(FrontierSlice));
+	pthread_t *workers = (pthread_t *) malloc(threadCount * sizeof(pthread_t));
+	if ((frontier == NULL) || (frontierSlices == NULL) || (workers == NULL))
+	{
+		error(STATUS_CODE_FAIL);
+		retValPropagate = STATUS_CODE_FAIL;
+		frontierSize = 0;
+	}
+	else
+	{
+		memset(levels, 0xFF, (size_t) contactGraph->vertexCount * sizeof(unsigned int));	// UNVISITED_LEVEL
+		levels[spreader] = 0;
+		frontier[0] = spreader;
+	}
+	
+	// ## LEVEL BY LEVEL ##
+	while (frontierSize > 0)
+	{
+		unsigned int sliceCount = (frontierSize >= GRAPH_PARALLEL_MIN_FRONTIER) ? threadCount : 1;
+		unsigned int sliceIndex = 0, workerCount = 0;
+		for (sliceIndex = 0; sliceIndex < sliceCount; sliceIndex++)
+		{
+			unsigned int sliceStart = (unsigned int) (((unsigned long) frontierSize * sliceIndex) / sliceCount);
+			unsigned int sliceEnd = (unsigned int) (((unsigned long) frontierSize * (sliceIndex + 1)) / sliceCount);
+			frontierSlices[sliceIndex].contactGraph = contactGraph;
+			frontierSlices[sliceIndex].peopleArray = peopleArray;
+			frontierSlices[sliceIndex].levels = levels;
+			frontierSlices[sliceIndex].frontier = frontier + sliceStart;
+			frontierSlices[sliceIndex].frontierSize = sliceEnd - sliceStart;
+			frontierSlices[sliceIndex].nextLevel = level + 1;
+		}
+		
+		//	Slices 1.. on their own threads (or on this one, if a thread can't be created), slice 0 on this one:
+		for (sliceIndex = 1; sliceIndex < sliceCount; sliceIndex++)
+		{
+			if (pthread_create(workers + workerCount, NULL, propagateFrontierWorker, frontierSlices + sliceIndex) == 0)
+			{
+				workerCount++;
+			}
+			else
+			{
+				propagateFrontierSlice(frontierSlices + sliceIndex);
+			}
+		}
+		propagateFrontierSlice(frontierSlices);
+		while (workerCount > 0)
+		{
+			workerCount--;
+			pthread_join(workers[workerCount], NULL);
+		}
+		
+		//	The next frontier is the concatenation of the slices' claims:
+		unsigned long nextSize = 0;
+		for (sliceIndex = 0; sliceIndex < sliceCount; sliceIndex++)
+		{
+			if (frontierSlices[sliceIndex].status != STATUS_CODE_SUCCESS)
+			{
+				retValPropagate = STATUS_CODE_FAIL;
+			}
+			nextSize += frontierSlices[sliceIndex].nextCount;
+		}
+		if ((retValPropagate == STATUS_CODE_SUCCESS) && (nextSize > frontierCapacity))
+		{
+			unsigned int *temporaryFrontierPointer = (unsigned int *) realloc(frontier, nextSize * sizeof(unsigned int));
+			if (temporaryFrontierPointer == NULL)
+			{
+				retValPropagate = STATUS_CODE_FAIL;
+			}
+			else
+			{
+				frontier = temporaryFrontierPointer;
+				frontierCapacity = (unsigned int) nextSize;
+			}
+		}
+		if (retValPropagate != STATUS_CODE_SUCCESS)
+		{
+			error(STATUS_CODE_FAIL);
+			break;
+		}
+		frontierSize = 0;
+		for (sliceIndex = 0; sliceIndex < sliceCount; sliceIndex++)
+		{
+			memcpy(frontier + frontierSize, frontierSlices[sliceIndex].nextFrontier,
+				   frontierSlices[sliceIndex].nextCount * sizeof(unsigned int));
+			frontierSize += frontierSlices[sliceIndex].nextCount;
+		}
+		level++;
+	}
+	
+	// ## FREE RESOURCES ##
+	unsigned int sliceIndex = 0;
+	for (sliceIndex = 0; (frontierSlices != NULL) && (sliceIndex < threadCount); sliceIndex++)
+	{
+		free(frontierSlices[sliceIndex].nextFrontier);
+	}
+	free(frontierSlices);
+	free(workers);
+	free(frontier);
+	return retValPropagate;
+}
+
+
+/**
+ * @brief A function that calculates the chances of infection for each person, over an in-memory contact graph.
+ * @details The meetings are parsed in parallel (parallelIngest), collected into a CSR ContactGraph, and the
+ * severities are propagated from the verified carrier by propagateSeveritiesByLevel. Unlike
+ * calculateSeverities, the meetings don't have to be written in BFS batch order.
+ * @details With a statePath, the result (the severities, levels and contact graph) is saved as a delta state,
+ * which later delta runs start from (see calculateSeveritiesDelta).
+ * @details The meetings may be sharded: every meeting of every shard is an edge of the same graph, so a person's
+ * severity is the highest over his meetings in all the shards - whatever their order is.
+ * @param[in] meetingShards the shards of the meetings, in order. The verified carrier's line is skipped. If all
+ * the shards are empty, there is no verified carrier, and nobody is infected.
+ * @param[in] shardCount number of shards.
+ * @param[in] peopleArray an array of all the people that were recorded.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] peopleCounter the amount of the people that were recorded.
+ * @param[in] statePath where to save the delta state. NULL - it isn't saved.
+ * @param[in] threadCount number of threads to parse and propagate with.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If calculation was succesfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode calculateSeveritiesGraph(MeetingShard *meetingShards, unsigned int shardCount, Person *peopleArray,
+									const PeopleIndex *peopleIndex, unsigned int peopleCounter,
+									const char *statePath, unsigned int threadCount, RunStats *runStats)
+{
+	Person *spreader = NULL;
+	if (meetingShardsReadSpreader(meetingShards, shardCount, peopleArray, peopleIndex, &spreader, runStats) !=
+		STATUS_CODE_SUCCESS)
+	{
+		return STATUS_CODE_FAIL;
+	}
+	if ((spreader == NULL) && (statePath == NULL))
+	{
+		return STATUS_CODE_SUCCESS;
+	}
+	
+	// ## BUILD GRAPH ##
+	ContactGraph contactGraph = {0};
+	StatusCode retValCalc = contactGraphParse(&contactGraph, meetingShards, shardCount, peopleArray, peopleIndex,
+											  peopleCounter, threadCount, runStats);
+	
+	// ## PROPAGATE ## - (without a verified carrier, nobody is reached)
+	unsigned int spreaderPosition = (spreader != NULL) ? (unsigned int) (spreader - peopleArray) :
+									DELTA_STATE_NO_SPREADER;
+	unsigned int *levels = (unsigned int *) malloc(((size_t) peopleCounter + 1) * sizeof(unsigned int));
+	if ((retValCalc == STATUS_CODE_SUCCESS) && (levels == NULL))
+	{
+		error(STATUS_CODE_FAIL);
+		retValCalc = STATUS_CODE_FAIL;
+	}
+	if ((retValCalc == STATUS_CODE_SUCCESS) && (spreader != NULL))
+	{
+		retValCalc = propagateSeveritiesByLevel(&contactGraph, peopleArray, spreaderPosition, levels, threadCount);
+	}
+	else if (retValCalc == STATUS_CODE_SUCCESS)
+	{
+		memset(levels, 0xFF, (size_t) peopleCounter * sizeof(unsigned int));	// UNVISITED_LEVEL
+	}
+	
+	// ## SAVE STATE ##
+	if ((retValCalc == STATUS_CODE_SUCCESS) && (statePath != NULL))
+	{
+		retValCalc = deltaStateWrite(statePath, &contactGraph, peopleArray, levels, spreaderPosition);
+	}
+	free(levels);
+	contactGraphFree(&contactGraph);
+	return retValCalc;
+}
+
+
+/**
+ * @brief A function that saves the result of a graph run as a delta state, which a later delta run
+ * continues from (see calculateSeveritiesDelta).
+ * @details Layout: a DeltaStateHeader, and the sections it describes. The file is written next to statePath
+ * and renamed over it only once complete.
+ * @param[in] statePath the path of the state.
+ * @param[in] contactGraph the contact graph of all the meetings so far.
+ * @param[in] peopleArray the array of people, sorted by ID, with their severities calculated.
+ * @param[in] levels the BFS level of every person.
+ * @param[in] spreader the position of the verified carrier. DELTA_STATE_NO_SPREADER - none.
+ * @param[out] STATUS_CODE_SUCCESS If the state was written.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode deltaStateWrite(const char *statePath, const ContactGraph *contactGraph, const Person *peopleArray,
+								  const unsigned int *levels, unsigned int spreader)
+{
+	// ## HEADER ##
+	DeltaStateHeader header;
+	unsigned int vertexCount = contactGraph->vertexCount, personIndex = 0;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, DELTA_STATE_MAGIC, DELTA_STATE_MAGIC_LEN);
+	header.version = DELTA_STATE_VERSION;
+	header.byteOrderMark = SNAPSHOT_BYTE_ORDER_MARK;
+	header.peopleCount = vertexCount;
+	header.edgeCount = contactGraph->edgeCount;
+	header.spreader = spreader;
+	
+	// ## OPEN OUTPUT FILE ## - a temporary one, renamed when complete:
+	char *temporaryPath = NULL;
+	OutputWriter outputWriter = {0};
+	StatusCode retValOpen = temporaryFileOpen(statePath, &temporaryPath, &outputWriter);
+	if (retValOpen != STATUS_CODE_SUCCESS)
+	{
+		return retValOpen;
+	}
+	
+	// ## WRITE ## - header, people, graph:
+	StatusCode retValWrite = outputWriterAppendBytes(&outputWriter, &header, sizeof(header));
+	for (personIndex = 0; (personIndex < vertexCount) && (retValWrite == STATUS_CODE_SUCCESS); personIndex++)
+	{
+		retValWrite = outputWriterAppendBytes(&outputWriter, &peopleArray[personIndex].id, sizeof(int));
+	}
+	for (personIndex = 0; (personIndex < vertexCount) && (retValWrite == STATUS_CODE_SUCCESS); personIndex++)
+	{
+		retValWrite = outputWriterAppendBytes(&outputWriter, &peopleArray[personIndex].severity, sizeof(float));
+	}
+	if (retValWrite == STATUS_CODE_SUCCESS)
+	{
+		retValWrite = outputWriterAppendBytes(&outputWriter, levels, (size_t) vertexCount * sizeof(unsigned int));
+	}
+	if (retValWrite == STATUS_CODE_SUCCESS)
+	{
+		retValWrite = outputWriterAppendBytes(&outputWriter, contactGraph->edgeOffsets,
+											  ((size_t) vertexCount + 1) * sizeof(unsigned int));
+	}
+	if (retValWrite == STATUS_CODE_SUCCESS)
+	{
+		retValWrite = outputWriterAppendBytes(&outputWriter, contactGraph->targets,
+											  (size_t) contactGraph->edgeCount * sizeof(unsigned int));
+	}
+	if (retValWrite == STATUS_CODE_SUCCESS)
+	{
+		retValWrite = outputWriterAppendBytes(&outputWriter, contactGraph->chances,
+											  (size_t) contactGraph->edgeCount * sizeof(float));
+	}
+	
+	// ## CLOSE OUTPUT FILE ## - and replace the old state:
+	return temporaryFileCommit(statePath, temporaryPath, &outputWriter, retValWrite);
+}
+
+
+/**
+ * @brief A function that maps a delta state (see deltaStateWrite), and validates it against the people.
+ * @details The mapping is private and writable, like a people snapshot's, and the state's arrays point
+ * straight into it. It must have been saved with the same people (the same IDs, in the same order).
+ * @note The function ALLOCATES MEMORY being stored in deltaState. released by deltaStateFree, even in failure.
+ * @param[in] statePath the path of the state.
+ * @param[in] peopleArray the array of people, sorted by ID.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] deltaState the loaded state.
+ * @param[out] STATUS_CODE_SUCCESS If the state was loaded.
+ * @param[out] STATUS_CODE_INPUT_ERROR If the state couldn't be mapped, is invalid, or is of other people.
+ */
+static StatusCode deltaStateLoad(const char *statePath, const Person *peopleArray, unsigned int peopleCounter,
+								 DeltaState *deltaState)
+{
+	// ## MAP INPUT FILE ##
+	struct stat stateStat;
+	int stateFd = open(statePath, O_RDONLY);
+	if ((stateFd < 0) || (fstat(stateFd, &stateStat) != 0) || !S_ISREG(stateStat.st_mode) ||
+		((size_t) stateStat.st_size < sizeof(DeltaStateHeader)))
+	{
+		if (stateFd >= 0)
+		{
+			close(stateFd);
+		}
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	size_t fileSize = (size_t) stateStat.st_size;
+	char *mappedFile = (char *) mmap(NULL, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, stateFd, 0);
+	close(stateFd);
+	if (mappedFile == MAP_FAILED)
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	deltaState->mappedFile = mappedFile;
+	deltaState->mappedSize = fileSize;
+	
+	// ## VALIDATE HEADER ##
+	const DeltaStateHeader *header = (const DeltaStateHeader *) mappedFile;
+	unsigned long long peopleCount = header->peopleCount, edgeCount = header->edgeCount;
+	unsigned long long expectedSize = sizeof(DeltaStateHeader) + (peopleCount * (sizeof(int) + sizeof(float))) +
+									  ((2 * peopleCount + 1) * sizeof(unsigned int)) +
+									  (edgeCount * (sizeof(unsigned int) + sizeof(float)));
+	if ((memcmp(header->magic, DELTA_STATE_MAGIC, DELTA_STATE_MAGIC_LEN) != 0) ||
+		(header->version != DELTA_STATE_VERSION) || (header->byteOrderMark != SNAPSHOT_BYTE_ORDER_MARK) ||
+		(header->peopleCount != peopleCounter) || (expectedSize != fileSize) ||
+		((header->spreader >= peopleCounter) && (header->spreader != DELTA_STATE_NO_SPREADER)))
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	
+	// ## LOCATE SECTIONS ##
+	const int *ids = (const int *) (mappedFile + sizeof(DeltaStateHeader));
+	deltaState->spreader = header->spreader;
+	deltaState->severities = (const float *) (ids + peopleCounter);
+	deltaState->levels = (const unsigned int *) (deltaState->severities + peopleCounter);
+	deltaState->contactGraph.vertexCount = peopleCounter;
+	deltaState->contactGraph.edgeCount = header->edgeCount;
+	deltaState->contactGraph.edgeOffsets = (unsigned int *) (deltaState->levels + peopleCounter);
+	deltaState->contactGraph.targets = deltaState->contactGraph.edgeOffsets + peopleCounter + 1;
+	deltaState->contactGraph.chances = (float *) (deltaState->contactGraph.targets + header->edgeCount);
+	
+	// ## VALIDATE SECTIONS ## - the same people, and a well formed graph:
+	const ContactGraph *contactGraph = &deltaState->contactGraph;
+	unsigned int personIndex = 0, edgeIndex = 0;
+	for (personIndex = 0; personIndex < peopleCounter; personIndex++)
+	{
+		if ((ids[personIndex] != peopleArray[personIndex].id) ||
+			(contactGraph->edgeOffsets[personIndex] > contactGraph->edgeOffsets[personIndex + 1]))
+		{
+			error(STATUS_CODE_INPUT_ERROR);
+			return STATUS_CODE_INPUT_ERROR;
+		}
+	}
+	if ((contactGraph->edgeOffsets[0] != 0) || (contactGraph->edgeOffsets[peopleCounter] != contactGraph->edgeCount))
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	for (edgeIndex = 0; edgeIndex < contactGraph->edgeCount; edgeIndex++)
+	{
+		if (contactGraph->targets[edgeIndex] >= peopleCounter)
+		{
+			error(STATUS_CODE_INPUT_ERROR);
+			return STATUS_CODE_INPUT_ERROR;
+		}
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that releases a delta state loaded by deltaStateLoad.
+ * @param[in] deltaState the state to release. May be partially loaded.
+ */
+static void deltaStateFree(DeltaState *deltaState)
+{
+	if (deltaState->mappedFile != NULL)
+	{
+		munmap(deltaState->mappedFile, deltaState->mappedSize);
+	}
+	memset(deltaState, 0, sizeof(DeltaState));
+}
+
+
+/**
+ * @brief A function that recalculates the levels and severities of the people downstream of newly added
+ * meetings, leaving everybody else as they were.
+ * @details The region is every person reachable from a target of an added meeting (not through the verified
+ * carrier). Nobody outside it has a new meeting on any of his shortest paths from the carrier, so his level
+ * and severity can't change. The region is cleared, its people are seeded with the lowest level their
+ * infectors outside the region give them, and a BFS which merges the seeds (in level order) with its own
+ * queue settles their levels. The severities are then calculated in the order the BFS settled the people,
+ * as propagateSeveritiesByLevel would: the highest infector severity * chance over the in-meetings from
+ * the previous level.
+ * @param[in] contactGraph the contact graph of all the meetings, the added ones included.
+ * @param[in] reverseGraph the reverse of contactGraph (see contactGraphReverse).
+ * @param[in] addedGraph the contact graph of the added meetings only.
+ * @param[in] peopleArray the array of people, with the severities of the previous run. Updated in place.
+ * @param[in] levels the levels of the previous run. Updated in place.
+ * @param[in] spreader the position of the verified carrier.
+ * @param[in] regionSize set to the number of people who were recalculated.
+ * @param[out] STATUS_CODE_SUCCESS If the region was recalculated.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+static StatusCode repropagateDownstream(const ContactGraph *contactGraph, const ContactGraph *reverseGraph,
+										const ContactGraph *addedGraph, Person *peopleArray, unsigned int *levels,
+										unsigned int spreader, unsigned int *regionSize)
+{
+	unsigned int vertexCount = contactGraph->vertexCount;
+	unsigned char *inRegion = (unsigned char *) calloc((size_t) vertexCount + 1, sizeof(unsigned char));
+	unsigned int *region = (unsigned int *) malloc(((size_t) vertexCount + 1) * sizeof(unsigned int));
+	unsigned int *settled = (unsigned int *) malloc(((size_t) vertexCount + 1) * sizeof(unsigned int));
+	unsigned long long *seeds = (unsigned long long *) malloc(((size_t) vertexCount + 1) *
+															  sizeof(unsigned long long));
+	if ((inRegion == NULL) || (region == NULL) || (settled == NULL) || (seeds == NULL))
+	{
+		free(inRegion);
+		free(region);
+		free(settled);
+		free(seeds);
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	
+	// ## COLLECT REGION ## - the targets of the added meetings, and everyone they reach:
+	unsigned int regionCount = 0, regionIndex = 0, edgeIndex = 0, vertex = 0;
+	inRegion[spreader] = 1;		// Never entered - his level and severity are fixed.
+	for (edgeIndex = 0; edgeIndex < addedGraph->edgeCount; edgeIndex++)
+	{
+		vertex = addedGraph->targets[edgeIndex];
+		if (!inRegion[vertex])
+		{
+			inRegion[vertex] = 1;
+			region[regionCount++] = vertex;
+		}
+	}
+	for (regionIndex = 0; regionIndex < regionCount; regionIndex++)
+	{
+		unsigned int infector = region[regionIndex];
+		for (edgeIndex = contactGraph->edgeOffsets[infector]; edgeIndex < contactGraph->edgeOffsets[infector + 1];
+			 edgeIndex++)
+		{
+			vertex = contactGraph->targets[edgeIndex];
+			if (!inRegion[vertex])
+			{
+				inRegion[vertex] = 1;
+				region[regionCount++] = vertex;
+			}
+		}
+	}
+	inRegion[spreader] = 0;
+	for (regionIndex = 0; regionIndex < regionCount; regionIndex++)
+	{
+		levels[region[regionIndex]] = UNVISITED_LEVEL;
+		peopleArray[region[regionIndex]].severity = 0;
+	}
+	
+	// ## SEED ## - the lowest level given by an infector outside the region, sorted by level:
+	unsigned int seedCount = 0;
+	for (regionIndex = 0; regionIndex < regionCount; regionIndex++)
+	{
+		unsigned int infected = region[regionIndex];
+		for (edgeIndex = reverseGraph->edgeOffsets[infected]; edgeIndex < reverseGraph->edgeOffsets[infected + 1];
+			 edgeIndex++)
+		{
+			unsigned int infector = reverseGraph->targets[edgeIndex];
+			if (!inRegion[infector] && (levels[infector] != UNVISITED_LEVEL) && (levels[infector] + 1 < levels[infected]))
+			{
+				levels[infected] = levels[infector] + 1;
+			}
+		}
+		if (levels[infected] != UNVISITED_LEVEL)
+		{
+			seeds[seedCount++] = ((unsigned long long) levels[infected] << 32) | infected;
+		}
+	}
+	qsort(seeds, seedCount, sizeof(unsigned long long), levelKeyCompare);
+	
+	// ## SETTLE LEVELS ## - the BFS queue is kept in region, which isn't needed anymore:
+	unsigned int seedIndex = 0, queueHead = 0, queueTail = 0, settledCount = 0;
+	unsigned int *queue = region;
+	while ((seedIndex < seedCount) || (queueHead < queueTail))
+	{
+		unsigned int infector = 0;
+		if ((queueHead == queueTail) ||
+			((seedIndex < seedCount) && ((unsigned int) (seeds[seedIndex] >> 32) <= levels[queue[queueHead]])))
+		{
+			infector = (unsigned int) seeds[seedIndex];
+			if (levels[infector] != (unsigned int) (seeds[seedIndex++] >> 32))
+			{
+				continue;	// Stale - the BFS reached him on a lower level.
+			}
+		}
+		else
+		{
+			infector = queue[queueHead++];
+		}
+		settled[settledCount++] = infector;
+		for (edgeIndex = contactGraph->edgeOffsets[infector]; edgeIndex < contactGraph->edgeOffsets[infector + 1];
+			 edgeIndex++)
+		{
+			unsigned int infected = contactGraph->targets[edgeIndex];
+			if (inRegion[infected] && (levels[infector] + 1 < levels[infected]))
+			{
+				levels[infected] = levels[infector] + 1;
+				queue[queueTail++] = infected;
+			}
+		}
+	}
+	
+	// ## SEVERITIES ## - in settling order, so every infector of the previous level is final:
+	for (regionIndex = 0; regionIndex < settledCount; regionIndex++)
+	{
+		unsigned int infected = settled[regionIndex];
+		for (edgeIndex = reverseGraph->edgeOffsets[infected]; edgeIndex < reverseGraph->edgeOffsets[infected + 1];
+			 edgeIndex++)
+		{
+			unsigned int infector = reverseGraph->targets[edgeIndex];
+			float candidate = peopleArray[infector].severity * reverseGraph->chances[edgeIndex];
+			if ((levels[infector] + 1 == levels[infected]) && (candidate > peopleArray[infected].severity))
+			{
+				peopleArray[infected].severity = candidate;
+			}
+		}
+	}
+	*regionSize = regionCount;
+	free(inRegion);
+	free(region);
+	free(settled);
+	free(seeds);
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that calculates the chances of infection for each person after new meetings were
+ * appended, starting from the delta state of the previous run instead of from scratch.
+ * @details The meetings file holds only the appended meeting lines (the verified carrier is already known).
+ * They are parsed into a contact graph and merged into the saved one, and only the people downstream of
+ * them are recalculated (repropagateDownstream). The result is the same as a graph run over all the
+ * meetings, and it is saved over the state for the next delta.
+ * @details If the state has no verified carrier (it was saved from an empty meetings file), the meetings file
+ * is the first real one, and is handled by calculateSeveritiesGraph.
+ * @param[in] meetingShards the shards of the appended meeting lines.
+ * @param[in] shardCount number of shards.
+ * @param[in] peopleArray an array of all the people that were recorded.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] peopleCounter the amount of the people that were recorded.
+ * @param[in] statePath the delta state. Read, and replaced by the updated one.
+ * @param[in] threadCount number of threads to parse with.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If calculation was succesfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode calculateSeveritiesDelta(MeetingShard *meetingShards, unsigned int shardCount, Person *peopleArray,
+									const PeopleIndex *peopleIndex, unsigned int peopleCounter,
+									const char *statePath, unsigned int threadCount, RunStats *runStats)
+{
+	// ## LOAD STATE ##
+	DeltaState deltaState = {0};
+	if (deltaStateLoad(statePath, peopleArray, peopleCounter, &deltaState) != STATUS_CODE_SUCCESS)
+	{
+		deltaStateFree(&deltaState);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	unsigned int spreader = deltaState.spreader;
+	if (spreader == DELTA_STATE_NO_SPREADER)
+	{
+		deltaStateFree(&deltaState);
+		return calculateSeveritiesGraph(meetingShards, shardCount, peopleArray, peopleIndex, peopleCounter,
+										statePath, threadCount, runStats);
+	}
+	unsigned int *levels = (unsigned int *) malloc(((size_t) peopleCounter + 1) * sizeof(unsigned int));
+	if (levels == NULL)
+	{
+		deltaStateFree(&deltaState);
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	unsigned int personIndex = 0;
+	for (personIndex = 0; personIndex < peopleCounter; personIndex++)
+	{
+		peopleArray[personIndex].severity = deltaState.severities[personIndex];
+	}
+	memcpy(levels, deltaState.levels, (size_t) peopleCounter * sizeof(unsigned int));
+	
+	// ## MERGE GRAPHS ## - the saved one, and the appended meetings:
+	ContactGraph addedGraph = {0}, mergedGraph = {0}, reverseGraph = {0};
+	StatusCode retValCalc = contactGraphParse(&addedGraph, meetingShards, shardCount, peopleArray, peopleIndex,
+											  peopleCounter, threadCount, runStats);
+	if (retValCalc == STATUS_CODE_SUCCESS)
+	{
+		retValCalc = contactGraphMerge(&deltaState.contactGraph, &addedGraph, &mergedGraph);
+	}
+	deltaStateFree(&deltaState);
+	if (retValCalc == STATUS_CODE_SUCCESS)
+	{
+		retValCalc = contactGraphReverse(&mergedGraph, &reverseGraph);
+	}
+	
+	// ## REPROPAGATE ## - only downstream of the appended meetings:
+	unsigned int regionSize = 0;
+	if (retValCalc == STATUS_CODE_SUCCESS)
+	{
+		retValCalc = repropagateDownstream(&mergedGraph, &reverseGraph, &addedGraph, peopleArray, levels, spreader,
+										   &regionSize);
+	}
+	contactGraphFree(&reverseGraph);
+	contactGraphFree(&addedGraph);
+	
+	// ## SAVE STATE ##
+	if (retValCalc == STATUS_CODE_SUCCESS)
+	{
+		retValCalc = deltaStateWrite(statePath, &mergedGraph, peopleArray, levels, spreader);
+	}
+	contactGraphFree(&mergedGraph);
+	free(levels);
+	return retValCalc;
+}
+
+
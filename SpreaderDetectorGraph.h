@@ -0,0 +1,83 @@
+/*
+ * File Name: SpreaderDetectorGraph.h
+ * Related Files: "SpreaderDetectorGraph.c", "SpreaderDetectorInternal.h"
+ *
+ * Purpose:
+ * 			The functions of SpreaderDetectorGraph.c which the other modules of the SpreaderDetector library
+ * 			use. They are internal (hidden): the API of the library is SpreaderDetector.h.
+ *
+ * Author's ID: 206174120
+ * Author's Name: Oren Kovartovsky
+ * University User Name: orenkov
+ *
+ * */
+
+#ifndef SPREADERDETECTORGRAPH_H
+#define SPREADERDETECTORGRAPH_H
+
+#include "SpreaderDetectorInternal.h"
+
+#if defined(__GNUC__)
+#pragma GCC visibility push(hidden)
+#endif
+
+//	****** CONTACT GRAPH FUNCTIONS ******
+/**
+ * @brief A function that calculates the chances of infection for each person, over an in-memory contact graph.
+ *
+ * @details The meetings are parsed in parallel (parallelIngest), collected into a CSR ContactGraph, and the
+ * severities are propagated from the verified carrier by propagateSeveritiesByLevel. Unlike
+ * calculateSeverities, the meetings don't have to be written in BFS batch order.
+ * @details With a statePath, the result (the severities, levels and contact graph) is saved as a delta state,
+ * which later delta runs start from (see calculateSeveritiesDelta).
+ * @details The meetings may be sharded: every meeting of every shard is an edge of the same graph, so a person's
+ * severity is the highest over his meetings in all the shards - whatever their order is.
+ * @param[in] meetingShards the shards of the meetings, in order. The verified carrier's line is skipped. If all
+ * the shards are empty, there is no verified carrier, and nobody is infected.
+ * @param[in] shardCount number of shards.
+ * @param[in] peopleArray an array of all the people that were recorded.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] peopleCounter the amount of the people that were recorded.
+ * @param[in] statePath where to save the delta state. NULL - it isn't saved.
+ * @param[in] threadCount number of threads to parse and propagate with.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If calculation was succesfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode calculateSeveritiesGraph(MeetingShard *meetingShards, unsigned int shardCount, Person *peopleArray,
+									const PeopleIndex *peopleIndex, unsigned int peopleCounter,
+									const char *statePath, unsigned int threadCount, RunStats *runStats);
+
+
+//	****** DELTA STATE FUNCTIONS ******
+/**
+ * @brief A function that calculates the chances of infection for each person after new meetings were
+ * appended, starting from the delta state of the previous run instead of from scratch.
+ *
+ * @details The meetings file holds only the appended meeting lines (the verified carrier is already known).
+ * They are parsed into a contact graph and merged into the saved one, and only the people downstream of
+ * them are recalculated (repropagateDownstream). The result is the same as a graph run over all the
+ * meetings, and it is saved over the state for the next delta.
+ * @details If the state has no verified carrier (it was saved from an empty meetings file), the meetings file
+ * is the first real one, and is handled by calculateSeveritiesGraph.
+ * @param[in] meetingShards the shards of the appended meeting lines.
+ * @param[in] shardCount number of shards.
+ * @param[in] peopleArray an array of all the people that were recorded.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] peopleCounter the amount of the people that were recorded.
+ * @param[in] statePath the delta state. Read, and replaced by the updated one.
+ * @param[in] threadCount number of threads to parse with.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If calculation was succesfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode calculateSeveritiesDelta(MeetingShard *meetingShards, unsigned int shardCount, Person *peopleArray,
+									const PeopleIndex *peopleIndex, unsigned int peopleCounter,
+									const char *statePath, unsigned int threadCount, RunStats *runStats);
+
+
+#if defined(__GNUC__)
+#pragma GCC visibility pop
+#endif
+
+#endif //SPREADERDETECTORGRAPH_H
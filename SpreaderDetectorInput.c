@@ -0,0 +1,1563 @@
+/*
+ * File Name: SpreaderDetectorInput.c
+ * Related Files: "SpreaderDetectorInput.h", "SpreaderDetectorInternal.h"
+ *
+ * Purpose:
+ * 			This file is the input of the SpreaderDetector library: the decompression of the input files, the
+ * 			read-ahead, the line reader, and the parsing of numbers.
+ *
+ * Author's ID: 206174120
+ * Author's Name: Oren Kovartovsky
+ * University User Name: orenkov
+ *
+ * */
+
+#include "SpreaderDetectorInput.h"
+#ifdef SPREADER_DETECTOR_ZLIB
+#include <zlib.h>
+#endif
+#ifdef SPREADER_DETECTOR_ZSTD
+#include <zstd.h>
+#include <zstd_errors.h>
+#endif
+#ifdef SPREADER_DETECTOR_IO_URING
+#include <sys/syscall.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+/*
+ * ***************************
+ * 	GLOBALS
+ * ***************************
+ */
+/**
+ * @brief The findLineEnd kernel of this CPU, chosen once by findLineEndSelectKernel.
+ */
+static const char *(*findLineEndKernel)(const char *cursor, const char *end) = NULL;
+static pthread_once_t findLineEndKernelOnce = PTHREAD_ONCE_INIT;
+
+
+/*
+ * ***********************
+ * 	DECLARATIONS
+ * ***********************
+ */
+//	****** DECOMPRESSION FUNCTIONS ******
+/**
+ * @brief A function that checks whether a compression format was compiled in.
+ *
+ * @param[in] compression the format.
+ * @return 1 if inputs of the format can be read, 0 otherwise.
+ */
+static int compressionIsSupported(Compression compression);
+
+#if defined(SPREADER_DETECTOR_ZLIB) || defined(SPREADER_DETECTOR_ZSTD)
+/**
+ * @brief A function that writes decompressed data to the pipe, whole.
+ *
+ * @param[in] pipeWriteFd the write end of the pipe.
+ * @param[in] data the data.
+ * @param[in] size the size of the data.
+ * @param[out] STATUS_CODE_SUCCESS If the data was written.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If the write failed (e.g. the reader closed the pipe).
+ */
+static StatusCode decompressorWrite(int pipeWriteFd, const char *data, size_t size);
+#endif
+
+#ifdef SPREADER_DETECTOR_ZLIB
+/**
+ * @brief A function that decompresses a gzip file into the pipe, a block at a time.
+ *
+ * @details Files of several gzip members (e.g. concatenated with cat) are decompressed one member after
+ * the other, as gzip does.
+ * @param[in] decompressor the decompressor.
+ * @param[out] STATUS_CODE_SUCCESS If the whole file was decompressed.
+ * @param[out] STATUS_CODE_INPUT_ERROR If the file is corrupt or truncated.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If writing to the pipe failed.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+static StatusCode decompressGzip(Decompressor *decompressor);
+#endif
+
+#ifdef SPREADER_DETECTOR_ZSTD
+/**
+ * @brief A function that decompresses a Zstandard file into the pipe, a block at a time.
+ *
+ * @details Files of several frames are decompressed one frame after the other, as zstd does.
+ * @param[in] decompressor the decompressor.
+ * @param[out] STATUS_CODE_SUCCESS If the whole file was decompressed.
+ * @param[out] STATUS_CODE_INPUT_ERROR If the file is corrupt or truncated.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If writing to the pipe failed.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+static StatusCode decompressZstd(Decompressor *decompressor);
+#endif
+
+/**
+ * @brief The function run by the decompressing thread.
+ *
+ * @details SIGPIPE is blocked in the thread: if the reader stops early and closes the pipe, the writes fail
+ * (and the thread ends) instead of the process being killed.
+ * @param[in] decompressor a pointer to the Decompressor. Its status is set when the thread ends.
+ * @return NULL.
+ */
+static void *decompressorWorker(void *decompressor);
+
+
+//	****** READ-AHEAD FUNCTIONS ******
+#ifdef SPREADER_DETECTOR_IO_URING
+/**
+ * @brief A function that sets up the io_uring of a ReadAhead, with the raw system calls.
+ *
+ * @details The reads use IORING_OP_READ, and the rings share one mapping - so Linux 5.6 is needed. A regular
+ * file is read at explicit offsets from its current position, so all the blocks can be in flight at once.
+ * Other files (pipes) are read at their position, one block at a time.
+ * @param[in] readAhead the ReadAhead. Its inputFd must be set.
+ * @param[out] STATUS_CODE_SUCCESS If the io_uring was set up.
+ * @param[out] STATUS_CODE_FAIL If io_uring isn't available (an old kernel, or a sandbox which blocks it).
+ */
+static StatusCode readAheadRingSetup(ReadAhead *readAhead);
+
+/**
+ * @brief A function that submits one request to the io_uring of a ReadAhead.
+ *
+ * @param[in] ring the io_uring.
+ * @param[in] request the request to submit.
+ * @param[out] STATUS_CODE_SUCCESS If the request was submitted.
+ * @param[out] STATUS_CODE_INPUT_ERROR Otherwise.
+ */
+static StatusCode readAheadRingSubmit(ReadAheadRing *ring, const struct io_uring_sqe *request);
+
+/**
+ * @brief A function that submits the read of the rest of a block (from its length) to the io_uring.
+ *
+ * @param[in] readAhead the ReadAhead.
+ * @param[in] blockIndex the block. Its status is set to an error if the read couldn't be submitted.
+ */
+static void readAheadRingRead(ReadAhead *readAhead, unsigned int blockIndex);
+
+/**
+ * @brief A function that starts reading the next block of the file into an (empty) block, unless the end of
+ * the file was already read - then the block is left empty.
+ *
+ * @param[in] readAhead the ReadAhead.
+ * @param[in] blockIndex the block.
+ */
+static void readAheadRingStartBlock(ReadAhead *readAhead, unsigned int blockIndex);
+
+/**
+ * @brief A function that waits for completions of the io_uring, and handles them.
+ *
+ * @details A read which was interrupted is submitted again, and a short read is continued (so every block but
+ * the last is full, as with the reader thread) - until the file is read to its end.
+ * @param[in] readAhead the ReadAhead.
+ * @param[out] STATUS_CODE_SUCCESS If completions were handled.
+ * @param[out] STATUS_CODE_INPUT_ERROR If waiting failed.
+ */
+static StatusCode readAheadRingWait(ReadAhead *readAhead);
+
+/**
+ * @brief A function that cancels the reads in flight, waits for them, and releases the io_uring.
+ *
+ * @details The kernel may write into a block until its read completes, so the blocks are released only after.
+ * @param[in] readAhead the ReadAhead.
+ */
+static void readAheadRingFree(ReadAhead *readAhead);
+#endif
+
+/**
+ * @brief The function run by the reader thread of a ReadAhead.
+ *
+ * @details The thread fills the free blocks in order, each until it is full or the input ends, and ends after
+ * handing over an empty block (the end of the input) or a failed one. Only the read() itself can be canceled
+ * (see readAheadStop), so the thread never stops holding the mutex.
+ * @param[in] readAhead a pointer to the ReadAhead.
+ * @return NULL.
+ */
+static void *readAheadWorker(void *readAhead);
+
+/**
+ * @brief A function that starts reading a file ahead: its next blocks are read while the current one is used.
+ *
+ * @details With SPREADER_DETECTOR_IO_URING the reads are submitted to an io_uring, if the kernel has one.
+ * Otherwise (and as a fallback) a reader thread reads them. Nothing was read from the file before.
+ * @note The function ALLOCATES MEMORY being stored in readAhead. released by readAheadStop. A failure isn't
+ * reported - the caller reads the file by itself.
+ * @param[in] readAhead the ReadAhead to start.
+ * @param[in] inputFd the file. Not closed by the ReadAhead.
+ * @param[out] STATUS_CODE_SUCCESS If the reads were started.
+ * @param[out] STATUS_CODE_FAIL Otherwise.
+ */
+static StatusCode readAheadStart(ReadAhead *readAhead, int inputFd);
+
+/**
+ * @brief A function that returns the next block of the file, waiting for it to be read.
+ *
+ * @details The block returned before is released (and read into again), so its data is no longer valid.
+ * @param[in] readAhead the ReadAhead.
+ * @param[in] data set to the data of the block.
+ * @param[in] length set to the length of the block. 0 at the end of the file - not to be called after.
+ * @param[out] STATUS_CODE_SUCCESS If a block was returned.
+ * @param[out] STATUS_CODE_INPUT_ERROR If reading failed.
+ */
+static StatusCode readAheadNext(ReadAhead *readAhead, const char **data, size_t *length);
+
+/**
+ * @brief A function that stops reading ahead, and releases the memory held by the ReadAhead.
+ *
+ * @details Reads in flight are canceled - a read of a pipe might wait for input which never comes.
+ * @param[in] readAhead the ReadAhead. Must be started.
+ */
+static void readAheadStop(ReadAhead *readAhead);
+
+
+//	****** LINE READER FUNCTIONS ******
+/**
+ * @brief The portable findLineEnd kernel.
+ *
+ * @details Compares 16 bytes at a time against '\n' when the program was compiled with SSE2, with a scalar
+ * loop for the tail, or for the whole range otherwise.
+ * @param[in] cursor a pointer to the beginning of the range to search.
+ * @param[in] end a pointer to the end of the range to search.
+ * @return a pointer to the first '\n' in the range, or end if there is none.
+ */
+static const char *findLineEndPortable(const char *cursor, const char *end);
+
+#if AVX2_DISPATCH
+/**
+ * @brief The AVX2 findLineEnd kernel: 32 bytes at a time, the rest by findLineEndPortable.
+ *
+ * @details Compiled for AVX2 even when the program isn't, and chosen at runtime only on CPUs which have it.
+ * @param[in] cursor a pointer to the beginning of the range to search.
+ * @param[in] end a pointer to the end of the range to search.
+ * @return a pointer to the first '\n' in the range, or end if there is none.
+ */
+static const char *findLineEndAvx2(const char *cursor, const char *end);
+#endif
+
+/**
+ * @brief A function that chooses the findLineEnd kernel: AVX2 if the CPU has it, otherwise the portable one.
+ */
+static void findLineEndSelectKernel();
+
+/**
+ * @brief A function that starts reading the file of a LineReader ahead.
+ *
+ * @details The file is read through its descriptor from now on, as nothing was read through its stdio buffer.
+ * If reading ahead can't start, the reader reads the file by itself (fread).
+ * @param[in] lineReader the reader. Nothing was read yet.
+ */
+static void lineReaderStartReadAhead(LineReader *lineReader);
+
+/**
+ * @brief A function that copies the next read-ahead data into the free room of the buffer of a LineReader.
+ *
+ * @param[in] lineReader the reader. Its buffer must have free room.
+ * @param[in] bytesRead set to the number of bytes copied. 0 at the end of the file.
+ * @param[out] STATUS_CODE_SUCCESS If the data was copied.
+ * @param[out] STATUS_CODE_INPUT_ERROR If reading failed.
+ */
+static StatusCode lineReaderReadAhead(LineReader *lineReader, size_t *bytesRead);
+
+/**
+ * @brief A function that reads the input which is available into the buffer of a streaming LineReader.
+ *
+ * @details If no input is waiting, onIdle is called first, and then the read blocks until some arrives.
+ * @param[in] lineReader the reader. Its buffer must have free room.
+ * @param[in] bytesRead set to the number of bytes read. 0 at the end of the input.
+ * @param[out] STATUS_CODE_SUCCESS If the read succeeded.
+ * @param[out] STATUS_CODE_INPUT_ERROR If the read failed.
+ */
+static StatusCode lineReaderReadAvailable(LineReader *lineReader, size_t *bytesRead);
+
+
+/*
+ * ***********************
+ * 	DEFINITIONS
+ * ***********************
+ */
+/**
+ * @brief A function that detects the compression of an input file by its magic number.
+ * @details Only regular files are checked (the check reads the beginning of the file without consuming it).
+ * @param[in] inputFd the opened file.
+ * @return the Compression of the file. COMPRESSION_NONE if it isn't a regular file.
+ */
+Compression detectCompression(int inputFd)
+{
+	char magic[ZSTD_MAGIC_LEN];
+	struct stat inputStat;
+	if ((fstat(inputFd, &inputStat) != 0) || !S_ISREG(inputStat.st_mode))
+	{
+		return COMPRESSION_NONE;
+	}
+	ssize_t magicLength = pread(inputFd, magic, ZSTD_MAGIC_LEN, 0);
+	if ((magicLength >= GZIP_MAGIC_LEN) && (memcmp(magic, GZIP_MAGIC, GZIP_MAGIC_LEN) == 0))
+	{
+		return COMPRESSION_GZIP;
+	}
+	if ((magicLength == ZSTD_MAGIC_LEN) && (memcmp(magic, ZSTD_MAGIC, ZSTD_MAGIC_LEN) == 0))
+	{
+		return COMPRESSION_ZSTD;
+	}
+	return COMPRESSION_NONE;
+}
+
+
+/**
+ * @brief A function that checks whether a compression format was compiled in.
+ * @param[in] compression the format.
+ * @return 1 if inputs of the format can be read, 0 otherwise.
+ */
+static int compressionIsSupported(Compression compression)
+{
+	switch (compression)
+	{
+		case COMPRESSION_NONE:
+			return 1;
+#ifdef SPREADER_DETECTOR_ZLIB
+		case COMPRESSION_GZIP:
+			return 1;
+#endif
+#ifdef SPREADER_DETECTOR_ZSTD
+		case COMPRESSION_ZSTD:
+			return 1;
+#endif
+		default:
+			return 0;
+	}
+}
+
+
+#if defined(SPREADER_DETECTOR_ZLIB) || defined(SPREADER_DETECTOR_ZSTD)
+/**
+ * @brief A function that writes decompressed data to the pipe, whole.
+ * @param[in] pipeWriteFd the write end of the pipe.
+ * @param[in] data the data.
+ * @param[in] size the size of the data.
+ * @param[out] STATUS_CODE_SUCCESS If the data was written.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If the write failed (e.g. the reader closed the pipe).
+ */
+static StatusCode decompressorWrite(int pipeWriteFd, const char *data, size_t size)
+{
+	while (size > 0)
+	{
+		ssize_t bytesWritten = write(pipeWriteFd, data, size);
+		if ((bytesWritten < 0) && (errno == EINTR))
+		{
+			continue;
+		}
+		if (bytesWritten <= 0)
+		{
+			return STATUS_CODE_OUTPUT_ERROR;
+		}
+		data += bytesWritten;
+		size -= (size_t) bytesWritten;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+#endif
+
+
+#ifdef SPREADER_DETECTOR_ZLIB
+/**
+ * @brief A function that decompresses a gzip file into the pipe, a block at a time.
+ * @details Files of several gzip members (e.g. concatenated with cat) are decompressed one member after
+ * the other, as gzip does.
+ * @param[in] decompressor the decompressor.
+ * @param[out] STATUS_CODE_SUCCESS If the whole file was decompressed.
+ * @param[out] STATUS_CODE_INPUT_ERROR If the file is corrupt or truncated.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If writing to the pipe failed.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+static StatusCode decompressGzip(Decompressor *decompressor)
+{
+	z_stream zStream;
+	memset(&zStream, 0, sizeof(zStream));
+	unsigned char *input = (unsigned char *) malloc(DECOMPRESS_BUFFER_SIZE);
+	unsigned char *output = (unsigned char *) malloc(DECOMPRESS_BUFFER_SIZE);
+	if ((input == NULL) || (output == NULL) || (inflateInit2(&zStream, MAX_WBITS + 32) != Z_OK))	// gzip header
+	{
+		free(input);
+		free(output);
+		return STATUS_CODE_FAIL;
+	}
+	StatusCode retValDecompress = STATUS_CODE_SUCCESS;
+	int zResult = Z_OK;
+	ssize_t bytesRead = 0;
+	while ((retValDecompress == STATUS_CODE_SUCCESS) &&
+		   ((bytesRead = read(decompressor->compressedFd, input, DECOMPRESS_BUFFER_SIZE)) > 0))
+	{
+		zStream.next_in = input;
+		zStream.avail_in = (uInt) bytesRead;
+		do
+		{
+			if ((zResult == Z_STREAM_END) && (zStream.avail_in > 0))
+			{
+				inflateReset(&zStream);	// The next member.
+			}
+			zStream.next_out = output;
+			zStream.avail_out = DECOMPRESS_BUFFER_SIZE;
+			zResult = inflate(&zStream, Z_NO_FLUSH);
+			
+			//	Z_BUF_ERROR only means no progress was possible - a corrupt member is Z_DATA_ERROR:
+			if ((zResult != Z_OK) && (zResult != Z_STREAM_END) && (zResult != Z_BUF_ERROR))
+			{
+				retValDecompress = (zResult == Z_MEM_ERROR) ? STATUS_CODE_FAIL : STATUS_CODE_INPUT_ERROR;
+				break;
+			}
+			retValDecompress = decompressorWrite(decompressor->pipeWriteFd, (const char *) output,
+												 DECOMPRESS_BUFFER_SIZE - zStream.avail_out);
+		} while ((retValDecompress == STATUS_CODE_SUCCESS) && ((zStream.avail_out == 0) || (zStream.avail_in > 0)));
+	}
+	if ((retValDecompress == STATUS_CODE_SUCCESS) && ((bytesRead < 0) || (zResult != Z_STREAM_END)))
+	{
+		retValDecompress = STATUS_CODE_INPUT_ERROR;	// Truncated member.
+	}
+	inflateEnd(&zStream);
+	free(input);
+	free(output);
+	return retValDecompress;
+}
+#endif
+
+
+#ifdef SPREADER_DETECTOR_ZSTD
+/**
+ * @brief A function that decompresses a Zstandard file into the pipe, a block at a time.
+ * @details Files of several frames are decompressed one frame after the other, as zstd does.
+ * @param[in] decompressor the decompressor.
+ * @param[out] STATUS_CODE_SUCCESS If the whole file was decompressed.
+ * @param[out] STATUS_CODE_INPUT_ERROR If the file is corrupt or truncated.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If writing to the pipe failed.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+static StatusCode decompressZstd(Decompressor *decompressor)
+{
+	size_t inputCapacity = ZSTD_DStreamInSize(), outputCapacity = ZSTD_DStreamOutSize();
+	char *input = (char *) malloc(inputCapacity);
+	char *output = (char *) malloc(outputCapacity);
+	ZSTD_DCtx *zstdContext = ZSTD_createDCtx();
+	if ((input == NULL) || (output == NULL) || (zstdContext == NULL))
+	{
+		ZSTD_freeDCtx(zstdContext);
+		free(input);
+		free(output);
+		return STATUS_CODE_FAIL;
+	}
+	StatusCode retValDecompress = STATUS_CODE_SUCCESS;
+	size_t zstdResult = 0;
+	ssize_t bytesRead = 0;
+	while ((retValDecompress == STATUS_CODE_SUCCESS) &&
+		   ((bytesRead = read(decompressor->compressedFd, input, inputCapacity)) > 0))
+	{
+		//	A frame's last byte isn't consumed before all of its data is flushed:
+		ZSTD_inBuffer inBuffer = {input, (size_t) bytesRead, 0};
+		while ((retValDecompress == STATUS_CODE_SUCCESS) && (inBuffer.pos < inBuffer.size))
+		{
+			ZSTD_outBuffer outBuffer = {output, outputCapacity, 0};
+			zstdResult = ZSTD_decompressStream(zstdContext, &outBuffer, &inBuffer);
+			if (ZSTD_isError(zstdResult))
+			{
+				retValDecompress = (ZSTD_getErrorCode(zstdResult) == ZSTD_error_memory_allocation) ?
+								   STATUS_CODE_FAIL : STATUS_CODE_INPUT_ERROR;	// A corrupt frame.
+				break;
+			}
+			retValDecompress = decompressorWrite(decompressor->pipeWriteFd, output, outBuffer.pos);
+		}
+	}
+	if ((retValDecompress == STATUS_CODE_SUCCESS) && ((bytesRead < 0) || (zstdResult != 0)))
+	{
+		retValDecompress = STATUS_CODE_INPUT_ERROR;	// Truncated frame.
+	}
+	ZSTD_freeDCtx(zstdContext);
+	free(input);
+	free(output);
+	return retValDecompress;
+}
+#endif
+
+
+/**
+ * @brief The function run by the decompressing thread.
+ * @details SIGPIPE is blocked in the thread: if the reader stops early and closes the pipe, the writes fail
+ * (and the thread ends) instead of the process being killed.
+ * @param[in] decompressor a pointer to the Decompressor. Its status is set when the thread ends.
+ * @return NULL.
+ */
+static void *decompressorWorker(void *decompressor)
+{
+	Decompressor *fileDecompressor = (Decompressor *) decompressor;
+	sigset_t pipeSignal;
+	sigemptyset(&pipeSignal);
+	sigaddset(&pipeSignal, SIGPIPE);
+	pthread_sigmask(SIG_BLOCK, &pipeSignal, NULL);
+	
+	StatusCode retValDecompress = STATUS_CODE_FAIL;
+#ifdef SPREADER_DETECTOR_ZLIB
+	if (fileDecompressor->compression == COMPRESSION_GZIP)
+	{
+		retValDecompress = decompressGzip(fileDecompressor);
+	}
+#endif
+#ifdef SPREADER_DETECTOR_ZSTD
+	if (fileDecompressor->compression == COMPRESSION_ZSTD)
+	{
+		retValDecompress = decompressZstd(fileDecompressor);
+	}
+#endif
+	close(fileDecompressor->pipeWriteFd);
+	close(fileDecompressor->compressedFd);
+	fileDecompressor->status = retValDecompress;
+	return NULL;
+}
+
+
+/**
+ * @brief A function that starts decompressing a compressed input file, on its own thread, into a pipe.
+ * @details The readers read the pipe as they read a plain (non-regular) file - line by line, or whole. The
+ * pipe is the buffer between the thread and the reader, so decompression and parsing overlap.
+ * @note The function takes compressedFd, and ALLOCATES the thread and the returned FILE. Released by
+ * inputFileClose.
+ * @param[in] compressedFd the opened compressed file. Closed (by the thread, or here in failure).
+ * @param[in] compression the format of the file.
+ * @param[in] decompressor the decompressor to start. Must be zero initialized.
+ * @return the read end of the pipe, or NULL if the format wasn't compiled in, or the thread couldn't start.
+ */
+FILE *decompressorOpen(int compressedFd, Compression compression, Decompressor *decompressor)
+{
+	int pipeFds[2] = {-1, -1};
+	if (!compressionIsSupported(compression) || (pipe(pipeFds) != 0))
+	{
+		close(compressedFd);
+		return NULL;
+	}
+	decompressor->compressedFd = compressedFd;
+	decompressor->pipeWriteFd = pipeFds[1];
+	decompressor->compression = compression;
+	decompressor->status = STATUS_CODE_SUCCESS;
+	FILE *pipeFile = fdopen(pipeFds[0], "r");
+	if ((pipeFile == NULL) || (pthread_create(&decompressor->thread, NULL, decompressorWorker, decompressor) != 0))
+	{
+		if (pipeFile != NULL)
+		{
+			fclose(pipeFile);
+		}
+		else
+		{
+			close(pipeFds[0]);
+		}
+		close(pipeFds[1]);
+		close(compressedFd);
+		return NULL;
+	}
+	decompressor->isStarted = 1;
+	return pipeFile;
+}
+
+
+/**
+ * @brief A function that opens an input file for reading: compressed files (see detectCompression) are
+ * decompressed on the fly (decompressorOpen), other files are opened as they are.
+ * @note The file is closed by inputFileClose.
+ * @param[in] inputFilePath the path of the file.
+ * @param[in] decompressor started if the file is compressed. Must be zero initialized.
+ * @return the opened file, or NULL if it couldn't be opened.
+ */
+FILE *inputFileOpen(const char *inputFilePath, Decompressor *decompressor)
+{
+	int inputFd = open(inputFilePath, O_RDONLY);
+	if (inputFd < 0)
+	{
+		return NULL;
+	}
+	Compression compression = detectCompression(inputFd);
+	if (compression != COMPRESSION_NONE)
+	{
+		return decompressorOpen(inputFd, compression, decompressor);
+	}
+	FILE *inputFile = fdopen(inputFd, "r");
+	if (inputFile == NULL)
+	{
+		close(inputFd);
+	}
+	return inputFile;
+}
+
+
+/**
+ * @brief A function that closes an input file opened by inputFileOpen (or decompressorOpen), and waits for
+ * its decompression to end.
+ * @details A corrupt or truncated compressed file reads as a shorter plain file, so its failure is reported
+ * here.
+ * @param[in] inputFile the file.
+ * @param[in] decompressor the decompressor of the file (not started for a plain file).
+ * @param[out] STATUS_CODE_SUCCESS If the file was closed, and decompressed successfully.
+ * @param[out] STATUS_CODE_INPUT_ERROR Otherwise.
+ */
+StatusCode inputFileClose(FILE *inputFile, Decompressor *decompressor)
+{
+	StatusCode retValClose = (fclose(inputFile) == 0) ? STATUS_CODE_SUCCESS : STATUS_CODE_INPUT_ERROR;
+	if (decompressor->isStarted)
+	{
+		pthread_join(decompressor->thread, NULL);
+		decompressor->isStarted = 0;
+		if (decompressor->status != STATUS_CODE_SUCCESS)
+		{
+			retValClose = STATUS_CODE_INPUT_ERROR;
+		}
+	}
+	return retValClose;
+}
+
+
+#ifdef SPREADER_DETECTOR_IO_URING
+/**
+ * @brief A function that sets up the io_uring of a ReadAhead, with the raw system calls.
+ * @details The reads use IORING_OP_READ, and the rings share one mapping - so Linux 5.6 is needed. A regular
+ * file is read at explicit offsets from its current position, so all the blocks can be in flight at once.
+ * Other files (pipes) are read at their position, one block at a time.
+ * @param[in] readAhead the ReadAhead. Its inputFd must be set.
+ * @param[out] STATUS_CODE_SUCCESS If the io_uring was set up.
+ * @param[out] STATUS_CODE_FAIL If io_uring isn't available (an old kernel, or a sandbox which blocks it).
+ */
+static StatusCode readAheadRingSetup(ReadAhead *readAhead)
+{
+	ReadAheadRing *ring = &readAhead->ring;
+	struct io_uring_params ringParams;
+	memset(&ringParams, 0, sizeof(ringParams));
+	ring->ringFd = (int) syscall(__NR_io_uring_setup, READ_AHEAD_RING_ENTRIES, &ringParams);
+	if (ring->ringFd < 0)
+	{
+		return STATUS_CODE_FAIL;
+	}
+	if (!(ringParams.features & IORING_FEAT_SINGLE_MMAP) || !(ringParams.features & IORING_FEAT_RW_CUR_POS))
+	{
+		close(ring->ringFd);
+		return STATUS_CODE_FAIL;
+	}
+	
+	// ## MAP THE RINGS ##
+	size_t sqRingSize = ringParams.sq_off.array + (ringParams.sq_entries * sizeof(unsigned int));
+	size_t cqRingSize = ringParams.cq_off.cqes + (ringParams.cq_entries * sizeof(struct io_uring_cqe));
+	ring->ringMappingSize = (sqRingSize > cqRingSize) ? sqRingSize : cqRingSize;
+	ring->sqesSize = ringParams.sq_entries * sizeof(struct io_uring_sqe);
+	ring->ringMapping = mmap(NULL, ring->ringMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, ring->ringFd,
+							 IORING_OFF_SQ_RING);
+	ring->sqes = (struct io_uring_sqe *) mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+											  ring->ringFd, IORING_OFF_SQES);
+	if ((ring->ringMapping == MAP_FAILED) || (ring->sqes == MAP_FAILED))
+	{
+		if (ring->ringMapping != MAP_FAILED)
+		{
+			munmap(ring->ringMapping, ring->ringMappingSize);
+		}
+		if (ring->sqes != MAP_FAILED)
+		{
+			munmap(ring->sqes, ring->sqesSize);
+		}
+		close(ring->ringFd);
+		return STATUS_CODE_FAIL;
+	}
+	char *ringBase = (char *) ring->ringMapping;
+	ring->sqTail = (unsigned int *) (ringBase + ringParams.sq_off.tail);
+	ring->sqMask = (unsigned int *) (ringBase + ringParams.sq_off.ring_mask);
+	ring->sqArray = (unsigned int *) (ringBase + ringParams.sq_off.array);
+	ring->cqHead = (unsigned int *) (ringBase + ringParams.cq_off.head);
+	ring->cqTail = (unsigned int *) (ringBase + ringParams.cq_off.tail);
+	ring->cqMask = (unsigned int *) (ringBase + ringParams.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe *) (ringBase + ringParams.cq_off.cqes);
+	
+	//	Regular files are read at explicit offsets, others at their position:
+	struct stat inputStat;
+	off_t position = lseek(readAhead->inputFd, 0, SEEK_CUR);
+	ring->isSeekable = ((position >= 0) && (fstat(readAhead->inputFd, &inputStat) == 0) &&
+						S_ISREG(inputStat.st_mode));
+	ring->nextOffset = ring->isSeekable ? (unsigned long long) position : 0;
+	ring->isEndOfFile = 0;
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that submits one request to the io_uring of a ReadAhead.
+ * @param[in] ring the io_uring.
+ * @param[in] request the request to submit.
+ * @param[out] STATUS_CODE_SUCCESS If the request was submitted.
+ * @param[out] STATUS_CODE_INPUT_ERROR Otherwise.
+ */
+static StatusCode readAheadRingSubmit(ReadAheadRing *ring, const struct io_uring_sqe *request)
+{
+	unsigned int tail = *ring->sqTail;	// Only written by us.
+	unsigned int entryIndex = tail & *ring->sqMask;
+	ring->sqes[entryIndex] = *request;
+	ring->sqArray[entryIndex] = entryIndex;
+	__atomic_store_n(ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+	
+	long submitted = 0;
+	do
+	{
+		submitted = syscall(__NR_io_uring_enter, ring->ringFd, 1, 0, 0, NULL, 0);
+	} while ((submitted < 0) && (errno == EINTR));
+	return (submitted == 1) ? STATUS_CODE_SUCCESS : STATUS_CODE_INPUT_ERROR;
+}
+
+
+/**
+ * @brief A function that submits the read of the rest of a block (from its length) to the io_uring.
+ * @param[in] readAhead the ReadAhead.
+ * @param[in] blockIndex the block. Its status is set to an error if the read couldn't be submitted.
+ */
+static void readAheadRingRead(ReadAhead *readAhead, unsigned int blockIndex)
+{
+	ReadAheadBlock *block = readAhead->blocks + blockIndex;
+	struct io_uring_sqe request;
+	memset(&request, 0, sizeof(request));
+	request.opcode = IORING_OP_READ;
+	request.fd = readAhead->inputFd;
+	request.addr = (unsigned long long) (uintptr_t) (block->data + block->length);
+	request.len = (unsigned int) (READ_AHEAD_BLOCK_SIZE - block->length);
+	request.off = readAhead->ring.isSeekable ? (block->offset + block->length) : READ_AHEAD_CURRENT_POSITION;
+	request.user_data = blockIndex;
+	block->isInFlight = (readAheadRingSubmit(&readAhead->ring, &request) == STATUS_CODE_SUCCESS);
+	if (!block->isInFlight)
+	{
+		block->status = STATUS_CODE_INPUT_ERROR;
+	}
+}
+
+
+/**
+ * @brief A function that starts reading the next block of the file into an (empty) block, unless the end of
+ * the file was already read - then the block is left empty.
+ * @param[in] readAhead the ReadAhead.
+ * @param[in] blockIndex the block.
+ */
+static void readAheadRingStartBlock(ReadAhead *readAhead, unsigned int blockIndex)
+{
+	ReadAheadBlock *block = readAhead->blocks + blockIndex;
+	block->length = 0;
+	block->status = STATUS_CODE_SUCCESS;
+	if (readAhead->ring.isEndOfFile)
+	{
+		return;
+	}
+	block->offset = readAhead->ring.nextOffset;
+	if (readAhead->ring.isSeekable)
+	{
+		readAhead->ring.nextOffset += READ_AHEAD_BLOCK_SIZE;
+	}
+	readAheadRingRead(readAhead, blockIndex);
+}
+
+
+/**
+ * @brief A function that waits for completions of the io_uring, and handles them.
+ * @details A read which was interrupted is submitted again, and a short read is continued (so every block but
+ * the last is full, as with the reader thread) - until the file is read to its end.
+ * @param[in] readAhead the ReadAhead.
+ * @param[out] STATUS_CODE_SUCCESS If completions were handled.
+ * @param[out] STATUS_CODE_INPUT_ERROR If waiting failed.
+ */
+static StatusCode readAheadRingWait(ReadAhead *readAhead)
+{
+	ReadAheadRing *ring = &readAhead->ring;
+	unsigned int head = *ring->cqHead;	// Only written by us.
+	if (head == __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE))
+	{
+		long waited = syscall(__NR_io_uring_enter, ring->ringFd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+		if ((waited < 0) && (errno != EINTR))
+		{
+			return STATUS_CODE_INPUT_ERROR;
+		}
+	}
+	
+	while (head != __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE))
+	{
+		struct io_uring_cqe completion = ring->cqes[head & *ring->cqMask];
+		head++;
+		__atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+		if (completion.user_data == READ_AHEAD_CANCEL_TAG)
+		{
+			continue;
+		}
+		
+		ReadAheadBlock *block = readAhead->blocks + completion.user_data;
+		block->isInFlight = 0;
+		if (readAhead->isStopping || (completion.res == -ECANCELED))
+		{
+			continue;
+		}
+		if ((completion.res == -EINTR) || (completion.res == -EAGAIN))
+		{
+			readAheadRingRead(readAhead, (unsigned int) completion.user_data);
+		}
+		else if (completion.res < 0)
+		{
+			block->status = STATUS_CODE_INPUT_ERROR;
+		}
+		else if (completion.res == 0)
+		{
+			ring->isEndOfFile = 1;
+		}
+		else
+		{
+			block->length += (size_t) completion.res;
+			if (block->length < READ_AHEAD_BLOCK_SIZE)
+			{
+				readAheadRingRead(readAhead, (unsigned int) completion.user_data);
+			}
+		}
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that cancels the reads in flight, waits for them, and releases the io_uring.
+ * @details The kernel may write into a block until its read completes, so the blocks are released only after.
+ * @param[in] readAhead the ReadAhead.
+ */
+static void readAheadRingFree(ReadAhead *readAhead)
+{
+	ReadAheadRing *ring = &readAhead->ring;
+	readAhead->isStopping = 1;
+	unsigned int blockIndex = 0, inFlightCount = 0;
+	for (blockIndex = 0; blockIndex < READ_AHEAD_BLOCK_COUNT; blockIndex++)
+	{
+		if (readAhead->blocks[blockIndex].isInFlight)
+		{
+			struct io_uring_sqe request;
+			memset(&request, 0, sizeof(request));
+			request.opcode = IORING_OP_ASYNC_CANCEL;
+			request.addr = blockIndex;	// The user_data of the read.
+			request.user_data = READ_AHEAD_CANCEL_TAG;
+			readAheadRingSubmit(ring, &request);
+			inFlightCount++;
+		}
+	}
+	while (inFlightCount > 0)
+	{
+		if (readAheadRingWait(readAhead) != STATUS_CODE_SUCCESS)
+		{
+			break;
+		}
+		inFlightCount = 0;
+		for (blockIndex = 0; blockIndex < READ_AHEAD_BLOCK_COUNT; blockIndex++)
+		{
+			inFlightCount += (unsigned int) readAhead->blocks[blockIndex].isInFlight;
+		}
+	}
+	munmap(ring->sqes, ring->sqesSize);
+	munmap(ring->ringMapping, ring->ringMappingSize);
+	close(ring->ringFd);
+}
+#endif
+
+
+/**
+ * @brief The function run by the reader thread of a ReadAhead.
+ * @details The thread fills the free blocks in order, each until it is full or the input ends, and ends after
+ * handing over an empty block (the end of the input) or a failed one. Only the read() itself can be canceled
+ * (see readAheadStop), so the thread never stops holding the mutex.
+ * @param[in] readAhead a pointer to the ReadAhead.
+ * @return NULL.
+ */
+static void *readAheadWorker(void *readAhead)
+{
+	ReadAhead *fileReadAhead = (ReadAhead *) readAhead;
+	unsigned int blockIndex = 0;
+	int cancelState = 0, isLastBlock = 0;
+	ssize_t readSize = 1;
+	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cancelState);
+	while (!isLastBlock)
+	{
+		// ## WAIT FOR A FREE BLOCK ##
+		pthread_mutex_lock(&fileReadAhead->mutex);
+		while ((fileReadAhead->filledCount == READ_AHEAD_BLOCK_COUNT) && !fileReadAhead->isStopping)
+		{
+			pthread_cond_wait(&fileReadAhead->blockFreed, &fileReadAhead->mutex);
+		}
+		int isStopping = fileReadAhead->isStopping;
+		pthread_mutex_unlock(&fileReadAhead->mutex);
+		if (isStopping)
+		{
+			break;
+		}
+		
+		// ## READ THE BLOCK ## - until it is full, or the input ended:
+		ReadAheadBlock *block = fileReadAhead->blocks + blockIndex;
+		block->length = 0;
+		block->status = STATUS_CODE_SUCCESS;
+		while ((block->length < READ_AHEAD_BLOCK_SIZE) && (readSize > 0))
+		{
+			pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, &cancelState);
+			readSize = read(fileReadAhead->inputFd, block->data + block->length,
+							READ_AHEAD_BLOCK_SIZE - block->length);
+			pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cancelState);
+			if (readSize > 0)
+			{
+				block->length += (size_t) readSize;
+			}
+			else if ((readSize < 0) && (errno == EINTR))
+			{
+				readSize = 1;
+			}
+		}
+		if (readSize < 0)
+		{
+			block->status = STATUS_CODE_INPUT_ERROR;
+		}
+		isLastBlock = ((block->length == 0) || (block->status != STATUS_CODE_SUCCESS));
+		
+		// ## HAND THE BLOCK OVER ##
+		pthread_mutex_lock(&fileReadAhead->mutex);
+		fileReadAhead->filledCount++;
+		pthread_cond_signal(&fileReadAhead->blockFilled);
+		pthread_mutex_unlock(&fileReadAhead->mutex);
+		blockIndex = (blockIndex + 1) % READ_AHEAD_BLOCK_COUNT;
+	}
+	return NULL;
+}
+
+
+/**
+ * @brief A function that starts reading a file ahead: its next blocks are read while the current one is used.
+ * @details With SPREADER_DETECTOR_IO_URING the reads are submitted to an io_uring, if the kernel has one.
+ * Otherwise (and as a fallback) a reader thread reads them. Nothing was read from the file before.
+ * @note The function ALLOCATES MEMORY being stored in readAhead. released by readAheadStop. A failure isn't
+ * reported - the caller reads the file by itself.
+ * @param[in] readAhead the ReadAhead to start.
+ * @param[in] inputFd the file. Not closed by the ReadAhead.
+ * @param[out] STATUS_CODE_SUCCESS If the reads were started.
+ * @param[out] STATUS_CODE_FAIL Otherwise.
+ */
+static StatusCode readAheadStart(ReadAhead *readAhead, int inputFd)
+{
+	memset(readAhead, 0, sizeof(*readAhead));
+	readAhead->inputFd = inputFd;
+	readAhead->buffer = (char *) malloc((size_t) READ_AHEAD_BLOCK_COUNT * READ_AHEAD_BLOCK_SIZE);
+	if (readAhead->buffer == NULL)
+	{
+		return STATUS_CODE_FAIL;
+	}
+	unsigned int blockIndex = 0;
+	for (blockIndex = 0; blockIndex < READ_AHEAD_BLOCK_COUNT; blockIndex++)
+	{
+		readAhead->blocks[blockIndex].data = readAhead->buffer + ((size_t) blockIndex * READ_AHEAD_BLOCK_SIZE);
+	}
+	
+#ifdef SPREADER_DETECTOR_IO_URING
+	//	A regular file has all its blocks in flight, a pipe one block at a time:
+	if (readAheadRingSetup(readAhead) == STATUS_CODE_SUCCESS)
+	{
+		readAhead->backend = READ_AHEAD_IO_URING;
+		for (blockIndex = 0; blockIndex < (readAhead->ring.isSeekable ? READ_AHEAD_BLOCK_COUNT : 1); blockIndex++)
+		{
+			readAheadRingStartBlock(readAhead, blockIndex);
+		}
+		return STATUS_CODE_SUCCESS;
+	}
+#endif
+	readAhead->backend = READ_AHEAD_THREAD;
+	pthread_mutex_init(&readAhead->mutex, NULL);
+	pthread_cond_init(&readAhead->blockFilled, NULL);
+	pthread_cond_init(&readAhead->blockFreed, NULL);
+	if (pthread_create(&readAhead->thread, NULL, readAheadWorker, readAhead) != 0)
+	{
+		pthread_mutex_destroy(&readAhead->mutex);
+		pthread_cond_destroy(&readAhead->blockFilled);
+		pthread_cond_destroy(&readAhead->blockFreed);
+		free(readAhead->buffer);
+		readAhead->buffer = NULL;
+		return STATUS_CODE_FAIL;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that returns the next block of the file, waiting for it to be read.
+ * @details The block returned before is released (and read into again), so its data is no longer valid.
+ * @param[in] readAhead the ReadAhead.
+ * @param[in] data set to the data of the block.
+ * @param[in] length set to the length of the block. 0 at the end of the file - not to be called after.
+ * @param[out] STATUS_CODE_SUCCESS If a block was returned.
+ * @param[out] STATUS_CODE_INPUT_ERROR If reading failed.
+ */
+static StatusCode readAheadNext(ReadAhead *readAhead, const char **data, size_t *length)
+{
+	unsigned int heldBlock = readAhead->nextBlock;
+	if (readAhead->isHoldingBlock)
+	{
+		readAhead->nextBlock = (readAhead->nextBlock + 1) % READ_AHEAD_BLOCK_COUNT;
+		readAhead->isHoldingBlock = 0;
+	}
+	ReadAheadBlock *block = readAhead->blocks + readAhead->nextBlock;
+	
+#ifdef SPREADER_DETECTOR_IO_URING
+	if (readAhead->backend == READ_AHEAD_IO_URING)
+	{
+		//	The released block reads the file's next range (a pipe's next block is read once this one is in):
+		if ((heldBlock != readAhead->nextBlock) && readAhead->ring.isSeekable)
+		{
+			readAheadRingStartBlock(readAhead, heldBlock);
+		}
+		while (block->isInFlight)
+		{
+			if (readAheadRingWait(readAhead) != STATUS_CODE_SUCCESS)
+			{
+				return STATUS_CODE_INPUT_ERROR;
+			}
+		}
+		if (!readAhead->ring.isSeekable && (block->length > 0))
+		{
+			readAheadRingStartBlock(readAhead, (readAhead->nextBlock + 1) % READ_AHEAD_BLOCK_COUNT);
+		}
+	}
+	else
+#endif
+	{
+		pthread_mutex_lock(&readAhead->mutex);
+		if (heldBlock != readAhead->nextBlock)
+		{
+			readAhead->filledCount--;
+			pthread_cond_signal(&readAhead->blockFreed);
+		}
+		while (readAhead->filledCount == 0)
+		{
+			pthread_cond_wait(&readAhead->blockFilled, &readAhead->mutex);
+		}
+		pthread_mutex_unlock(&readAhead->mutex);
+	}
+	
+	readAhead->isHoldingBlock = 1;
+	*data = block->data;
+	*length = block->length;
+	return block->status;
+}
+
+
+/**
+ * @brief A function that stops reading ahead, and releases the memory held by the ReadAhead.
+ * @details Reads in flight are canceled - a read of a pipe might wait for input which never comes.
+ * @param[in] readAhead the ReadAhead. Must be started.
+ */
+static void readAheadStop(ReadAhead *readAhead)
+{
+#ifdef SPREADER_DETECTOR_IO_URING
+	if (readAhead->backend == READ_AHEAD_IO_URING)
+	{
+		readAheadRingFree(readAhead);
+	}
+	else
+#endif
+	{
+		pthread_mutex_lock(&readAhead->mutex);
+		readAhead->isStopping = 1;
+		pthread_cond_broadcast(&readAhead->blockFreed);
+		pthread_mutex_unlock(&readAhead->mutex);
+		pthread_cancel(readAhead->thread);
+		pthread_join(readAhead->thread, NULL);
+		pthread_mutex_destroy(&readAhead->mutex);
+		pthread_cond_destroy(&readAhead->blockFilled);
+		pthread_cond_destroy(&readAhead->blockFreed);
+	}
+	free(readAhead->buffer);
+	readAhead->buffer = NULL;
+}
+
+
+/**
+ * @brief The portable findLineEnd kernel.
+ * @details Compares 16 bytes at a time against '\n' when the program was compiled with SSE2, with a scalar
+ * loop for the tail, or for the whole range otherwise.
+ * @param[in] cursor a pointer to the beginning of the range to search.
+ * @param[in] end a pointer to the end of the range to search.
+ * @return a pointer to the first '\n' in the range, or end if there is none.
+ */
+static const char *findLineEndPortable(const char *cursor, const char *end)
+{
+#if defined(__SSE2__)
+	const __m128i newLines128 = _mm_set1_epi8('\n');
+	while ((end - cursor) >= (long) sizeof(__m128i))
+	{
+		__m128i chunk = _mm_loadu_si128((const __m128i *) cursor);
+		unsigned int mask = (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newLines128));
+		if (mask != 0)
+		{
+			return (cursor + __builtin_ctz(mask));
+		}
+		cursor += sizeof(__m128i);
+	}
+#endif
+	while ((cursor < end) && (*cursor != '\n'))
+	{
+		cursor++;
+	}
+	return cursor;
+}
+
+
+#if AVX2_DISPATCH
+/**
+ * @brief The AVX2 findLineEnd kernel: 32 bytes at a time, the rest by findLineEndPortable.
+ * @details Compiled for AVX2 even when the program isn't, and chosen at runtime only on CPUs which have it.
+ * @param[in] cursor a pointer to the beginning of the range to search.
+ * @param[in] end a pointer to the end of the range to search.
+ * @return a pointer to the first '\n' in the range, or end if there is none.
+ */
+__attribute__((target("avx2")))
+static const char *findLineEndAvx2(const char *cursor, const char *end)
+{
+	const __m256i newLines256 = _mm256_set1_epi8('\n');
+	while ((end - cursor) >= (long) sizeof(__m256i))
+	{
+		__m256i chunk = _mm256_loadu_si256((const __m256i *) cursor);
+		unsigned int mask = (unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newLines256));
+		if (mask != 0)
+		{
+			return (cursor + __builtin_ctz(mask));
+		}
+		cursor += sizeof(__m256i);
+	}
+	return findLineEndPortable(cursor, end);
+}
+#endif
+
+
+/**
+ * @brief A function that chooses the findLineEnd kernel: AVX2 if the CPU has it, otherwise the portable one.
+ */
+static void findLineEndSelectKernel()
+{
+	findLineEndKernel = findLineEndPortable;
+#if AVX2_DISPATCH
+	if (__builtin_cpu_supports("avx2"))
+	{
+		findLineEndKernel = findLineEndAvx2;
+	}
+#endif
+}
+
+
+/**
+ * @brief A function that finds the end of the current line, with the best kernel of the CPU.
+ * @param[in] cursor a pointer to the beginning of the range to search.
+ * @param[in] end a pointer to the end of the range to search.
+ * @return a pointer to the first '\n' in the range, or end if there is none.
+ */
+const char *findLineEnd(const char *cursor, const char *end)
+{
+	pthread_once(&findLineEndKernelOnce, findLineEndSelectKernel);
+	return findLineEndKernel(cursor, end);
+}
+
+
+/**
+ * @brief A function that initializes a LineReader over an opened file.
+ * @note The function ALLOCATES MEMORY being stored in lineReader. released by lineReaderFree.
+ * @param[in] lineReader the reader to initialize.
+ * @param[in] inputFile the opened file to read from. Not closed by the reader.
+ * @param[out] STATUS_CODE_SUCCESS If the reader was initialized successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode lineReaderInit(LineReader *lineReader, FILE *inputFile)
+{
+	lineReader->buffer = (char *) malloc(READER_BUFFER_SIZE);
+	if (lineReader->buffer == NULL)
+	{
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	lineReader->inputFile = inputFile;
+	lineReader->capacity = READER_BUFFER_SIZE;
+	lineReader->start = 0;
+	lineReader->scanned = 0;
+	lineReader->end = 0;
+	lineReader->isEndOfFile = 0;
+	lineReader->bytesRead = 0;
+	lineReader->isStreaming = 0;
+	lineReader->onIdle = NULL;
+	lineReader->idleContext = NULL;
+	lineReader->readAhead = NULL;
+	lineReader->aheadData = NULL;
+	lineReader->aheadLength = 0;
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that returns the next line of the file.
+ * @details The file is read in large blocks (read ahead - see lineReaderReadAhead). A line which crosses the
+ * end of a block is moved to the beginning of the buffer before the next block is read, and the buffer grows
+ * if a single line doesn't fit.
+ * @note The returned line is valid until the next call. It doesn't include the '\n' and isn't '\0' terminated.
+ * @param[in] lineReader the reader.
+ * @param[in] lineStart set to the beginning of the line.
+ * @param[in] lineEnd set to the end of the line.
+ * @param[out] STATUS_CODE_SUCCESS If a line was returned.
+ * @param[out] STATUS_CODE_END_OF_FILE If there are no more lines.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode lineReaderNextLine(LineReader *lineReader, const char **lineStart, const char **lineEnd)
+{
+	while (1)
+	{
+		//	Search for the end of the line in what was already read:
+		const char *bufferEnd = lineReader->buffer + lineReader->end;
+		const char *newLine = findLineEnd(lineReader->buffer + lineReader->scanned, bufferEnd);
+		if (newLine < bufferEnd)
+		{
+			*lineStart = lineReader->buffer + lineReader->start;
+			*lineEnd = newLine;
+			lineReader->start = (size_t) (newLine - lineReader->buffer) + 1;
+			lineReader->scanned = lineReader->start;
+			return STATUS_CODE_SUCCESS;
+		}
+		lineReader->scanned = lineReader->end;
+		
+		//	Last line, without a 'new line':
+		if (lineReader->isEndOfFile)
+		{
+			if (lineReader->start == lineReader->end)
+			{
+				return STATUS_CODE_END_OF_FILE;
+			}
+			*lineStart = lineReader->buffer + lineReader->start;
+			*lineEnd = bufferEnd;
+			lineReader->start = lineReader->end;
+			return STATUS_CODE_SUCCESS;
+		}
+		
+		//	Move the partial line to the beginning of the buffer, and grow the buffer if it is full:
+		size_t leftover = lineReader->end - lineReader->start;
+		memmove(lineReader->buffer, lineReader->buffer + lineReader->start, leftover);
+		lineReader->start = 0;
+		lineReader->scanned = leftover;
+		lineReader->end = leftover;
+		if (leftover == lineReader->capacity)
+		{
+			char *temporaryBufferPointer = (char *) realloc(lineReader->buffer, 2 * lineReader->capacity);
+			if (temporaryBufferPointer == NULL)
+			{
+				error(STATUS_CODE_FAIL);
+				return STATUS_CODE_FAIL;
+			}
+			lineReader->buffer = temporaryBufferPointer;
+			lineReader->capacity *= 2;
+		}
+		
+		//	Read the next block (or, when streaming, whatever input is available):
+		size_t bytesRead = 0;
+		if (lineReader->isStreaming)
+		{
+			StatusCode retValRead = lineReaderReadAvailable(lineReader, &bytesRead);
+			if (retValRead != STATUS_CODE_SUCCESS)
+			{
+				return retValRead;
+			}
+		}
+		else
+		{
+			//	Reading ahead starts with the first block (a streaming reader reads by itself):
+			if ((lineReader->readAhead == NULL) && (lineReader->bytesRead == 0))
+			{
+				lineReaderStartReadAhead(lineReader);
+			}
+			if (lineReader->readAhead != NULL)
+			{
+				StatusCode retValRead = lineReaderReadAhead(lineReader, &bytesRead);
+				if (retValRead != STATUS_CODE_SUCCESS)
+				{
+					return retValRead;
+				}
+			}
+			else
+			{
+				bytesRead = fread(lineReader->buffer + lineReader->end, 1,
+								  lineReader->capacity - lineReader->end, lineReader->inputFile);
+				if ((bytesRead == 0) && ferror(lineReader->inputFile))
+				{
+					error(STATUS_CODE_INPUT_ERROR);
+					return STATUS_CODE_INPUT_ERROR;
+				}
+			}
+		}
+		if (bytesRead == 0)
+		{
+			lineReader->isEndOfFile = 1;
+		}
+		lineReader->end += bytesRead;
+		lineReader->bytesRead += bytesRead;
+	}
+}
+
+
+/**
+ * @brief A function that starts reading the file of a LineReader ahead.
+ * @details The file is read through its descriptor from now on, as nothing was read through its stdio buffer.
+ * If reading ahead can't start, the reader reads the file by itself (fread).
+ * @param[in] lineReader the reader. Nothing was read yet.
+ */
+static void lineReaderStartReadAhead(LineReader *lineReader)
+{
+	ReadAhead *readAhead = (ReadAhead *) malloc(sizeof(ReadAhead));
+	if ((readAhead != NULL) && (readAheadStart(readAhead, fileno(lineReader->inputFile)) == STATUS_CODE_SUCCESS))
+	{
+		lineReader->readAhead = readAhead;
+		return;
+	}
+	free(readAhead);
+}
+
+
+/**
+ * @brief A function that copies the next read-ahead data into the free room of the buffer of a LineReader.
+ * @param[in] lineReader the reader. Its buffer must have free room.
+ * @param[in] bytesRead set to the number of bytes copied. 0 at the end of the file.
+ * @param[out] STATUS_CODE_SUCCESS If the data was copied.
+ * @param[out] STATUS_CODE_INPUT_ERROR If reading failed.
+ */
+static StatusCode lineReaderReadAhead(LineReader *lineReader, size_t *bytesRead)
+{
+	if ((lineReader->aheadLength == 0) &&
+		(readAheadNext(lineReader->readAhead, &lineReader->aheadData, &lineReader->aheadLength) !=
+		 STATUS_CODE_SUCCESS))
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	size_t copySize = lineReader->capacity - lineReader->end;
+	if (copySize > lineReader->aheadLength)
+	{
+		copySize = lineReader->aheadLength;
+	}
+	memcpy(lineReader->buffer + lineReader->end, lineReader->aheadData, copySize);
+	lineReader->aheadData += copySize;
+	lineReader->aheadLength -= copySize;
+	*bytesRead = copySize;
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that switches a LineReader to streaming mode.
+ * @details In streaming mode every read returns the input which is available, instead of waiting for a
+ * whole block, so lines are returned as soon as they arrive (e.g. from a pipe).
+ * @param[in] lineReader the reader.
+ * @param[in] onIdle called (with idleContext) before the reader blocks waiting for input. May be NULL.
+ * @param[in] idleContext the argument of onIdle.
+ */
+void lineReaderSetStreaming(LineReader *lineReader, void (*onIdle)(void *), void *idleContext)
+{
+	lineReader->isStreaming = 1;
+	lineReader->onIdle = onIdle;
+	lineReader->idleContext = idleContext;
+}
+
+
+/**
+ * @brief A function that reads the input which is available into the buffer of a streaming LineReader.
+ * @details If no input is waiting, onIdle is called first, and then the read blocks until some arrives.
+ * @param[in] lineReader the reader. Its buffer must have free room.
+ * @param[in] bytesRead set to the number of bytes read. 0 at the end of the input.
+ * @param[out] STATUS_CODE_SUCCESS If the read succeeded.
+ * @param[out] STATUS_CODE_INPUT_ERROR If the read failed.
+ */
+static StatusCode lineReaderReadAvailable(LineReader *lineReader, size_t *bytesRead)
+{
+	int inputFd = fileno(lineReader->inputFile);
+	struct pollfd inputPoll = {0};
+	inputPoll.fd = inputFd;
+	inputPoll.events = POLLIN;
+	if ((lineReader->onIdle != NULL) && (poll(&inputPoll, 1, 0) == 0))
+	{
+		lineReader->onIdle(lineReader->idleContext);
+	}
+	
+	ssize_t readSize = 0;
+	do
+	{
+		readSize = read(inputFd, lineReader->buffer + lineReader->end, lineReader->capacity - lineReader->end);
+	} while ((readSize < 0) && (errno == EINTR));
+	if (readSize < 0)
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	*bytesRead = (size_t) readSize;
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that releases the memory held by the LineReader, and stops its reading ahead.
+ * @param[in] lineReader the reader to release.
+ */
+void lineReaderFree(LineReader *lineReader)
+{
+	if (lineReader->readAhead != NULL)
+	{
+		readAheadStop(lineReader->readAhead);
+		free(lineReader->readAhead);
+		lineReader->readAhead = NULL;
+	}
+	free(lineReader->buffer);
+	lineReader->buffer = NULL;
+	lineReader->capacity = 0;
+}
+
+
+/**
+ * @brief A function that reads a whole (not necessarily regular) file into one buffer.
+ * @note The function ALLOCATES MEMORY being stored in content. The caller releases it, even in failure.
+ * @param[in] inputFile the opened file.
+ * @param[in] content set to the buffer holding the file's content.
+ * @param[in] contentSize set to the size of the file's content.
+ * @param[out] STATUS_CODE_SUCCESS If the file was read successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode readWholeFile(FILE *inputFile, char **content, size_t *contentSize)
+{
+	size_t capacity = 0;
+	*contentSize = 0;
+	while (1)
+	{
+		// ## MEMORY ALLOCATION ## - (Dynamic Array)
+		if (*contentSize == capacity)
+		{
+			capacity = (capacity == 0) ? READER_BUFFER_SIZE : (2 * capacity);
+			char *temporaryContentPointer = (char *) realloc(*content, capacity);
+			if (temporaryContentPointer == NULL)
+			{
+				error(STATUS_CODE_FAIL);
+				return STATUS_CODE_FAIL;
+			}
+			*content = temporaryContentPointer;
+		}
+		
+		size_t bytesRead = fread(*content + *contentSize, 1, capacity - *contentSize, inputFile);
+		if (bytesRead == 0)
+		{
+			if (ferror(inputFile))
+			{
+				error(STATUS_CODE_INPUT_ERROR);
+				return STATUS_CODE_INPUT_ERROR;
+			}
+			return STATUS_CODE_SUCCESS;
+		}
+		*contentSize += bytesRead;
+	}
+}
+
+
+/**
+ * @brief A function that parses a decimal integer in place, the same way strtol does (leading spaces and
+ * a sign are allowed).
+ * @note Unlike strtol, the text doesn't have to be '\0' terminated - parsing stops at end.
+ * @param[in] cursor a pointer to the current position. Advanced past the parsed integer.
+ * @param[in] end a pointer to the end of the text.
+ * @return the parsed value, or 0 if no digits were found.
+ */
+long parseDecimalInteger(const char **cursor, const char *end)
+{
+	const char *curChar = *cursor;
+	long value = 0;
+	int isNegative = 0;
+	
+	while ((curChar < end) && (*curChar == ' '))
+	{
+		curChar++;
+	}
+	if ((curChar < end) && ((*curChar == '-') || (*curChar == '+')))
+	{
+		isNegative = (*curChar == '-');
+		curChar++;
+	}
+	while ((curChar < end) && (*curChar >= '0') && (*curChar <= '9'))
+	{
+		value = (value * 10) + (*curChar - '0');
+		curChar++;
+	}
+	
+	*cursor = curChar;
+	return (isNegative ? -value : value);
+}
+
+
+/**
+ * @brief A function that parses a decimal floating point number in place, giving the same result as strtof.
+ * @details Numbers of the form [sign]digits[.digits] whose digits fit in a float's mantissa, with at most
+ * MAX_FAST_FLOAT_FRACTION_DIGITS digits after the point, are computed as one division of two exact floats -
+ * which IEEE-754 rounds correctly, exactly as strtof does. Any other number is handed to strtof.
+ * @note Unlike strtof, the text doesn't have to be '\0' terminated - parsing stops at end.
+ * @param[in] cursor a pointer to the current position. Advanced past the parsed number.
+ * @param[in] end a pointer to the end of the text.
+ * @return the parsed value, or 0 if no number was found.
+ */
+float parseDecimalFloat(const char **cursor, const char *end)
+{
+	static const float powersOfTen[MAX_FAST_FLOAT_FRACTION_DIGITS + 1] =
+		{1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+	const char *curChar = *cursor;
+	unsigned long mantissa = 0;
+	int fractionDigits = 0, isNegative = 0, isExact = 1;
+	
+	while ((curChar < end) && (*curChar == ' '))
+	{
+		curChar++;
+	}
+	const char *numberStart = curChar;
+	
+	if ((curChar < end) && ((*curChar == '-') || (*curChar == '+')))
+	{
+		isNegative = (*curChar == '-');
+		curChar++;
+	}
+	while ((curChar < end) && (*curChar >= '0') && (*curChar <= '9'))
+	{
+		mantissa = (mantissa * 10) + (unsigned long) (*curChar - '0');
+		isExact = isExact && (mantissa <= MAX_FAST_FLOAT_MANTISSA);
+		curChar++;
+	}
+	if ((curChar < end) && (*curChar == '.'))
+	{
+		curChar++;
+		while ((curChar < end) && (*curChar >= '0') && (*curChar <= '9'))
+		{
+			mantissa = (mantissa * 10) + (unsigned long) (*curChar - '0');
+			isExact = isExact && (mantissa <= MAX_FAST_FLOAT_MANTISSA);
+			fractionDigits++;
+			curChar++;
+		}
+	}
+	
+	//	Exponents, hex, inf/nan and too many digits are left to strtof:
+	int isSimpleEnd = ((curChar == end) || (*curChar == ' ') || (*curChar == '\n') || (*curChar == '\r'));
+	if (FAST_FLOAT_ENABLED && isExact && isSimpleEnd && (fractionDigits <= MAX_FAST_FLOAT_FRACTION_DIGITS))
+	{
+		*cursor = curChar;
+		float value = ((float) mantissa) / powersOfTen[fractionDigits];
+		return (isNegative ? -value : value);
+	}
+	
+	char token[INPUT_MAX_LINE_LEN] = {0};
+	size_t tokenLength = 0;
+	while (((numberStart + tokenLength) < end) && (numberStart[tokenLength] != ' ') &&
+		   (numberStart[tokenLength] != '\n') && (tokenLength < (sizeof(token) - 1)))
+	{
+		tokenLength++;
+	}
+	memcpy(token, numberStart, tokenLength);
+	char *checkPtr = NULL;
+	float value = strtof(token, &checkPtr);
+	*cursor = numberStart + (checkPtr - token);
+	return value;
+}
+
+
@@ -0,0 +1,171 @@
+/*
+ * File Name: SpreaderDetectorInput.h
+ * Related Files: "SpreaderDetectorInput.c", "SpreaderDetectorInternal.h"
+ *
+ * Purpose:
+ * 			The functions of SpreaderDetectorInput.c which the other modules of the SpreaderDetector library
+ * 			use. They are internal (hidden): the API of the library is SpreaderDetector.h.
+ *
+ * Author's ID: 206174120
+ * Author's Name: Oren Kovartovsky
+ * University User Name: orenkov
+ *
+ * */
+
+#ifndef SPREADERDETECTORINPUT_H
+#define SPREADERDETECTORINPUT_H
+
+#include "SpreaderDetectorInternal.h"
+
+#if defined(__GNUC__)
+#pragma GCC visibility push(hidden)
+#endif
+
+//	****** DECOMPRESSION FUNCTIONS ******
+/**
+ * @brief A function that detects the compression of an input file by its magic number.
+ *
+ * @details Only regular files are checked (the check reads the beginning of the file without consuming it).
+ * @param[in] inputFd the opened file.
+ * @return the Compression of the file. COMPRESSION_NONE if it isn't a regular file.
+ */
+Compression detectCompression(int inputFd);
+
+/**
+ * @brief A function that starts decompressing a compressed input file, on its own thread, into a pipe.
+ *
+ * @details The readers read the pipe as they read a plain (non-regular) file - line by line, or whole. The
+ * pipe is the buffer between the thread and the reader, so decompression and parsing overlap.
+ * @note The function takes compressedFd, and ALLOCATES the thread and the returned FILE. Released by
+ * inputFileClose.
+ * @param[in] compressedFd the opened compressed file. Closed (by the thread, or here in failure).
+ * @param[in] compression the format of the file.
+ * @param[in] decompressor the decompressor to start. Must be zero initialized.
+ * @return the read end of the pipe, or NULL if the format wasn't compiled in, or the thread couldn't start.
+ */
+FILE *decompressorOpen(int compressedFd, Compression compression, Decompressor *decompressor);
+
+/**
+ * @brief A function that opens an input file for reading: compressed files (see detectCompression) are
+ * decompressed on the fly (decompressorOpen), other files are opened as they are.
+ *
+ * @note The file is closed by inputFileClose.
+ * @param[in] inputFilePath the path of the file.
+ * @param[in] decompressor started if the file is compressed. Must be zero initialized.
+ * @return the opened file, or NULL if it couldn't be opened.
+ */
+FILE *inputFileOpen(const char *inputFilePath, Decompressor *decompressor);
+
+/**
+ * @brief A function that closes an input file opened by inputFileOpen (or decompressorOpen), and waits for
+ * its decompression to end.
+ *
+ * @details A corrupt or truncated compressed file reads as a shorter plain file, so its failure is reported
+ * here.
+ * @param[in] inputFile the file.
+ * @param[in] decompressor the decompressor of the file (not started for a plain file).
+ * @param[out] STATUS_CODE_SUCCESS If the file was closed, and decompressed successfully.
+ * @param[out] STATUS_CODE_INPUT_ERROR Otherwise.
+ */
+StatusCode inputFileClose(FILE *inputFile, Decompressor *decompressor);
+
+
+//	****** LINE READER FUNCTIONS ******
+/**
+ * @brief A function that finds the end of the current line, with the best kernel of the CPU.
+ *
+ * @param[in] cursor a pointer to the beginning of the range to search.
+ * @param[in] end a pointer to the end of the range to search.
+ * @return a pointer to the first '\n' in the range, or end if there is none.
+ */
+const char *findLineEnd(const char *cursor, const char *end);
+
+/**
+ * @brief A function that initializes a LineReader over an opened file.
+ *
+ * @note The function ALLOCATES MEMORY being stored in lineReader. released by lineReaderFree.
+ * @param[in] lineReader the reader to initialize.
+ * @param[in] inputFile the opened file to read from. Not closed by the reader.
+ * @param[out] STATUS_CODE_SUCCESS If the reader was initialized successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode lineReaderInit(LineReader *lineReader, FILE *inputFile);
+
+/**
+ * @brief A function that returns the next line of the file.
+ *
+ * @details The file is read in large blocks (read ahead - see lineReaderReadAhead). A line which crosses the
+ * end of a block is moved to the beginning of the buffer before the next block is read, and the buffer grows
+ * if a single line doesn't fit.
+ * @note The returned line is valid until the next call. It doesn't include the '\n' and isn't '\0' terminated.
+ * @param[in] lineReader the reader.
+ * @param[in] lineStart set to the beginning of the line.
+ * @param[in] lineEnd set to the end of the line.
+ * @param[out] STATUS_CODE_SUCCESS If a line was returned.
+ * @param[out] STATUS_CODE_END_OF_FILE If there are no more lines.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode lineReaderNextLine(LineReader *lineReader, const char **lineStart, const char **lineEnd);
+
+/**
+ * @brief A function that switches a LineReader to streaming mode.
+ *
+ * @details In streaming mode every read returns the input which is available, instead of waiting for a
+ * whole block, so lines are returned as soon as they arrive (e.g. from a pipe).
+ * @param[in] lineReader the reader.
+ * @param[in] onIdle called (with idleContext) before the reader blocks waiting for input. May be NULL.
+ * @param[in] idleContext the argument of onIdle.
+ */
+void lineReaderSetStreaming(LineReader *lineReader, void (*onIdle)(void *), void *idleContext);
+
+/**
+ * @brief A function that releases the memory held by the LineReader, and stops its reading ahead.
+ *
+ * @param[in] lineReader the reader to release.
+ */
+void lineReaderFree(LineReader *lineReader);
+
+/**
+ * @brief A function that reads a whole (not necessarily regular) file into one buffer.
+ *
+ * @note The function ALLOCATES MEMORY being stored in content. The caller releases it, even in failure.
+ * @param[in] inputFile the opened file.
+ * @param[in] content set to the buffer holding the file's content.
+ * @param[in] contentSize set to the size of the file's content.
+ * @param[out] STATUS_CODE_SUCCESS If the file was read successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode readWholeFile(FILE *inputFile, char **content, size_t *contentSize);
+
+
+//	****** NUMBER PARSING FUNCTIONS ******
+/**
+ * @brief A function that parses a decimal integer in place, the same way strtol does (leading spaces and
+ * a sign are allowed).
+ *
+ * @note Unlike strtol, the text doesn't have to be '\0' terminated - parsing stops at end.
+ * @param[in] cursor a pointer to the current position. Advanced past the parsed integer.
+ * @param[in] end a pointer to the end of the text.
+ * @return the parsed value, or 0 if no digits were found.
+ */
+long parseDecimalInteger(const char **cursor, const char *end);
+
+/**
+ * @brief A function that parses a decimal floating point number in place, giving the same result as strtof.
+ *
+ * @details Numbers of the form [sign]digits[.digits] whose digits fit in a float's mantissa, with at most
+ * MAX_FAST_FLOAT_FRACTION_DIGITS digits after the point, are computed as one division of two exact floats -
+ * which IEEE-754 rounds correctly, exactly as strtof does. Any other number is handed to strtof.
+ * @note Unlike strtof, the text doesn't have to be '\0' terminated - parsing stops at end.
+ * @param[in] cursor a pointer to the current position. Advanced past the parsed number.
+ * @param[in] end a pointer to the end of the text.
+ * @return the parsed value, or 0 if no number was found.
+ */
+float parseDecimalFloat(const char **cursor, const char *end);
+
+
+#if defined(__GNUC__)
+#pragma GCC visibility pop
+#endif
+
+#endif //SPREADERDETECTORINPUT_H
@@ -0,0 +1,845 @@
+/*
+ * File Name: SpreaderDetectorInternal.h
+ * Related Files: "SpreaderDetector.h", "SpreaderDetectorParams.h"
+ *
+ * Purpose:
+ * 			The internals shared by the modules of the SpreaderDetector library: its constants, its structs, and
+ * 			the functions of SpreaderDetector.c which the other modules use. They are internal (hidden): the API
+ * 			of the library is SpreaderDetector.h.
+ *
+ * Author's ID: 206174120
+ * Author's Name: Oren Kovartovsky
+ * University User Name: orenkov
+ *
+ * */
+
+#ifndef SPREADERDETECTORINTERNAL_H
+#define SPREADERDETECTORINTERNAL_H
+
+#define _POSIX_C_SOURCE 200809L
+#ifdef SPREADER_DETECTOR_IO_URING
+#define _DEFAULT_SOURCE		// syscall(), for the io_uring system calls.
+#endif
+
+#include "SpreaderDetector.h"
+#include "SpreaderDetectorParams.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <poll.h>
+#include <float.h>
+#include <errno.h>
+#include <sys/resource.h>
+#include <dirent.h>
+#include <signal.h>
+#include <stdint.h>
+
+#ifdef SPREADER_DETECTOR_IO_URING
+#include <linux/io_uring.h>
+#endif
+
+#define FILE_DO_NOT_EXIST -1
+#define NANOSECONDS_IN_SECOND 1e9
+
+#define ERROR_INPUT "Error in input files.\n"
+#define ERROR_OUTPUT "Error in output file.\n"
+#define ERROR_DEAFULT "Standard library error.\n"
+
+#define INPUT_MAX_LINE_LEN 1024
+
+#define GZIP_MAGIC "\x1f\x8b"
+#define GZIP_MAGIC_LEN 2
+#define ZSTD_MAGIC "\x28\xb5\x2f\xfd"
+#define ZSTD_MAGIC_LEN 4
+#define DECOMPRESS_BUFFER_SIZE (1 << 17)
+
+#define PEOPLE_NAME_INDEX 0
+#define PEOPLE_ID_INDEX 1
+#define NAME_ARENA_INITIAL_CAPACITY 4096
+#define PERSON_LINE_MIN_LEN 14		// "N 123456789 1\n" - the shortest line of a (9 digits ID) person.
+#define RUN_ARENA_ALIGNMENT 16
+
+#define SNAPSHOT_MAGIC "SDPEOPLE"
+#define SNAPSHOT_MAGIC_LEN 8
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_BYTE_ORDER_MARK 0x01020304u
+#define SNAPSHOT_TEMPORARY_SUFFIX ".tmp"
+
+#define SHARD_PATHS_INITIAL_CAPACITY 16
+
+#define BATCH_MANIFEST_READ_SIZE 65536
+#define BATCH_JOBS_INITIAL_CAPACITY 64
+#define BATCH_FIELD_COUNT 3
+#define BATCH_FIELD_PEOPLE 0
+#define BATCH_FIELD_MEETINGS 1
+#define BATCH_FIELD_OUTPUT 2
+#define BATCH_FIELD_SEPARATORS " \t\r"
+#define BATCH_COMMENT_PREFIX "#"
+
+#define DELTA_STATE_MAGIC "SDSTATE."
+#define DELTA_STATE_MAGIC_LEN 8
+#define DELTA_STATE_VERSION 1
+#define DELTA_STATE_NO_SPREADER UINT_MAX
+
+#define MEETINGS_TABLE_MAGIC "SDMEETS."
+#define MEETINGS_TABLE_MAGIC_LEN 8
+#define MEETINGS_TABLE_VERSION 1
+#define MEETINGS_TABLE_BLOCK_SIZE 65536
+#define MEETINGS_TABLE_COLUMN_COUNT 4
+#define MEETINGS_TABLE_INDEX_INITIAL_CAPACITY 64
+#define MEETINGS_TABLE_NO_SPREADER 0
+
+#define EXTERNAL_RUN_BUFFER_SIZE (1 << 18)
+#define EXTERNAL_MAX_FAN_IN 256
+#define EXTERNAL_RUN_TEMPLATE "/.SpreaderDetectorRun.XXXXXX"
+#define EXTERNAL_BUDGET_SHARES 3	// The records collected, their payloads, and qsort's scratch.
+#define EXTERNAL_RUNS_INITIAL_CAPACITY 16
+
+#define PEOPLE_INDEX_EMPTY_SLOT 0
+#define PEOPLE_INDEX_MIN_CAPACITY 16
+#define PEOPLE_INDEX_HASH_MULTIPLIER 0x9E3779B1u
+
+#define READER_BUFFER_SIZE (1 << 20)
+#define READ_AHEAD_BLOCK_COUNT 4
+#define READ_AHEAD_BLOCK_SIZE (1 << 20)
+#define READ_AHEAD_RING_ENTRIES (2 * READ_AHEAD_BLOCK_COUNT)	// A read and a cancel for every block.
+#define READ_AHEAD_CANCEL_TAG READ_AHEAD_BLOCK_COUNT		// user_data of the cancel requests.
+#define READ_AHEAD_CURRENT_POSITION ((unsigned long long) -1)	// io_uring offset of non-seekable files.
+#define WRITER_BUFFER_SIZE (1 << 20)
+#define OUTPUT_FILE_MODE 0666
+#define MAX_DECIMAL_DIGITS 20
+#define SEVERITY_MESSAGE_COUNT 3
+#define MESSAGE_NAME_FORMAT "%s"
+#define MESSAGE_ID_FORMAT "%lu"
+#define MAX_FAST_FLOAT_MANTISSA (1ul << 24)
+#define MAX_FAST_FLOAT_FRACTION_DIGITS 10
+
+#define SERIAL_THREAD_COUNT 1
+#define ALL_ONLINE_CPUS 0
+#define MAX_THREAD_COUNT 1024
+#define CHUNKS_PER_THREAD 4
+#define MIN_CHUNK_SIZE (1 << 20)
+#define MEETING_LINE_MIN_LEN 24		// "123456789 123456789 1 1\n" - the shortest meeting line.
+#define MEETING_BLOCK_SIZE 256
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AVX2_DISPATCH 1
+#else
+#define AVX2_DISPATCH 0
+#endif
+
+#define UNVISITED_LEVEL UINT_MAX
+#define FRONTIER_INITIAL_CAPACITY 1024
+#define GRAPH_PARALLEL_MIN_FRONTIER 4096
+
+#define RADIX_DIGIT_BITS 8
+#define RADIX_BUCKET_COUNT (1 << RADIX_DIGIT_BITS)
+#define RADIX_DIGIT_MASK (RADIX_BUCKET_COUNT - 1)
+#define RADIX_PASS_COUNT 4
+#define RADIX_SIGN_BIT 0x80000000u
+#define RADIX_SORT_MIN_SLICE_SIZE (1 << 18)
+#define PEOPLE_MAX_MERGED_RUNS 8
+#if defined(FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 0)
+#define FAST_FLOAT_ENABLED 1
+#else
+#define FAST_FLOAT_ENABLED 0
+#endif
+
+#define MEET_FIRST_ID_INDEX 0
+#define MEET_SECOND_ID_INDEX 1
+#define MEET_DISTANCE_INDEX 2
+#define MEET_TIME_INDEX 3
+#define INFECTOR_OLD 0
+#define INFECTOR_NEW 1
+#define MAX_SEVERITY 1
+
+
+/*
+ * ***************************
+ * 	STRUCTS AND ENUMS
+ * ***************************
+ */
+/**
+ * @brief A struct represents a Person which might be a coronavirus carrier.
+ * @details Used to store relevant data about the person.
+ * @details The record is kept small and fixed-size (the name itself lives in a NameArena), so sorting
+ * and growing the People-Array moves only a few bytes per person.
+ */
+typedef struct _Person
+{
+	int id; 				/**< 9 digits number, represents ID of a person */
+	float severity;				/**< Severity, value between 0 to 1 (included) */
+	unsigned int nameOffset;		/**< Offset of the person's name inside the NameArena */
+	unsigned int nameLength;		/**< Length of the person's name (not '\0' terminated) */
+} Person;
+
+/**
+ * @brief A struct represents the single allocation which holds the bulk data of a run: the People-Array and
+ * its index. It is sized once, from the size of the peopleFile (see runArenaReserve), handed out by a bump
+ * pointer, and released in one go with the NameArena.
+ */
+typedef struct _RunArena
+{
+	char *base;			/**< The allocation. NULL if nothing was reserved */
+	size_t used;			/**< Number of bytes handed out */
+	size_t capacity;		/**< Number of bytes allocated */
+	unsigned int peopleEstimate;	/**< Number of people the arena was sized for */
+} RunArena;
+
+/**
+ * @brief A struct represents one contiguous buffer which holds the names of all the people.
+ * @details Names are stored one after the other, and are referred to by (nameOffset, nameLength)
+ * from the Person records.
+ */
+typedef struct _NameArena
+{
+	char *names;		/**< The contiguous buffer of names */
+	size_t length;		/**< Number of bytes in use */
+	size_t capacity;	/**< Number of bytes allocated */
+	char *mappedBase;	/**< Beginning of the file mapping names points into */
+	size_t mappedSize;	/**< Size of the file mapping names points into. 0 if names is heap allocated */
+	RunArena runArena;	/**< The People-Array and index of the run, released with the names */
+} NameArena;
+
+/**
+ * @brief A struct represents the header of a people snapshot (see writePeopleSnapshot).
+ * @details Followed by peopleCount Person records sorted by ID, and by the name blob at namesOffset.
+ * The fields are in the byte order of the machine which wrote it, checked by byteOrderMark.
+ */
+typedef struct _PeopleSnapshotHeader
+{
+	char magic[SNAPSHOT_MAGIC_LEN];		/**< SNAPSHOT_MAGIC, not '\0' terminated */
+	unsigned int version;			/**< SNAPSHOT_VERSION */
+	unsigned int byteOrderMark;		/**< SNAPSHOT_BYTE_ORDER_MARK */
+	unsigned int recordSize;		/**< sizeof(Person) */
+	unsigned int peopleCount;		/**< Number of records */
+	unsigned long long namesOffset;		/**< Offset of the name blob in the file */
+	unsigned long long namesSize;		/**< Size of the name blob */
+} PeopleSnapshotHeader;
+
+/**
+ * @brief A struct represents one slot of the PeopleIndex hash table.
+ * @details The ID is kept inside the slot, so a lookup doesn't have to touch the People-Array.
+ */
+typedef struct _PeopleIndexSlot
+{
+	int id;				/**< The ID of the person stored in the slot */
+	unsigned int position;		/**< 1 + the person's position in the People-Array. PEOPLE_INDEX_EMPTY_SLOT if free */
+} PeopleIndexSlot;
+
+/**
+ * @brief A struct represents an open-addressing (linear probing) hash table from ID to People-Array position.
+ * @details Built once after the People-Array is sorted by ID, and used for O(1) lookups during the
+ * meetings pass.
+ * @note The positions are only valid as long as the People-Array isn't re-ordered.
+ */
+typedef struct _PeopleIndex
+{
+	PeopleIndexSlot *slots;		/**< The table itself. capacity is a power of 2 */
+	unsigned int mask;		/**< capacity - 1, used instead of modulo */
+	unsigned int shift;		/**< 32 - log2(capacity), used by the multiplicative hash */
+	int isInArena;			/**< 1 if slots lie in a RunArena (released with it), 0 if heap allocated */
+} PeopleIndex;
+
+/**
+ * @brief A struct represents a Meeting between 2 people that might have coronavirus.
+ * @details Used to store the data conveniently during the program.
+ */
+typedef struct _Meeting
+{
+	int infectorID;		/**< 9 digits number, represents ID of the potential infector */
+	int infectedID;		/**< 9 digits number, represents ID of the potential infected */
+	float distance;		/**< distance measured between them. bounded by MIN_DISTANCE */
+	float time;		/**< time measured in which they were next to each other. bounded by MAX_TIME. */
+} Meeting;
+
+/**
+ * @brief The ways a ReadAhead reads its blocks.
+ */
+typedef enum _ReadAheadBackend
+{
+	READ_AHEAD_THREAD = 0,	/**< A reader thread reads the blocks with read() */
+	READ_AHEAD_IO_URING	/**< The reads are submitted to an io_uring (SPREADER_DETECTOR_IO_URING) */
+} ReadAheadBackend;
+
+/**
+ * @brief A struct represents one block buffer of a ReadAhead.
+ */
+typedef struct _ReadAheadBlock
+{
+	char *data;			/**< The buffer, READ_AHEAD_BLOCK_SIZE bytes */
+	size_t length;			/**< Number of bytes read into data. 0 at the end of the input */
+	StatusCode status;		/**< The result of the read */
+	unsigned long long offset;	/**< The file offset of data (io_uring, seekable files) */
+	int isInFlight;			/**< Whether a read into the block wasn't completed yet (io_uring) */
+} ReadAheadBlock;
+
+#ifdef SPREADER_DETECTOR_IO_URING
+/**
+ * @brief A struct represents the io_uring of a ReadAhead: its ring mappings, set up with the raw system calls.
+ */
+typedef struct _ReadAheadRing
+{
+	int ringFd;				/**< The io_uring */
+	void *ringMapping;			/**< The submission and completion rings (a single mapping) */
+	size_t ringMappingSize;			/**< Size of ringMapping */
+	struct io_uring_sqe *sqes;		/**< The submission queue entries */
+	size_t sqesSize;			/**< Size of the sqes mapping */
+	unsigned int *sqTail;			/**< Tail of the submission ring. Written by us */
+	unsigned int *sqMask;			/**< Mask of the submission ring's indexes */
+	unsigned int *sqArray;			/**< The submission ring (indexes into sqes) */
+	unsigned int *cqHead;			/**< Head of the completion ring. Written by us */
+	unsigned int *cqTail;			/**< Tail of the completion ring. Written by the kernel */
+	unsigned int *cqMask;			/**< Mask of the completion ring's indexes */
+	struct io_uring_cqe *cqes;		/**< The completion ring */
+	int isSeekable;				/**< Whether reads are at explicit offsets (all the blocks in flight) */
+	unsigned long long nextOffset;		/**< The offset of the next block to submit (seekable files) */
+	int isEndOfFile;			/**< Whether a read returned the end of the input */
+} ReadAheadRing;
+#endif
+
+/**
+ * @brief A struct represents a reader which reads the next blocks of a file while the current one is used, so
+ * I/O and computing overlap (see readAheadStart). The blocks are returned in file order.
+ */
+typedef struct _ReadAhead
+{
+	int inputFd;				/**< The file being read. Not owned */
+	ReadAheadBackend backend;		/**< How the blocks are read */
+	char *buffer;				/**< The data of all the blocks */
+	ReadAheadBlock blocks[READ_AHEAD_BLOCK_COUNT];	/**< The blocks, used as a ring */
+	unsigned int nextBlock;			/**< The block returned next (or held by the consumer) */
+	int isHoldingBlock;			/**< Whether the consumer holds blocks[nextBlock] */
+	pthread_t thread;			/**< The reader thread (READ_AHEAD_THREAD) */
+	pthread_mutex_t mutex;			/**< Guards filledCount and isStopping (READ_AHEAD_THREAD) */
+	pthread_cond_t blockFilled;		/**< Signaled when the thread filled a block (READ_AHEAD_THREAD) */
+	pthread_cond_t blockFreed;		/**< Signaled when the consumer released a block (READ_AHEAD_THREAD) */
+	unsigned int filledCount;		/**< Blocks filled and not released yet (READ_AHEAD_THREAD) */
+	int isStopping;				/**< Whether the thread should stop (READ_AHEAD_THREAD) */
+#ifdef SPREADER_DETECTOR_IO_URING
+	ReadAheadRing ring;			/**< The io_uring (READ_AHEAD_IO_URING) */
+#endif
+} ReadAhead;
+
+/**
+ * @brief A struct represents a reader which returns the lines of a file, one by one.
+ * @details The file is read in large blocks, and the lines are returned in place (no copy, no '\0'). Unless
+ * streaming, the next blocks are read ahead (see ReadAhead) while the lines of the current one are used.
+ */
+typedef struct _LineReader
+{
+	FILE *inputFile;	/**< The file being read. Not owned by the reader */
+	char *buffer;		/**< The block buffer */
+	size_t capacity;	/**< Number of bytes allocated for buffer */
+	size_t start;		/**< Beginning of the first line which wasn't returned yet */
+	size_t scanned;		/**< Position up to which buffer was already searched for '\n' */
+	size_t end;		/**< End of the valid data in buffer */
+	int isEndOfFile;	/**< Whether inputFile was read to its end */
+	unsigned long long bytesRead;	/**< Number of bytes read from inputFile so far */
+	int isStreaming;	/**< Whether to return lines as soon as they arrive (see lineReaderSetStreaming) */
+	void (*onIdle)(void *);	/**< Called before a streaming read blocks. May be NULL */
+	void *idleContext;	/**< The argument of onIdle */
+	ReadAhead *readAhead;	/**< Reads the next blocks ahead (not when streaming). NULL if it wasn't started */
+	const char *aheadData;	/**< The part of the current read-ahead block which wasn't copied to buffer */
+	size_t aheadLength;	/**< Length of aheadData */
+} LineReader;
+
+/**
+ * @brief The compression formats of an input file, detected by its magic number.
+ */
+typedef enum _Compression
+{
+	COMPRESSION_NONE,	/**< Plain text */
+	COMPRESSION_GZIP,	/**< gzip (needs SPREADER_DETECTOR_ZLIB) */
+	COMPRESSION_ZSTD	/**< Zstandard (needs SPREADER_DETECTOR_ZSTD) */
+} Compression;
+
+/**
+ * @brief A struct represents the thread which decompresses an input file into a pipe, which the readers read
+ * as a plain file (see decompressorOpen).
+ */
+typedef struct _Decompressor
+{
+	int compressedFd;		/**< The compressed file. Closed by the thread */
+	int pipeWriteFd;		/**< The write end of the pipe. Closed by the thread */
+	Compression compression;	/**< The format of the compressed file */
+	pthread_t thread;		/**< The decompressing thread */
+	int isStarted;			/**< Whether the thread was started */
+	StatusCode status;		/**< The result of the decompression. Set by the thread */
+} Decompressor;
+
+/**
+ * @brief A struct represents a message of "SpreaderDetectorParams.h", split around its name (MESSAGE_NAME_FORMAT)
+ * and its ID (MESSAGE_ID_FORMAT), so that output lines can be formatted without printf.
+ */
+typedef struct _MessageFormat
+{
+	const char *prefix;		/**< The text before the name */
+	size_t prefixLength;	/**< The length of prefix */
+	const char *separator;	/**< The text between the name and the ID */
+	size_t separatorLength;	/**< The length of separator */
+	const char *suffix;		/**< The text after the ID */
+	size_t suffixLength;	/**< The length of suffix */
+} MessageFormat;
+
+/**
+ * @brief A struct represents a writer which formats output lines into a large buffer.
+ * @details The buffer is written to the descriptor with write(), only when it is full or flushed.
+ */
+typedef struct _OutputWriter
+{
+	int outputFd;		/**< The descriptor being written. Not owned by the writer */
+	char *buffer;		/**< The block buffer */
+	size_t length;		/**< Number of bytes in buffer which weren't written yet */
+	size_t capacity;	/**< Number of bytes allocated for buffer */
+	unsigned long long bytesWritten;	/**< Number of bytes written to the descriptor so far */
+	MessageFormat messageFormats[SEVERITY_MESSAGE_COUNT];	/**< The messages, indexed by severityToMessage */
+} OutputWriter;
+
+/**
+ * @brief A struct represents the state of the periodic urgent-tier emission of the streaming mode.
+ */
+typedef struct _UrgentTierEmitter
+{
+	const Person *peopleArray;	/**< The array of people, whose severities are being updated */
+	unsigned int peopleCounter;	/**< Number of people in peopleArray */
+	const NameArena *nameArena;	/**< The arena which holds the names of the people */
+	Person *urgentPeople;		/**< Scratch array the urgent people are collected and sorted in */
+	unsigned int urgentCapacity;	/**< Number of people allocated in urgentPeople */
+	OutputWriter outputWriter;	/**< Writes the lists to stdout */
+	unsigned long emitInterval;	/**< Updates between emissions */
+	unsigned long pendingUpdates;	/**< Updates since the last emission */
+	unsigned int threadCount;	/**< Threads to sort with */
+	StatusCode status;		/**< STATUS_CODE_SUCCESS, or the error of a failed emission */
+} UrgentTierEmitter;
+
+/**
+ * @brief A struct represents a parsed meeting, ready to be applied to the People-Array.
+ * @details IDs are already resolved to positions, and crna is already calculated.
+ */
+typedef struct _MeetingEdge
+{
+	unsigned int infector;	/**< Position of the potential infector in the People-Array */
+	unsigned int infected;	/**< Position of the potential infected in the People-Array */
+	float chance;		/**< crna() of the meeting */
+} MeetingEdge;
+
+/**
+ * @brief A struct represents a block of parsed meetings, in structure-of-arrays form.
+ * @details The chances of the whole block are calculated at once by crnaBatch, and then applied in order -
+ * an infector may have been infected by an earlier meeting of the same block.
+ */
+typedef struct _MeetingBlock
+{
+	Person *infectors[MEETING_BLOCK_SIZE];	/**< The potential infector of each meeting */
+	Person *infecteds[MEETING_BLOCK_SIZE];	/**< The potential infected of each meeting */
+	float distances[MEETING_BLOCK_SIZE];	/**< The distance of each meeting */
+	float times[MEETING_BLOCK_SIZE];		/**< The time of each meeting */
+	float chances[MEETING_BLOCK_SIZE];		/**< crna() of each meeting, filled by crnaBatch */
+	unsigned int count;						/**< Number of meetings in the block */
+} MeetingBlock;
+
+/**
+ * @brief A struct represents a newline-aligned chunk of the meetingFile, and the edges parsed out of it.
+ */
+typedef struct _MeetingChunk
+{
+	const char *start;		/**< Beginning of the chunk (beginning of a line) */
+	const char *end;		/**< End of the chunk (after a '\n', or the end of the file) */
+	MeetingEdge *edges;		/**< The chunk's meetings, in file order */
+	unsigned int edgeCount;		/**< Number of edges parsed */
+	unsigned int edgeCapacity;	/**< Number of edges allocated */
+	unsigned int lookupCount;	/**< Number of PeopleIndex lookups made while parsing */
+	StatusCode status;		/**< STATUS_CODE_SUCCESS, or the error which stopped the parsing */
+	int isParsed;			/**< Whether a thread finished parsing the chunk. Guarded by the lock */
+	unsigned int tableMeetings;	/**< Number of meetings, if the chunk is a block of a meetings table. 0 - lines */
+} MeetingChunk;
+
+/**
+ * @brief A struct represents the header of a meetings table - the columnar binary form of a meetingFile (see
+ * writeMeetingsTable).
+ * @details Followed by the blocks, and by the block index at indexOffset. The fields are in the byte order of
+ * the machine which wrote it, checked by byteOrderMark.
+ */
+typedef struct _MeetingsTableHeader
+{
+	char magic[MEETINGS_TABLE_MAGIC_LEN];	/**< MEETINGS_TABLE_MAGIC, not '\0' terminated */
+	unsigned int version;			/**< MEETINGS_TABLE_VERSION */
+	unsigned int byteOrderMark;		/**< SNAPSHOT_BYTE_ORDER_MARK */
+	int spreaderID;				/**< The verified carrier's ID. MEETINGS_TABLE_NO_SPREADER - no such row */
+	unsigned int blockCount;		/**< Number of blocks */
+	unsigned long long meetingCount;	/**< Number of meetings in all the blocks */
+	unsigned long long indexOffset;		/**< Offset of the block index in the file */
+} MeetingsTableHeader;
+
+/**
+ * @brief A struct represents an entry of the block index of a meetings table.
+ * @details The block holds 4 columns of meetingCount values each, back to back: the infector IDs and the
+ * infected IDs (int), the distances and the times (float) - in file order.
+ */
+typedef struct _MeetingsTableBlock
+{
+	unsigned long long offset;		/**< Offset of the block in the file */
+	unsigned int meetingCount;		/**< Number of meetings in the block, up to MEETINGS_TABLE_BLOCK_SIZE */
+	unsigned int reserved;			/**< 0 */
+} MeetingsTableBlock;
+
+/**
+ * @brief A struct represents a shard of the meetings - one of the files which make up the meetings, in order.
+ * @details A single meetingFile (or buffer) is one shard which holds no content of its own.
+ * @details A shard may be a meetings table (see meetingShardsOpenTables), whose start and end then span its
+ * blocks.
+ */
+typedef struct _MeetingShard
+{
+	const char *start;		/**< Beginning of the lines left to parse */
+	const char *end;		/**< End of the shard's lines */
+	char *content;			/**< The mapping or buffer the shard was loaded to. NULL - not owned */
+	size_t contentSize;		/**< Size of content */
+	int isMapped;			/**< Whether content is a mapping (or else a malloc'ed buffer) */
+	const MeetingsTableHeader *table;	/**< The header, if the shard is a meetings table. NULL - lines */
+} MeetingShard;
+
+/**
+ * @brief A struct represents the state shared by the threads of the parallel meetings ingest.
+ */
+typedef struct _ParallelIngest
+{
+	MeetingChunk *chunks;		/**< The chunks, in file order */
+	unsigned int chunkCount;	/**< Number of chunks */
+	unsigned int nextChunk;		/**< The first chunk no thread claimed yet. Guarded by the lock */
+	Person *peopleArray;		/**< The array of people, sorted by ID */
+	const PeopleIndex *peopleIndex;	/**< The ID hash index of peopleArray */
+	pthread_t *workers;		/**< The worker threads */
+	unsigned int workerCount;	/**< Number of worker threads that were created */
+	pthread_mutex_t lock;		/**< Guards nextChunk and the chunks' isParsed */
+	pthread_cond_t chunkParsed;	/**< Signaled whenever a chunk is parsed */
+} ParallelIngest;
+
+/**
+ * @brief A struct represents the contact graph, in compressed-sparse-row form.
+ * @details Vertices are People-Array positions, and every meeting is an edge from the infector to the infected.
+ */
+typedef struct _ContactGraph
+{
+	unsigned int vertexCount;	/**< Number of people */
+	unsigned int edgeCount;		/**< Number of meetings */
+	unsigned int *edgeOffsets;	/**< The out-edges of person v are [edgeOffsets[v], edgeOffsets[v + 1]) */
+	unsigned int *targets;		/**< Position of the potential infected of each edge, grouped by infector */
+	float *chances;			/**< crna() of each edge */
+} ContactGraph;
+
+/**
+ * @brief A struct represents the header of a delta state (see deltaStateWrite).
+ * @details Followed by the sections: the IDs, severities and levels of the people (in People-Array order),
+ * and the contact graph - edgeOffsets, targets and chances. The fields are in the byte order of the machine
+ * which wrote it, checked by byteOrderMark.
+ */
+typedef struct _DeltaStateHeader
+{
+	char magic[DELTA_STATE_MAGIC_LEN];	/**< DELTA_STATE_MAGIC, not '\0' terminated */
+	unsigned int version;			/**< DELTA_STATE_VERSION */
+	unsigned int byteOrderMark;		/**< SNAPSHOT_BYTE_ORDER_MARK */
+	unsigned int peopleCount;		/**< Number of people */
+	unsigned int edgeCount;			/**< Number of meetings in the contact graph */
+	unsigned int spreader;			/**< Position of the verified carrier. DELTA_STATE_NO_SPREADER - none */
+	unsigned int reserved;			/**< 0 */
+} DeltaStateHeader;
+
+/**
+ * @brief A struct represents a loaded delta state: the result of the previous run, mapped in place.
+ */
+typedef struct _DeltaState
+{
+	char *mappedFile;			/**< The mapping of the state file */
+	size_t mappedSize;			/**< Size of the mapping */
+	unsigned int spreader;			/**< Position of the verified carrier. DELTA_STATE_NO_SPREADER - none */
+	const float *severities;		/**< The severity of every person */
+	const unsigned int *levels;		/**< The BFS level of every person. UNVISITED_LEVEL if not reached */
+	ContactGraph contactGraph;		/**< The contact graph, pointing into the mapping */
+} DeltaState;
+
+/**
+ * @brief A struct represents the delta state files of a graph run (see DeltaStateHeader).
+ */
+typedef struct _StatePaths
+{
+	const char *statePath;		/**< Where the run saves its delta state. NULL - it isn't saved */
+	const char *deltaStatePath;	/**< The delta state the meetings are appended to. NULL - not a delta run */
+} StatePaths;
+
+/**
+ * @brief A struct represents the part of a BFS frontier expanded by one thread.
+ */
+typedef struct _FrontierSlice
+{
+	const ContactGraph *contactGraph;	/**< The contact graph */
+	Person *peopleArray;			/**< The array of people, whose severities are updated */
+	unsigned int *levels;			/**< The BFS level of every person. UNVISITED_LEVEL if not reached */
+	const unsigned int *frontier;		/**< The slice of the frontier to expand */
+	unsigned int frontierSize;		/**< Number of people in the slice */
+	unsigned int nextLevel;			/**< The level being discovered */
+	unsigned int *nextFrontier;		/**< The people this slice claimed for nextLevel */
+	unsigned int nextCount;			/**< Number of people in nextFrontier */
+	unsigned int nextCapacity;		/**< Number of people allocated in nextFrontier */
+	StatusCode status;			/**< STATUS_CODE_SUCCESS, or the error which stopped the expansion */
+} FrontierSlice;
+
+/**
+ * @brief A struct represents a record of an external sort (see ExternalSorter), followed on disk by its payload.
+ * @details The records are ordered by key, and then by value - every sort packs the order it needs into them.
+ */
+typedef struct _ExternalRecord
+{
+	unsigned long long key;		/**< The sort key */
+	unsigned long long value;	/**< Breaks the ties of key. Unique within a sort */
+	int id;				/**< The ID of the person the record is about */
+	float severity;			/**< The severity of the person, or the chance of a meeting */
+	unsigned int payloadLength;	/**< Number of payload bytes (a name) which follow the record */
+	unsigned int payloadOffset;	/**< Offset of the payload in the ExternalSorter's payloads (in memory only) */
+} ExternalRecord;
+
+/**
+ * @brief A struct represents a reader which returns the records of a run (a file of ExternalRecords), one by one.
+ * @details The run is read in blocks with pread, from the reader's own offset - so a file may be read again.
+ */
+typedef struct _ExternalRunReader
+{
+	int runFd;				/**< The run. Not owned by the reader */
+	char *buffer;			/**< The block buffer, EXTERNAL_RUN_BUFFER_SIZE bytes */
+	size_t start;			/**< Beginning of the data in buffer which wasn't returned yet */
+	size_t end;				/**< End of the valid data in buffer */
+	unsigned long long offset;	/**< The file offset of the next block */
+	ExternalRecord record;		/**< The current record */
+	char *payload;			/**< The payload of the current record */
+	size_t payloadCapacity;		/**< Number of bytes allocated for payload */
+} ExternalRunReader;
+
+/**
+ * @brief A struct represents a k-way merge of sorted runs, which returns their records in order.
+ */
+typedef struct _ExternalMerge
+{
+	ExternalRunReader *readers;	/**< A reader per run */
+	unsigned int readerCount;	/**< Number of readers */
+	unsigned int *heap;		/**< Min-heap of the readers which have a current record */
+	unsigned int heapSize;		/**< Number of readers in heap */
+	int isAdvancePending;		/**< Whether the record of heap[0] was returned, so its reader advances first */
+} ExternalMerge;
+
+/**
+ * @brief A struct represents an external merge sort: the records are collected up to a memory budget, sorted,
+ * and written to disk as runs, which are then merged (see externalSorterFinish and ExternalMerge).
+ */
+typedef struct _ExternalSorter
+{
+	ExternalRecord *records;	/**< The records of the run being collected */
+	unsigned int recordCount;	/**< Number of records collected */
+	unsigned int recordCapacity;	/**< Number of records the budget has room for */
+	char *payloads;			/**< The payloads of the records collected */
+	size_t payloadLength;		/**< Number of bytes in payloads */
+	size_t payloadCapacity;		/**< Number of bytes allocated for payloads */
+	int *runFds;			/**< The runs written so far (unlinked temporary files) */
+	unsigned int runCount;		/**< Number of runs */
+	unsigned int runCapacity;	/**< Number of runs allocated in runFds */
+	unsigned int fanIn;		/**< Number of runs merged at once, by the budget */
+	const char *directory;		/**< The directory the runs are written to */
+	unsigned long long recordTotal;	/**< Number of records added */
+} ExternalSorter;
+
+/**
+ * @brief Person Sort Key Enum
+ *
+ * @details The field the People-Array is sorted by (see sortPeople).
+ */
+typedef enum _PersonSortKey
+{
+	PERSON_SORT_BY_ID,		/**< Ascending ID, as personCompareByID */
+	PERSON_SORT_BY_SEVERITY		/**< Ascending severity, as personCompareBySeverity */
+} PersonSortKey;
+
+/**
+ * @brief A struct represents the part of the People-Array handled by one thread in a radix sort pass.
+ */
+typedef struct _RadixSortSlice
+{
+	const Person *source;				/**< The array being sorted by this pass */
+	Person *destination;				/**< The array this pass scatters into */
+	unsigned int sliceStart;			/**< Index of the first person of the slice */
+	unsigned int sliceEnd;				/**< Index past the last person of the slice */
+	PersonSortKey sortKey;				/**< The field to sort by */
+	unsigned int shift;				/**< Position of the pass's digit in the key */
+	int isScatterPhase;				/**< Whether the worker scatters (1) or counts (0) */
+	unsigned int counts[RADIX_BUCKET_COUNT];	/**< Digit counts, then the slice's scatter cursors */
+} RadixSortSlice;
+
+/**
+ * @brief A struct represents the ID-ordered runs of the People-Array, tracked as the people are read (see
+ * peopleRunsTrack): a new run starts wherever an ID is smaller than the one before it.
+ */
+typedef struct _PeopleRuns
+{
+	unsigned int runCount;				/**< Number of runs. Above PEOPLE_MAX_MERGED_RUNS - too many to merge */
+	int lastID;					/**< The ID of the last person tracked */
+	unsigned int runStarts[PEOPLE_MAX_MERGED_RUNS];	/**< Index of the first person of every run */
+} PeopleRuns;
+
+/**
+ * @brief A struct represents a people registry of the in-memory API (see SpreaderDetector.h).
+ * @details Loaded once, and shared (read only) by the analyses: each of them works on its own copy of the
+ * People-Array, so the positions the index refers to stay valid.
+ */
+struct _SpreaderDetectorRegistry
+{
+	Person *peopleArray;		/**< The people, sorted by ID, with no severities */
+	unsigned int peopleCounter;	/**< Number of people in peopleArray */
+	NameArena nameArena;		/**< The arena which holds the names of the people */
+	PeopleIndex peopleIndex;	/**< The ID hash index of peopleArray. Empty if there are no people */
+};
+
+/**
+ * @brief A struct represents a peopleFile of a batch, shared by all the jobs which give it - under any path
+ * which leads to the same file: it is loaded by the first of them to run, and released when the last of them is
+ * done.
+ */
+typedef struct _BatchPeople
+{
+	const char *peopleFilePath;		/**< The path of the peopleFile, as its first job gives it */
+	SpreaderDetectorRegistry *registry;	/**< The loaded people. NULL - not loaded yet, or loading failed */
+	int isLoadAttempted;			/**< Whether a job already loaded (or failed to load) the registry */
+	unsigned int pendingJobCount;		/**< Number of jobs of the peopleFile which aren't done yet */
+	pthread_mutex_t mutex;			/**< Guards the fields above */
+} BatchPeople;
+
+/**
+ * @brief A struct represents a job of a batch: a line of the manifest.
+ */
+typedef struct _BatchJob
+{
+	const char *peopleFilePath;	/**< The path of the job's peopleFile (inside the manifest) */
+	const char *meetingFilePath;	/**< The path of the job's meetingFile (inside the manifest) */
+	const char *outputFilePath;	/**< The path the job's analysis is written to (inside the manifest) */
+	unsigned int lineNumber;	/**< The line of the job in the manifest */
+	int isPeopleFound;		/**< Whether the peopleFile could be stat()ed. If not, it is told by its path */
+	dev_t peopleDevice;		/**< The device of the peopleFile (if isPeopleFound) */
+	ino_t peopleInode;		/**< The inode of the peopleFile (if isPeopleFound) */
+	BatchPeople *people;		/**< The shared peopleFile of the job */
+	StatusCode status;		/**< The result of the job, once it ran */
+	RunStats runStats;		/**< The measurements of the job (when the batch is measured) */
+} BatchJob;
+
+/**
+ * @brief A struct represents the jobs left to a worker of a batch: a range of the (grouped) jobs. The worker
+ * runs them from the head, and the workers which ran out of jobs steal them from the tail.
+ */
+typedef struct _BatchDeque
+{
+	unsigned int head;		/**< The next job the worker runs */
+	unsigned int tail;		/**< End of the range - a thief takes the job before it */
+	pthread_mutex_t mutex;	/**< Guards head and tail */
+} BatchDeque;
+
+/**
+ * @brief A struct represents the work-stealing pool which runs the jobs of a batch.
+ */
+typedef struct _BatchPool
+{
+	BatchJob *jobs;			/**< The jobs, grouped by peopleFile */
+	BatchDeque *deques;		/**< A deque per worker */
+	unsigned int workerCount;	/**< Number of workers */
+	const RunOptions *jobOptions;	/**< The options every job runs with */
+} BatchPool;
+
+/**
+ * @brief A struct represents a worker of a batch (a thread of its pool).
+ */
+typedef struct _BatchWorker
+{
+	BatchPool *pool;		/**< The pool of the worker */
+	unsigned int workerIndex;	/**< The worker's deque in the pool */
+	unsigned int failedJobCount;	/**< Number of jobs the worker ran which failed */
+} BatchWorker;
+
+
+/*
+ * ***********************
+ * 	DECLARATIONS
+ * ***********************
+ */
+//	****** ERRORS ******
+/**
+ * @brief Writes the message of an error to stderr (see spreaderDetectorError).
+ * @details being used in the library at the moment error detected. A macro, so the library doesn't define a
+ * function named error, which would clash with the error(3) of the C library.
+ */
+#define error(errorCode) spreaderDetectorError(errorCode)
+
+
+#if defined(__GNUC__)
+#pragma GCC visibility push(hidden)
+#endif
+
+//	****** STATS FUNCTIONS ******
+/**
+ * @brief A function that marks the beginning of a phase of the run.
+ *
+ * @note Does nothing unless the run is measured (runStats isn't NULL).
+ * @param[in] runStats the measurements of the run (RunOptions.runStats).
+ */
+void runStatsPhaseStart(RunStats *runStats);
+
+/**
+ * @brief A function that marks the end of a phase of the run: adds its time, and records the memory
+ * high-water mark of the process so far.
+ *
+ * @note Does nothing unless the run is measured (runStats isn't NULL).
+ * @param[in] runStats the measurements of the run (RunOptions.runStats).
+ * @param[in] statsPhase the phase which ended.
+ */
+void runStatsPhaseEnd(RunStats *runStats, StatsPhase statsPhase);
+
+/**
+ * @brief A function that adds to the counters of a phase of the run.
+ *
+ * @details Hot loops count in local variables, and report them once they are done.
+ * @note Does nothing unless the run is measured (runStats isn't NULL).
+ * @param[in] runStats the measurements of the run (RunOptions.runStats).
+ * @param[in] statsPhase the phase being counted.
+ * @param[in] bytes bytes read (or written).
+ * @param[in] lines lines read (or people handled).
+ * @param[in] lookups PeopleIndex lookups made.
+ */
+void runStatsCount(RunStats *runStats, StatsPhase statsPhase, unsigned long long bytes, unsigned long long lines,
+				   unsigned long long lookups);
+
+/**
+ * @brief A function that prints the RunStats of a run as a JSON object.
+ *
+ * @details The object holds the result of the run, the total time, and an object per phase (people,
+ * meetings, order, output) with its seconds, bytes, lines, lookups and peakRssKilobytes. Phases the run
+ * didn't reach are all 0.
+ * @param[in] statsFile the opened file to print to.
+ * @param[in] runStats the measurements of the run.
+ * @param[in] runStatus the StatusCode the run ended with.
+ */
+void runStatsPrint(FILE *statsFile, const RunStats *runStats, StatusCode runStatus);
+
+/**
+ * @brief A function that translates a requested number of threads to the number of threads to use.
+ *
+ * @param[in] threadCount the requested number of threads. ALL_ONLINE_CPUS means one per online CPU.
+ * @return the number of threads to use (at least 1).
+ */
+unsigned int resolveThreadCount(unsigned int threadCount);
+
+
+#if defined(__GNUC__)
+#pragma GCC visibility pop
+#endif
+
+#endif //SPREADERDETECTORINTERNAL_H
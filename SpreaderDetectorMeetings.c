@@ -0,0 +1,1665 @@
+/*
+ * File Name: SpreaderDetectorMeetings.c
+ * Related Files: "SpreaderDetectorMeetings.h", "SpreaderDetectorInternal.h"
+ *
+ * Purpose:
+ * 			This file is the meetings of the SpreaderDetector library: parsing them and calculating the
+ * 			severities (serially and in parallel), the meeting shards, and the meetings tables.
+ *
+ * Author's ID: 206174120
+ * Author's Name: Oren Kovartovsky
+ * University User Name: orenkov
+ *
+ * */
+
+#include "SpreaderDetectorMeetings.h"
+#include "SpreaderDetectorOutput.h"
+#include "SpreaderDetectorInput.h"
+#include "SpreaderDetectorPeople.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+/*
+ * ***************************
+ * 	GLOBALS
+ * ***************************
+ */
+/**
+ * @brief The crnaBatch kernel of this CPU, chosen once by crnaBatchSelectKernel.
+ */
+static void (*crnaBatchKernel)(const float *distances, const float *times, float *chances, unsigned int count) = NULL;
+static pthread_once_t crnaBatchKernelOnce = PTHREAD_ONCE_INIT;
+
+
+/*
+ * ***********************
+ * 	DECLARATIONS
+ * ***********************
+ */
+//	****** MEETINGS PARSING / CALCULATING FUNCTIONS ******
+/**
+ * @brief calculates the chances of infection in coronavirus between 2 people, according to given data.
+ *
+ * @details Special function, was developed by one of the staff members of Emzeti-Shem University in the US.
+ * @details Using data given about a meeting of 2 people, and determines the chances of infection in corona.
+ * @param[in] distance distance measured between the people.
+ * @param[in] time measured in which they were next to each other.
+ * @return float value between 0 to 1, represents the chances.
+ */
+static float crna(float distance, float time);
+
+/**
+ * @brief The portable crnaBatch kernel: calls crna for every meeting.
+ *
+ * @param[in] distances the distances of the meetings.
+ * @param[in] times the times of the meetings.
+ * @param[in] chances receives crna() of every meeting.
+ * @param[in] count number of meetings.
+ */
+static void crnaBatchScalar(const float *distances, const float *times, float *chances, unsigned int count);
+
+#if defined(__SSE2__)
+/**
+ * @brief The SSE2 crnaBatch kernel: 4 meetings at a time, the rest by crnaBatchScalar.
+ *
+ * @details Same operations as crna, in the same order (IEEE multiply and divide per lane), so the chances
+ * are bit-identical to it.
+ * @param[in] distances the distances of the meetings.
+ * @param[in] times the times of the meetings.
+ * @param[in] chances receives crna() of every meeting.
+ * @param[in] count number of meetings.
+ */
+static void crnaBatchSse2(const float *distances, const float *times, float *chances, unsigned int count);
+#endif
+
+#if AVX2_DISPATCH
+/**
+ * @brief The AVX2 crnaBatch kernel: 8 meetings at a time, the rest by crnaBatchScalar.
+ *
+ * @details Compiled for AVX2 even when the program isn't, and chosen at runtime only on CPUs which have it.
+ * Bit-identical to crna, as crnaBatchSse2.
+ * @param[in] distances the distances of the meetings.
+ * @param[in] times the times of the meetings.
+ * @param[in] chances receives crna() of every meeting.
+ * @param[in] count number of meetings.
+ */
+static void crnaBatchAvx2(const float *distances, const float *times, float *chances, unsigned int count);
+#endif
+
+/**
+ * @brief A function that chooses the crnaBatch kernel: AVX2 if the CPU has it, otherwise SSE2 (when the
+ * program was compiled with it), otherwise the scalar one.
+ */
+static void crnaBatchSelectKernel();
+
+/**
+ * @brief A function that applies a MeetingBlock to the People-Array, and empties it.
+ *
+ * @details The chances are calculated by crnaBatch, and the severities are updated in block order, exactly
+ * as calculateSeverities updates them line by line.
+ * @param[in] meetingBlock the block to apply.
+ * @param[in] tierEmitter emits the urgent tiers while streaming (told about every update). NULL - not streaming.
+ * @param[out] STATUS_CODE_SUCCESS If the block was applied.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If the emitter failed.
+ */
+static StatusCode meetingBlockApply(MeetingBlock *meetingBlock, UrgentTierEmitter *tierEmitter);
+
+/**
+ * @brief A function that sets the chance of the last edges of a chunk, by crnaBatch.
+ *
+ * @param[in] meetingChunk the chunk.
+ * @param[in] distances the distances of the edges.
+ * @param[in] times the times of the edges.
+ * @param[in] pendingCount number of edges (at most MEETING_BLOCK_SIZE) - the last ones of the chunk.
+ */
+static void meetingChunkSetChances(MeetingChunk *meetingChunk, const float *distances, const float *times,
+								   unsigned int pendingCount);
+
+/**
+ * @brief A function that parses one chunk of the meetingsFile into MeetingEdges.
+ *
+ * @details The IDs are resolved to People-Array positions and crna is calculated here (by crnaBatch, a block
+ * of edges at a time), so only the severity multiplication is left for the in-order pass.
+ * @note Runs on the worker threads, so it doesn't write to stderr. The error is kept in chunk->status and
+ * reported by the in-order pass, when it reaches this chunk.
+ * @note The function ALLOCATES MEMORY being stored in chunk->edges.
+ * @param[in] meetingChunk the chunk to parse.
+ * @param[in] peopleArray the array of people, sorted by ID.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ */
+static void parseMeetingChunk(MeetingChunk *meetingChunk, Person *peopleArray, const PeopleIndex *peopleIndex);
+
+/**
+ * @brief A function that claims the next chunk no thread took yet, and parses it.
+ *
+ * @details Used by the worker threads, and by the in-order pass while it waits for a chunk.
+ * @param[in] parallelIngest the shared state of the parallel ingest.
+ * @return 1 if a chunk was parsed, 0 if there were no chunks left to claim.
+ */
+static int parallelIngestParseNext(ParallelIngest *parallelIngest);
+
+/**
+ * @brief The function run by each worker thread of the parallel ingest.
+ *
+ * @param[in] parallelIngest a pointer to the shared ParallelIngest.
+ * @return NULL.
+ */
+static void *meetingChunkWorker(void *parallelIngest);
+
+/**
+ * @brief A function that counts the chunks a shard is split to: its share (by size) of the chunks of all the
+ * shards, but not smaller than MIN_CHUNK_SIZE. A meetings table is split to its blocks.
+ *
+ * @param[in] meetingShard the shard.
+ * @param[in] totalSize the total size of all the shards.
+ * @param[in] threadCount number of worker threads to parse with.
+ * @return the number of chunks. 0 for an empty shard.
+ */
+static unsigned int shardChunkCount(const MeetingShard *meetingShard, unsigned long long totalSize,
+									unsigned int threadCount);
+
+/**
+ * @brief A function that reads the line of the verified carrier, and initializes his severity level.
+ *
+ * @param[in] meetings a pointer to the beginning of the meetingFile's content.
+ * @param[in] fileEnd a pointer to the end of the meetingFile's content.
+ * @param[in] peopleArray an array of all the people that were recorded.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] spreader set to the verified carrier.
+ * @param[in] bodyStart set to the beginning of the first meeting line.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If the carrier was found.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode readSpreaderLine(const char *meetings, const char *fileEnd, Person *peopleArray,
+								   const PeopleIndex *peopleIndex, Person **spreader, const char **bodyStart,
+								   RunStats *runStats);
+
+
+//	****** MEETING SHARDS FUNCTIONS ******
+/**
+ * @brief compares between 2 shard paths, by their bytes (strcmp).
+ *
+ * @param[in] pathA a void pointer, represents pointer to the 1st path (a char pointer) to compare.
+ * @param[in] pathB a void pointer, represents pointer to the 2nd path (a char pointer) to compare.
+ * @return integer: 0 if equal, negative integer if pathA comes before pathB,
+ * and positive integer if pathA comes after pathB.
+ */
+static int shardPathCompare(const void* pathA, const void* pathB);
+
+
+//	****** MEETINGS TABLE FUNCTIONS ******
+/**
+ * @brief A function that parses one block of a meetings table into MeetingEdges - the counterpart of
+ * parseMeetingChunk, without the text: the IDs are resolved to People-Array positions, and crna is calculated
+ * by crnaBatch straight from the distance and time columns.
+ *
+ * @note Runs on the worker threads, so it doesn't write to stderr. The error is kept in chunk->status and
+ * reported by the in-order pass, when it reaches this chunk.
+ * @note The function ALLOCATES MEMORY being stored in chunk->edges.
+ * @param[in] meetingChunk the chunk to parse. start points to the block's columns.
+ * @param[in] peopleArray the array of people, sorted by ID.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ */
+static void parseMeetingTableBlock(MeetingChunk *meetingChunk, Person *peopleArray, const PeopleIndex *peopleIndex);
+
+/**
+ * @brief A function that appends a block of meetings to a meetings table being written, and adds it to the
+ * block index.
+ *
+ * @param[in] outputWriter the writer of the table.
+ * @param[in] header the header of the table. Its counts, and indexOffset - the end of the blocks so far - are
+ * updated.
+ * @param[in] blockIndex the block index. Being (re)allocated.
+ * @param[in] indexCapacity number of entries allocated in blockIndex.
+ * @param[in] idColumns the infector IDs, followed (at MEETINGS_TABLE_BLOCK_SIZE) by the infected IDs.
+ * @param[in] valueColumns the distances, followed (at MEETINGS_TABLE_BLOCK_SIZE) by the times.
+ * @param[in] meetingCount number of meetings in the block.
+ * @param[out] STATUS_CODE_SUCCESS If the block was appended.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode meetingsTableAppendBlock(OutputWriter *outputWriter, MeetingsTableHeader *header,
+										   MeetingsTableBlock **blockIndex, unsigned int *indexCapacity,
+										   const int *idColumns, const float *valueColumns, unsigned int meetingCount);
+
+
+/*
+ * ***********************
+ * 	DEFINITIONS
+ * ***********************
+ */
+/**
+ * @brief A function that parsing the lines from the input meetingsFile.
+ * @details The line has a fixed shape: <infector_id> <infected_id> <distance> <time>, so the fields are parsed
+ * one after the other, in place.
+ * @param[in] meetingReceiver holds all the variables that gonna be 'fed' with the data in the line.
+ * @param[in] lineStart a pointer to the beginning of the line gonna be parsed by the function.
+ * @param[in] lineEnd a pointer to the end of the line (not included).
+ * @param[in] infectorStatus a pointer to a varible that holds the status of the current infector (NEW or OLD).
+ * if it is old, it won't be searched again in the array.
+ * @param[in] curInfector the ID of the current infector examined by the program.
+ * @param[out] STATUS_CODE_SUCCESS If data was stored successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode parseMeetingLine(Meeting *meetingReceiver, const char *lineStart, const char *lineEnd,
+							unsigned int *infectorStatus, int *curInfector)
+{
+	const char *curChar = lineStart;
+	
+	meetingReceiver->infectorID = (int) parseDecimalInteger(&curChar, lineEnd);
+	if (meetingReceiver->infectorID == 0)	// Input can't be 0 by assumption.
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	
+	//	Check if Infector is NEW:
+	if (*curInfector != meetingReceiver->infectorID)
+	{
+		*curInfector = meetingReceiver->infectorID;
+		*infectorStatus = INFECTOR_NEW;
+	}
+	
+	meetingReceiver->infectedID = (int) parseDecimalInteger(&curChar, lineEnd);
+	if (meetingReceiver->infectedID == 0)	// Input can't be 0 by assumption.
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	
+	meetingReceiver->distance = parseDecimalFloat(&curChar, lineEnd);
+	meetingReceiver->time = parseDecimalFloat(&curChar, lineEnd);
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief calculates the chances of infection in coronavirus between 2 people, according to given data.
+ * @details Special function, was developed by one of the staff members of Emzeti-Shem University in the US.
+ * @details Using data given about a meeting of 2 people, and determines the chances of infection in corona.
+ * @param[in] distance distance measured between the people.
+ * @param[in] time measured in which they were next to each other.
+ * @return float value between 0 to 1, represents the chances.
+ */
+static float crna(float distance, float time)
+{
+	float maxTime = MAX_TIME;
+	float minDistance = MIN_DISTANCE;
+	return ((time * minDistance) / (distance * maxTime));
+}
+
+
+/**
+ * @brief The portable crnaBatch kernel: calls crna for every meeting.
+ * @param[in] distances the distances of the meetings.
+ * @param[in] times the times of the meetings.
+ * @param[in] chances receives crna() of every meeting.
+ * @param[in] count number of meetings.
+ */
+static void crnaBatchScalar(const float *distances, const float *times, float *chances, unsigned int count)
+{
+	unsigned int meetingIndex = 0;
+	for (meetingIndex = 0; meetingIndex < count; meetingIndex++)
+	{
+		chances[meetingIndex] = crna(distances[meetingIndex], times[meetingIndex]);
+	}
+}
+
+
+#if defined(__SSE2__)
+/**
+ * @brief The SSE2 crnaBatch kernel: 4 meetings at a time, the rest by crnaBatchScalar.
+ * @details Same operations as crna, in the same order (IEEE multiply and divide per lane), so the chances
+ * are bit-identical to it.
+ * @param[in] distances the distances of the meetings.
+ * @param[in] times the times of the meetings.
+ * @param[in] chances receives crna() of every meeting.
+ * @param[in] count number of meetings.
+ */
+static void crnaBatchSse2(const float *distances, const float *times, float *chances, unsigned int count)
+{
+	const __m128 minDistance128 = _mm_set1_ps(MIN_DISTANCE);
+	const __m128 maxTime128 = _mm_set1_ps(MAX_TIME);
+	unsigned int meetingIndex = 0;
+	for (meetingIndex = 0; (meetingIndex + 4) <= count; meetingIndex += 4)
+	{
+		__m128 numerators = _mm_mul_ps(_mm_loadu_ps(times + meetingIndex), minDistance128);
+		__m128 denominators = _mm_mul_ps(_mm_loadu_ps(distances + meetingIndex), maxTime128);
+		_mm_storeu_ps(chances + meetingIndex, _mm_div_ps(numerators, denominators));
+	}
+	crnaBatchScalar(distances + meetingIndex, times + meetingIndex, chances + meetingIndex,
+					count - meetingIndex);
+}
+#endif
+
+
+#if AVX2_DISPATCH
+/**
+ * @brief The AVX2 crnaBatch kernel: 8 meetings at a time, the rest by crnaBatchScalar.
+ * @details Compiled for AVX2 even when the program isn't, and chosen at runtime only on CPUs which have it.
+ * Bit-identical to crna, as crnaBatchSse2.
+ * @param[in] distances the distances of the meetings.
+ * @param[in] times the times of the meetings.
+ * @param[in] chances receives crna() of every meeting.
+ * @param[in] count number of meetings.
+ */
+__attribute__((target("avx2")))
+static void crnaBatchAvx2(const float *distances, const float *times, float *chances, unsigned int count)
+{
+	const __m256 minDistance256 = _mm256_set1_ps(MIN_DISTANCE);
+	const __m256 maxTime256 = _mm256_set1_ps(MAX_TIME);
+	unsigned int meetingIndex = 0;
+	for (meetingIndex = 0; (meetingIndex + 8) <= count; meetingIndex += 8)
+	{
+		__m256 numerators = _mm256_mul_ps(_mm256_loadu_ps(times + meetingIndex), minDistance256);
+		__m256 denominators = _mm256_mul_ps(_mm256_loadu_ps(distances + meetingIndex), maxTime256);
+		_mm256_storeu_ps(chances + meetingIndex, _mm256_div_ps(numerators, denominators));
+	}
+	crnaBatchScalar(distances + meetingIndex, times + meetingIndex, chances + meetingIndex,
+					count - meetingIndex);
+}
+#endif
+
+
+/**
+ * @brief A function that chooses the crnaBatch kernel: AVX2 if the CPU has it, otherwise SSE2 (when the
+ * program was compiled with it), otherwise the scalar one.
+ */
+static void crnaBatchSelectKernel()
+{
+	crnaBatchKernel = crnaBatchScalar;
+#if defined(__SSE2__)
+	crnaBatchKernel = crnaBatchSse2;
+#endif
+#if AVX2_DISPATCH
+	if (__builtin_cpu_supports("avx2"))
+	{
+		crnaBatchKernel = crnaBatchAvx2;
+	}
+#endif
+}
+
+
+/**
+ * @brief A function that calculates crna for a batch of meetings, with the best kernel of the CPU.
+ * @param[in] distances the distances of the meetings.
+ * @param[in] times the times of the meetings.
+ * @param[in] chances receives crna() of every meeting.
+ * @param[in] count number of meetings.
+ */
+void crnaBatch(const float *distances, const float *times, float *chances, unsigned int count)
+{
+	pthread_once(&crnaBatchKernelOnce, crnaBatchSelectKernel);
+	crnaBatchKernel(distances, times, chances, count);
+}
+
+
+/**
+ * @brief A function that applies a MeetingBlock to the People-Array, and empties it.
+ * @details The chances are calculated by crnaBatch, and the severities are updated in block order, exactly
+ * as calculateSeverities updates them line by line.
+ * @param[in] meetingBlock the block to apply.
+ * @param[in] tierEmitter emits the urgent tiers while streaming (told about every update). NULL - not streaming.
+ * @param[out] STATUS_CODE_SUCCESS If the block was applied.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If the emitter failed.
+ */
+static StatusCode meetingBlockApply(MeetingBlock *meetingBlock, UrgentTierEmitter *tierEmitter)
+{
+	crnaBatch(meetingBlock->distances, meetingBlock->times, meetingBlock->chances, meetingBlock->count);
+	unsigned int meetingIndex = 0;
+	for (meetingIndex = 0; meetingIndex < meetingBlock->count; meetingIndex++)
+	{
+		meetingBlock->infecteds[meetingIndex]->severity = ((meetingBlock->infectors[meetingIndex]->severity) *
+														   (meetingBlock->chances[meetingIndex]));
+		if ((tierEmitter != NULL) && (urgentTierEmitterUpdated(tierEmitter) != STATUS_CODE_SUCCESS))
+		{
+			return STATUS_CODE_OUTPUT_ERROR;
+		}
+	}
+	meetingBlock->count = 0;
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that calculates the chances of infection for each person.
+ * @details the function uses previous data about the people, if exists - in order to make the calculations
+ * faster.
+ * @details The file is read in large blocks through a LineReader, and every line is parsed in place.
+ * @details With a tierEmitter (streaming mode), lines are handled as soon as they arrive, and every update
+ * is reported to the emitter.
+ * @param[in] meetingFile the files that contains the data about meetings, used to calculate
+ * infection chances.
+ * @param[in] peopleArray an array of all the people that were recorded.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] tierEmitter emits the urgent tiers while streaming. NULL - not streaming.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If calculation was succesfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode calculateSeverities(FILE *meetingFile, Person *peopleArray, const PeopleIndex *peopleIndex,
+							   UrgentTierEmitter *tierEmitter, RunStats *runStats)
+{
+	//	Initialize Resources:
+	LineReader lineReader = {0};
+	const char *lineStart = NULL, *lineEnd = NULL;
+	unsigned int infectorStatus = INFECTOR_OLD;		// Used to determine when new search needed.
+	Meeting meetingReceiver = {0};				// Used to receive data from each line.
+	unsigned long long lineCount = 1, lookupCount = 1;	// Reported to runStats. The carrier's line is counted.
+	if (lineReaderInit(&lineReader, meetingFile) != STATUS_CODE_SUCCESS)
+	{
+		return STATUS_CODE_FAIL;
+	}
+	if (tierEmitter != NULL)
+	{
+		lineReaderSetStreaming(&lineReader, urgentTierEmitterOnIdle, tierEmitter);
+	}
+	
+	//	Read First Line (of the verified carrier). if file is empty, EXIT with no error.
+	StatusCode retValRead = lineReaderNextLine(&lineReader, &lineStart, &lineEnd);
+	if (retValRead != STATUS_CODE_SUCCESS)
+	{
+		lineReaderFree(&lineReader);
+		return ((retValRead == STATUS_CODE_END_OF_FILE) ? STATUS_CODE_SUCCESS : STATUS_CODE_FAIL);
+	}
+	int infectorID = (int) parseDecimalInteger(&lineStart, lineEnd);
+	
+	// Searching the carrier and initializing his severity level:
+	Person *infector = peopleIndexLookup(peopleIndex, peopleArray, infectorID);
+	if (infector == NULL)
+	{
+		lineReaderFree(&lineReader);
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_FAIL;
+	}
+	infector->severity = MAX_SEVERITY;
+	if ((tierEmitter != NULL) && (urgentTierEmitterUpdated(tierEmitter) != STATUS_CODE_SUCCESS))
+	{
+		lineReaderFree(&lineReader);
+		error(STATUS_CODE_OUTPUT_ERROR);
+		return STATUS_CODE_FAIL;
+	}
+	Person *infected = NULL;
+	MeetingBlock meetingBlock;	// The parsed lines wait here until their severities are calculated.
+	meetingBlock.count = 0;
+	unsigned int blockCapacity = (tierEmitter != NULL) ? 1 : MEETING_BLOCK_SIZE;	// Streaming: line by line.
+	
+	//	Parsing Line by Line
+	while ((retValRead = lineReaderNextLine(&lineReader, &lineStart, &lineEnd)) == STATUS_CODE_SUCCESS)
+	{
+		if (parseMeetingLine(&meetingReceiver, lineStart, lineEnd, &infectorStatus, &infectorID) !=
+			STATUS_CODE_SUCCESS)
+		{
+			lineReaderFree(&lineReader);
+			return STATUS_CODE_FAIL;
+		}
+		
+		infected = peopleIndexLookup(peopleIndex, peopleArray, meetingReceiver.infectedID);
+		lineCount++;
+		lookupCount++;
+		
+		//	If The Infector changed, search for the new one in the array:
+		if (infectorStatus == INFECTOR_NEW)
+		{
+			infector = peopleIndexLookup(peopleIndex, peopleArray, meetingReceiver.infectorID);
+			infectorStatus = INFECTOR_OLD;
+			lookupCount++;
+		}
+		
+		if ((infected == NULL) || (infector == NULL))
+		{
+			lineReaderFree(&lineReader);
+			error(STATUS_CODE_INPUT_ERROR);
+			return STATUS_CODE_FAIL;
+		}
+		
+		//	Calculating Severity of the infected person (a block of lines at a time):
+		meetingBlock.infectors[meetingBlock.count] = infector;
+		meetingBlock.infecteds[meetingBlock.count] = infected;
+		meetingBlock.distances[meetingBlock.count] = meetingReceiver.distance;
+		meetingBlock.times[meetingBlock.count] = meetingReceiver.time;
+		meetingBlock.count++;
+		if ((meetingBlock.count == blockCapacity) &&
+			(meetingBlockApply(&meetingBlock, tierEmitter) != STATUS_CODE_SUCCESS))
+		{
+			lineReaderFree(&lineReader);
+			error(STATUS_CODE_OUTPUT_ERROR);
+			return STATUS_CODE_FAIL;
+		}
+	}
+	meetingBlockApply(&meetingBlock, tierEmitter);	// Not streaming here, so it can't fail.
+	
+	runStatsCount(runStats, STATS_PHASE_MEETINGS, lineReader.bytesRead, lineCount, lookupCount);
+	lineReaderFree(&lineReader);
+	return ((retValRead == STATUS_CODE_END_OF_FILE) ? STATUS_CODE_SUCCESS : STATUS_CODE_FAIL);
+}
+
+
+/**
+ * @brief A function that calculates the chances of infection for each person, from an array of meetings.
+ * @details The in-memory counterpart of calculateSeverities: the meetings are applied in array order, by
+ * the same rules (the infector is searched again only when it changes).
+ * @param[in] spreaderID the ID of the verified carrier. 0 - there are no meetings at all.
+ * @param[in] meetings the meetings, in BFS batch order.
+ * @param[in] meetingCount number of meetings.
+ * @param[in] peopleArray an array of all the people that were recorded.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If calculation was succesfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode calculateSeveritiesFromMeetings(int spreaderID, const SpreaderDetectorMeeting *meetings,
+										   size_t meetingCount, Person *peopleArray,
+										   const PeopleIndex *peopleIndex, RunStats *runStats)
+{
+	if ((spreaderID == 0) && (meetingCount == 0))
+	{
+		return STATUS_CODE_SUCCESS;
+	}
+	Person *infector = peopleIndexLookup(peopleIndex, peopleArray, spreaderID);
+	if (infector == NULL)
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_FAIL;
+	}
+	infector->severity = MAX_SEVERITY;
+	
+	int infectorID = spreaderID;
+	unsigned long long lookupCount = 1;	// Reported to runStats.
+	MeetingBlock meetingBlock;
+	meetingBlock.count = 0;
+	size_t meetingIndex = 0;
+	for (meetingIndex = 0; meetingIndex < meetingCount; meetingIndex++)
+	{
+		const SpreaderDetectorMeeting *meeting = meetings + meetingIndex;
+		Person *infected = peopleIndexLookup(peopleIndex, peopleArray, meeting->infectedID);
+		lookupCount++;
+		if (meeting->infectorID != infectorID)
+		{
+			infector = peopleIndexLookup(peopleIndex, peopleArray, meeting->infectorID);
+			infectorID = meeting->infectorID;
+			lookupCount++;
+		}
+		if ((infected == NULL) || (infector == NULL))
+		{
+			error(STATUS_CODE_INPUT_ERROR);
+			return STATUS_CODE_FAIL;
+		}
+		meetingBlock.infectors[meetingBlock.count] = infector;
+		meetingBlock.infecteds[meetingBlock.count] = infected;
+		meetingBlock.distances[meetingBlock.count] = meeting->distance;
+		meetingBlock.times[meetingBlock.count] = meeting->time;
+		meetingBlock.count++;
+		if (meetingBlock.count == MEETING_BLOCK_SIZE)
+		{
+			meetingBlockApply(&meetingBlock, NULL);
+		}
+	}
+	meetingBlockApply(&meetingBlock, NULL);
+	runStatsCount(runStats, STATS_PHASE_MEETINGS, 0, meetingCount, lookupCount);
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that sets the chance of the last edges of a chunk, by crnaBatch.
+ * @param[in] meetingChunk the chunk.
+ * @param[in] distances the distances of the edges.
+ * @param[in] times the times of the edges.
+ * @param[in] pendingCount number of edges (at most MEETING_BLOCK_SIZE) - the last ones of the chunk.
+ */
+static void meetingChunkSetChances(MeetingChunk *meetingChunk, const float *distances, const float *times,
+								   unsigned int pendingCount)
+{
+	float chances[MEETING_BLOCK_SIZE];
+	crnaBatch(distances, times, chances, pendingCount);
+	MeetingEdge *blockEdges = meetingChunk->edges + (meetingChunk->edgeCount - pendingCount);
+	unsigned int edgeIndex = 0;
+	for (edgeIndex = 0; edgeIndex < pendingCount; edgeIndex++)
+	{
+		blockEdges[edgeIndex].chance = chances[edgeIndex];
+	}
+}
+
+
+/**
+ * @brief A function that parses one chunk of the meetingsFile into MeetingEdges.
+ * @details The IDs are resolved to People-Array positions and crna is calculated here (by crnaBatch, a block
+ * of edges at a time), so only the severity multiplication is left for the in-order pass.
+ * @note Runs on the worker threads, so it doesn't write to stderr. The error is kept in chunk->status and
+ * reported by the in-order pass, when it reaches this chunk.
+ * @note The function ALLOCATES MEMORY being stored in chunk->edges.
+ * @param[in] meetingChunk the chunk to parse.
+ * @param[in] peopleArray the array of people, sorted by ID.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ */
+static void parseMeetingChunk(MeetingChunk *meetingChunk, Person *peopleArray, const PeopleIndex *peopleIndex)
+{
+	const char *lineStart = meetingChunk->start;
+	const char *lineEnd = NULL;
+	const char *curChar = NULL;
+	int infectorID = 0, infectedID = 0, curInfectorID = 0;
+	Person *infector = NULL, *infected = NULL;
+	float distance = 0, time = 0;
+	float distances[MEETING_BLOCK_SIZE], times[MEETING_BLOCK_SIZE];	// Of the edges waiting for their chance.
+	unsigned int pendingCount = 0;
+	
+	meetingChunk->status = STATUS_CODE_SUCCESS;
+	while (lineStart < meetingChunk->end)
+	{
+		lineEnd = findLineEnd(lineStart, meetingChunk->end);
+		curChar = lineStart;
+		
+		//	Same fields and checks as parseMeetingLine:
+		infectorID = (int) parseDecimalInteger(&curChar, lineEnd);
+		infectedID = (int) parseDecimalInteger(&curChar, lineEnd);
+		if ((infectorID == 0) || (infectedID == 0))	// Input can't be 0 by assumption.
+		{
+			meetingChunk->status = STATUS_CODE_INPUT_ERROR;
+			return;
+		}
+		distance = parseDecimalFloat(&curChar, lineEnd);
+		time = parseDecimalFloat(&curChar, lineEnd);
+		
+		infected = peopleIndexLookup(peopleIndex, peopleArray, infectedID);
+		meetingChunk->lookupCount++;
+		if ((infector == NULL) || (infectorID != curInfectorID))
+		{
+			infector = peopleIndexLookup(peopleIndex, peopleArray, infectorID);
+			curInfectorID = infectorID;
+			meetingChunk->lookupCount++;
+		}
+		if ((infected == NULL) || (infector == NULL))
+		{
+			meetingChunk->status = STATUS_CODE_INPUT_ERROR;
+			return;
+		}
+		
+		// ## MEMORY ALLOCATION ## - (Dynamic Array, first sized by the rest of the chunk - for valid lines, once)
+		if (meetingChunk->edgeCount == meetingChunk->edgeCapacity)
+		{
+			size_t edgeEstimate = ((size_t) (meetingChunk->end - lineStart) / MEETING_LINE_MIN_LEN) + 1;
+			unsigned int newCapacity = (meetingChunk->edgeCapacity != 0) ? (2 * meetingChunk->edgeCapacity) :
+									   (edgeEstimate > (UINT_MAX / 2)) ? (UINT_MAX / 2) :
+									   (unsigned int) edgeEstimate;
+			MeetingEdge *temporaryEdgesPointer = (MeetingEdge *) realloc(meetingChunk->edges,
+																		 newCapacity * sizeof(MeetingEdge));
+			if (temporaryEdgesPointer == NULL)
+			{
+				meetingChunk->status = STATUS_CODE_FAIL;
+				return;
+			}
+			meetingChunk->edges = temporaryEdgesPointer;
+			meetingChunk->edgeCapacity = newCapacity;
+		}
+		
+		MeetingEdge *meetingEdge = meetingChunk->edges + meetingChunk->edgeCount;
+		meetingEdge->infector = (unsigned int) (infector - peopleArray);
+		meetingEdge->infected = (unsigned int) (infected - peopleArray);
+		meetingChunk->edgeCount++;
+		distances[pendingCount] = distance;
+		times[pendingCount] = time;
+		pendingCount++;
+		if (pendingCount == MEETING_BLOCK_SIZE)
+		{
+			meetingChunkSetChances(meetingChunk, distances, times, pendingCount);
+			pendingCount = 0;
+		}
+		
+		lineStart = lineEnd + 1;
+	}
+	meetingChunkSetChances(meetingChunk, distances, times, pendingCount);
+}
+
+
+/**
+ * @brief A function that claims the next chunk no thread took yet, and parses it.
+ * @details Used by the worker threads, and by the in-order pass while it waits for a chunk.
+ * @param[in] parallelIngest the shared state of the parallel ingest.
+ * @return 1 if a chunk was parsed, 0 if there were no chunks left to claim.
+ */
+static int parallelIngestParseNext(ParallelIngest *parallelIngest)
+{
+	pthread_mutex_lock(&parallelIngest->lock);
+	if (parallelIngest->nextChunk >= parallelIngest->chunkCount)
+	{
+		pthread_mutex_unlock(&parallelIngest->lock);
+		return 0;
+	}
+	MeetingChunk *meetingChunk = parallelIngest->chunks + parallelIngest->nextChunk;
+	parallelIngest->nextChunk++;
+	pthread_mutex_unlock(&parallelIngest->lock);
+	
+	if (meetingChunk->tableMeetings > 0)
+	{
+		parseMeetingTableBlock(meetingChunk, parallelIngest->peopleArray, parallelIngest->peopleIndex);
+	}
+	else
+	{
+		parseMeetingChunk(meetingChunk, parallelIngest->peopleArray, parallelIngest->peopleIndex);
+	}
+	
+	pthread_mutex_lock(&parallelIngest->lock);
+	meetingChunk->isParsed = 1;
+	pthread_cond_broadcast(&parallelIngest->chunkParsed);
+	pthread_mutex_unlock(&parallelIngest->lock);
+	return 1;
+}
+
+
+/**
+ * @brief The function run by each worker thread of the parallel ingest.
+ * @param[in] parallelIngest a pointer to the shared ParallelIngest.
+ * @return NULL.
+ */
+static void *meetingChunkWorker(void *parallelIngest)
+{
+	while (parallelIngestParseNext((ParallelIngest *) parallelIngest))
+	{
+		continue;
+	}
+	return NULL;
+}
+
+
+/**
+ * @brief A function that counts the chunks a shard is split to: its share (by size) of the chunks of all the
+ * shards, but not smaller than MIN_CHUNK_SIZE. A meetings table is split to its blocks.
+ * @param[in] meetingShard the shard.
+ * @param[in] totalSize the total size of all the shards.
+ * @param[in] threadCount number of worker threads to parse with.
+ * @return the number of chunks. 0 for an empty shard.
+ */
+static unsigned int shardChunkCount(const MeetingShard *meetingShard, unsigned long long totalSize,
+									unsigned int threadCount)
+{
+	size_t bodySize = (size_t) (meetingShard->end - meetingShard->start);
+	if (meetingShard->table != NULL)
+	{
+		return meetingShard->table->blockCount;	// A chunk per block.
+	}
+	if (bodySize == 0)
+	{
+		return 0;
+	}
+	unsigned long long chunkCount = ((unsigned long long) threadCount * CHUNKS_PER_THREAD * bodySize) / totalSize;
+	if ((bodySize / MIN_CHUNK_SIZE) + 1 < chunkCount)
+	{
+		chunkCount = (bodySize / MIN_CHUNK_SIZE) + 1;
+	}
+	return (chunkCount == 0) ? 1 : (unsigned int) chunkCount;
+}
+
+
+/**
+ * @brief A function that splits the meetings (the lines after the verified carrier) to chunks, and starts
+ * the threads which parse them.
+ * @details A few newline-aligned chunks per thread (for balance), but not smaller than MIN_CHUNK_SIZE. The
+ * chunks are divided between the shards by their sizes, and no chunk crosses a shard, so the chunks (in
+ * order) cover the shards in order - a meetings table's chunks are its blocks. If a thread can't be created,
+ * the other threads (and the caller, in parallelIngestWaitChunk) do its part.
+ * @note The function ALLOCATES MEMORY being stored in parallelIngest. released by parallelIngestStop.
+ * @param[in] parallelIngest the shared state to initialize.
+ * @param[in] meetingShards the shards of meeting lines.
+ * @param[in] shardCount number of shards. If all of them are empty, there is a single empty chunk.
+ * @param[in] peopleArray the array of people, sorted by ID.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] threadCount number of worker threads to parse with.
+ * @param[out] STATUS_CODE_SUCCESS If the ingest was started successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode parallelIngestStart(ParallelIngest *parallelIngest, const MeetingShard *meetingShards,
+							   unsigned int shardCount, Person *peopleArray, const PeopleIndex *peopleIndex,
+							   unsigned int threadCount)
+{
+	// ## COUNT CHUNKS ## - per shard, in proportion to its size:
+	unsigned long long totalSize = 0;
+	unsigned int shardIndex = 0, chunkCount = 0;
+	for (shardIndex = 0; shardIndex < shardCount; shardIndex++)
+	{
+		totalSize += (unsigned long long) (meetingShards[shardIndex].end - meetingShards[shardIndex].start);
+	}
+	for (shardIndex = 0; shardIndex < shardCount; shardIndex++)
+	{
+		chunkCount += shardChunkCount(meetingShards + shardIndex, totalSize, threadCount);
+	}
+	parallelIngest->chunks = (MeetingChunk *) calloc((chunkCount == 0) ? 1 : chunkCount, sizeof(MeetingChunk));
+	parallelIngest->workers = (pthread_t *) malloc(threadCount * sizeof(pthread_t));
+	if ((parallelIngest->chunks == NULL) || (parallelIngest->workers == NULL))
+	{
+		free(parallelIngest->chunks);
+		free(parallelIngest->workers);
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	
+	// ## SPLIT TO CHUNKS ## - (an empty body is a single empty chunk)
+	unsigned int chunkIndex = 0;
+	if (chunkCount == 0)
+	{
+		chunkCount = 1;
+	}
+	for (shardIndex = 0; shardIndex < shardCount; shardIndex++)
+	{
+		const char *bodyStart = meetingShards[shardIndex].start, *fileEnd = meetingShards[shardIndex].end;
+		size_t bodySize = (size_t) (fileEnd - bodyStart);
+		unsigned int shardChunks = shardChunkCount(meetingShards + shardIndex, totalSize, threadCount);
+		const char *chunkStart = bodyStart;
+		unsigned int shardChunkIndex = 0;
+		const MeetingsTableHeader *table = meetingShards[shardIndex].table;
+		const MeetingsTableBlock *blockIndex = (table == NULL) ? NULL :
+											   (const MeetingsTableBlock *) ((const char *) table + table->indexOffset);
+		for (shardChunkIndex = 0; shardChunkIndex < shardChunks; shardChunkIndex++, chunkIndex++)
+		{
+			if (table != NULL)	// A block of a meetings table.
+			{
+				parallelIngest->chunks[chunkIndex].start = (const char *) table + blockIndex[shardChunkIndex].offset;
+				parallelIngest->chunks[chunkIndex].end = parallelIngest->chunks[chunkIndex].start +
+														 (MEETINGS_TABLE_COLUMN_COUNT * sizeof(int) *
+														  blockIndex[shardChunkIndex].meetingCount);
+				parallelIngest->chunks[chunkIndex].tableMeetings = blockIndex[shardChunkIndex].meetingCount;
+				continue;
+			}
+			const char *chunkEnd = fileEnd;
+			if (shardChunkIndex != (shardChunks - 1))
+			{
+				chunkEnd = bodyStart + ((bodySize / shardChunks) * (shardChunkIndex + 1));
+				chunkEnd = (chunkEnd < chunkStart) ? chunkStart : findLineEnd(chunkEnd, fileEnd);
+				chunkEnd = (chunkEnd < fileEnd) ? (chunkEnd + 1) : fileEnd;
+			}
+			parallelIngest->chunks[chunkIndex].start = chunkStart;
+			parallelIngest->chunks[chunkIndex].end = chunkEnd;
+			chunkStart = chunkEnd;
+		}
+	}
+	parallelIngest->chunkCount = chunkCount;
+	parallelIngest->nextChunk = 0;
+	parallelIngest->peopleArray = peopleArray;
+	parallelIngest->peopleIndex = peopleIndex;
+	pthread_mutex_init(&parallelIngest->lock, NULL);
+	pthread_cond_init(&parallelIngest->chunkParsed, NULL);
+	
+	// ## START WORKERS ##
+	parallelIngest->workerCount = 0;
+	while ((parallelIngest->workerCount < threadCount) &&
+		   (pthread_create(parallelIngest->workers + parallelIngest->workerCount, NULL, meetingChunkWorker,
+						   parallelIngest) == 0))
+	{
+		parallelIngest->workerCount++;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that waits until a chunk is parsed, parsing unclaimed chunks in the meantime.
+ * @param[in] parallelIngest the shared state of the parallel ingest.
+ * @param[in] chunkIndex the chunk to wait for.
+ * @return a pointer to the parsed chunk.
+ */
+MeetingChunk *parallelIngestWaitChunk(ParallelIngest *parallelIngest, unsigned int chunkIndex)
+{
+	MeetingChunk *meetingChunk = parallelIngest->chunks + chunkIndex;
+	pthread_mutex_lock(&parallelIngest->lock);
+	while (!meetingChunk->isParsed)
+	{
+		if (parallelIngest->nextChunk < parallelIngest->chunkCount)
+		{
+			pthread_mutex_unlock(&parallelIngest->lock);
+			parallelIngestParseNext(parallelIngest);
+			pthread_mutex_lock(&parallelIngest->lock);
+		}
+		else
+		{
+			pthread_cond_wait(&parallelIngest->chunkParsed, &parallelIngest->lock);
+		}
+	}
+	pthread_mutex_unlock(&parallelIngest->lock);
+	return meetingChunk;
+}
+
+
+/**
+ * @brief A function that stops the parallel ingest, and releases its memory.
+ * @details Chunks which weren't claimed yet are not parsed. The function waits for the chunks being parsed.
+ * @param[in] parallelIngest the shared state of the parallel ingest.
+ */
+void parallelIngestStop(ParallelIngest *parallelIngest)
+{
+	pthread_mutex_lock(&parallelIngest->lock);
+	parallelIngest->nextChunk = parallelIngest->chunkCount;
+	pthread_mutex_unlock(&parallelIngest->lock);
+	while (parallelIngest->workerCount > 0)
+	{
+		parallelIngest->workerCount--;
+		pthread_join(parallelIngest->workers[parallelIngest->workerCount], NULL);
+	}
+	
+	unsigned int chunkIndex = 0;
+	for (chunkIndex = 0; chunkIndex < parallelIngest->chunkCount; chunkIndex++)
+	{
+		free(parallelIngest->chunks[chunkIndex].edges);
+	}
+	free(parallelIngest->workers);
+	free(parallelIngest->chunks);
+	parallelIngest->workers = NULL;
+	parallelIngest->chunks = NULL;
+	parallelIngest->chunkCount = 0;
+	pthread_cond_destroy(&parallelIngest->chunkParsed);
+	pthread_mutex_destroy(&parallelIngest->lock);
+}
+
+
+/**
+ * @brief A function that reads the line of the verified carrier, and initializes his severity level.
+ * @param[in] meetings a pointer to the beginning of the meetingFile's content.
+ * @param[in] fileEnd a pointer to the end of the meetingFile's content.
+ * @param[in] peopleArray an array of all the people that were recorded.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] spreader set to the verified carrier.
+ * @param[in] bodyStart set to the beginning of the first meeting line.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If the carrier was found.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode readSpreaderLine(const char *meetings, const char *fileEnd, Person *peopleArray,
+								   const PeopleIndex *peopleIndex, Person **spreader, const char **bodyStart,
+								   RunStats *runStats)
+{
+	const char *lineEnd = findLineEnd(meetings, fileEnd);
+	const char *curChar = meetings;
+	*spreader = peopleIndexLookup(peopleIndex, peopleArray, (int) parseDecimalInteger(&curChar, lineEnd));
+	if (*spreader == NULL)
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_FAIL;
+	}
+	(*spreader)->severity = MAX_SEVERITY;
+	*bodyStart = (lineEnd < fileEnd) ? (lineEnd + 1) : fileEnd;
+	runStatsCount(runStats, STATS_PHASE_MEETINGS, (unsigned long long) (*bodyStart - meetings), 1, 1);
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that reads the line of the verified carrier, and initializes his severity level.
+ * @details The carrier's shard is the first one which starts with a single ID (or a meetings table which holds
+ * the carrier in its header), whatever its place among the shards. The line is skipped in its shard. A carrier
+ * of a later shard is ignored.
+ * @param[in] meetingShards the shards of the meetings, in order.
+ * @param[in] shardCount number of shards.
+ * @param[in] peopleArray an array of all the people that were recorded.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] spreader set to the verified carrier. NULL if all the shards are empty.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If the carrier was found, or all the shards are empty.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode meetingShardsReadSpreader(MeetingShard *meetingShards, unsigned int shardCount, Person *peopleArray,
+									 const PeopleIndex *peopleIndex, Person **spreader, RunStats *runStats)
+{
+	unsigned int shardIndex = 0;
+	int hasMeetings = 0;
+	*spreader = NULL;
+	for (shardIndex = 0; shardIndex < shardCount; shardIndex++)
+	{
+		MeetingShard *meetingShard = meetingShards + shardIndex;
+		if ((meetingShard->table != NULL) && (meetingShard->table->spreaderID != MEETINGS_TABLE_NO_SPREADER))
+		{
+			*spreader = peopleIndexLookup(peopleIndex, peopleArray, meetingShard->table->spreaderID);
+			if (*spreader == NULL)
+			{
+				error(STATUS_CODE_INPUT_ERROR);
+				return STATUS_CODE_FAIL;
+			}
+			(*spreader)->severity = MAX_SEVERITY;
+			runStatsCount(runStats, STATS_PHASE_MEETINGS, 0, 1, 1);
+			return STATUS_CODE_SUCCESS;
+		}
+		if (meetingShard->start == meetingShard->end)
+		{
+			continue;
+		}
+		hasMeetings = 1;
+		if (meetingShard->table == NULL)
+		{
+			//	The carrier's row is a single ID - a meeting row has two IDs:
+			const char *lineEnd = findLineEnd(meetingShard->start, meetingShard->end);
+			const char *curChar = meetingShard->start;
+			parseDecimalInteger(&curChar, lineEnd);
+			if (parseDecimalInteger(&curChar, lineEnd) == 0)
+			{
+				return readSpreaderLine(meetingShard->start, meetingShard->end, peopleArray, peopleIndex, spreader,
+										&meetingShard->start, runStats);
+			}
+		}
+	}
+	if (hasMeetings)
+	{
+		error(STATUS_CODE_INPUT_ERROR);	// The meetings have no carrier.
+		return STATUS_CODE_FAIL;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that calculates the chances of infection for each person, parsing the meetingFile on
+ * several threads.
+ * @details The meetings are parsed by parallelIngest threads into per-chunk MeetingEdge arrays. The calling
+ * thread then applies the chunks in file order, exactly as calculateSeverities applies the lines - so the
+ * results are the same. Shards are applied in order, as if they were one file.
+ * @param[in] meetingShards the shards of the meetings, in order. The verified carrier's line is skipped.
+ * @param[in] shardCount number of shards.
+ * @param[in] peopleArray an array of all the people that were recorded.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] threadCount number of worker threads to parse with.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If calculation was succesfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode calculateSeveritiesParallel(MeetingShard *meetingShards, unsigned int shardCount, Person *peopleArray,
+									   const PeopleIndex *peopleIndex, unsigned int threadCount,
+									   RunStats *runStats)
+{
+	Person *spreader = NULL;
+	if (meetingShardsReadSpreader(meetingShards, shardCount, peopleArray, peopleIndex, &spreader, runStats) !=
+		STATUS_CODE_SUCCESS)
+	{
+		return STATUS_CODE_FAIL;
+	}
+	if (spreader == NULL)
+	{
+		return STATUS_CODE_SUCCESS;
+	}
+	
+	ParallelIngest parallelIngest = {0};
+	if (parallelIngestStart(&parallelIngest, meetingShards, shardCount, peopleArray, peopleIndex, threadCount) !=
+		STATUS_CODE_SUCCESS)
+	{
+		return STATUS_CODE_FAIL;
+	}
+	
+	// ## APPLY CHUNKS IN FILE ORDER ##
+	StatusCode retValCalc = STATUS_CODE_SUCCESS;
+	unsigned int chunkIndex = 0;
+	for (chunkIndex = 0; (chunkIndex < parallelIngest.chunkCount) && (retValCalc == STATUS_CODE_SUCCESS);
+		 chunkIndex++)
+	{
+		MeetingChunk *meetingChunk = parallelIngestWaitChunk(&parallelIngest, chunkIndex);
+		runStatsCount(runStats, STATS_PHASE_MEETINGS, (unsigned long long) (meetingChunk->end - meetingChunk->start),
+					  meetingChunk->edgeCount, meetingChunk->lookupCount);
+		
+		//	Severities of the chunk's lines (the edges before a bad line are applied, as in the serial path):
+		unsigned int edgeIndex = 0;
+		for (edgeIndex = 0; edgeIndex < meetingChunk->edgeCount; edgeIndex++)
+		{
+			const MeetingEdge *meetingEdge = meetingChunk->edges + edgeIndex;
+			peopleArray[meetingEdge->infected].severity =
+				((peopleArray[meetingEdge->infector].severity) * (meetingEdge->chance));
+		}
+		if (meetingChunk->status != STATUS_CODE_SUCCESS)
+		{
+			error(meetingChunk->status);
+			retValCalc = STATUS_CODE_FAIL;
+		}
+		free(meetingChunk->edges);
+		meetingChunk->edges = NULL;
+	}
+	
+	parallelIngestStop(&parallelIngest);
+	return retValCalc;
+}
+
+
+/**
+ * @brief compares between 2 shard paths, by their bytes (strcmp).
+ * @param[in] pathA a void pointer, represents pointer to the 1st path (a char pointer) to compare.
+ * @param[in] pathB a void pointer, represents pointer to the 2nd path (a char pointer) to compare.
+ * @return integer: 0 if equal, negative integer if pathA comes before pathB,
+ * and positive integer if pathA comes after pathB.
+ */
+static int shardPathCompare(const void* pathA, const void* pathB)
+{
+	return strcmp(*(char * const *) pathA, *(char * const *) pathB);
+}
+
+
+/**
+ * @brief A function that lists the shards in a meetings directory: its regular files (not the hidden ones),
+ * sorted by name - so the same directory always gives the same order.
+ * @note The function ALLOCATES MEMORY being stored in shardPaths. released by meetingShardPathsFree, even in
+ * failure.
+ * @param[in] directoryPath the path of the directory.
+ * @param[in] shardPaths set to the paths of the shards.
+ * @param[in] shardCount set to the number of shards.
+ * @param[out] STATUS_CODE_SUCCESS If the directory was listed.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode meetingShardsListDirectory(const char *directoryPath, char ***shardPaths, unsigned int *shardCount)
+{
+	DIR *meetingsDirectory = opendir(directoryPath);
+	*shardPaths = NULL;
+	*shardCount = 0;
+	if (meetingsDirectory == NULL)
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	size_t directoryLength = strlen(directoryPath);
+	unsigned int capacity = 0;
+	struct dirent *directoryEntry = NULL;
+	while ((directoryEntry = readdir(meetingsDirectory)) != NULL)
+	{
+		if (directoryEntry->d_name[0] == '.')
+		{
+			continue;
+		}
+		
+		// ## MEMORY ALLOCATION ## - (Dynamic Array)
+		if (*shardCount == capacity)
+		{
+			capacity = (capacity == 0) ? SHARD_PATHS_INITIAL_CAPACITY : (2 * capacity);
+			char **temporaryPathsPointer = (char **) realloc(*shardPaths, capacity * sizeof(char *));
+			if (temporaryPathsPointer == NULL)
+			{
+				closedir(meetingsDirectory);
+				error(STATUS_CODE_FAIL);
+				return STATUS_CODE_FAIL;
+			}
+			*shardPaths = temporaryPathsPointer;
+		}
+		size_t nameLength = strlen(directoryEntry->d_name);
+		char *shardPath = (char *) malloc(directoryLength + nameLength + 2);
+		if (shardPath == NULL)
+		{
+			closedir(meetingsDirectory);
+			error(STATUS_CODE_FAIL);
+			return STATUS_CODE_FAIL;
+		}
+		memcpy(shardPath, directoryPath, directoryLength);
+		shardPath[directoryLength] = '/';
+		memcpy(shardPath + directoryLength + 1, directoryEntry->d_name, nameLength + 1);
+		
+		//	Regular files only (sub-directories are not shards):
+		struct stat shardStat;
+		if ((stat(shardPath, &shardStat) != 0) || !S_ISREG(shardStat.st_mode))
+		{
+			free(shardPath);
+			continue;
+		}
+		(*shardPaths)[(*shardCount)++] = shardPath;
+	}
+	closedir(meetingsDirectory);
+	if (*shardCount > 1)
+	{
+		qsort(*shardPaths, *shardCount, sizeof(char *), shardPathCompare);
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that releases the shard paths listed by meetingShardsListDirectory.
+ * @param[in] shardPaths the paths. May be NULL.
+ * @param[in] shardCount number of paths.
+ */
+void meetingShardPathsFree(char **shardPaths, unsigned int shardCount)
+{
+	unsigned int shardIndex = 0;
+	for (shardIndex = 0; (shardPaths != NULL) && (shardIndex < shardCount); shardIndex++)
+	{
+		free(shardPaths[shardIndex]);
+	}
+	free(shardPaths);
+}
+
+
+/**
+ * @brief A function that loads the meeting shards: regular files are mapped to memory, other files (e.g.
+ * pipes, and compressed files - see inputFileOpen) are read whole. An empty file is an empty shard.
+ * @note The function ALLOCATES MEMORY being stored in meetingShards. released by meetingShardsFree, even in
+ * failure.
+ * @param[in] shardPaths the paths of the shards, in order.
+ * @param[in] shardCount number of shards.
+ * @param[in] meetingShards set to the loaded shards.
+ * @param[out] STATUS_CODE_SUCCESS If all the shards were loaded.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode meetingShardsLoad(const char *const *shardPaths, unsigned int shardCount,
+							 MeetingShard **meetingShards)
+{
+	*meetingShards = (MeetingShard *) calloc((size_t) shardCount + 1, sizeof(MeetingShard));
+	if (*meetingShards == NULL)
+	{
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	unsigned int shardIndex = 0;
+	for (shardIndex = 0; shardIndex < shardCount; shardIndex++)
+	{
+		MeetingShard *meetingShard = *meetingShards + shardIndex;
+		struct stat shardStat;
+		Decompressor decompressor = {0};
+		FILE *shardFile = inputFileOpen(shardPaths[shardIndex], &decompressor);
+		if ((shardFile == NULL) || (fstat(fileno(shardFile), &shardStat) != 0) || S_ISDIR(shardStat.st_mode))
+		{
+			if (shardFile != NULL)
+			{
+				inputFileClose(shardFile, &decompressor);
+			}
+			error(STATUS_CODE_INPUT_ERROR);
+			return STATUS_CODE_INPUT_ERROR;
+		}
+		StatusCode retValLoad = STATUS_CODE_SUCCESS;
+		if (S_ISREG(shardStat.st_mode) && (shardStat.st_size > 0))
+		{
+			char *mappedFile = (char *) mmap(NULL, (size_t) shardStat.st_size, PROT_READ, MAP_PRIVATE,
+											 fileno(shardFile), 0);
+			if (mappedFile == MAP_FAILED)
+			{
+				error(STATUS_CODE_INPUT_ERROR);
+				retValLoad = STATUS_CODE_INPUT_ERROR;
+			}
+			else
+			{
+				meetingShard->content = mappedFile;
+				meetingShard->contentSize = (size_t) shardStat.st_size;
+				meetingShard->isMapped = 1;
+			}
+		}
+		else if (!S_ISREG(shardStat.st_mode))
+		{
+			retValLoad = readWholeFile(shardFile, &meetingShard->content, &meetingShard->contentSize);
+		}
+		if ((inputFileClose(shardFile, &decompressor) != STATUS_CODE_SUCCESS) && (retValLoad == STATUS_CODE_SUCCESS))
+		{
+			error(STATUS_CODE_INPUT_ERROR);
+			retValLoad = STATUS_CODE_INPUT_ERROR;
+		}
+		if (retValLoad != STATUS_CODE_SUCCESS)
+		{
+			return retValLoad;
+		}
+		meetingShard->start = meetingShard->content;
+		meetingShard->end = meetingShard->content + meetingShard->contentSize;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that releases the shards loaded by meetingShardsLoad.
+ * @param[in] meetingShards the shards. May be NULL, or partially loaded.
+ * @param[in] shardCount number of shards.
+ */
+void meetingShardsFree(MeetingShard *meetingShards, unsigned int shardCount)
+{
+	unsigned int shardIndex = 0;
+	for (shardIndex = 0; (meetingShards != NULL) && (shardIndex < shardCount); shardIndex++)
+	{
+		if (meetingShards[shardIndex].isMapped)
+		{
+			munmap(meetingShards[shardIndex].content, meetingShards[shardIndex].contentSize);
+		}
+		else
+		{
+			free(meetingShards[shardIndex].content);
+		}
+	}
+	free(meetingShards);
+}
+
+
+/**
+ * @brief A function that checks whether an opened meetingFile is a meetings table, by its magic.
+ * @param[in] meetingFd the opened meetingFile descriptor. Must be a regular file.
+ * @param[in] fileSize the size of the meetingFile.
+ * @return 1 if the file starts with MEETINGS_TABLE_MAGIC, 0 otherwise.
+ */
+int isMeetingsTable(int meetingFd, size_t fileSize)
+{
+	char magic[MEETINGS_TABLE_MAGIC_LEN];
+	if (fileSize < sizeof(MeetingsTableHeader))
+	{
+		return 0;
+	}
+	return ((pread(meetingFd, magic, MEETINGS_TABLE_MAGIC_LEN, 0) == MEETINGS_TABLE_MAGIC_LEN) &&
+			(memcmp(magic, MEETINGS_TABLE_MAGIC, MEETINGS_TABLE_MAGIC_LEN) == 0));
+}
+
+
+/**
+ * @brief A function that finds the shards which are meetings tables (by their magic), validates them, and
+ * points them at their blocks - which are then parsed in place, a chunk per block (see
+ * parseMeetingTableBlock). The other shards are left as lines.
+ * @details Nothing is parsed here: the header and the block index are only checked against the size of the
+ * shard.
+ * @param[in] meetingShards the shards of the meetings, not parsed yet.
+ * @param[in] shardCount number of shards.
+ * @param[out] STATUS_CODE_SUCCESS If every table is valid.
+ * @param[out] STATUS_CODE_INPUT_ERROR If a table is invalid (or isn't aligned in memory).
+ */
+StatusCode meetingShardsOpenTables(MeetingShard *meetingShards, unsigned int shardCount)
+{
+	unsigned int shardIndex = 0;
+	for (shardIndex = 0; shardIndex < shardCount; shardIndex++)
+	{
+		MeetingShard *meetingShard = meetingShards + shardIndex;
+		size_t shardSize = (size_t) (meetingShard->end - meetingShard->start);
+		if ((shardSize < sizeof(MeetingsTableHeader)) ||
+			(memcmp(meetingShard->start, MEETINGS_TABLE_MAGIC, MEETINGS_TABLE_MAGIC_LEN) != 0))
+		{
+			continue;
+		}
+		
+		// ## VALIDATE HEADER ##
+		const MeetingsTableHeader *header = (const MeetingsTableHeader *) meetingShard->start;
+		if ((((uintptr_t) meetingShard->start % sizeof(unsigned long long)) != 0) ||
+			(header->version != MEETINGS_TABLE_VERSION) || (header->byteOrderMark != SNAPSHOT_BYTE_ORDER_MARK) ||
+			(header->indexOffset < sizeof(MeetingsTableHeader)) ||
+			((header->indexOffset % sizeof(unsigned long long)) != 0) || (header->indexOffset > shardSize) ||
+			((shardSize - header->indexOffset) / sizeof(MeetingsTableBlock) != header->blockCount) ||
+			((shardSize - header->indexOffset) % sizeof(MeetingsTableBlock) != 0))
+		{
+			error(STATUS_CODE_INPUT_ERROR);
+			return STATUS_CODE_INPUT_ERROR;
+		}
+		
+		// ## VALIDATE BLOCK INDEX ## - every block is inside the blocks' area:
+		const MeetingsTableBlock *blockIndex = (const MeetingsTableBlock *) (meetingShard->start +
+																			 header->indexOffset);
+		unsigned long long meetingCount = 0;
+		unsigned int blockIndexPosition = 0;
+		for (blockIndexPosition = 0; blockIndexPosition < header->blockCount; blockIndexPosition++)
+		{
+			const MeetingsTableBlock *tableBlock = blockIndex + blockIndexPosition;
+			if ((tableBlock->meetingCount == 0) || (tableBlock->meetingCount > MEETINGS_TABLE_BLOCK_SIZE) ||
+				(tableBlock->offset < sizeof(MeetingsTableHeader)) || ((tableBlock->offset % sizeof(int)) != 0) ||
+				(tableBlock->offset > header->indexOffset) ||
+				((header->indexOffset - tableBlock->offset) / (MEETINGS_TABLE_COLUMN_COUNT * sizeof(int)) <
+				 tableBlock->meetingCount))
+			{
+				error(STATUS_CODE_INPUT_ERROR);
+				return STATUS_CODE_INPUT_ERROR;
+			}
+			meetingCount += tableBlock->meetingCount;
+		}
+		if (meetingCount != header->meetingCount)
+		{
+			error(STATUS_CODE_INPUT_ERROR);
+			return STATUS_CODE_INPUT_ERROR;
+		}
+		meetingShard->table = header;
+		meetingShard->start += sizeof(MeetingsTableHeader);
+		meetingShard->end = (const char *) header + header->indexOffset;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that parses one block of a meetings table into MeetingEdges - the counterpart of
+ * parseMeetingChunk, without the text: the IDs are resolved to People-Array positions, and crna is calculated
+ * by crnaBatch straight from the distance and time columns.
+ * @note Runs on the worker threads, so it doesn't write to stderr. The error is kept in chunk->status and
+ * reported by the in-order pass, when it reaches this chunk.
+ * @note The function ALLOCATES MEMORY being stored in chunk->edges.
+ * @param[in] meetingChunk the chunk to parse. start points to the block's columns.
+ * @param[in] peopleArray the array of people, sorted by ID.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ */
+static void parseMeetingTableBlock(MeetingChunk *meetingChunk, Person *peopleArray, const PeopleIndex *peopleIndex)
+{
+	unsigned int meetingCount = meetingChunk->tableMeetings;
+	const int *infectorIDs = (const int *) meetingChunk->start;
+	const int *infectedIDs = infectorIDs + meetingCount;
+	const float *distances = (const float *) (infectedIDs + meetingCount);
+	const float *times = distances + meetingCount;
+	Person *infector = NULL, *infected = NULL;
+	int curInfectorID = 0;
+	
+	meetingChunk->status = STATUS_CODE_SUCCESS;
+	meetingChunk->edges = (MeetingEdge *) malloc(meetingCount * sizeof(MeetingEdge));
+	if (meetingChunk->edges == NULL)
+	{
+		meetingChunk->status = STATUS_CODE_FAIL;
+		return;
+	}
+	meetingChunk->edgeCapacity = meetingCount;
+	
+	//	IDs to positions (the edges before a bad meeting are kept, as in parseMeetingChunk):
+	unsigned int meetingIndex = 0;
+	for (meetingIndex = 0; meetingIndex < meetingCount; meetingIndex++)
+	{
+		infected = peopleIndexLookup(peopleIndex, peopleArray, infectedIDs[meetingIndex]);
+		meetingChunk->lookupCount++;
+		if ((infector == NULL) || (infectorIDs[meetingIndex] != curInfectorID))
+		{
+			infector = peopleIndexLookup(peopleIndex, peopleArray, infectorIDs[meetingIndex]);
+			curInfectorID = infectorIDs[meetingIndex];
+			meetingChunk->lookupCount++;
+		}
+		if ((infected == NULL) || (infector == NULL))
+		{
+			meetingChunk->status = STATUS_CODE_INPUT_ERROR;
+			break;
+		}
+		meetingChunk->edges[meetingIndex].infector = (unsigned int) (infector - peopleArray);
+		meetingChunk->edges[meetingIndex].infected = (unsigned int) (infected - peopleArray);
+		meetingChunk->edgeCount++;
+	}
+	
+	//	Chances, a MEETING_BLOCK_SIZE slice of the columns at a time:
+	float chances[MEETING_BLOCK_SIZE];
+	unsigned int sliceStart = 0;
+	for (sliceStart = 0; sliceStart < meetingChunk->edgeCount; sliceStart += MEETING_BLOCK_SIZE)
+	{
+		unsigned int sliceCount = meetingChunk->edgeCount - sliceStart;
+		sliceCount = (sliceCount > MEETING_BLOCK_SIZE) ? MEETING_BLOCK_SIZE : sliceCount;
+		crnaBatch(distances + sliceStart, times + sliceStart, chances, sliceCount);
+		for (meetingIndex = 0; meetingIndex < sliceCount; meetingIndex++)
+		{
+			meetingChunk->edges[sliceStart + meetingIndex].chance = chances[meetingIndex];
+		}
+	}
+}
+
+
+/**
+ * @brief A function that appends a block of meetings to a meetings table being written, and adds it to the
+ * block index.
+ * @param[in] outputWriter the writer of the table.
+ * @param[in] header the header of the table. Its counts, and indexOffset - the end of the blocks so far - are
+ * updated.
+ * @param[in] blockIndex the block index. Being (re)allocated.
+ * @param[in] indexCapacity number of entries allocated in blockIndex.
+ * @param[in] idColumns the infector IDs, followed (at MEETINGS_TABLE_BLOCK_SIZE) by the infected IDs.
+ * @param[in] valueColumns the distances, followed (at MEETINGS_TABLE_BLOCK_SIZE) by the times.
+ * @param[in] meetingCount number of meetings in the block.
+ * @param[out] STATUS_CODE_SUCCESS If the block was appended.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode meetingsTableAppendBlock(OutputWriter *outputWriter, MeetingsTableHeader *header,
+										   MeetingsTableBlock **blockIndex, unsigned int *indexCapacity,
+										   const int *idColumns, const float *valueColumns, unsigned int meetingCount)
+{
+	// ## MEMORY ALLOCATION ## - (Dynamic Array)
+	if (header->blockCount == *indexCapacity)
+	{
+		unsigned int newCapacity = (*indexCapacity == 0) ? MEETINGS_TABLE_INDEX_INITIAL_CAPACITY :
+								   (2 * (*indexCapacity));
+		MeetingsTableBlock *temporaryIndexPointer = (MeetingsTableBlock *) realloc(*blockIndex, newCapacity *
+																				   sizeof(MeetingsTableBlock));
+		if (temporaryIndexPointer == NULL)
+		{
+			error(STATUS_CODE_FAIL);
+			return STATUS_CODE_FAIL;
+		}
+		*blockIndex = temporaryIndexPointer;
+		*indexCapacity = newCapacity;
+	}
+	MeetingsTableBlock *tableBlock = *blockIndex + header->blockCount;
+	tableBlock->offset = header->indexOffset;
+	tableBlock->meetingCount = meetingCount;
+	tableBlock->reserved = 0;
+	
+	// ## WRITE COLUMNS ##
+	size_t columnSize = meetingCount * sizeof(int);
+	StatusCode retValWrite = outputWriterAppendBytes(outputWriter, idColumns, columnSize);
+	if (retValWrite == STATUS_CODE_SUCCESS)
+	{
+		retValWrite = outputWriterAppendBytes(outputWriter, idColumns + MEETINGS_TABLE_BLOCK_SIZE, columnSize);
+	}
+	if (retValWrite == STATUS_CODE_SUCCESS)
+	{
+		retValWrite = outputWriterAppendBytes(outputWriter, valueColumns, columnSize);
+	}
+	if (retValWrite == STATUS_CODE_SUCCESS)
+	{
+		retValWrite = outputWriterAppendBytes(outputWriter, valueColumns + MEETINGS_TABLE_BLOCK_SIZE, columnSize);
+	}
+	header->blockCount++;
+	header->meetingCount += meetingCount;
+	header->indexOffset += MEETINGS_TABLE_COLUMN_COUNT * columnSize;
+	return retValWrite;
+}
+
+
+/**
+ * @brief A function that converts a meetingFile to a meetings table.
+ * @details Layout: a MeetingsTableHeader, the blocks (MEETINGS_TABLE_BLOCK_SIZE meetings each, but the last)
+ * and the block index. The lines are parsed (and checked) once, as calculateSeverities parses them, and the
+ * values are stored as parsed - so a run over the table gives the same output as a run over the meetingFile.
+ * A first row of a single ID is the verified carrier's; a file whose first row is a meeting (a later shard,
+ * or the meetings of a delta run) has no carrier. The blocks are written as they fill, and the header - once
+ * they are all written. The file is written next to tablePath and renamed over it only once complete.
+ * @param[in] meetingFile the opened meetingFile.
+ * @param[in] tablePath the path of the table.
+ * @param[out] STATUS_CODE_SUCCESS If the table was written.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode writeMeetingsTable(FILE *meetingFile, const char *tablePath)
+{
+	// ## HEADER ## - completed once the blocks are written:
+	MeetingsTableHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, MEETINGS_TABLE_MAGIC, MEETINGS_TABLE_MAGIC_LEN);
+	header.version = MEETINGS_TABLE_VERSION;
+	header.byteOrderMark = SNAPSHOT_BYTE_ORDER_MARK;
+	header.spreaderID = MEETINGS_TABLE_NO_SPREADER;
+	header.indexOffset = sizeof(MeetingsTableHeader);
+	
+	// ## OPEN OUTPUT FILE ## - a temporary one, renamed when complete:
+	LineReader lineReader = {0};
+	int *idColumns = (int *) malloc(2 * MEETINGS_TABLE_BLOCK_SIZE * sizeof(int));
+	float *valueColumns = (float *) malloc(2 * MEETINGS_TABLE_BLOCK_SIZE * sizeof(float));
+	MeetingsTableBlock *blockIndex = NULL;
+	unsigned int indexCapacity = 0, blockMeetings = 0;
+	char *temporaryPath = NULL;
+	OutputWriter outputWriter = {0};
+	StatusCode retValWrite = STATUS_CODE_FAIL;
+	if ((idColumns == NULL) || (valueColumns == NULL))
+	{
+		error(STATUS_CODE_FAIL);
+	}
+	else if (lineReaderInit(&lineReader, meetingFile) == STATUS_CODE_SUCCESS)
+	{
+		retValWrite = temporaryFileOpen(tablePath, &temporaryPath, &outputWriter);
+	}
+	if (retValWrite == STATUS_CODE_SUCCESS)
+	{
+		retValWrite = outputWriterAppendBytes(&outputWriter, &header, sizeof(header));
+	}
+	
+	// ## CONVERT ## - the verified carrier's row, and the meetings, a block at a time:
+	const char *lineStart = NULL, *lineEnd = NULL;
+	unsigned int infectorStatus = INFECTOR_OLD;
+	int curInfector = 0, isFirstLine = 1;
+	Meeting meetingReceiver = {0};
+	StatusCode retValRead = STATUS_CODE_SUCCESS;
+	while ((retValWrite == STATUS_CODE_SUCCESS) &&
+		   ((retValRead = lineReaderNextLine(&lineReader, &lineStart, &lineEnd)) == STATUS_CODE_SUCCESS))
+	{
+		if (isFirstLine)
+		{
+			const char *curChar = lineStart;
+			int spreaderID = (int) parseDecimalInteger(&curChar, lineEnd);
+			isFirstLine = 0;
+			if (parseDecimalInteger(&curChar, lineEnd) == 0)	// A single ID - not a meeting.
+			{
+				header.spreaderID = spreaderID;
+				continue;
+			}
+		}
+		if (parseMeetingLine(&meetingReceiver, lineStart, lineEnd, &infectorStatus, &curInfector) !=
+			STATUS_CODE_SUCCESS)
+		{
+			retValWrite = STATUS_CODE_FAIL;
+			break;
+		}
+		idColumns[blockMeetings] = meetingReceiver.infectorID;
+		idColumns[MEETINGS_TABLE_BLOCK_SIZE + blockMeetings] = meetingReceiver.infectedID;
+		valueColumns[blockMeetings] = meetingReceiver.distance;
+		valueColumns[MEETINGS_TABLE_BLOCK_SIZE + blockMeetings] = meetingReceiver.time;
+		blockMeetings++;
+		if (blockMeetings == MEETINGS_TABLE_BLOCK_SIZE)
+		{
+			retValWrite = meetingsTableAppendBlock(&outputWriter, &header, &blockIndex, &indexCapacity, idColumns,
+												   valueColumns, blockMeetings);
+			blockMeetings = 0;
+		}
+	}
+	if ((retValWrite == STATUS_CODE_SUCCESS) && (retValRead != STATUS_CODE_END_OF_FILE))
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		retValWrite = STATUS_CODE_INPUT_ERROR;
+	}
+	if ((retValWrite == STATUS_CODE_SUCCESS) && (blockMeetings > 0))
+	{
+		retValWrite = meetingsTableAppendBlock(&outputWriter, &header, &blockIndex, &indexCapacity, idColumns,
+											   valueColumns, blockMeetings);
+	}
+	lineReaderFree(&lineReader);
+	free(idColumns);
+	free(valueColumns);
+	
+	// ## WRITE INDEX AND HEADER ##
+	if (retValWrite == STATUS_CODE_SUCCESS)
+	{
+		retValWrite = outputWriterAppendBytes(&outputWriter, blockIndex,
+											  (size_t) header.blockCount * sizeof(MeetingsTableBlock));
+	}
+	free(blockIndex);
+	if (retValWrite == STATUS_CODE_SUCCESS)
+	{
+		retValWrite = outputWriterFlush(&outputWriter);
+	}
+	if ((retValWrite == STATUS_CODE_SUCCESS) &&
+		(pwrite(outputWriter.outputFd, &header, sizeof(header), 0) != (ssize_t) sizeof(header)))
+	{
+		retValWrite = STATUS_CODE_OUTPUT_ERROR;
+	}
+	
+	// ## CLOSE OUTPUT FILE ## - and replace the old table:
+	if (temporaryPath == NULL)
+	{
+		return retValWrite;
+	}
+	if ((retValWrite != STATUS_CODE_SUCCESS) && (retValWrite != STATUS_CODE_OUTPUT_ERROR))
+	{
+		//	The conversion failed, and was already reported - the temporary file is only removed:
+		close(outputWriter.outputFd);
+		outputWriterFree(&outputWriter);
+		unlink(temporaryPath);
+		free(temporaryPath);
+		return retValWrite;
+	}
+	return temporaryFileCommit(tablePath, temporaryPath, &outputWriter, retValWrite);
+}
+
+
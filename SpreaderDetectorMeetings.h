@@ -0,0 +1,260 @@
+/*
+ * File Name: SpreaderDetectorMeetings.h
+ * Related Files: "SpreaderDetectorMeetings.c", "SpreaderDetectorInternal.h"
+ *
+ * Purpose:
+ * 			The functions of SpreaderDetectorMeetings.c which the other modules of the SpreaderDetector library
+ * 			use. They are internal (hidden): the API of the library is SpreaderDetector.h.
+ *
+ * Author's ID: 206174120
+ * Author's Name: Oren Kovartovsky
+ * University User Name: orenkov
+ *
+ * */
+
+#ifndef SPREADERDETECTORMEETINGS_H
+#define SPREADERDETECTORMEETINGS_H
+
+#include "SpreaderDetectorInternal.h"
+
+#if defined(__GNUC__)
+#pragma GCC visibility push(hidden)
+#endif
+
+//	****** MEETINGS PARSING / CALCULATING FUNCTIONS ******
+/**
+ * @brief A function that parsing the lines from the input meetingsFile.
+ *
+ * @details The line has a fixed shape: <infector_id> <infected_id> <distance> <time>, so the fields are parsed
+ * one after the other, in place.
+ * @param[in] meetingReceiver holds all the variables that gonna be 'fed' with the data in the line.
+ * @param[in] lineStart a pointer to the beginning of the line gonna be parsed by the function.
+ * @param[in] lineEnd a pointer to the end of the line (not included).
+ * @param[in] infectorStatus a pointer to a varible that holds the status of the current infector (NEW or OLD).
+ * if it is old, it won't be searched again in the array.
+ * @param[in] curInfector the ID of the current infector examined by the program.
+ * @param[out] STATUS_CODE_SUCCESS If data was stored successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode parseMeetingLine(Meeting *meetingReceiver, const char *lineStart, const char *lineEnd,
+							unsigned int *infectorStatus, int *curInfector);
+
+/**
+ * @brief A function that calculates crna for a batch of meetings, with the best kernel of the CPU.
+ *
+ * @param[in] distances the distances of the meetings.
+ * @param[in] times the times of the meetings.
+ * @param[in] chances receives crna() of every meeting.
+ * @param[in] count number of meetings.
+ */
+void crnaBatch(const float *distances, const float *times, float *chances, unsigned int count);
+
+/**
+ * @brief A function that calculates the chances of infection for each person.
+ *
+ * @details the function uses previous data about the people, if exists - in order to make the calculations
+ * faster.
+ * @details The file is read in large blocks through a LineReader, and every line is parsed in place.
+ * @details With a tierEmitter (streaming mode), lines are handled as soon as they arrive, and every update
+ * is reported to the emitter.
+ * @param[in] meetingFile the files that contains the data about meetings, used to calculate
+ * infection chances.
+ * @param[in] peopleArray an array of all the people that were recorded.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] tierEmitter emits the urgent tiers while streaming. NULL - not streaming.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If calculation was succesfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode calculateSeverities(FILE *meetingFile, Person *peopleArray, const PeopleIndex *peopleIndex,
+							   UrgentTierEmitter *tierEmitter, RunStats *runStats);
+
+/**
+ * @brief A function that calculates the chances of infection for each person, from an array of meetings.
+ *
+ * @details The in-memory counterpart of calculateSeverities: the meetings are applied in array order, by
+ * the same rules (the infector is searched again only when it changes).
+ * @param[in] spreaderID the ID of the verified carrier. 0 - there are no meetings at all.
+ * @param[in] meetings the meetings, in BFS batch order.
+ * @param[in] meetingCount number of meetings.
+ * @param[in] peopleArray an array of all the people that were recorded.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If calculation was succesfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode calculateSeveritiesFromMeetings(int spreaderID, const SpreaderDetectorMeeting *meetings,
+										   size_t meetingCount, Person *peopleArray,
+										   const PeopleIndex *peopleIndex, RunStats *runStats);
+
+/**
+ * @brief A function that splits the meetings (the lines after the verified carrier) to chunks, and starts
+ * the threads which parse them.
+ *
+ * @details A few newline-aligned chunks per thread (for balance), but not smaller than MIN_CHUNK_SIZE. The
+ * chunks are divided between the shards by their sizes, and no chunk crosses a shard, so the chunks (in
+ * order) cover the shards in order - a meetings table's chunks are its blocks. If a thread can't be created,
+ * the other threads (and the caller, in parallelIngestWaitChunk) do its part.
+ * @note The function ALLOCATES MEMORY being stored in parallelIngest. released by parallelIngestStop.
+ * @param[in] parallelIngest the shared state to initialize.
+ * @param[in] meetingShards the shards of meeting lines.
+ * @param[in] shardCount number of shards. If all of them are empty, there is a single empty chunk.
+ * @param[in] peopleArray the array of people, sorted by ID.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] threadCount number of worker threads to parse with.
+ * @param[out] STATUS_CODE_SUCCESS If the ingest was started successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode parallelIngestStart(ParallelIngest *parallelIngest, const MeetingShard *meetingShards,
+							   unsigned int shardCount, Person *peopleArray, const PeopleIndex *peopleIndex,
+							   unsigned int threadCount);
+
+/**
+ * @brief A function that waits until a chunk is parsed, parsing unclaimed chunks in the meantime.
+ *
+ * @param[in] parallelIngest the shared state of the parallel ingest.
+ * @param[in] chunkIndex the chunk to wait for.
+ * @return a pointer to the parsed chunk.
+ */
+MeetingChunk *parallelIngestWaitChunk(ParallelIngest *parallelIngest, unsigned int chunkIndex);
+
+/**
+ * @brief A function that stops the parallel ingest, and releases its memory.
+ *
+ * @details Chunks which weren't claimed yet are not parsed. The function waits for the chunks being parsed.
+ * @param[in] parallelIngest the shared state of the parallel ingest.
+ */
+void parallelIngestStop(ParallelIngest *parallelIngest);
+
+/**
+ * @brief A function that reads the line of the verified carrier, and initializes his severity level.
+ * @details The carrier's shard is the first one which starts with a single ID (or a meetings table which holds
+ * the carrier in its header), whatever its place among the shards. The line is skipped in its shard. A carrier
+ * of a later shard is ignored.
+ *
+ * @param[in] meetingShards the shards of the meetings, in order.
+ * @param[in] shardCount number of shards.
+ * @param[in] peopleArray an array of all the people that were recorded.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] spreader set to the verified carrier. NULL if all the shards are empty.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If the carrier was found, or all the shards are empty.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode meetingShardsReadSpreader(MeetingShard *meetingShards, unsigned int shardCount, Person *peopleArray,
+									 const PeopleIndex *peopleIndex, Person **spreader, RunStats *runStats);
+
+/**
+ * @brief A function that calculates the chances of infection for each person, parsing the meetingFile on
+ * several threads.
+ *
+ * @details The meetings are parsed by parallelIngest threads into per-chunk MeetingEdge arrays. The calling
+ * thread then applies the chunks in file order, exactly as calculateSeverities applies the lines - so the
+ * results are the same. Shards are applied in order, as if they were one file.
+ * @param[in] meetingShards the shards of the meetings, in order. The verified carrier's line is skipped.
+ * @param[in] shardCount number of shards.
+ * @param[in] peopleArray an array of all the people that were recorded.
+ * @param[in] peopleIndex the ID hash index of peopleArray.
+ * @param[in] threadCount number of worker threads to parse with.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS If calculation was succesfull.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode calculateSeveritiesParallel(MeetingShard *meetingShards, unsigned int shardCount, Person *peopleArray,
+									   const PeopleIndex *peopleIndex, unsigned int threadCount,
+									   RunStats *runStats);
+
+
+//	****** MEETING SHARDS FUNCTIONS ******
+/**
+ * @brief A function that lists the shards in a meetings directory: its regular files (not the hidden ones),
+ * sorted by name - so the same directory always gives the same order.
+ *
+ * @note The function ALLOCATES MEMORY being stored in shardPaths. released by meetingShardPathsFree, even in
+ * failure.
+ * @param[in] directoryPath the path of the directory.
+ * @param[in] shardPaths set to the paths of the shards.
+ * @param[in] shardCount set to the number of shards.
+ * @param[out] STATUS_CODE_SUCCESS If the directory was listed.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode meetingShardsListDirectory(const char *directoryPath, char ***shardPaths, unsigned int *shardCount);
+
+/**
+ * @brief A function that releases the shard paths listed by meetingShardsListDirectory.
+ *
+ * @param[in] shardPaths the paths. May be NULL.
+ * @param[in] shardCount number of paths.
+ */
+void meetingShardPathsFree(char **shardPaths, unsigned int shardCount);
+
+/**
+ * @brief A function that loads the meeting shards: regular files are mapped to memory, other files (e.g.
+ * pipes, and compressed files - see inputFileOpen) are read whole. An empty file is an empty shard.
+ *
+ * @note The function ALLOCATES MEMORY being stored in meetingShards. released by meetingShardsFree, even in
+ * failure.
+ * @param[in] shardPaths the paths of the shards, in order.
+ * @param[in] shardCount number of shards.
+ * @param[in] meetingShards set to the loaded shards.
+ * @param[out] STATUS_CODE_SUCCESS If all the shards were loaded.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode meetingShardsLoad(const char *const *shardPaths, unsigned int shardCount,
+							 MeetingShard **meetingShards);
+
+/**
+ * @brief A function that releases the shards loaded by meetingShardsLoad.
+ *
+ * @param[in] meetingShards the shards. May be NULL, or partially loaded.
+ * @param[in] shardCount number of shards.
+ */
+void meetingShardsFree(MeetingShard *meetingShards, unsigned int shardCount);
+
+
+//	****** MEETINGS TABLE FUNCTIONS ******
+/**
+ * @brief A function that checks whether an opened meetingFile is a meetings table, by its magic.
+ *
+ * @param[in] meetingFd the opened meetingFile descriptor. Must be a regular file.
+ * @param[in] fileSize the size of the meetingFile.
+ * @return 1 if the file starts with MEETINGS_TABLE_MAGIC, 0 otherwise.
+ */
+int isMeetingsTable(int meetingFd, size_t fileSize);
+
+/**
+ * @brief A function that finds the shards which are meetings tables (by their magic), validates them, and
+ * points them at their blocks - which are then parsed in place, a chunk per block (see
+ * parseMeetingTableBlock). The other shards are left as lines.
+ *
+ * @details Nothing is parsed here: the header and the block index are only checked against the size of the
+ * shard.
+ * @param[in] meetingShards the shards of the meetings, not parsed yet.
+ * @param[in] shardCount number of shards.
+ * @param[out] STATUS_CODE_SUCCESS If every table is valid.
+ * @param[out] STATUS_CODE_INPUT_ERROR If a table is invalid (or isn't aligned in memory).
+ */
+StatusCode meetingShardsOpenTables(MeetingShard *meetingShards, unsigned int shardCount);
+
+/**
+ * @brief A function that converts a meetingFile to a meetings table.
+ *
+ * @details Layout: a MeetingsTableHeader, the blocks (MEETINGS_TABLE_BLOCK_SIZE meetings each, but the last)
+ * and the block index. The lines are parsed (and checked) once, as calculateSeverities parses them, and the
+ * values are stored as parsed - so a run over the table gives the same output as a run over the meetingFile.
+ * A first row of a single ID is the verified carrier's; a file whose first row is a meeting (a later shard,
+ * or the meetings of a delta run) has no carrier. The blocks are written as they fill, and the header - once
+ * they are all written. The file is written next to tablePath and renamed over it only once complete.
+ * @param[in] meetingFile the opened meetingFile.
+ * @param[in] tablePath the path of the table.
+ * @param[out] STATUS_CODE_SUCCESS If the table was written.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode writeMeetingsTable(FILE *meetingFile, const char *tablePath);
+
+
+#if defined(__GNUC__)
+#pragma GCC visibility pop
+#endif
+
+#endif //SPREADERDETECTORMEETINGS_H
@@ -0,0 +1,1456 @@
+/*
+ * File Name: SpreaderDetectorOutput.c
+ * Related Files: "SpreaderDetectorOutput.h", "SpreaderDetectorInternal.h"
+ *
+ * Purpose:
+ * 			This file is the output of the SpreaderDetector library: the output writer, the comparison and
+ * 			sorting of the people, their output order, the streaming emitter of the urgent tiers, and the output
+ * 			files.
+ *
+ * Author's ID: 206174120
+ * Author's Name: Oren Kovartovsky
+ * University User Name: orenkov
+ *
+ * */
+
+#include "SpreaderDetectorOutput.h"
+
+
+/*
+ * ***************************
+ * 	GLOBALS
+ * ***************************
+ */
+/**
+ * @brief The messages of "SpreaderDetectorParams.h", from the most severe one.
+ */
+static const char *const severityMessages[SEVERITY_MESSAGE_COUNT] = {MEDICAL_SUPERVISION_THRESHOLD_MSG,
+																	 REGULAR_QUARANTINE_MSG, CLEAN_MSG};
+
+
+/*
+ * ***********************
+ * 	DECLARATIONS
+ * ***********************
+ */
+//	****** GENERATING FILES or MESSAGES FUNCTIONS ******
+/**
+ * @brief A function that determines which message a person should get, according to the chances
+ * of him being a carrier.
+ *
+ * @note uses a #define statements from "SpreaderDetectorParams.h" file
+ * @param[in] severityLevel the severity of the person.
+ * @return The index of the relevant message in severityMessages
+ */
+static unsigned int severityToMessage(float severityLevel);
+
+/**
+ * @brief A function that splits a message of "SpreaderDetectorParams.h" around its name and its ID.
+ *
+ * @param[in] messageFormat receives the parts of the message.
+ * @param[in] message the message, which contains MESSAGE_NAME_FORMAT and then MESSAGE_ID_FORMAT.
+ */
+static void messageFormatInit(MessageFormat *messageFormat, const char *message);
+
+
+//	****** OUTPUT WRITER FUNCTIONS ******
+/**
+ * @brief A function that makes room for at least reserveSize more bytes in the buffer of an OutputWriter.
+ *
+ * @details The buffer is flushed when it is too full, and grown only for a single line longer than it.
+ * @param[in] outputWriter the writer.
+ * @param[in] reserveSize the number of bytes about to be appended.
+ * @return a pointer to the end of the buffered content, or NULL if flushing or growing failed.
+ */
+static char *outputWriterReserve(OutputWriter *outputWriter, size_t reserveSize);
+
+/**
+ * @brief A function that formats an unsigned integer in decimal.
+ *
+ * @details Two digits at a time, from a table of digit pairs, without any call to the stdio formatter.
+ * @param[in] destination where to write the digits. Must have room for MAX_DECIMAL_DIGITS characters.
+ * @param[in] value the integer to format.
+ * @return the number of characters written.
+ */
+static size_t formatUnsignedDecimal(char *destination, unsigned long value);
+
+/**
+ * @brief A function that appends the output line of a person to an OutputWriter (see outputWriterAppendLine).
+ *
+ * @param[in] outputWriter the writer.
+ * @param[in] person the person to write.
+ * @param[in] nameArena the arena which holds the person's name.
+ * @param[out] STATUS_CODE_SUCCESS If the line was appended.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If the buffer couldn't be flushed or grown.
+ */
+static StatusCode outputWriterAppendPerson(OutputWriter *outputWriter, const Person *person,
+										   const NameArena *nameArena);
+
+/**
+ * @brief A function that writes the output lines of the people to an OutputWriter, most severe first.
+ *
+ * @details Reads the People-Array backwards, as ordered by orderPeopleForOutput. Doesn't flush.
+ * @param[in] outputWriter the writer.
+ * @param[in] peopleArray the array of people.
+ * @param[in] peopleCounter the amount of people to write.
+ * @param[in] nameArena the arena which holds the names of the people.
+ * @param[out] STATUS_CODE_SUCCESS If the lines were appended.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If the buffer couldn't be flushed or grown.
+ */
+static StatusCode writeSeverityLines(OutputWriter *outputWriter, const Person *peopleArray, unsigned int peopleCounter,
+									 const NameArena *nameArena);
+
+
+//	****** COMPARISON FUNCTIONS ******
+/**
+ * @brief compares between 2 Person objects, according to their ID.
+ *
+ * @details ID is 9 digits unsigned int, and the comparision uses the order theory '<'.
+ * @param[in] personA a void pointer, represents pointer to 1st person to compare.
+ * @param[in] personB personA a void pointer, represents pointer to 2nd person to compare.
+ * @return integer: 0 if equal, negative integer if personA has bigger ID than personB,
+ * and positive integer if personA has smaller ID than personB.
+ */
+static int personCompareByID(const void* personA, const void* personB);
+
+/**
+ * @brief compares between 2 Person objects, according to their severity field.
+ *
+ * @details the severity field is a **float** one.
+ * @param[in] personA a void pointer, represents pointer to 1st person to compare.
+ * @param[in] personB personA a void pointer, represents pointer to 2nd person to compare.
+ * @return integer: 0 if equal, negative integer if personA has bigger ID than personB,
+ * and positive integer if personA has smaller ID than personB.
+ */
+static int personCompareBySeverity(const void* personA, const void* personB);
+
+/**
+ * @brief compares between 2 Person objects, according to their severity, and then their ID.
+ *
+ * @details The same order the full output has (read backwards): severity, with ties broken by ID.
+ * @param[in] personA a void pointer, represents pointer to 1st person to compare.
+ * @param[in] personB personA a void pointer, represents pointer to 2nd person to compare.
+ * @return integer: 0 if equal, negative integer if personA comes before personB,
+ * and positive integer if personA comes after personB.
+ */
+static int personCompareBySeverityThenID(const void* personA, const void* personB);
+
+
+//	****** SORTING FUNCTIONS ******
+/**
+ * @brief A function that counts the digits of one RadixSortSlice (the first phase of a parallel pass).
+ *
+ * @param[in] radixSlice the slice to count. Its counts are overwritten.
+ */
+static void radixSliceCount(RadixSortSlice *radixSlice);
+
+/**
+ * @brief A function that scatters one RadixSortSlice (the second phase of a parallel pass).
+ *
+ * @details counts must hold, for every digit, the position of the slice's first person with that digit.
+ * @param[in] radixSlice the slice to scatter. Its counts are used as cursors.
+ */
+static void radixSliceScatter(RadixSortSlice *radixSlice);
+
+/**
+ * @brief The thread routine of a parallel radix pass.
+ *
+ * @param[in] radixSliceArg a RadixSortSlice, whose isScatterPhase selects the phase to run.
+ * @return NULL.
+ */
+static void *radixSortWorker(void *radixSliceArg);
+
+/**
+ * @brief A function that runs one phase of a parallel radix pass over all the slices.
+ *
+ * @details Slices 1.. run on their own threads (or on this one, if a thread can't be created), slice 0 on
+ * this one.
+ * @param[in] radixSlices the slices.
+ * @param[in] sliceCount number of slices.
+ * @param[in] workers room for sliceCount - 1 thread handles.
+ */
+static void radixSortRunPhase(RadixSortSlice *radixSlices, unsigned int sliceCount, pthread_t *workers);
+
+/**
+ * @brief A function that sorts the People-Array by an LSD radix sort, on a single thread.
+ *
+ * @details The histograms of all the digits are counted in one read, and passes whose digit is the same for
+ * every person (e.g. the high bytes of IDs) are skipped.
+ * @param[in] peopleArray the array of people to sort.
+ * @param[in] sortBuffer room for peopleCounter people.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] sortKey the field to sort by.
+ */
+static void radixSortPeopleSerial(Person *peopleArray, Person *sortBuffer, unsigned int peopleCounter,
+								  PersonSortKey sortKey);
+
+/**
+ * @brief A function that sorts the People-Array by an LSD radix sort, on several threads.
+ *
+ * @details The array is split into sliceCount contiguous slices. In every pass each slice counts its digits,
+ * the counts are turned into per-slice cursors (digit-major, slice-minor - which keeps the sort stable), and
+ * each slice scatters its own people.
+ * @param[in] peopleArray the array of people to sort.
+ * @param[in] sortBuffer room for peopleCounter people.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] sortKey the field to sort by.
+ * @param[in] sliceCount number of slices (and threads). Must be at least 2.
+ * @param[out] STATUS_CODE_SUCCESS If the array was sorted.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed. The array is left unchanged.
+ */
+static StatusCode radixSortPeopleParallel(Person *peopleArray, Person *sortBuffer, unsigned int peopleCounter,
+										  PersonSortKey sortKey, unsigned int sliceCount);
+
+/**
+ * @brief A function that sorts the People-Array in ascending order of ID or severity.
+ *
+ * @details An LSD radix sort over an order-preserving unsigned key (personRadixKey). It is stable, so equal
+ * keys keep their relative order on any libc (as glibc's merge sort based qsort did). Large arrays are
+ * sorted on up to threadCount threads. If the sort buffer can't be allocated, qsort is used instead.
+ * @param[in] peopleArray the array of people to sort.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] sortKey the field to sort by.
+ * @param[in] threadCount the maximal number of threads to sort with.
+ */
+static void sortPeople(Person *peopleArray, unsigned int peopleCounter, PersonSortKey sortKey,
+					   unsigned int threadCount);
+
+/**
+ * @brief A function that sorts a People-Array of a few ID-ordered runs by ID, merging adjacent runs in pairs.
+ *
+ * @details Each pass halves the number of runs, so runCount runs take log2(runCount) sequential passes. Ties
+ * are taken from the left run, so - as the radix sort - the merge is stable.
+ * @param[in] peopleArray the array of people to sort.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] peopleRuns the runs of the array. At most PEOPLE_MAX_MERGED_RUNS.
+ * @param[out] STATUS_CODE_SUCCESS If the array was sorted.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed. The array is left unchanged.
+ */
+static StatusCode mergePeopleRuns(Person *peopleArray, unsigned int peopleCounter, const PeopleRuns *peopleRuns);
+
+
+//	****** OUTPUT ORDER FUNCTIONS ******
+/**
+ * @brief A function that moves the people who need treatment to the end of the People-Array, and sorts them.
+ *
+ * @details A stable partition: the "No serious chance" people stay in ascending ID order at the beginning,
+ * and only the people above REGULAR_QUARANTINE_THRESHOLD are sorted by severity. Read backwards (as
+ * generateSeverityFile does), the urgent tiers come out exactly as in the full sort, followed by the clean
+ * tier in descending ID order.
+ * @param[in] peopleArray the array of people, sorted by ID.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] threadCount the maximal number of threads to sort with.
+ * @param[out] STATUS_CODE_SUCCESS If the array was ordered.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed. The array is left unchanged.
+ */
+static StatusCode partitionSeverityTiers(Person *peopleArray, unsigned int peopleCounter, unsigned int threadCount);
+
+/**
+ * @brief A function that restores the min-heap order below one node of a heap of people.
+ *
+ * @details The heap is ordered by personCompareBySeverityThenID, so its root is the least severe person.
+ * @param[in] heap the heap.
+ * @param[in] heapSize number of people in the heap.
+ * @param[in] nodeIndex the node to sift down.
+ */
+static void severityHeapSiftDown(Person *heap, unsigned int heapSize, unsigned int nodeIndex);
+
+/**
+ * @brief A function that moves the topCount most severe people to the beginning of the People-Array.
+ *
+ * @details The first topCount people are made a min-heap, and every other person who is more severe than
+ * the heap's root replaces it - O(n log K), in place. The selected people are then sorted, so reading
+ * them backwards gives the same order as the full output.
+ * @param[in] peopleArray the array of people.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] topCount the number of people to select.
+ * @return the number of people selected: the smaller of topCount and peopleCounter.
+ */
+static unsigned int selectTopSeverities(Person *peopleArray, unsigned int peopleCounter, unsigned long topCount);
+
+
+/*
+ * ***********************
+ * 	DEFINITIONS
+ * ***********************
+ */
+/**
+ * @brief A function that generates an empty output file.
+ *
+ * @details used whenever input is valid - but people's input file is empty.
+ * @param[in] outputFilePath the path of the output file.
+ * @param[out] STATUS_CODE_SUCCESS if file was generated successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode generateEmptyOutputFile(const char *outputFilePath)
+{
+	FILE* outputFile = fopen(outputFilePath, "w");
+	if (outputFile == NULL)
+	{
+		error(STATUS_CODE_OUTPUT_ERROR);
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	
+	if (EOF == fclose(outputFile))
+	{
+		error(STATUS_CODE_OUTPUT_ERROR);
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that determines which message a person should get, according to the chances
+ * of him being a carrier.
+ * @note uses a #define statements from "SpreaderDetectorParams.h" file
+ * @param[in] severityLevel the severity of the person.
+ * @return The index of the relevant message in severityMessages
+ */
+static unsigned int severityToMessage(float severityLevel)
+{
+	// Higest Risk:
+	if (severityLevel >= MEDICAL_SUPERVISION_THRESHOLD)
+	{
+		return 0;
+	}
+	
+	// Med-Level Risk:
+	else if ((severityLevel < MEDICAL_SUPERVISION_THRESHOLD) &&
+			 (severityLevel) >= REGULAR_QUARANTINE_THRESHOLD)
+	{
+		return 1;
+	}
+	
+	// Low-Level Risk:
+	else
+	{
+		return 2;
+	}
+}
+
+
+/**
+ * @brief A function that splits a message of "SpreaderDetectorParams.h" around its name and its ID.
+ * @param[in] messageFormat receives the parts of the message.
+ * @param[in] message the message, which contains MESSAGE_NAME_FORMAT and then MESSAGE_ID_FORMAT.
+ */
+static void messageFormatInit(MessageFormat *messageFormat, const char *message)
+{
+	const char *nameFormat = strstr(message, MESSAGE_NAME_FORMAT);
+	const char *idFormat = strstr(nameFormat, MESSAGE_ID_FORMAT);
+	messageFormat->prefix = message;
+	messageFormat->prefixLength = (size_t) (nameFormat - message);
+	messageFormat->separator = nameFormat + strlen(MESSAGE_NAME_FORMAT);
+	messageFormat->separatorLength = (size_t) (idFormat - messageFormat->separator);
+	messageFormat->suffix = idFormat + strlen(MESSAGE_ID_FORMAT);
+	messageFormat->suffixLength = strlen(messageFormat->suffix);
+}
+
+
+/**
+ * @brief A function that generates an output file of the potential carriers, sorted by urgency of treatment.
+ * @details output file is divided to 3 sections: Hospitalization needed, Quarantine needed, No serious.
+ * @details each of the section is sorted by severity level.
+ * @details The lines are formatted by an OutputWriter straight into its buffer, and written in large blocks.
+ * @param[in] peopleArray a pointer to the peopleArray, which contains the relevant data about them.
+ * @param[in] peopleCounter number of different people which were recorded, and appears in the array.
+ * @param[in] nameArena the arena which holds the names of the people in peopleArray.
+ * @param[in] outputFilePath the path of the output file.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS if file was generated successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode generateSeverityFile(Person *peopleArray, const unsigned int peopleCounter,
+								const NameArena *nameArena, const char *outputFilePath, RunStats *runStats)
+{
+	//	Create an empty file:
+	int outputFd = open(outputFilePath, O_WRONLY | O_CREAT | O_TRUNC, OUTPUT_FILE_MODE);
+	if (outputFd < 0)
+	{
+		error(STATUS_CODE_OUTPUT_ERROR);
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	OutputWriter outputWriter = {0};
+	if (outputWriterInit(&outputWriter, outputFd) != STATUS_CODE_SUCCESS)
+	{
+		close(outputFd);
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	
+	// Write the People-Array, from the most severe person:
+	StatusCode retValWrite = writeSeverityLines(&outputWriter, peopleArray, peopleCounter, nameArena);
+	if (retValWrite == STATUS_CODE_SUCCESS)
+	{
+		retValWrite = outputWriterFlush(&outputWriter);
+	}
+	runStatsCount(runStats, STATS_PHASE_OUTPUT, outputWriter.bytesWritten, peopleCounter, 0);
+	outputWriterFree(&outputWriter);
+	
+	if ((close(outputFd) != 0) || (retValWrite != STATUS_CODE_SUCCESS))
+	{
+		error(STATUS_CODE_OUTPUT_ERROR);
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that opens a temporary file next to path, which is renamed over it once it is complete
+ * (see temporaryFileCommit). So a reader of path never sees a half-written file.
+ * @note The function ALLOCATES MEMORY being stored in temporaryPath and outputWriter. released by
+ * temporaryFileCommit (or here, in failure).
+ * @param[in] path the path the file is written for.
+ * @param[in] temporaryPath set to the path of the temporary file.
+ * @param[in] outputWriter initialized over the temporary file.
+ * @param[out] STATUS_CODE_SUCCESS If the file was opened.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode temporaryFileOpen(const char *path, char **temporaryPath, OutputWriter *outputWriter)
+{
+	size_t pathLength = strlen(path);
+	*temporaryPath = (char *) malloc(pathLength + sizeof(SNAPSHOT_TEMPORARY_SUFFIX));
+	if (*temporaryPath == NULL)
+	{
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	memcpy(*temporaryPath, path, pathLength);
+	memcpy(*temporaryPath + pathLength, SNAPSHOT_TEMPORARY_SUFFIX, sizeof(SNAPSHOT_TEMPORARY_SUFFIX));
+	int temporaryFd = open(*temporaryPath, O_WRONLY | O_CREAT | O_TRUNC, OUTPUT_FILE_MODE);
+	if ((temporaryFd < 0) || (outputWriterInit(outputWriter, temporaryFd) != STATUS_CODE_SUCCESS))
+	{
+		if (temporaryFd >= 0)
+		{
+			close(temporaryFd);
+			unlink(*temporaryPath);
+		}
+		free(*temporaryPath);
+		*temporaryPath = NULL;
+		error(STATUS_CODE_OUTPUT_ERROR);
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that finishes a file opened by temporaryFileOpen: flushes and closes it, and renames it
+ * over path - or removes it, if writing it failed.
+ * @param[in] path the path the file is written for.
+ * @param[in] temporaryPath the path of the temporary file. Released.
+ * @param[in] outputWriter the writer of the temporary file. Released, and its descriptor closed.
+ * @param[in] retValWrite STATUS_CODE_SUCCESS if everything was appended to the writer.
+ * @param[out] STATUS_CODE_SUCCESS If the file replaced path.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If writing failed. path is left as it was.
+ */
+StatusCode temporaryFileCommit(const char *path, char *temporaryPath, OutputWriter *outputWriter,
+							   StatusCode retValWrite)
+{
+	int temporaryFd = outputWriter->outputFd;
+	if (retValWrite == STATUS_CODE_SUCCESS)
+	{
+		retValWrite = outputWriterFlush(outputWriter);
+	}
+	outputWriterFree(outputWriter);
+	if ((close(temporaryFd) != 0) || (retValWrite != STATUS_CODE_SUCCESS) || (rename(temporaryPath, path) != 0))
+	{
+		unlink(temporaryPath);
+		free(temporaryPath);
+		error(STATUS_CODE_OUTPUT_ERROR);
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	free(temporaryPath);
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that initiates an OutputWriter, and allocates its buffer.
+ * @param[in] outputWriter the writer to initiate.
+ * @param[in] outputFd the descriptor to write to. The writer doesn't close it.
+ * @param[out] STATUS_CODE_SUCCESS If the writer was initiated.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+StatusCode outputWriterInit(OutputWriter *outputWriter, int outputFd)
+{
+	outputWriter->outputFd = outputFd;
+	outputWriter->length = 0;
+	outputWriter->bytesWritten = 0;
+	outputWriter->capacity = WRITER_BUFFER_SIZE;
+	for (unsigned int messageIndex = 0; messageIndex < SEVERITY_MESSAGE_COUNT; messageIndex++)
+	{
+		messageFormatInit(outputWriter->messageFormats + messageIndex, severityMessages[messageIndex]);
+	}
+	outputWriter->buffer = (char *) malloc(WRITER_BUFFER_SIZE);
+	if (outputWriter->buffer == NULL)
+	{
+		outputWriter->capacity = 0;
+		return STATUS_CODE_FAIL;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that writes the buffered content of an OutputWriter to its descriptor.
+ * @details Partial writes and interrupted writes are retried until everything is written.
+ * @param[in] outputWriter the writer.
+ * @param[out] STATUS_CODE_SUCCESS If the content was written.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If write failed.
+ */
+StatusCode outputWriterFlush(OutputWriter *outputWriter)
+{
+	size_t written = 0;
+	while (written < outputWriter->length)
+	{
+		ssize_t writeSize = write(outputWriter->outputFd, outputWriter->buffer + written,
+								  outputWriter->length - written);
+		if (writeSize < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			return STATUS_CODE_OUTPUT_ERROR;
+		}
+		written += (size_t) writeSize;
+	}
+	outputWriter->bytesWritten += written;
+	outputWriter->length = 0;
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that makes room for at least reserveSize more bytes in the buffer of an OutputWriter.
+ * @details The buffer is flushed when it is too full, and grown only for a single line longer than it.
+ * @param[in] outputWriter the writer.
+ * @param[in] reserveSize the number of bytes about to be appended.
+ * @return a pointer to the end of the buffered content, or NULL if flushing or growing failed.
+ */
+static char *outputWriterReserve(OutputWriter *outputWriter, size_t reserveSize)
+{
+	if ((outputWriter->capacity - outputWriter->length) >= reserveSize)
+	{
+		return outputWriter->buffer + outputWriter->length;
+	}
+	if (outputWriterFlush(outputWriter) != STATUS_CODE_SUCCESS)
+	{
+		return NULL;
+	}
+	if (reserveSize > outputWriter->capacity)
+	{
+		char *temporaryBufferPointer = (char *) realloc(outputWriter->buffer, reserveSize);
+		if (temporaryBufferPointer == NULL)
+		{
+			return NULL;
+		}
+		outputWriter->buffer = temporaryBufferPointer;
+		outputWriter->capacity = reserveSize;
+	}
+	return outputWriter->buffer;
+}
+
+
+/**
+ * @brief A function that formats an unsigned integer in decimal.
+ * @details Two digits at a time, from a table of digit pairs, without any call to the stdio formatter.
+ * @param[in] destination where to write the digits. Must have room for MAX_DECIMAL_DIGITS characters.
+ * @param[in] value the integer to format.
+ * @return the number of characters written.
+ */
+static size_t formatUnsignedDecimal(char *destination, unsigned long value)
+{
+	static const char digitPairs[] =
+		"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+		"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+		"8081828384858687888990919293949596979899";
+	char digits[MAX_DECIMAL_DIGITS];
+	char *digitStart = digits + MAX_DECIMAL_DIGITS;
+	while (value >= 100)
+	{
+		unsigned long pairIndex = (value % 100) * 2;
+		value /= 100;
+		digitStart -= 2;
+		digitStart[0] = digitPairs[pairIndex];
+		digitStart[1] = digitPairs[pairIndex + 1];
+	}
+	if (value >= 10)
+	{
+		digitStart -= 2;
+		digitStart[0] = digitPairs[value * 2];
+		digitStart[1] = digitPairs[(value * 2) + 1];
+	}
+	else
+	{
+		digitStart--;
+		digitStart[0] = (char) ('0' + value);
+	}
+	
+	size_t digitCount = (size_t) ((digits + MAX_DECIMAL_DIGITS) - digitStart);
+	memcpy(destination, digitStart, digitCount);
+	return digitCount;
+}
+
+
+/**
+ * @brief A function that appends text to an OutputWriter.
+ * @param[in] outputWriter the writer.
+ * @param[in] text the text (doesn't have to be '\0' terminated).
+ * @param[in] textLength the length of the text.
+ * @param[out] STATUS_CODE_SUCCESS If the text was appended.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If the buffer couldn't be flushed or grown.
+ */
+StatusCode outputWriterAppend(OutputWriter *outputWriter, const char *text, size_t textLength)
+{
+	char *textCursor = outputWriterReserve(outputWriter, textLength);
+	if (textCursor == NULL)
+	{
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	memcpy(textCursor, text, textLength);
+	outputWriter->length += textLength;
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that appends binary data of any size to the buffer, a buffer-size part at a time.
+ * @details Unlike outputWriterAppend, the buffer isn't grown to fit the whole data.
+ * @param[in] outputWriter the writer.
+ * @param[in] bytes the data to append.
+ * @param[in] size the size of the data.
+ * @param[out] STATUS_CODE_SUCCESS If the data was appended.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If a flush failed.
+ */
+StatusCode outputWriterAppendBytes(OutputWriter *outputWriter, const void *bytes, size_t size)
+{
+	const char *bytesCursor = (const char *) bytes;
+	while (size > 0)
+	{
+		size_t partSize = (size < WRITER_BUFFER_SIZE) ? size : WRITER_BUFFER_SIZE;
+		if (outputWriterAppend(outputWriter, bytesCursor, partSize) != STATUS_CODE_SUCCESS)
+		{
+			return STATUS_CODE_OUTPUT_ERROR;
+		}
+		bytesCursor += partSize;
+		size -= partSize;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that appends an output line to an OutputWriter.
+ * @details Formats exactly what the severity's message in "SpreaderDetectorParams.h" does, from the parts
+ * messageFormatInit split it to: the prefix, the name, the separator, the ID (as %lu of the ID) and the suffix.
+ * @param[in] outputWriter the writer.
+ * @param[in] severity the severity of the person, which determines the message.
+ * @param[in] name the name of the person (doesn't have to be '\0' terminated).
+ * @param[in] nameLength the length of the name.
+ * @param[in] id the ID of the person.
+ * @param[out] STATUS_CODE_SUCCESS If the line was appended.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If the buffer couldn't be flushed or grown.
+ */
+StatusCode outputWriterAppendLine(OutputWriter *outputWriter, float severity, const char *name,
+								  size_t nameLength, int id)
+{
+	const MessageFormat *messageFormat = outputWriter->messageFormats + severityToMessage(severity);
+	char *lineCursor = outputWriterReserve(outputWriter, messageFormat->prefixLength + nameLength +
+													   messageFormat->separatorLength + MAX_DECIMAL_DIGITS +
+													   messageFormat->suffixLength);
+	if (lineCursor == NULL)
+	{
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	char *lineStart = lineCursor;
+	memcpy(lineCursor, messageFormat->prefix, messageFormat->prefixLength);
+	lineCursor += messageFormat->prefixLength;
+	memcpy(lineCursor, name, nameLength);
+	lineCursor += nameLength;
+	memcpy(lineCursor, messageFormat->separator, messageFormat->separatorLength);
+	lineCursor += messageFormat->separatorLength;
+	lineCursor += formatUnsignedDecimal(lineCursor, (unsigned long) id);
+	memcpy(lineCursor, messageFormat->suffix, messageFormat->suffixLength);
+	lineCursor += messageFormat->suffixLength;
+	outputWriter->length += (size_t) (lineCursor - lineStart);
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that appends the output line of a person to an OutputWriter (see outputWriterAppendLine).
+ * @param[in] outputWriter the writer.
+ * @param[in] person the person to write.
+ * @param[in] nameArena the arena which holds the person's name.
+ * @param[out] STATUS_CODE_SUCCESS If the line was appended.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If the buffer couldn't be flushed or grown.
+ */
+static StatusCode outputWriterAppendPerson(OutputWriter *outputWriter, const Person *person, const NameArena *nameArena)
+{
+	return outputWriterAppendLine(outputWriter, person->severity, nameArena->names + person->nameOffset,
+								  person->nameLength, person->id);
+}
+
+
+/**
+ * @brief A function that writes the output lines of the people to an OutputWriter, most severe first.
+ * @details Reads the People-Array backwards, as ordered by orderPeopleForOutput. Doesn't flush.
+ * @param[in] outputWriter the writer.
+ * @param[in] peopleArray the array of people.
+ * @param[in] peopleCounter the amount of people to write.
+ * @param[in] nameArena the arena which holds the names of the people.
+ * @param[out] STATUS_CODE_SUCCESS If the lines were appended.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If the buffer couldn't be flushed or grown.
+ */
+static StatusCode writeSeverityLines(OutputWriter *outputWriter, const Person *peopleArray, unsigned int peopleCounter,
+									 const NameArena *nameArena)
+{
+	StatusCode retValWrite = STATUS_CODE_SUCCESS;
+	while ((peopleCounter > 0) && (retValWrite == STATUS_CODE_SUCCESS))
+	{
+		peopleCounter--;
+		retValWrite = outputWriterAppendPerson(outputWriter, peopleArray + peopleCounter, nameArena);
+	}
+	return retValWrite;
+}
+
+
+/**
+ * @brief A function that releases the buffer of an OutputWriter, without flushing it.
+ * @param[in] outputWriter the writer to free.
+ */
+void outputWriterFree(OutputWriter *outputWriter)
+{
+	free(outputWriter->buffer);
+	outputWriter->buffer = NULL;
+	outputWriter->length = 0;
+	outputWriter->capacity = 0;
+}
+
+
+/**
+ * @brief compares between 2 Person objects, according to their ID.
+ * @details ID is 9 digits unsigned int, and the comparision uses the order theory '<'.
+ * @param[in] personA a void pointer, represents pointer to 1st person to compare.
+ * @param[in] personB personA a void pointer, represents pointer to 2nd person to compare.
+ * @return integer: 0 if equal, negative integer if personA has bigger ID than personB,
+ * and positive integer if personA has smaller ID than personB.
+ */
+static int personCompareByID(const void* personA, const void* personB)
+{
+	const Person *pA = (Person*) personA;
+	const Person *pB = (Person*) personB;
+	return ((pA->id) - (pB->id));
+}
+
+
+/**
+ * @brief compares between 2 Person objects, according to their severity field.
+ * @details the severity field is a **float** one.
+ * @param[in] personA a void pointer, represents pointer to 1st person to compare.
+ * @param[in] personB personA a void pointer, represents pointer to 2nd person to compare.
+ * @return integer: 0 if equal, negative integer if personA has bigger ID than personB,
+ * and positive integer if personA has smaller ID than personB.
+ */
+static int personCompareBySeverity(const void* personA, const void* personB)
+{
+	const Person *pA = (Person*) personA;
+	const Person *pB = (Person*) personB;
+	float severityA = pA->severity;
+	float severityB = pB->severity;
+	if (severityA < severityB)
+	{
+		return -1;
+	}
+	else if (severityA > severityB)
+	{
+		return 1;
+	}
+	return 0;
+}
+
+
+/**
+ * @brief compares between 2 Person objects, according to their severity, and then their ID.
+ * @details The same order the full output has (read backwards): severity, with ties broken by ID.
+ * @param[in] personA a void pointer, represents pointer to 1st person to compare.
+ * @param[in] personB personA a void pointer, represents pointer to 2nd person to compare.
+ * @return integer: 0 if equal, negative integer if personA comes before personB,
+ * and positive integer if personA comes after personB.
+ */
+static int personCompareBySeverityThenID(const void* personA, const void* personB)
+{
+	int severityOrder = personCompareBySeverity(personA, personB);
+	if (severityOrder != 0)
+	{
+		return severityOrder;
+	}
+	return personCompareByID(personA, personB);
+}
+
+
+/**
+ * @brief A function that maps a person's sort key to an unsigned integer with the same order.
+ * @details IDs get their sign bit flipped. Severities are taken as IEEE-754 bits: non-negative floats get
+ * their sign bit set, negative ones are inverted, and -0 is folded into +0 (personCompareBySeverity treats
+ * them as equal).
+ * @param[in] person the person.
+ * @param[in] sortKey the field to sort by.
+ * @return the radix key of the person.
+ */
+unsigned int personRadixKey(const Person *person, PersonSortKey sortKey)
+{
+	unsigned int bits = 0;
+	if (sortKey == PERSON_SORT_BY_ID)
+	{
+		return ((unsigned int) person->id) ^ RADIX_SIGN_BIT;
+	}
+	memcpy(&bits, &person->severity, sizeof(bits));
+	if (bits == RADIX_SIGN_BIT)
+	{
+		bits = 0;
+	}
+	return (bits & RADIX_SIGN_BIT) ? ~bits : (bits | RADIX_SIGN_BIT);
+}
+
+
+/**
+ * @brief A function that counts the digits of one RadixSortSlice (the first phase of a parallel pass).
+ * @param[in] radixSlice the slice to count. Its counts are overwritten.
+ */
+static void radixSliceCount(RadixSortSlice *radixSlice)
+{
+	unsigned int personIndex = 0;
+	memset(radixSlice->counts, 0, sizeof(radixSlice->counts));
+	for (personIndex = radixSlice->sliceStart; personIndex < radixSlice->sliceEnd; personIndex++)
+	{
+		unsigned int key = personRadixKey(radixSlice->source + personIndex, radixSlice->sortKey);
+		radixSlice->counts[(key >> radixSlice->shift) & RADIX_DIGIT_MASK]++;
+	}
+}
+
+
+/**
+ * @brief A function that scatters one RadixSortSlice (the second phase of a parallel pass).
+ * @details counts must hold, for every digit, the position of the slice's first person with that digit.
+ * @param[in] radixSlice the slice to scatter. Its counts are used as cursors.
+ */
+static void radixSliceScatter(RadixSortSlice *radixSlice)
+{
+	unsigned int personIndex = 0;
+	for (personIndex = radixSlice->sliceStart; personIndex < radixSlice->sliceEnd; personIndex++)
+	{
+		const Person *curPerson = radixSlice->source + personIndex;
+		unsigned int digit = (personRadixKey(curPerson, radixSlice->sortKey) >> radixSlice->shift) & RADIX_DIGIT_MASK;
+		radixSlice->destination[radixSlice->counts[digit]++] = *curPerson;
+	}
+}
+
+
+/**
+ * @brief The thread routine of a parallel radix pass.
+ * @param[in] radixSliceArg a RadixSortSlice, whose isScatterPhase selects the phase to run.
+ * @return NULL.
+ */
+static void *radixSortWorker(void *radixSliceArg)
+{
+	RadixSortSlice *radixSlice = (RadixSortSlice *) radixSliceArg;
+	if (radixSlice->isScatterPhase)
+	{
+		radixSliceScatter(radixSlice);
+	}
+	else
+	{
+		radixSliceCount(radixSlice);
+	}
+	return NULL;
+}
+
+
+/**
+ * @brief A function that runs one phase of a parallel radix pass over all the slices.
+ * @details Slices 1.. run on their own threads (or on this one, if a thread can't be created), slice 0 on
+ * this one.
+ * @param[in] radixSlices the slices.
+ * @param[in] sliceCount number of slices.
+ * @param[in] workers room for sliceCount - 1 thread handles.
+ */
+static void radixSortRunPhase(RadixSortSlice *radixSlices, unsigned int sliceCount, pthread_t *workers)
+{
+	unsigned int sliceIndex = 0, workerCount = 0;
+	for (sliceIndex = 1; sliceIndex < sliceCount; sliceIndex++)
+	{
+		if (pthread_create(workers + workerCount, NULL, radixSortWorker, radixSlices + sliceIndex) == 0)
+		{
+			workerCount++;
+		}
+		else
+		{
+			radixSortWorker(radixSlices + sliceIndex);
+		}
+	}
+	radixSortWorker(radixSlices);
+	while (workerCount > 0)
+	{
+		workerCount--;
+		pthread_join(workers[workerCount], NULL);
+	}
+}
+
+
+/**
+ * @brief A function that sorts the People-Array by an LSD radix sort, on a single thread.
+ * @details The histograms of all the digits are counted in one read, and passes whose digit is the same for
+ * every person (e.g. the high bytes of IDs) are skipped.
+ * @param[in] peopleArray the array of people to sort.
+ * @param[in] sortBuffer room for peopleCounter people.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] sortKey the field to sort by.
+ */
+static void radixSortPeopleSerial(Person *peopleArray, Person *sortBuffer, unsigned int peopleCounter,
+								  PersonSortKey sortKey)
+{
+	unsigned int counts[RADIX_PASS_COUNT][RADIX_BUCKET_COUNT];
+	unsigned int personIndex = 0, passIndex = 0, digit = 0;
+	Person *source = peopleArray, *destination = sortBuffer;
+	memset(counts, 0, sizeof(counts));
+	for (personIndex = 0; personIndex < peopleCounter; personIndex++)
+	{
+		unsigned int key = personRadixKey(peopleArray + personIndex, sortKey);
+		for (passIndex = 0; passIndex < RADIX_PASS_COUNT; passIndex++)
+		{
+			counts[passIndex][(key >> (passIndex * RADIX_DIGIT_BITS)) & RADIX_DIGIT_MASK]++;
+		}
+	}
+	
+	for (passIndex = 0; passIndex < RADIX_PASS_COUNT; passIndex++)
+	{
+		unsigned int shift = passIndex * RADIX_DIGIT_BITS;
+		unsigned int position = 0;
+		if (counts[passIndex][(personRadixKey(source, sortKey) >> shift) & RADIX_DIGIT_MASK] == peopleCounter)
+		{
+			continue;
+		}
+		for (digit = 0; digit < RADIX_BUCKET_COUNT; digit++)
+		{
+			unsigned int digitCount = counts[passIndex][digit];
+			counts[passIndex][digit] = position;
+			position += digitCount;
+		}
+		for (personIndex = 0; personIndex < peopleCounter; personIndex++)
+		{
+			digit = (personRadixKey(source + personIndex, sortKey) >> shift) & RADIX_DIGIT_MASK;
+			destination[counts[passIndex][digit]++] = source[personIndex];
+		}
+		Person *swapPointer = source;
+		source = destination;
+		destination = swapPointer;
+	}
+	
+	if (source != peopleArray)
+	{
+		memcpy(peopleArray, source, (size_t) peopleCounter * sizeof(Person));
+	}
+}
+
+
+/**
+ * @brief A function that sorts the People-Array by an LSD radix sort, on several threads.
+ * @details The array is split into sliceCount contiguous slices. In every pass each slice counts its digits,
+ * the counts are turned into per-slice cursors (digit-major, slice-minor - which keeps the sort stable), and
+ * each slice scatters its own people.
+ * @param[in] peopleArray the array of people to sort.
+ * @param[in] sortBuffer room for peopleCounter people.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] sortKey the field to sort by.
+ * @param[in] sliceCount number of slices (and threads). Must be at least 2.
+ * @param[out] STATUS_CODE_SUCCESS If the array was sorted.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed. The array is left unchanged.
+ */
+static StatusCode radixSortPeopleParallel(Person *peopleArray, Person *sortBuffer, unsigned int peopleCounter,
+										  PersonSortKey sortKey, unsigned int sliceCount)
+{
+	RadixSortSlice *radixSlices = (RadixSortSlice *) malloc(sliceCount * sizeof(RadixSortSlice));
+	pthread_t *workers = (pthread_t *) malloc(sliceCount * sizeof(pthread_t));
+	unsigned int passIndex = 0, sliceIndex = 0, digit = 0;
+	Person *source = peopleArray, *destination = sortBuffer;
+	if ((radixSlices == NULL) || (workers == NULL))
+	{
+		free(radixSlices);
+		free(workers);
+		return STATUS_CODE_FAIL;
+	}
+	for (sliceIndex = 0; sliceIndex < sliceCount; sliceIndex++)
+	{
+		radixSlices[sliceIndex].sliceStart = (unsigned int) (((unsigned long) peopleCounter * sliceIndex) / sliceCount);
+		radixSlices[sliceIndex].sliceEnd = (unsigned int) (((unsigned long) peopleCounter * (sliceIndex + 1)) /
+														   sliceCount);
+		radixSlices[sliceIndex].sortKey = sortKey;
+	}
+	
+	for (passIndex = 0; passIndex < RADIX_PASS_COUNT; passIndex++)
+	{
+		//	## COUNT ##
+		for (sliceIndex = 0; sliceIndex < sliceCount; sliceIndex++)
+		{
+			radixSlices[sliceIndex].source = source;
+			radixSlices[sliceIndex].destination = destination;
+			radixSlices[sliceIndex].shift = passIndex * RADIX_DIGIT_BITS;
+			radixSlices[sliceIndex].isScatterPhase = 0;
+		}
+		radixSortRunPhase(radixSlices, sliceCount, workers);
+		
+		//	## PREFIX ## - skip the pass if every person has the same digit:
+		unsigned int position = 0;
+		int isTrivialPass = 0;
+		for (digit = 0; (digit < RADIX_BUCKET_COUNT) && (!isTrivialPass); digit++)
+		{
+			unsigned int digitStart = position;
+			for (sliceIndex = 0; sliceIndex < sliceCount; sliceIndex++)
+			{
+				unsigned int digitCount = radixSlices[sliceIndex].counts[digit];
+				radixSlices[sliceIndex].counts[digit] = position;
+				position += digitCount;
+			}
+			isTrivialPass = ((position - digitStart) == peopleCounter);
+		}
+		if (isTrivialPass)
+		{
+			continue;
+		}
+		
+		//	## SCATTER ##
+		for (sliceIndex = 0; sliceIndex < sliceCount; sliceIndex++)
+		{
+			radixSlices[sliceIndex].isScatterPhase = 1;
+		}
+		radixSortRunPhase(radixSlices, sliceCount, workers);
+		Person *swapPointer = source;
+		source = destination;
+		destination = swapPointer;
+	}
+	
+	if (source != peopleArray)
+	{
+		memcpy(peopleArray, source, (size_t) peopleCounter * sizeof(Person));
+	}
+	free(radixSlices);
+	free(workers);
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that sorts the People-Array in ascending order of ID or severity.
+ * @details An LSD radix sort over an order-preserving unsigned key (personRadixKey). It is stable, so equal
+ * keys keep their relative order on any libc (as glibc's merge sort based qsort did). Large arrays are
+ * sorted on up to threadCount threads. If the sort buffer can't be allocated, qsort is used instead.
+ * @param[in] peopleArray the array of people to sort.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] sortKey the field to sort by.
+ * @param[in] threadCount the maximal number of threads to sort with.
+ */
+static void sortPeople(Person *peopleArray, unsigned int peopleCounter, PersonSortKey sortKey, unsigned int threadCount)
+{
+	unsigned int sliceCount = peopleCounter / RADIX_SORT_MIN_SLICE_SIZE;
+	Person *sortBuffer = (Person *) malloc((size_t) peopleCounter * sizeof(Person));
+	if (sortBuffer == NULL)
+	{
+		qsort(peopleArray, peopleCounter, sizeof(Person),
+			  (sortKey == PERSON_SORT_BY_ID) ? personCompareByID : personCompareBySeverity);
+		return;
+	}
+	
+	if (sliceCount > threadCount)
+	{
+		sliceCount = threadCount;
+	}
+	if ((sliceCount <= SERIAL_THREAD_COUNT) ||
+		(radixSortPeopleParallel(peopleArray, sortBuffer, peopleCounter, sortKey, sliceCount) != STATUS_CODE_SUCCESS))
+	{
+		radixSortPeopleSerial(peopleArray, sortBuffer, peopleCounter, sortKey);
+	}
+	free(sortBuffer);
+}
+
+
+/**
+ * @brief A function that tracks the ID-ordered runs of the People-Array, as a person is added to it.
+ * @param[in] peopleRuns the runs so far. Starts as a single run (runCount 1, runStarts[0] 0).
+ * @param[in] id the ID of the added person.
+ * @param[in] personIndex the index of the added person.
+ */
+void peopleRunsTrack(PeopleRuns *peopleRuns, int id, unsigned int personIndex)
+{
+	if ((personIndex > 0) && (id < peopleRuns->lastID) && (peopleRuns->runCount <= PEOPLE_MAX_MERGED_RUNS))
+	{
+		if (peopleRuns->runCount < PEOPLE_MAX_MERGED_RUNS)
+		{
+			peopleRuns->runStarts[peopleRuns->runCount] = personIndex;
+		}
+		peopleRuns->runCount++;
+	}
+	peopleRuns->lastID = id;
+}
+
+
+/**
+ * @brief A function that sorts a People-Array of a few ID-ordered runs by ID, merging adjacent runs in pairs.
+ * @details Each pass halves the number of runs, so runCount runs take log2(runCount) sequential passes. Ties
+ * are taken from the left run, so - as the radix sort - the merge is stable.
+ * @param[in] peopleArray the array of people to sort.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] peopleRuns the runs of the array. At most PEOPLE_MAX_MERGED_RUNS.
+ * @param[out] STATUS_CODE_SUCCESS If the array was sorted.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed. The array is left unchanged.
+ */
+static StatusCode mergePeopleRuns(Person *peopleArray, unsigned int peopleCounter, const PeopleRuns *peopleRuns)
+{
+	Person *sortBuffer = (Person *) malloc((size_t) peopleCounter * sizeof(Person));
+	if (sortBuffer == NULL)
+	{
+		return STATUS_CODE_FAIL;
+	}
+	unsigned int runBounds[PEOPLE_MAX_MERGED_RUNS + 1];
+	unsigned int runCount = peopleRuns->runCount, runIndex = 0;
+	memcpy(runBounds, peopleRuns->runStarts, (size_t) runCount * sizeof(unsigned int));
+	runBounds[runCount] = peopleCounter;
+	Person *source = peopleArray, *destination = sortBuffer;
+	
+	while (runCount > 1)
+	{
+		unsigned int mergedCount = 0;
+		for (runIndex = 0; runIndex < runCount; runIndex += 2)
+		{
+			unsigned int left = runBounds[runIndex];
+			unsigned int middle = runBounds[((runIndex + 1) < runCount) ? (runIndex + 1) : runCount];
+			unsigned int end = runBounds[((runIndex + 2) < runCount) ? (runIndex + 2) : runCount];
+			unsigned int right = middle, position = left;
+			while ((left < middle) && (right < end))
+			{
+				destination[position++] = (source[right].id < source[left].id) ? source[right++] : source[left++];
+			}
+			memcpy(destination + position, source + left, (size_t) (middle - left) * sizeof(Person));
+			position += middle - left;
+			memcpy(destination + position, source + right, (size_t) (end - right) * sizeof(Person));
+			runBounds[mergedCount++] = runBounds[runIndex];
+		}
+		runBounds[mergedCount] = peopleCounter;
+		runCount = mergedCount;
+		Person *swapPointer = source;
+		source = destination;
+		destination = swapPointer;
+	}
+	
+	if (source != peopleArray)
+	{
+		memcpy(peopleArray, source, (size_t) peopleCounter * sizeof(Person));
+	}
+	free(sortBuffer);
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that sorts the People-Array by ID, by the ID-ordered runs tracked as it was read.
+ * @details An array already in ID order (a single run - e.g. an exporter's ID-ordered People.in) isn't sorted
+ * at all, and one of up to PEOPLE_MAX_MERGED_RUNS runs is merged (mergePeopleRuns). Others - and if the
+ * merge buffer can't be allocated - are sorted by sortPeople. The order is the same either way.
+ * @param[in] peopleArray the array of people to sort.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] peopleRuns the runs of the array.
+ * @param[in] threadCount the maximal number of threads to sort with.
+ */
+void sortPeopleRuns(Person *peopleArray, unsigned int peopleCounter, const PeopleRuns *peopleRuns,
+					unsigned int threadCount)
+{
+	if (peopleRuns->runCount <= 1)
+	{
+		return;
+	}
+	if ((peopleRuns->runCount > PEOPLE_MAX_MERGED_RUNS) ||
+		(mergePeopleRuns(peopleArray, peopleCounter, peopleRuns) != STATUS_CODE_SUCCESS))
+	{
+		sortPeople(peopleArray, peopleCounter, PERSON_SORT_BY_ID, threadCount);
+	}
+}
+
+
+/**
+ * @brief A function that moves the people who need treatment to the end of the People-Array, and sorts them.
+ * @details A stable partition: the "No serious chance" people stay in ascending ID order at the beginning,
+ * and only the people above REGULAR_QUARANTINE_THRESHOLD are sorted by severity. Read backwards (as
+ * generateSeverityFile does), the urgent tiers come out exactly as in the full sort, followed by the clean
+ * tier in descending ID order.
+ * @param[in] peopleArray the array of people, sorted by ID.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] threadCount the maximal number of threads to sort with.
+ * @param[out] STATUS_CODE_SUCCESS If the array was ordered.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed. The array is left unchanged.
+ */
+static StatusCode partitionSeverityTiers(Person *peopleArray, unsigned int peopleCounter, unsigned int threadCount)
+{
+	unsigned int urgentCounter = 0, cleanCounter = 0, personIndex = 0;
+	for (personIndex = 0; personIndex < peopleCounter; personIndex++)
+	{
+		urgentCounter += (peopleArray[personIndex].severity >= REGULAR_QUARANTINE_THRESHOLD);
+	}
+	if (urgentCounter == 0)
+	{
+		return STATUS_CODE_SUCCESS;
+	}
+	
+	Person *urgentPeople = (Person *) malloc((size_t) urgentCounter * sizeof(Person));
+	if (urgentPeople == NULL)
+	{
+		return STATUS_CODE_FAIL;
+	}
+	urgentCounter = 0;
+	for (personIndex = 0; personIndex < peopleCounter; personIndex++)
+	{
+		if (peopleArray[personIndex].severity >= REGULAR_QUARANTINE_THRESHOLD)
+		{
+			urgentPeople[urgentCounter++] = peopleArray[personIndex];
+		}
+		else
+		{
+			peopleArray[cleanCounter++] = peopleArray[personIndex];
+		}
+	}
+	sortPeople(urgentPeople, urgentCounter, PERSON_SORT_BY_SEVERITY, threadCount);
+	memcpy(peopleArray + cleanCounter, urgentPeople, (size_t) urgentCounter * sizeof(Person));
+	free(urgentPeople);
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that restores the min-heap order below one node of a heap of people.
+ * @details The heap is ordered by personCompareBySeverityThenID, so its root is the least severe person.
+ * @param[in] heap the heap.
+ * @param[in] heapSize number of people in the heap.
+ * @param[in] nodeIndex the node to sift down.
+ */
+static void severityHeapSiftDown(Person *heap, unsigned int heapSize, unsigned int nodeIndex)
+{
+	Person sifted = heap[nodeIndex];
+	unsigned long childIndex = (2ul * nodeIndex) + 1;
+	while (childIndex < heapSize)
+	{
+		if (((childIndex + 1) < heapSize) &&
+			(personCompareBySeverityThenID(heap + childIndex + 1, heap + childIndex) < 0))
+		{
+			childIndex++;
+		}
+		if (personCompareBySeverityThenID(heap + childIndex, &sifted) >= 0)
+		{
+			break;
+		}
+		heap[nodeIndex] = heap[childIndex];
+		nodeIndex = (unsigned int) childIndex;
+		childIndex = (2ul * nodeIndex) + 1;
+	}
+	heap[nodeIndex] = sifted;
+}
+
+
+/**
+ * @brief A function that moves the topCount most severe people to the beginning of the People-Array.
+ * @details The first topCount people are made a min-heap, and every other person who is more severe than
+ * the heap's root replaces it - O(n log K), in place. The selected people are then sorted, so reading
+ * them backwards gives the same order as the full output.
+ * @param[in] peopleArray the array of people.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] topCount the number of people to select.
+ * @return the number of people selected: the smaller of topCount and peopleCounter.
+ */
+static unsigned int selectTopSeverities(Person *peopleArray, unsigned int peopleCounter, unsigned long topCount)
+{
+	unsigned int heapSize = (topCount < peopleCounter) ? (unsigned int) topCount : peopleCounter;
+	unsigned int personIndex = 0;
+	if (heapSize == 0)
+	{
+		return 0;
+	}
+	for (personIndex = heapSize / 2; personIndex > 0; personIndex--)
+	{
+		severityHeapSiftDown(peopleArray, heapSize, personIndex - 1);
+	}
+	
+	for (personIndex = heapSize; personIndex < peopleCounter; personIndex++)
+	{
+		if (personCompareBySeverityThenID(peopleArray + personIndex, peopleArray) > 0)
+		{
+			Person swapPerson = peopleArray[0];
+			peopleArray[0] = peopleArray[personIndex];
+			peopleArray[personIndex] = swapPerson;
+			severityHeapSiftDown(peopleArray, heapSize, 0);
+		}
+	}
+	
+	qsort(peopleArray, heapSize, sizeof(Person), personCompareBySeverityThenID);
+	return heapSize;
+}
+
+
+/**
+ * @brief A function that orders the People-Array for generateSeverityFile, according to the output mode.
+ * @details OUTPUT_MODE_FULL sorts everyone by severity, OUTPUT_MODE_TIERS sorts the urgent tiers only
+ * (partitionSeverityTiers), and OUTPUT_MODE_TOP selects the most severe people (selectTopSeverities).
+ * If the tiers can't be partitioned, everyone is sorted.
+ * @param[in] peopleArray the array of people, sorted by ID.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] runOptions the options the program was run with.
+ * @return the number of people to write, from the beginning of peopleArray.
+ */
+unsigned int orderPeopleForOutput(Person *peopleArray, unsigned int peopleCounter, const RunOptions *runOptions)
+{
+	unsigned int threadCount = resolveThreadCount(runOptions->threadCount);
+	if (runOptions->outputMode == OUTPUT_MODE_TOP)
+	{
+		return selectTopSeverities(peopleArray, peopleCounter, runOptions->topCount);
+	}
+	if ((runOptions->outputMode != OUTPUT_MODE_TIERS) ||
+		(partitionSeverityTiers(peopleArray, peopleCounter, threadCount) != STATUS_CODE_SUCCESS))
+	{
+		sortPeople(peopleArray, peopleCounter, PERSON_SORT_BY_SEVERITY, threadCount);
+	}
+	return peopleCounter;
+}
+
+
+/**
+ * @brief A function that initiates an UrgentTierEmitter, which writes to stdout.
+ * @note The function ALLOCATES MEMORY being stored in tierEmitter. released by urgentTierEmitterFree.
+ * @param[in] tierEmitter the emitter to initiate.
+ * @param[in] peopleArray the array of people, whose severities are being updated.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] nameArena the arena which holds the names of the people.
+ * @param[in] runOptions the options the program was run with (streamInterval, threadCount).
+ * @param[out] STATUS_CODE_SUCCESS If the emitter was initiated.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+StatusCode urgentTierEmitterInit(UrgentTierEmitter *tierEmitter, const Person *peopleArray,
+								 unsigned int peopleCounter, const NameArena *nameArena,
+								 const RunOptions *runOptions)
+{
+	tierEmitter->peopleArray = peopleArray;
+	tierEmitter->peopleCounter = peopleCounter;
+	tierEmitter->nameArena = nameArena;
+	tierEmitter->urgentPeople = NULL;
+	tierEmitter->urgentCapacity = 0;
+	tierEmitter->emitInterval = runOptions->streamInterval;
+	tierEmitter->pendingUpdates = 0;
+	tierEmitter->threadCount = resolveThreadCount(runOptions->threadCount);
+	tierEmitter->status = outputWriterInit(&tierEmitter->outputWriter, STDOUT_FILENO);
+	return tierEmitter->status;
+}
+
+
+/**
+ * @brief A function that writes the current urgent tiers to stdout.
+ * @details The people above REGULAR_QUARANTINE_THRESHOLD are collected and sorted, and written the same
+ * way as in the output file (most severe first), followed by an empty line which ends the list.
+ * @param[in] tierEmitter the emitter.
+ * @param[out] STATUS_CODE_SUCCESS If the list was written.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode urgentTierEmit(UrgentTierEmitter *tierEmitter)
+{
+	unsigned int urgentCounter = 0, personIndex = 0;
+	for (personIndex = 0; personIndex < tierEmitter->peopleCounter; personIndex++)
+	{
+		urgentCounter += (tierEmitter->peopleArray[personIndex].severity >= REGULAR_QUARANTINE_THRESHOLD);
+	}
+	if (urgentCounter > tierEmitter->urgentCapacity)
+	{
+		Person *temporaryUrgentPointer = (Person *) realloc(tierEmitter->urgentPeople,
+															 (size_t) urgentCounter * sizeof(Person));
+		if (temporaryUrgentPointer == NULL)
+		{
+			return STATUS_CODE_FAIL;
+		}
+		tierEmitter->urgentPeople = temporaryUrgentPointer;
+		tierEmitter->urgentCapacity = urgentCounter;
+	}
+	
+	urgentCounter = 0;
+	for (personIndex = 0; personIndex < tierEmitter->peopleCounter; personIndex++)
+	{
+		if (tierEmitter->peopleArray[personIndex].severity >= REGULAR_QUARANTINE_THRESHOLD)
+		{
+			tierEmitter->urgentPeople[urgentCounter++] = tierEmitter->peopleArray[personIndex];
+		}
+	}
+	sortPeople(tierEmitter->urgentPeople, urgentCounter, PERSON_SORT_BY_SEVERITY, tierEmitter->threadCount);
+	
+	StatusCode retValWrite = STATUS_CODE_SUCCESS;
+	while ((urgentCounter > 0) && (retValWrite == STATUS_CODE_SUCCESS))
+	{
+		urgentCounter--;
+		retValWrite = outputWriterAppendPerson(&tierEmitter->outputWriter, tierEmitter->urgentPeople + urgentCounter,
+											   tierEmitter->nameArena);
+	}
+	if (retValWrite == STATUS_CODE_SUCCESS)
+	{
+		retValWrite = outputWriterAppend(&tierEmitter->outputWriter, "\n", 1);
+	}
+	if (retValWrite == STATUS_CODE_SUCCESS)
+	{
+		retValWrite = outputWriterFlush(&tierEmitter->outputWriter);
+	}
+	tierEmitter->pendingUpdates = 0;
+	return retValWrite;
+}
+
+
+/**
+ * @brief A function that records a severity update, and emits the urgent tiers every emitInterval updates.
+ * @param[in] tierEmitter the emitter.
+ * @param[out] STATUS_CODE_SUCCESS If no emission failed so far.
+ * @param[out] StatusCode - If ERROR occurred, the error of the failed emission.
+ */
+StatusCode urgentTierEmitterUpdated(UrgentTierEmitter *tierEmitter)
+{
+	tierEmitter->pendingUpdates++;
+	if ((tierEmitter->status == STATUS_CODE_SUCCESS) && (tierEmitter->pendingUpdates >= tierEmitter->emitInterval))
+	{
+		tierEmitter->status = urgentTierEmit(tierEmitter);
+	}
+	return tierEmitter->status;
+}
+
+
+/**
+ * @brief The idle handler of a streaming LineReader: emits the urgent tiers if they changed.
+ * @details Called when no input is waiting, so the latest severities are written before the program
+ * blocks for more meetings.
+ * @param[in] tierEmitter a pointer to the UrgentTierEmitter.
+ */
+void urgentTierEmitterOnIdle(void *tierEmitter)
+{
+	UrgentTierEmitter *emitter = (UrgentTierEmitter *) tierEmitter;
+	if ((emitter->status == STATUS_CODE_SUCCESS) && (emitter->pendingUpdates > 0))
+	{
+		emitter->status = urgentTierEmit(emitter);
+	}
+}
+
+
+/**
+ * @brief A function that releases the memory held by an UrgentTierEmitter, without emitting.
+ * @param[in] tierEmitter the emitter to free.
+ */
+void urgentTierEmitterFree(UrgentTierEmitter *tierEmitter)
+{
+	free(tierEmitter->urgentPeople);
+	tierEmitter->urgentPeople = NULL;
+	tierEmitter->urgentCapacity = 0;
+	outputWriterFree(&tierEmitter->outputWriter);
+}
+
+
@@ -0,0 +1,258 @@
+/*
+ * File Name: SpreaderDetectorOutput.h
+ * Related Files: "SpreaderDetectorOutput.c", "SpreaderDetectorInternal.h"
+ *
+ * Purpose:
+ * 			The functions of SpreaderDetectorOutput.c which the other modules of the SpreaderDetector library
+ * 			use. They are internal (hidden): the API of the library is SpreaderDetector.h.
+ *
+ * Author's ID: 206174120
+ * Author's Name: Oren Kovartovsky
+ * University User Name: orenkov
+ *
+ * */
+
+#ifndef SPREADERDETECTOROUTPUT_H
+#define SPREADERDETECTOROUTPUT_H
+
+#include "SpreaderDetectorInternal.h"
+
+#if defined(__GNUC__)
+#pragma GCC visibility push(hidden)
+#endif
+
+//	****** GENERATING FILES or MESSAGES FUNCTIONS ******
+/**
+ * @brief A function that generates an empty output file.
+ * @details used whenever input is valid - but people's input file is empty.
+ * @param[in] outputFilePath the path of the output file.
+ * @param[out] STATUS_CODE_SUCCESS if file was generated successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode generateEmptyOutputFile(const char *outputFilePath);
+
+/**
+ * @brief A function that generates an output file of the potential carriers, sorted by urgency of treatment.
+ *
+ * @details output file is divided to 3 sections: Hospitalization needed, Quarantine needed, No serious.
+ * @details each of the section is sorted by severity level.
+ * @details The lines are formatted by an OutputWriter straight into its buffer, and written in large blocks.
+ * @param[in] peopleArray a pointer to the peopleArray, which contains the relevant data about them.
+ * @param[in] peopleCounter number of different people which were recorded, and appears in the array.
+ * @param[in] nameArena the arena which holds the names of the people in peopleArray.
+ * @param[in] outputFilePath the path of the output file.
+ * @param[in] runStats the measurements of the run (RunOptions.runStats). NULL - not measured.
+ * @param[out] STATUS_CODE_SUCCESS if file was generated successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode generateSeverityFile(Person *peopleArray, unsigned int peopleCounter, const NameArena *nameArena,
+							  const char *outputFilePath, RunStats *runStats);
+
+/**
+ * @brief A function that opens a temporary file next to path, which is renamed over it once it is complete
+ * (see temporaryFileCommit). So a reader of path never sees a half-written file.
+ *
+ * @note The function ALLOCATES MEMORY being stored in temporaryPath and outputWriter. released by
+ * temporaryFileCommit (or here, in failure).
+ * @param[in] path the path the file is written for.
+ * @param[in] temporaryPath set to the path of the temporary file.
+ * @param[in] outputWriter initialized over the temporary file.
+ * @param[out] STATUS_CODE_SUCCESS If the file was opened.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode temporaryFileOpen(const char *path, char **temporaryPath, OutputWriter *outputWriter);
+
+/**
+ * @brief A function that finishes a file opened by temporaryFileOpen: flushes and closes it, and renames it
+ * over path - or removes it, if writing it failed.
+ *
+ * @param[in] path the path the file is written for.
+ * @param[in] temporaryPath the path of the temporary file. Released.
+ * @param[in] outputWriter the writer of the temporary file. Released, and its descriptor closed.
+ * @param[in] retValWrite STATUS_CODE_SUCCESS if everything was appended to the writer.
+ * @param[out] STATUS_CODE_SUCCESS If the file replaced path.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If writing failed. path is left as it was.
+ */
+StatusCode temporaryFileCommit(const char *path, char *temporaryPath, OutputWriter *outputWriter,
+							   StatusCode retValWrite);
+
+
+//	****** OUTPUT WRITER FUNCTIONS ******
+/**
+ * @brief A function that initiates an OutputWriter, and allocates its buffer.
+ *
+ * @param[in] outputWriter the writer to initiate.
+ * @param[in] outputFd the descriptor to write to. The writer doesn't close it.
+ * @param[out] STATUS_CODE_SUCCESS If the writer was initiated.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+StatusCode outputWriterInit(OutputWriter *outputWriter, int outputFd);
+
+/**
+ * @brief A function that writes the buffered content of an OutputWriter to its descriptor.
+ *
+ * @details Partial writes and interrupted writes are retried until everything is written.
+ * @param[in] outputWriter the writer.
+ * @param[out] STATUS_CODE_SUCCESS If the content was written.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If write failed.
+ */
+StatusCode outputWriterFlush(OutputWriter *outputWriter);
+
+/**
+ * @brief A function that appends text to an OutputWriter.
+ *
+ * @param[in] outputWriter the writer.
+ * @param[in] text the text (doesn't have to be '\0' terminated).
+ * @param[in] textLength the length of the text.
+ * @param[out] STATUS_CODE_SUCCESS If the text was appended.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If the buffer couldn't be flushed or grown.
+ */
+StatusCode outputWriterAppend(OutputWriter *outputWriter, const char *text, size_t textLength);
+
+/**
+ * @brief A function that appends binary data of any size to the buffer, a buffer-size part at a time.
+ *
+ * @details Unlike outputWriterAppend, the buffer isn't grown to fit the whole data.
+ * @param[in] outputWriter the writer.
+ * @param[in] bytes the data to append.
+ * @param[in] size the size of the data.
+ * @param[out] STATUS_CODE_SUCCESS If the data was appended.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If a flush failed.
+ */
+StatusCode outputWriterAppendBytes(OutputWriter *outputWriter, const void *bytes, size_t size);
+
+/**
+ * @brief A function that appends an output line to an OutputWriter.
+ *
+ * @details Formats exactly what the severity's message in "SpreaderDetectorParams.h" does, from the parts
+ * messageFormatInit split it to: the prefix, the name, the separator, the ID (as %lu of the ID) and the suffix.
+ * @param[in] outputWriter the writer.
+ * @param[in] severity the severity of the person, which determines the message.
+ * @param[in] name the name of the person (doesn't have to be '\0' terminated).
+ * @param[in] nameLength the length of the name.
+ * @param[in] id the ID of the person.
+ * @param[out] STATUS_CODE_SUCCESS If the line was appended.
+ * @param[out] STATUS_CODE_OUTPUT_ERROR If the buffer couldn't be flushed or grown.
+ */
+StatusCode outputWriterAppendLine(OutputWriter *outputWriter, float severity, const char *name,
+								  size_t nameLength, int id);
+
+/**
+ * @brief A function that releases the buffer of an OutputWriter, without flushing it.
+ *
+ * @param[in] outputWriter the writer to free.
+ */
+void outputWriterFree(OutputWriter *outputWriter);
+
+
+//	****** SORTING FUNCTIONS ******
+/**
+ * @brief A function that maps a person's sort key to an unsigned integer with the same order.
+ *
+ * @details IDs get their sign bit flipped. Severities are taken as IEEE-754 bits: non-negative floats get
+ * their sign bit set, negative ones are inverted, and -0 is folded into +0 (personCompareBySeverity treats
+ * them as equal).
+ * @param[in] person the person.
+ * @param[in] sortKey the field to sort by.
+ * @return the radix key of the person.
+ */
+unsigned int personRadixKey(const Person *person, PersonSortKey sortKey);
+
+/**
+ * @brief A function that tracks the ID-ordered runs of the People-Array, as a person is added to it.
+ *
+ * @param[in] peopleRuns the runs so far. Starts as a single run (runCount 1, runStarts[0] 0).
+ * @param[in] id the ID of the added person.
+ * @param[in] personIndex the index of the added person.
+ */
+void peopleRunsTrack(PeopleRuns *peopleRuns, int id, unsigned int personIndex);
+
+/**
+ * @brief A function that sorts the People-Array by ID, by the ID-ordered runs tracked as it was read.
+ *
+ * @details An array already in ID order (a single run - e.g. an exporter's ID-ordered People.in) isn't sorted
+ * at all, and one of up to PEOPLE_MAX_MERGED_RUNS runs is merged (mergePeopleRuns). Others - and if the
+ * merge buffer can't be allocated - are sorted by sortPeople. The order is the same either way.
+ * @param[in] peopleArray the array of people to sort.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] peopleRuns the runs of the array.
+ * @param[in] threadCount the maximal number of threads to sort with.
+ */
+void sortPeopleRuns(Person *peopleArray, unsigned int peopleCounter, const PeopleRuns *peopleRuns,
+					unsigned int threadCount);
+
+
+//	****** OUTPUT ORDER FUNCTIONS ******
+/**
+ * @brief A function that orders the People-Array for generateSeverityFile, according to the output mode.
+ *
+ * @details OUTPUT_MODE_FULL sorts everyone by severity, OUTPUT_MODE_TIERS sorts the urgent tiers only
+ * (partitionSeverityTiers), and OUTPUT_MODE_TOP selects the most severe people (selectTopSeverities).
+ * If the tiers can't be partitioned, everyone is sorted.
+ * @param[in] peopleArray the array of people, sorted by ID.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] runOptions the options the program was run with.
+ * @return the number of people to write, from the beginning of peopleArray.
+ */
+unsigned int orderPeopleForOutput(Person *peopleArray, unsigned int peopleCounter, const RunOptions *runOptions);
+
+
+//	****** STREAMING FUNCTIONS ******
+/**
+ * @brief A function that initiates an UrgentTierEmitter, which writes to stdout.
+ *
+ * @note The function ALLOCATES MEMORY being stored in tierEmitter. released by urgentTierEmitterFree.
+ * @param[in] tierEmitter the emitter to initiate.
+ * @param[in] peopleArray the array of people, whose severities are being updated.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] nameArena the arena which holds the names of the people.
+ * @param[in] runOptions the options the program was run with (streamInterval, threadCount).
+ * @param[out] STATUS_CODE_SUCCESS If the emitter was initiated.
+ * @param[out] STATUS_CODE_FAIL If memory allocation failed.
+ */
+StatusCode urgentTierEmitterInit(UrgentTierEmitter *tierEmitter, const Person *peopleArray,
+								 unsigned int peopleCounter, const NameArena *nameArena,
+								 const RunOptions *runOptions);
+
+/**
+ * @brief A function that writes the current urgent tiers to stdout.
+ *
+ * @details The people above REGULAR_QUARANTINE_THRESHOLD are collected and sorted, and written the same
+ * way as in the output file (most severe first), followed by an empty line which ends the list.
+ * @param[in] tierEmitter the emitter.
+ * @param[out] STATUS_CODE_SUCCESS If the list was written.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode urgentTierEmit(UrgentTierEmitter *tierEmitter);
+
+/**
+ * @brief A function that records a severity update, and emits the urgent tiers every emitInterval updates.
+ *
+ * @param[in] tierEmitter the emitter.
+ * @param[out] STATUS_CODE_SUCCESS If no emission failed so far.
+ * @param[out] StatusCode - If ERROR occurred, the error of the failed emission.
+ */
+StatusCode urgentTierEmitterUpdated(UrgentTierEmitter *tierEmitter);
+
+/**
+ * @brief The idle handler of a streaming LineReader: emits the urgent tiers if they changed.
+ *
+ * @details Called when no input is waiting, so the latest severities are written before the program
+ * blocks for more meetings.
+ * @param[in] tierEmitter a pointer to the UrgentTierEmitter.
+ */
+void urgentTierEmitterOnIdle(void *tierEmitter);
+
+/**
+ * @brief A function that releases the memory held by an UrgentTierEmitter, without emitting.
+ *
+ * @param[in] tierEmitter the emitter to free.
+ */
+void urgentTierEmitterFree(UrgentTierEmitter *tierEmitter);
+
+
+#if defined(__GNUC__)
+#pragma GCC visibility pop
+#endif
+
+#endif //SPREADERDETECTOROUTPUT_H
@@ -0,0 +1,1031 @@
+/*
+ * File Name: SpreaderDetectorPeople.c
+ * Related Files: "SpreaderDetectorPeople.h", "SpreaderDetectorInternal.h"
+ *
+ * Purpose:
+ * 			This file is the people of the SpreaderDetector library: the arenas they are stored in, the
+ * 			PeopleIndex, and the reading, sorting and snapshots of the peopleFile.
+ *
+ * Author's ID: 206174120
+ * Author's Name: Oren Kovartovsky
+ * University User Name: orenkov
+ *
+ * */
+
+#include "SpreaderDetectorPeople.h"
+#include "SpreaderDetectorOutput.h"
+#include "SpreaderDetectorInput.h"
+
+
+/*
+ * ***********************
+ * 	DECLARATIONS
+ * ***********************
+ */
+//	****** RUN ARENA FUNCTIONS ******
+/**
+ * @brief A function that reserves the RunArena of a peopleFile, by the file's size.
+ *
+ * @details The number of people is estimated by the shortest line a person can have (PERSON_LINE_MIN_LEN), so
+ * for valid input the estimate is an upper bound, and the People-Array is never moved. The pages of the
+ * allocation that are never written aren't backed by memory, so the overestimate costs address space only. If
+ * the allocation fails nothing is reserved, and the People-Array grows dynamically as it would without it.
+ * @param[in] runArena the arena to reserve. Must be empty.
+ * @param[in] fileSize the size of the peopleFile.
+ */
+static void runArenaReserve(RunArena *runArena, unsigned long long fileSize);
+
+/**
+ * @brief A function that hands out the next bytes of the RunArena.
+ *
+ * @param[in] runArena the arena. May be NULL, or empty.
+ * @param[in] size the number of bytes.
+ * @return a pointer to the bytes (aligned to RUN_ARENA_ALIGNMENT), or NULL if the arena has no room for them.
+ */
+static void *runArenaAlloc(RunArena *runArena, size_t size);
+
+/**
+ * @brief A function that checks whether a pointer was handed out by the RunArena.
+ *
+ * @param[in] runArena the arena. May be NULL, or empty.
+ * @param[in] pointer the pointer.
+ * @return 1 if the pointer lies inside the arena, 0 otherwise.
+ */
+static int runArenaContains(const RunArena *runArena, const void *pointer);
+
+/**
+ * @brief A function that releases the RunArena, with everything handed out by it.
+ *
+ * @param[in] runArena the arena to release. May be empty.
+ */
+static void runArenaFree(RunArena *runArena);
+
+
+//	****** PEOPLE INDEX FUNCTIONS ******
+/**
+ * @brief A function that computes the capacity of the PeopleIndex of peopleCounter people: the smallest power of
+ * 2 that keeps the load factor under 1/2.
+ *
+ * @param[in] peopleCounter the amount of the people.
+ * @param[in] shift set to 32 - log2(capacity). May be NULL.
+ * @return the capacity, or 0 if it doesn't fit an unsigned int.
+ */
+static unsigned int peopleIndexCapacity(unsigned int peopleCounter, unsigned int *shift);
+
+
+//	****** PEOPLE PARSING / PROCESSING FUNCTIONS ******
+/**
+ * @brief A function that parsing the lines from the input peopleFile.
+ *
+ * @note The function handle with a certain given input (Extracting 2 arguments only from the line,
+ * in a certain order). Therefor, if the format or the needed details are to be changed, more tokens-handling
+ * will be needed.
+ * @param[in] personReceiver holds all the variables that gonna be 'fed' with the data in the line.
+ * @param[in] nameArena the arena the person's name is copied into.
+ * @param[in] lineToRead a pointer to the beginning of the line gonna be parsed by the function.
+ * @param[out] STATUS_CODE_SUCCESS If data was stored successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode parsePersonLine(Person *personReceiver, NameArena *nameArena, char *lineToRead);
+
+/**
+ * @brief A function that allocates the People-Array in the RunArena, for the number of people it was sized for.
+ *
+ * @param[in] peopleArray set to the array. Left as it is if the arena has no room for it.
+ * @param[in] runArena the arena. May be empty.
+ * @return the number of bytes allocated for the array (0 if it wasn't allocated), for peopleArrayAppend.
+ */
+static long peopleArrayReserve(Person **peopleArray, RunArena *runArena);
+
+/**
+ * @brief A function that adds a person to the end of the People-Array.
+ *
+ * @details Using Dynamic Array Method while allocating new memory, to save running time complexity.
+ * @param[in] peopleArray pointer to the array of people. Being (re)allocated.
+ * @param[in] peopleCounter number of people in the array. Being incremented.
+ * @param[in] arrSizeWithBuffer the number of bytes currently allocated for the array.
+ * @param[in] personReceiver the person to add.
+ * @param[in] runArena the arena the array may lie in (see peopleArrayReserve).
+ * @param[out] STATUS_CODE_SUCCESS If the person was added successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode peopleArrayAppend(Person **peopleArray, unsigned int *peopleCounter, long *arrSizeWithBuffer,
+									const Person *personReceiver, const RunArena *runArena);
+
+/**
+ * @brief The function reads the peopleFile line by line through stdio, copying the names into nameArena.
+ *
+ * @details Used for files that can't be mapped (pipes, devices, etc.).
+ * @note The function doesn't OPEN or CLOSE the file.
+ * @param[in] peopleFile the opened peopleFile.
+ * @param[in] peopleArray pointer to the array of people. Being allocated.
+ * @param[in] peopleCounter number of people in the array.
+ * @param[in] nameArena the arena which holds the names of the people. Being allocated.
+ * @param[in] peopleRuns the ID-ordered runs of the array. Tracked as the people are added.
+ * @param[out] STATUS_CODE_SUCCESS If reading was successful.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode peopleReadStream(FILE *peopleFile, Person **peopleArray, unsigned int *peopleCounter,
+								   NameArena *nameArena, PeopleRuns *peopleRuns);
+
+/**
+ * @brief The function maps the peopleFile to memory and scans it in place.
+ *
+ * @details The names aren't copied: nameArena is set to point into the mapping, which is released
+ * with nameArenaFree.
+ * @note The function doesn't CLOSE peopleFd. The mapping stays valid after it is closed.
+ * @param[in] peopleFd the opened peopleFile descriptor. Must be a regular file.
+ * @param[in] fileSize the size of the peopleFile. must be positive.
+ * @param[in] peopleArray pointer to the array of people. Being allocated.
+ * @param[in] peopleCounter number of people in the array.
+ * @param[in] nameArena the arena which holds the names of the people. Being mapped.
+ * @param[in] peopleRuns the ID-ordered runs of the array. Tracked as the people are added.
+ * @param[out] STATUS_CODE_SUCCESS If reading was successful.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode peopleReadMapped(int peopleFd, size_t fileSize, Person **peopleArray, unsigned int *peopleCounter,
+								   NameArena *nameArena, PeopleRuns *peopleRuns);
+
+/**
+ * @brief A function that checks whether an opened peopleFile is a snapshot, by its magic.
+ *
+ * @param[in] peopleFd the opened peopleFile descriptor. Must be a regular file.
+ * @param[in] fileSize the size of the peopleFile.
+ * @return 1 if the file starts with SNAPSHOT_MAGIC, 0 otherwise.
+ */
+static int isPeopleSnapshot(int peopleFd, size_t fileSize);
+
+/**
+ * @brief The function maps a snapshot of the peopleFile, and uses it in place.
+ *
+ * @details The mapping is private and writable, so peopleArray points straight into the record table (the
+ * severities are written copy-on-write, never to the file), and the names stay in the name blob. Nothing
+ * is parsed or sorted: the header and the records are only validated (the IDs must be sorted).
+ * @note The function doesn't CLOSE peopleFd. The mapping stays valid after it is closed, and is released
+ * with nameArenaFree.
+ * @param[in] peopleFd the opened snapshot descriptor. Must be a regular file.
+ * @param[in] fileSize the size of the snapshot.
+ * @param[in] peopleArray set to the record table.
+ * @param[in] peopleCounter set to the number of people in the snapshot.
+ * @param[in] nameArena the arena which holds the names of the people. Being mapped.
+ * @param[out] STATUS_CODE_SUCCESS If the snapshot was loaded.
+ * @param[out] STATUS_CODE_INPUT_ERROR If the snapshot couldn't be mapped, or is invalid.
+ */
+static StatusCode peopleLoadSnapshot(int peopleFd, size_t fileSize, Person **peopleArray, unsigned int *peopleCounter,
+									 NameArena *nameArena);
+
+
+/*
+ * ***********************
+ * 	DEFINITIONS
+ * ***********************
+ */
+/**
+ * @brief A function that reserves the RunArena of a peopleFile, by the file's size.
+ * @details The number of people is estimated by the shortest line a person can have (PERSON_LINE_MIN_LEN), so
+ * for valid input the estimate is an upper bound, and the People-Array is never moved. The pages of the
+ * allocation that are never written aren't backed by memory, so the overestimate costs address space only. If
+ * the allocation fails nothing is reserved, and the People-Array grows dynamically as it would without it.
+ * @param[in] runArena the arena to reserve. Must be empty.
+ * @param[in] fileSize the size of the peopleFile.
+ */
+static void runArenaReserve(RunArena *runArena, unsigned long long fileSize)
+{
+	//	+1 for a last line without a 'new line', and +1 as peopleArrayAppend keeps the last slot free:
+	unsigned long long peopleEstimate = (fileSize / PERSON_LINE_MIN_LEN) + 2;
+	unsigned int indexCapacity = peopleIndexCapacity((peopleEstimate > UINT_MAX) ? UINT_MAX :
+													 (unsigned int) peopleEstimate, NULL);
+	if (indexCapacity == 0)
+	{
+		return;
+	}
+	unsigned long long capacity = (peopleEstimate * sizeof(Person)) + RUN_ARENA_ALIGNMENT +
+								  ((unsigned long long) indexCapacity * sizeof(PeopleIndexSlot));
+	if (capacity > SIZE_MAX)
+	{
+		return;
+	}
+	runArena->base = (char *) malloc((size_t) capacity);
+	if (runArena->base == NULL)
+	{
+		return;
+	}
+	runArena->used = 0;
+	runArena->capacity = (size_t) capacity;
+	runArena->peopleEstimate = (unsigned int) peopleEstimate;
+}
+
+
+/**
+ * @brief A function that hands out the next bytes of the RunArena.
+ * @param[in] runArena the arena. May be NULL, or empty.
+ * @param[in] size the number of bytes.
+ * @return a pointer to the bytes (aligned to RUN_ARENA_ALIGNMENT), or NULL if the arena has no room for them.
+ */
+static void *runArenaAlloc(RunArena *runArena, size_t size)
+{
+	if ((runArena == NULL) || (runArena->base == NULL))
+	{
+		return NULL;
+	}
+	size_t start = (runArena->used + RUN_ARENA_ALIGNMENT - 1) & ~((size_t) RUN_ARENA_ALIGNMENT - 1);
+	if ((start > runArena->capacity) || (size > (runArena->capacity - start)))
+	{
+		return NULL;
+	}
+	runArena->used = start + size;
+	return runArena->base + start;
+}
+
+
+/**
+ * @brief A function that checks whether a pointer was handed out by the RunArena.
+ * @param[in] runArena the arena. May be NULL, or empty.
+ * @param[in] pointer the pointer.
+ * @return 1 if the pointer lies inside the arena, 0 otherwise.
+ */
+static int runArenaContains(const RunArena *runArena, const void *pointer)
+{
+	return ((runArena != NULL) && (runArena->base != NULL) && ((const char *) pointer >= runArena->base) &&
+			((const char *) pointer < (runArena->base + runArena->capacity)));
+}
+
+
+/**
+ * @brief A function that releases the RunArena, with everything handed out by it.
+ * @param[in] runArena the arena to release. May be empty.
+ */
+static void runArenaFree(RunArena *runArena)
+{
+	free(runArena->base);
+	runArena->base = NULL;
+	runArena->used = 0;
+	runArena->capacity = 0;
+	runArena->peopleEstimate = 0;
+}
+
+
+/**
+ * @brief A function that copies a name into the end of the NameArena.
+ * @details Using Dynamic Array Method while allocating new memory, to save running time complexity.
+ * @param[in] nameArena the arena to append the name to.
+ * @param[in] name a pointer to the beginning of the name (doesn't have to be '\0' terminated).
+ * @param[in] nameLength the length of the name.
+ * @param[in] personReceiver the person whose nameOffset and nameLength are set to the stored name.
+ * @param[out] STATUS_CODE_SUCCESS If the name was stored successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode nameArenaAppend(NameArena *nameArena, const char *name, size_t nameLength, Person *personReceiver)
+{
+	//	Offsets are kept as unsigned int in order to keep the Person record small:
+	if ((nameArena->length + nameLength) > (size_t) UINT_MAX)
+	{
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	
+	// ## MEMORY ALLOCATION ## - (Dynamic Array)
+	if ((nameArena->length + nameLength) > nameArena->capacity)
+	{
+		size_t newCapacity = (nameArena->capacity == 0) ? NAME_ARENA_INITIAL_CAPACITY : nameArena->capacity;
+		while ((nameArena->length + nameLength) > newCapacity)
+		{
+			newCapacity *= 2;
+		}
+		char *temporaryNamesPointer = (char *) realloc(nameArena->names, newCapacity);
+		if (temporaryNamesPointer == NULL)
+		{
+			error(STATUS_CODE_FAIL);
+			return STATUS_CODE_FAIL;
+		}
+		nameArena->names = temporaryNamesPointer;
+		nameArena->capacity = newCapacity;
+	}
+	
+	memcpy(nameArena->names + nameArena->length, name, nameLength);
+	personReceiver->nameOffset = (unsigned int) nameArena->length;
+	personReceiver->nameLength = (unsigned int) nameLength;
+	nameArena->length += nameLength;
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that releases the memory held by the NameArena.
+ * @details If the arena points into a file mapping, the mapping is unmapped. The RunArena is released too.
+ * @param[in] nameArena the arena to release. May be empty.
+ */
+void nameArenaFree(NameArena *nameArena)
+{
+	if (nameArena->mappedSize != 0)
+	{
+		munmap(nameArena->mappedBase, nameArena->mappedSize);
+	}
+	else
+	{
+		free(nameArena->names);
+	}
+	runArenaFree(&nameArena->runArena);
+	nameArena->names = NULL;
+	nameArena->length = 0;
+	nameArena->capacity = 0;
+	nameArena->mappedBase = NULL;
+	nameArena->mappedSize = 0;
+}
+
+
+/**
+ * @brief A function that releases the People-Array.
+ * @details A People-Array loaded from a snapshot lies inside the arena's file mapping, and one read from a
+ * text file in its RunArena - both are released with the arena (by nameArenaFree) instead.
+ * @param[in] peopleArray the array of people. May be NULL.
+ * @param[in] nameArena the arena which holds the names of the people. Must not be released yet.
+ */
+void peopleArrayFree(Person *peopleArray, const NameArena *nameArena)
+{
+	const char *arrayStart = (const char *) peopleArray;
+	if ((nameArena->mappedSize != 0) && (arrayStart >= nameArena->mappedBase) &&
+		(arrayStart < (nameArena->mappedBase + nameArena->mappedSize)))
+	{
+		return;
+	}
+	if (runArenaContains(&nameArena->runArena, peopleArray))
+	{
+		return;
+	}
+	free(peopleArray);
+}
+
+
+/**
+ * @brief A function that computes the capacity of the PeopleIndex of peopleCounter people: the smallest power of
+ * 2 that keeps the load factor under 1/2.
+ * @param[in] peopleCounter the amount of the people.
+ * @param[in] shift set to 32 - log2(capacity). May be NULL.
+ * @return the capacity, or 0 if it doesn't fit an unsigned int.
+ */
+static unsigned int peopleIndexCapacity(unsigned int peopleCounter, unsigned int *shift)
+{
+	unsigned int capacity = PEOPLE_INDEX_MIN_CAPACITY;
+	unsigned int capacityShift = 32 - 4;	// log2(PEOPLE_INDEX_MIN_CAPACITY) == 4
+	while (capacity < (2 * (unsigned long long) peopleCounter))
+	{
+		if (capacity > (UINT_MAX / 2))
+		{
+			return 0;
+		}
+		capacity *= 2;
+		capacityShift--;
+	}
+	if (shift != NULL)
+	{
+		*shift = capacityShift;
+	}
+	return capacity;
+}
+
+
+/**
+ * @brief A function that builds the ID hash index of the People-Array.
+ * @details The table's capacity is at least twice the number of people, so probe sequences stay short.
+ * @note The function ALLOCATES MEMORY being stored in peopleIndex (in runArena, if it has room). released by
+ * peopleIndexFree.
+ * @param[in] peopleIndex the index to build.
+ * @param[in] peopleArray the array of people, sorted by ID.
+ * @param[in] peopleCounter the amount of the people in peopleArray.
+ * @param[in] runArena the arena to allocate the table in. May be NULL - the table is heap allocated.
+ * @param[out] STATUS_CODE_SUCCESS If the index was built successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode peopleIndexBuild(PeopleIndex *peopleIndex, const Person *peopleArray, unsigned int peopleCounter,
+							RunArena *runArena)
+{
+	unsigned int shift = 0;
+	unsigned int capacity = peopleIndexCapacity(peopleCounter, &shift);
+	if (capacity == 0)
+	{
+		error(STATUS_CODE_FAIL);
+		return STATUS_CODE_FAIL;
+	}
+	
+	peopleIndex->slots = (PeopleIndexSlot *) runArenaAlloc(runArena, capacity * sizeof(PeopleIndexSlot));
+	peopleIndex->isInArena = (peopleIndex->slots != NULL);
+	if (peopleIndex->isInArena)
+	{
+		memset(peopleIndex->slots, 0, capacity * sizeof(PeopleIndexSlot));
+	}
+	else
+	{
+		peopleIndex->slots = (PeopleIndexSlot *) calloc(capacity, sizeof(PeopleIndexSlot));
+		if (peopleIndex->slots == NULL)
+		{
+			error(STATUS_CODE_FAIL);
+			return STATUS_CODE_FAIL;
+		}
+	}
+	peopleIndex->mask = capacity - 1;
+	peopleIndex->shift = shift;
+	
+	//	Insert every person, probing linearly from its hashed slot:
+	unsigned int position = 0, slot = 0;
+	for (position = 0; position < peopleCounter; position++)
+	{
+		slot = (((unsigned int) peopleArray[position].id) * PEOPLE_INDEX_HASH_MULTIPLIER) >> shift;
+		while (peopleIndex->slots[slot].position != PEOPLE_INDEX_EMPTY_SLOT)
+		{
+			slot = (slot + 1) & peopleIndex->mask;
+		}
+		peopleIndex->slots[slot].id = peopleArray[position].id;
+		peopleIndex->slots[slot].position = position + 1;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that finds a person in the People-Array by his ID.
+ * @param[in] peopleIndex the index of the People-Array.
+ * @param[in] peopleArray the array of people the index was built from.
+ * @param[in] id the ID to search for.
+ * @return a pointer to the person in peopleArray, or NULL if there is no person with that ID.
+ */
+Person *peopleIndexLookup(const PeopleIndex *peopleIndex, Person *peopleArray, int id)
+{
+	unsigned int slot = (((unsigned int) id) * PEOPLE_INDEX_HASH_MULTIPLIER) >> peopleIndex->shift;
+	while (peopleIndex->slots[slot].position != PEOPLE_INDEX_EMPTY_SLOT)
+	{
+		if (peopleIndex->slots[slot].id == id)
+		{
+			return (peopleArray + (peopleIndex->slots[slot].position - 1));
+		}
+		slot = (slot + 1) & peopleIndex->mask;
+	}
+	return NULL;
+}
+
+
+/**
+ * @brief A function that releases the memory held by the PeopleIndex (a table in a RunArena is released with it).
+ * @param[in] peopleIndex the index to release. May be empty.
+ */
+void peopleIndexFree(PeopleIndex *peopleIndex)
+{
+	if (!peopleIndex->isInArena)
+	{
+		free(peopleIndex->slots);
+	}
+	peopleIndex->slots = NULL;
+	peopleIndex->isInArena = 0;
+	peopleIndex->mask = 0;
+	peopleIndex->shift = 0;
+}
+
+
+/**
+ * @brief A function that skips the leading spaces of a line of the peopleFile. It is the blank-line rule of
+ * every people reader (stdio, mapped and external): a line which is empty, or holds only spaces, is skipped -
+ * so the people don't depend on how the file is read.
+ * @param[in] lineStart a pointer to the beginning of the line.
+ * @param[in] lineEnd a pointer to the end of the line (not included).
+ * @return a pointer to the first character of the line which isn't a space. lineEnd - the line is blank.
+ */
+const char *peopleLineStart(const char *lineStart, const char *lineEnd)
+{
+	while ((lineStart < lineEnd) && (*lineStart == ' '))
+	{
+		lineStart++;
+	}
+	return lineStart;
+}
+
+
+/**
+ * @brief A function that parsing the lines from the input peopleFile.
+ * @note The function handle with a certain given input (Extracting 2 arguments only from the line,
+ * in a certain order). Therefor, if the format or the needed details are to be changed, more tokens-handling
+ * will be needed.
+ * @param[in] personReceiver holds all the variables that gonna be 'fed' with the data in the line.
+ * @param[in] nameArena the arena the person's name is copied into.
+ * @param[in] lineToRead a pointer to the beginning of the line gonna be parsed by the function.
+ * @param[out] STATUS_CODE_SUCCESS If data was stored successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode parsePersonLine(Person *personReceiver, NameArena *nameArena, char *lineToRead)
+{
+	short index = 0;
+	char *checkPtr = NULL;
+	char *chunk = strtok(lineToRead, " ");
+	while (chunk != NULL)
+	{
+		if (index == PEOPLE_NAME_INDEX)
+		{
+			if (nameArenaAppend(nameArena, chunk, strlen(chunk), personReceiver) != STATUS_CODE_SUCCESS)
+			{
+				return STATUS_CODE_FAIL;
+			}
+		}
+		
+		else if (index == PEOPLE_ID_INDEX)
+		{
+			personReceiver->id = (int) strtol(chunk, &checkPtr, 10);
+			if (personReceiver->id == 0) // Input can't be 0 by assumption.
+			{
+				error(STATUS_CODE_INPUT_ERROR);
+				return STATUS_CODE_INPUT_ERROR;
+			}
+		}
+		chunk = strtok(NULL, " ");
+		index ++;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that parsing a line of the peopleFile in place, inside the file mapping.
+ * @details The name isn't copied: the person's nameOffset points to it inside the mapping.
+ * @param[in] personReceiver holds all the variables that gonna be 'fed' with the data in the line.
+ * @param[in] mappedFile a pointer to the beginning of the file mapping.
+ * @param[in] lineStart a pointer to the beginning of the line.
+ * @param[in] lineEnd a pointer to the end of the line (the '\n', or the end of the mapping).
+ * @param[out] STATUS_CODE_SUCCESS If data was stored successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode parseMappedPersonLine(Person *personReceiver, const char *mappedFile,
+								 const char *lineStart, const char *lineEnd)
+{
+	//	Name - the first token:
+	const char *curChar = lineStart;
+	while ((curChar < lineEnd) && (*curChar != ' '))
+	{
+		curChar++;
+	}
+	personReceiver->nameOffset = (unsigned int) (lineStart - mappedFile);
+	personReceiver->nameLength = (unsigned int) (curChar - lineStart);
+	
+	//	ID - the second token:
+	personReceiver->id = (int) parseDecimalInteger(&curChar, lineEnd);
+	if (personReceiver->id == 0) // Input can't be 0 by assumption.
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that allocates the People-Array in the RunArena, for the number of people it was sized for.
+ * @param[in] peopleArray set to the array. Left as it is if the arena has no room for it.
+ * @param[in] runArena the arena. May be empty.
+ * @return the number of bytes allocated for the array (0 if it wasn't allocated), for peopleArrayAppend.
+ */
+static long peopleArrayReserve(Person **peopleArray, RunArena *runArena)
+{
+	size_t arrSize = (size_t) runArena->peopleEstimate * sizeof(Person);
+	Person *arenaArray = (Person *) runArenaAlloc(runArena, arrSize);
+	if ((arenaArray == NULL) || (arrSize > LONG_MAX))
+	{
+		return 0;
+	}
+	*peopleArray = arenaArray;
+	return (long) arrSize;
+}
+
+
+/**
+ * @brief A function that adds a person to the end of the People-Array.
+ * @details Using Dynamic Array Method while allocating new memory, to save running time complexity.
+ * @param[in] peopleArray pointer to the array of people. Being (re)allocated.
+ * @param[in] peopleCounter number of people in the array. Being incremented.
+ * @param[in] arrSizeWithBuffer the number of bytes currently allocated for the array.
+ * @param[in] personReceiver the person to add.
+ * @param[in] runArena the arena the array may lie in (see peopleArrayReserve).
+ * @param[out] STATUS_CODE_SUCCESS If the person was added successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode peopleArrayAppend(Person **peopleArray, unsigned int *peopleCounter, long *arrSizeWithBuffer,
+									const Person *personReceiver, const RunArena *runArena)
+{
+	// ## MEMORY ALLOCATION ## - (Dynamic Array)
+	long arrSize = (((long)(*peopleCounter) + 1) * ((long)sizeof(Person)));
+	if (arrSize >= *arrSizeWithBuffer) // '>' only at first iteration.
+	{
+		//	An array in the RunArena (that outgrew its estimate) can't be reallocated, so it is moved out of it:
+		int isInArena = runArenaContains(runArena, *peopleArray);
+		Person *temporaryArrayPointer = (Person *) (isInArena ? malloc(2 * arrSize) :
+													realloc(*peopleArray, 2 * arrSize));
+		if (temporaryArrayPointer == NULL)
+		{
+			error(STATUS_CODE_FAIL);
+			return STATUS_CODE_FAIL;
+		}
+		if (isInArena)
+		{
+			memcpy(temporaryArrayPointer, *peopleArray, (size_t) (*peopleCounter) * sizeof(Person));
+		}
+		*arrSizeWithBuffer = (2 * arrSize);
+		(*peopleArray) = temporaryArrayPointer;
+	}
+	
+	(*peopleArray)[*peopleCounter] = *personReceiver;
+	(*peopleCounter)++;
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief The function reads the peopleFile line by line through stdio, copying the names into nameArena.
+ * @details Used for files that can't be mapped (pipes, devices, etc.).
+ * @note The function doesn't OPEN or CLOSE the file.
+ * @param[in] peopleFile the opened peopleFile.
+ * @param[in] peopleArray pointer to the array of people. Being allocated.
+ * @param[in] peopleCounter number of people in the array.
+ * @param[in] nameArena the arena which holds the names of the people. Being allocated.
+ * @param[in] peopleRuns the ID-ordered runs of the array. Tracked as the people are added.
+ * @param[out] STATUS_CODE_SUCCESS If reading was successful.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode peopleReadStream(FILE *peopleFile, Person **peopleArray, unsigned int *peopleCounter,
+								   NameArena *nameArena, PeopleRuns *peopleRuns)
+{
+	// ## INITIATION OF RESOURCES ##
+	char lineToRead[INPUT_MAX_LINE_LEN] = {0};
+	Person personReceiver = {0};
+	long arrSizeWithBuffer = peopleArrayReserve(peopleArray, &nameArena->runArena);
+	
+	// ## PROCCESSING INPUT ## - Start reading line by line, allocating Data in an dynamic array:
+	while (fgets(lineToRead, INPUT_MAX_LINE_LEN, peopleFile))
+	{
+		// Replace the 'new line' from the string (the last line may have none), and skip blank lines:
+		size_t lineLength = strlen(lineToRead);
+		if ((lineLength > 0) && (lineToRead[lineLength - 1] == '\n'))
+		{
+			lineToRead[--lineLength] = '\0';
+		}
+		if (peopleLineStart(lineToRead, lineToRead + lineLength) == lineToRead + lineLength)
+		{
+			continue;
+		}
+		if (parsePersonLine(&personReceiver, nameArena, lineToRead) != STATUS_CODE_SUCCESS)
+		{
+			return STATUS_CODE_FAIL;
+		}
+		
+		if (peopleArrayAppend(peopleArray, peopleCounter, &arrSizeWithBuffer, &personReceiver,
+							  &nameArena->runArena) != STATUS_CODE_SUCCESS)
+		{
+			return STATUS_CODE_FAIL;
+		}
+		peopleRunsTrack(peopleRuns, personReceiver.id, *peopleCounter - 1);
+		
+		memset(&personReceiver, 0, sizeof(personReceiver));
+		memset(lineToRead, 0, sizeof(lineToRead));
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief The function maps the peopleFile to memory and scans it in place.
+ * @details The names aren't copied: nameArena is set to point into the mapping, which is released
+ * with nameArenaFree.
+ * @note The function doesn't CLOSE peopleFd. The mapping stays valid after it is closed.
+ * @param[in] peopleFd the opened peopleFile descriptor. Must be a regular file.
+ * @param[in] fileSize the size of the peopleFile. must be positive.
+ * @param[in] peopleArray pointer to the array of people. Being allocated.
+ * @param[in] peopleCounter number of people in the array.
+ * @param[in] nameArena the arena which holds the names of the people. Being mapped.
+ * @param[in] peopleRuns the ID-ordered runs of the array. Tracked as the people are added.
+ * @param[out] STATUS_CODE_SUCCESS If reading was successful.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+static StatusCode peopleReadMapped(int peopleFd, size_t fileSize, Person **peopleArray, unsigned int *peopleCounter,
+								   NameArena *nameArena, PeopleRuns *peopleRuns)
+{
+	// ## MAP INPUT FILE ## - The whole file, read only:
+	char *mappedFile = (char *) mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, peopleFd, 0);
+	if (mappedFile == MAP_FAILED)
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	posix_madvise(mappedFile, fileSize, POSIX_MADV_SEQUENTIAL);
+	nameArena->names = mappedFile;
+	nameArena->length = fileSize;
+	nameArena->mappedBase = mappedFile;
+	nameArena->mappedSize = fileSize;
+	
+	// ## INITIATION OF RESOURCES ##
+	const char *lineStart = mappedFile;
+	const char *fileEnd = mappedFile + fileSize;
+	const char *lineEnd = NULL;
+	Person personReceiver = {0};
+	long arrSizeWithBuffer = peopleArrayReserve(peopleArray, &nameArena->runArena);
+	
+	// ## PROCCESSING INPUT ## - Scanning line by line, allocating Data in an dynamic array:
+	while (lineStart < fileEnd)
+	{
+		lineEnd = (const char *) memchr(lineStart, '\n', (size_t) (fileEnd - lineStart));
+		if (lineEnd == NULL)
+		{
+			lineEnd = fileEnd;	// Last line, without a 'new line'.
+		}
+		
+		//	Blank lines are skipped:
+		lineStart = peopleLineStart(lineStart, lineEnd);
+		if (lineStart < lineEnd)
+		{
+			if (parseMappedPersonLine(&personReceiver, mappedFile, lineStart, lineEnd) != STATUS_CODE_SUCCESS)
+			{
+				return STATUS_CODE_FAIL;
+			}
+			
+			if (peopleArrayAppend(peopleArray, peopleCounter, &arrSizeWithBuffer, &personReceiver,
+								  &nameArena->runArena) != STATUS_CODE_SUCCESS)
+			{
+				return STATUS_CODE_FAIL;
+			}
+			peopleRunsTrack(peopleRuns, personReceiver.id, *peopleCounter - 1);
+		}
+		lineStart = lineEnd + 1;
+	}
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that checks whether an opened peopleFile is a snapshot, by its magic.
+ * @param[in] peopleFd the opened peopleFile descriptor. Must be a regular file.
+ * @param[in] fileSize the size of the peopleFile.
+ * @return 1 if the file starts with SNAPSHOT_MAGIC, 0 otherwise.
+ */
+static int isPeopleSnapshot(int peopleFd, size_t fileSize)
+{
+	char magic[SNAPSHOT_MAGIC_LEN];
+	if (fileSize < sizeof(PeopleSnapshotHeader))
+	{
+		return 0;
+	}
+	return ((pread(peopleFd, magic, SNAPSHOT_MAGIC_LEN, 0) == SNAPSHOT_MAGIC_LEN) &&
+			(memcmp(magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LEN) == 0));
+}
+
+
+/**
+ * @brief The function maps a snapshot of the peopleFile, and uses it in place.
+ * @details The mapping is private and writable, so peopleArray points straight into the record table (the
+ * severities are written copy-on-write, never to the file), and the names stay in the name blob. Nothing
+ * is parsed or sorted: the header and the records are only validated (the IDs must be sorted).
+ * @note The function doesn't CLOSE peopleFd. The mapping stays valid after it is closed, and is released
+ * with nameArenaFree.
+ * @param[in] peopleFd the opened snapshot descriptor. Must be a regular file.
+ * @param[in] fileSize the size of the snapshot.
+ * @param[in] peopleArray set to the record table.
+ * @param[in] peopleCounter set to the number of people in the snapshot.
+ * @param[in] nameArena the arena which holds the names of the people. Being mapped.
+ * @param[out] STATUS_CODE_SUCCESS If the snapshot was loaded.
+ * @param[out] STATUS_CODE_INPUT_ERROR If the snapshot couldn't be mapped, or is invalid.
+ */
+static StatusCode peopleLoadSnapshot(int peopleFd, size_t fileSize, Person **peopleArray, unsigned int *peopleCounter,
+									 NameArena *nameArena)
+{
+	// ## MAP INPUT FILE ##
+	char *mappedFile = (char *) mmap(NULL, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, peopleFd, 0);
+	if (mappedFile == MAP_FAILED)
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	nameArena->mappedBase = mappedFile;
+	nameArena->mappedSize = fileSize;
+	
+	// ## VALIDATE HEADER ##
+	const PeopleSnapshotHeader *header = (const PeopleSnapshotHeader *) mappedFile;
+	unsigned long long recordsEnd = sizeof(PeopleSnapshotHeader) +
+									((unsigned long long) header->peopleCount * sizeof(Person));
+	if ((header->version != SNAPSHOT_VERSION) || (header->byteOrderMark != SNAPSHOT_BYTE_ORDER_MARK) ||
+		(header->recordSize != sizeof(Person)) || (header->namesOffset != recordsEnd) ||
+		(header->namesSize > UINT_MAX) || ((header->namesOffset + header->namesSize) != fileSize))
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	nameArena->names = mappedFile + header->namesOffset;
+	nameArena->length = (size_t) header->namesSize;
+	
+	// ## VALIDATE RECORDS ##
+	Person *records = (Person *) (mappedFile + sizeof(PeopleSnapshotHeader));
+	unsigned int personIndex = 0;
+	for (personIndex = 0; personIndex < header->peopleCount; personIndex++)
+	{
+		const Person *curPerson = records + personIndex;
+		if (((unsigned long long) curPerson->nameOffset + curPerson->nameLength > header->namesSize) ||
+			(curPerson->id == 0) || ((personIndex > 0) && (curPerson[-1].id > curPerson->id)))
+		{
+			error(STATUS_CODE_INPUT_ERROR);
+			return STATUS_CODE_INPUT_ERROR;
+		}
+	}
+	*peopleArray = records;
+	*peopleCounter = header->peopleCount;
+	return STATUS_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief A function that writes a snapshot of the People-Array.
+ * @details Layout: a PeopleSnapshotHeader, the records (sorted by ID, with their severities zeroed and the
+ * name offsets relative to the blob), and the name blob - the names, back to back. The file is written
+ * next to snapshotPath and renamed over it only once complete.
+ * @param[in] snapshotPath the path of the snapshot.
+ * @param[in] peopleArray the array of people, sorted by ID.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] nameArena the arena which holds the names of the people.
+ * @param[out] STATUS_CODE_SUCCESS If the snapshot was written.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode writePeopleSnapshot(const char *snapshotPath, const Person *peopleArray, unsigned int peopleCounter,
+							   const NameArena *nameArena)
+{
+	// ## HEADER ## - the total size of the names is known in advance:
+	PeopleSnapshotHeader header;
+	unsigned int personIndex = 0;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LEN);
+	header.version = SNAPSHOT_VERSION;
+	header.byteOrderMark = SNAPSHOT_BYTE_ORDER_MARK;
+	header.recordSize = sizeof(Person);
+	header.peopleCount = peopleCounter;
+	header.namesOffset = sizeof(PeopleSnapshotHeader) + ((unsigned long long) peopleCounter * sizeof(Person));
+	for (personIndex = 0; personIndex < peopleCounter; personIndex++)
+	{
+		header.namesSize += peopleArray[personIndex].nameLength;
+	}
+	if (header.namesSize > UINT_MAX)
+	{
+		error(STATUS_CODE_OUTPUT_ERROR);
+		return STATUS_CODE_OUTPUT_ERROR;
+	}
+	
+	// ## OPEN OUTPUT FILE ## - a temporary one, renamed when complete:
+	char *temporaryPath = NULL;
+	OutputWriter outputWriter = {0};
+	StatusCode retValOpen = temporaryFileOpen(snapshotPath, &temporaryPath, &outputWriter);
+	if (retValOpen != STATUS_CODE_SUCCESS)
+	{
+		return retValOpen;
+	}
+	
+	// ## WRITE ## - header, records, names:
+	StatusCode retValWrite = outputWriterAppend(&outputWriter, (const char *) &header, sizeof(header));
+	unsigned int nameOffset = 0;
+	for (personIndex = 0; (personIndex < peopleCounter) && (retValWrite == STATUS_CODE_SUCCESS); personIndex++)
+	{
+		Person record = peopleArray[personIndex];
+		record.severity = 0;
+		record.nameOffset = nameOffset;
+		nameOffset += record.nameLength;
+		retValWrite = outputWriterAppend(&outputWriter, (const char *) &record, sizeof(record));
+	}
+	for (personIndex = 0; (personIndex < peopleCounter) && (retValWrite == STATUS_CODE_SUCCESS); personIndex++)
+	{
+		retValWrite = outputWriterAppend(&outputWriter, nameArena->names + peopleArray[personIndex].nameOffset,
+										 peopleArray[personIndex].nameLength);
+	}
+	
+	// ## CLOSE OUTPUT FILE ## - and replace the old snapshot:
+	return temporaryFileCommit(snapshotPath, temporaryPath, &outputWriter, retValWrite);
+}
+
+
+/**
+ * @brief The function reads, process, and sorts (By ID) the peopleFile.
+ * @details Snapshots (see writePeopleSnapshot) are mapped and used as they are (peopleLoadSnapshot). Other
+ * regular files are mapped to memory and scanned in place (peopleReadMapped). Other files are read line by
+ * line (peopleReadStream). The People-Array of a regular text file is allocated in nameArena's RunArena,
+ * sized by the file, so it isn't reallocated as it grows.
+ * @note Including OPEN and CLOSE of the file.
+ * @note The function ALLOCATES MEMORY being stored in peopleArray and nameArena - vars declared outside,
+ * and being used later in the program.
+ * @note peopleArray's and nameArena's memory is NOT released in that function, even in failure. They are
+ * released by peopleArrayFree and nameArenaFree (which releases the RunArena).
+ * @details Using Dynamic Array Method while allocating new memory, to save running time complexity.
+ * @param[in] meetingFilePath argv path for the file.
+ * @param[in] peopleArray pointer to the array of people (The Data Structure being used). Being allocated.
+ * @param[in] peopleCounter number of people in the DS, used for sorting, calculation, and later in program.
+ * @param[in] nameArena the arena which holds the names of the people. Being allocated.
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If processing was successful.
+ * @param[out] STATUS_CODE_EMPTY_FILE If the people's file is empty.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode peopleProcessAndSort(const char* peopleFilePath, Person **peopleArray, unsigned int *peopleCounter,
+								NameArena *nameArena, const RunOptions *runOptions)
+{
+	// ## OPEN INPUT FILE ## - Open peopleFile & Checking Existence:
+	int peopleFd = open(peopleFilePath, O_RDONLY);
+	if (peopleFd == FILE_DO_NOT_EXIST)
+	{
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	struct stat peopleFileStat;
+	if (fstat(peopleFd, &peopleFileStat) != 0)
+	{
+		close(peopleFd);
+		error(STATUS_CODE_INPUT_ERROR);
+		return STATUS_CODE_INPUT_ERROR;
+	}
+	
+	// ## PROCCESSING INPUT ## - Use snapshots in place, map regular files (name offsets must fit an unsigned
+	//	int), stream the rest - and compressed files, through their decompressor:
+	StatusCode retValRead = STATUS_CODE_SUCCESS;
+	int isSorted = 0;
+	PeopleRuns peopleRuns = {1, 0, {0}};	// A single run, until an ID is smaller than the one before it.
+	Compression peopleCompression = detectCompression(peopleFd);
+	int isSnapshot = ((peopleCompression == COMPRESSION_NONE) && S_ISREG(peopleFileStat.st_mode) &&
+					  isPeopleSnapshot(peopleFd, (size_t) peopleFileStat.st_size));
+	
+	//	## RESERVE RUN ARENA ## - A text file's size bounds its people (the size of a compressed one doesn't):
+	if (!isSnapshot && (peopleCompression == COMPRESSION_NONE) && S_ISREG(peopleFileStat.st_mode))
+	{
+		runArenaReserve(&nameArena->runArena, (unsigned long long) peopleFileStat.st_size);
+	}
+	
+	if (isSnapshot)
+	{
+		retValRead = peopleLoadSnapshot(peopleFd, (size_t) peopleFileStat.st_size, peopleArray, peopleCounter,
+										nameArena);
+		isSorted = 1;
+		
+		//	## CLOSE INPUT FILE ##
+		if (close(peopleFd) != 0)
+		{
+			error(STATUS_CODE_INPUT_ERROR);
+			return STATUS_CODE_INPUT_ERROR;
+		}
+	}
+	else if ((peopleCompression == COMPRESSION_NONE) && S_ISREG(peopleFileStat.st_mode) &&
+			 (peopleFileStat.st_size > 0) && ((unsigned long long) peopleFileStat.st_size <= UINT_MAX))
+	{
+		retValRead = peopleReadMapped(peopleFd, (size_t) peopleFileStat.st_size, peopleArray, peopleCounter,
+									  nameArena, &peopleRuns);
+		
+		//	## CLOSE INPUT FILE ##
+		if (close(peopleFd) != 0)
+		{
+			error(STATUS_CODE_INPUT_ERROR);
+			return STATUS_CODE_INPUT_ERROR;
+		}
+	}
+	else
+	{
+		Decompressor decompressor = {0};
+		FILE* peopleFile = (peopleCompression == COMPRESSION_NONE) ? fdopen(peopleFd, "r") :
+						   decompressorOpen(peopleFd, peopleCompression, &decompressor);
+		if (peopleFile == NULL)
+		{
+			if (peopleCompression == COMPRESSION_NONE)
+			{
+				close(peopleFd);
+			}
+			error(STATUS_CODE_INPUT_ERROR);
+			return STATUS_CODE_INPUT_ERROR;
+		}
+		retValRead = peopleReadStream(peopleFile, peopleArray, peopleCounter, nameArena, &peopleRuns);
+		
+		//	## CLOSE INPUT FILE ## - a failed read was already reported (a decompressor fails as well):
+		if ((inputFileClose(peopleFile, &decompressor) != STATUS_CODE_SUCCESS) && (retValRead == STATUS_CODE_SUCCESS))
+		{
+			error(STATUS_CODE_INPUT_ERROR);
+			return STATUS_CODE_INPUT_ERROR;
+		}
+		peopleFile = NULL;
+	}
+	
+	if (retValRead != STATUS_CODE_SUCCESS)
+	{
+		return retValRead;
+	}
+	
+	//	## EMPTY PEOPLE FILE SCENARIO ##
+	if ((*peopleCounter) == 0)
+	{
+		return STATUS_CODE_EMPTY_FILE;
+	}
+	
+	runStatsCount(runOptions->runStats, STATS_PHASE_PEOPLE, (unsigned long long) peopleFileStat.st_size,
+				  *peopleCounter, 0);
+	
+	//	## SORT 1 ## -  Array of People by ID (a snapshot is already sorted, and so may be the file - see
+	//	sortPeopleRuns):
+	if (!isSorted)
+	{
+		sortPeopleRuns(*peopleArray, *peopleCounter, &peopleRuns, resolveThreadCount(runOptions->threadCount));
+	}
+	
+	return STATUS_CODE_SUCCESS;
+}
+
+
@@ -0,0 +1,161 @@
+/*
+ * File Name: SpreaderDetectorPeople.h
+ * Related Files: "SpreaderDetectorPeople.c", "SpreaderDetectorInternal.h"
+ *
+ * Purpose:
+ * 			The functions of SpreaderDetectorPeople.c which the other modules of the SpreaderDetector library
+ * 			use. They are internal (hidden): the API of the library is SpreaderDetector.h.
+ *
+ * Author's ID: 206174120
+ * Author's Name: Oren Kovartovsky
+ * University User Name: orenkov
+ *
+ * */
+
+#ifndef SPREADERDETECTORPEOPLE_H
+#define SPREADERDETECTORPEOPLE_H
+
+#include "SpreaderDetectorInternal.h"
+
+#if defined(__GNUC__)
+#pragma GCC visibility push(hidden)
+#endif
+
+//	****** NAME ARENA FUNCTIONS ******
+/**
+ * @brief A function that copies a name into the end of the NameArena.
+ *
+ * @details Using Dynamic Array Method while allocating new memory, to save running time complexity.
+ * @param[in] nameArena the arena to append the name to.
+ * @param[in] name a pointer to the beginning of the name (doesn't have to be '\0' terminated).
+ * @param[in] nameLength the length of the name.
+ * @param[in] personReceiver the person whose nameOffset and nameLength are set to the stored name.
+ * @param[out] STATUS_CODE_SUCCESS If the name was stored successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode nameArenaAppend(NameArena *nameArena, const char *name, size_t nameLength, Person *personReceiver);
+
+/**
+ * @brief A function that releases the memory held by the NameArena.
+ * @details If the arena points into a file mapping, the mapping is unmapped. The RunArena is released too.
+ * @param[in] nameArena the arena to release. May be empty.
+ */
+void nameArenaFree(NameArena *nameArena);
+
+/**
+ * @brief A function that releases the People-Array.
+ *
+ * @details A People-Array loaded from a snapshot lies inside the arena's file mapping, and one read from a
+ * text file in its RunArena - both are released with the arena (by nameArenaFree) instead.
+ * @param[in] peopleArray the array of people. May be NULL.
+ * @param[in] nameArena the arena which holds the names of the people. Must not be released yet.
+ */
+void peopleArrayFree(Person *peopleArray, const NameArena *nameArena);
+
+
+//	****** PEOPLE INDEX FUNCTIONS ******
+/**
+ * @brief A function that builds the ID hash index of the People-Array.
+ *
+ * @details The table's capacity is at least twice the number of people, so probe sequences stay short.
+ * @note The function ALLOCATES MEMORY being stored in peopleIndex (in runArena, if it has room). released by
+ * peopleIndexFree.
+ * @param[in] peopleIndex the index to build.
+ * @param[in] peopleArray the array of people, sorted by ID.
+ * @param[in] peopleCounter the amount of the people in peopleArray.
+ * @param[in] runArena the arena to allocate the table in. May be NULL - the table is heap allocated.
+ * @param[out] STATUS_CODE_SUCCESS If the index was built successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode peopleIndexBuild(PeopleIndex *peopleIndex, const Person *peopleArray, unsigned int peopleCounter,
+							RunArena *runArena);
+
+/**
+ * @brief A function that finds a person in the People-Array by his ID.
+ * @param[in] peopleIndex the index of the People-Array.
+ * @param[in] peopleArray the array of people the index was built from.
+ * @param[in] id the ID to search for.
+ * @return a pointer to the person in peopleArray, or NULL if there is no person with that ID.
+ */
+Person *peopleIndexLookup(const PeopleIndex *peopleIndex, Person *peopleArray, int id);
+
+/**
+ * @brief A function that releases the memory held by the PeopleIndex (a table in a RunArena is released with it).
+ * @param[in] peopleIndex the index to release. May be empty.
+ */
+void peopleIndexFree(PeopleIndex *peopleIndex);
+
+
+//	****** PEOPLE PARSING / PROCESSING FUNCTIONS ******
+/**
+ * @brief A function that skips the leading spaces of a line of the peopleFile. It is the blank-line rule of
+ * every people reader (stdio, mapped and external): a line which is empty, or holds only spaces, is skipped -
+ * so the people don't depend on how the file is read.
+ *
+ * @param[in] lineStart a pointer to the beginning of the line.
+ * @param[in] lineEnd a pointer to the end of the line (not included).
+ * @return a pointer to the first character of the line which isn't a space. lineEnd - the line is blank.
+ */
+const char *peopleLineStart(const char *lineStart, const char *lineEnd);
+
+/**
+ * @brief A function that parsing a line of the peopleFile in place, inside the file mapping.
+ *
+ * @details The name isn't copied: the person's nameOffset points to it inside the mapping.
+ * @param[in] personReceiver holds all the variables that gonna be 'fed' with the data in the line.
+ * @param[in] mappedFile a pointer to the beginning of the file mapping.
+ * @param[in] lineStart a pointer to the beginning of the line.
+ * @param[in] lineEnd a pointer to the end of the line (the '\n', or the end of the mapping).
+ * @param[out] STATUS_CODE_SUCCESS If data was stored successfully.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode parseMappedPersonLine(Person *personReceiver, const char *mappedFile,
+								 const char *lineStart, const char *lineEnd);
+
+/**
+ * @brief A function that writes a snapshot of the People-Array.
+ *
+ * @details Layout: a PeopleSnapshotHeader, the records (sorted by ID, with their severities zeroed and the
+ * name offsets relative to the blob), and the name blob - the names, back to back. The file is written
+ * next to snapshotPath and renamed over it only once complete.
+ * @param[in] snapshotPath the path of the snapshot.
+ * @param[in] peopleArray the array of people, sorted by ID.
+ * @param[in] peopleCounter the amount of people in the array.
+ * @param[in] nameArena the arena which holds the names of the people.
+ * @param[out] STATUS_CODE_SUCCESS If the snapshot was written.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode writePeopleSnapshot(const char *snapshotPath, const Person *peopleArray, unsigned int peopleCounter,
+							   const NameArena *nameArena);
+
+/**
+ * @brief The function reads, process, and sorts (By ID) the peopleFile.
+ *
+ * @details Snapshots (see writePeopleSnapshot) are mapped and used as they are (peopleLoadSnapshot). Other
+ * regular files are mapped to memory and scanned in place (peopleReadMapped). Other files are read line by
+ * line (peopleReadStream). The People-Array of a regular text file is allocated in nameArena's RunArena,
+ * sized by the file, so it isn't reallocated as it grows.
+ * @note Including OPEN and CLOSE of the file.
+ * @note The function ALLOCATES MEMORY being stored in peopleArray and nameArena - vars declared outside,
+ * and being used later in the program.
+ * @note peopleArray's and nameArena's memory is NOT released in that function, even in failure. They are
+ * released by peopleArrayFree and nameArenaFree (which releases the RunArena).
+ * @details Using Dynamic Array Method while allocating new memory, to save running time complexity.
+ * @param[in] meetingFilePath argv path for the file.
+ * @param[in] peopleArray pointer to the array of people (The Data Structure being used). Being allocated.
+ * @param[in] peopleCounter number of people in the DS, used for sorting, calculation, and later in program.
+ * @param[in] nameArena the arena which holds the names of the people. Being allocated.
+ * @param[in] runOptions the options the program was run with.
+ * @param[out] STATUS_CODE_SUCCESS If processing was successful.
+ * @param[out] STATUS_CODE_EMPTY_FILE If the people's file is empty.
+ * @param[out] StatusCode - If ERROR occurred, ERROR/FAILURE returns depends on the error.
+ */
+StatusCode peopleProcessAndSort(const char* peopleFilePath, Person **peopleArray, unsigned int *peopleCounter,
+								NameArena *nameArena, const RunOptions *runOptions);
+
+
+#if defined(__GNUC__)
+#pragma GCC visibility pop
+#endif
+
+#endif //SPREADERDETECTORPEOPLE_H
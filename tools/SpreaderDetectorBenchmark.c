@@ -0,0 +1,531 @@
+/*
+ * File Name: SpreaderDetectorBenchmark.c
+ * Related Files: "SpreaderDetectorGenerator.c", "../SpreaderDetectorBackend.c"
+ *
+ * Purpose:
+ * 			An end-to-end benchmark of the SpreaderDetectorBackend. For every workload size, generates the
+ * 			input with the SpreaderDetectorGenerator, runs the backend on it (timing it and measuring its
+ * 			peak RSS), and compares the output with the one of a reference backend.
+ *
+ * */
+
+#define _DEFAULT_SOURCE
+
+// ------------------------------ includes ------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+// -------------------------- const definitions -------------------------
+#define ARGS_MIN_COUNT 4
+#define ARG_BACKEND 1
+#define ARG_GENERATOR 2
+#define ARG_WORK_DIR 3
+#define ARG_FIRST_OPTION 4
+
+#define OPTION_SIZES "--sizes"
+#define OPTION_FAN_OUT "--fanout"
+#define OPTION_DEPTH "--depth"
+#define OPTION_REFERENCE "--reference"
+#define OPTION_BACKEND_ARGS "--"
+
+#define DEFAULT_SIZES "1000,10000,100000,1000000,10000000,50000000"
+#define DEFAULT_FAN_OUT "8"
+#define DEFAULT_DEPTH "64"
+#define MAX_SIZES 32
+#define MAX_BACKEND_ARGS 32
+#define MAX_PATH_LEN 4096
+#define COMPARE_BUFFER_SIZE (1 << 16)
+#define KILOBYTES_IN_MEGABYTE 1024.0
+#define NANOSECONDS_IN_SECOND 1e9
+
+#define PEOPLE_FILE_NAME "People.in"
+#define MEETINGS_FILE_NAME "Meetings.in"
+#define OUTPUT_FILE_NAME "SpreaderDetectorAnalysis.out"
+#define CANDIDATE_DIR_NAME "candidate"
+#define REFERENCE_DIR_NAME "reference"
+
+#define ERROR_ARGS "Usage: ./SpreaderDetectorBenchmark <Backend> <Generator> <Work Directory> " \
+				   "[--sizes <N,N,...>] [--fanout <F>] [--depth <D>] [--reference <Reference Backend>] " \
+				   "[-- <Backend Options>]\n"
+#define ERROR_RUN "Error: %s failed on %lu people.\n"
+#define ERROR_WORK_DIR "Error: can't prepare the work directory.\n"
+#define ERROR_PATH "Error: can't resolve %s.\n"
+
+/*
+ * ***************************
+ * 	STRUCTS AND ENUMS
+ * ***************************
+ */
+/**
+ * @brief A struct represents the parameters of a benchmark.
+ */
+typedef struct _BenchmarkParams
+{
+	const char *backendPath;		/**< The backend being measured */
+	const char *generatorPath;		/**< The SpreaderDetectorGenerator */
+	const char *referencePath;		/**< The backend whose output is trusted. NULL for no reference */
+	const char *workDir;			/**< Where the workloads and the outputs are written */
+	const char *fanOut;				/**< Passed to the generator */
+	const char *depth;				/**< Passed to the generator */
+	unsigned long sizes[MAX_SIZES];	/**< The workload sizes, in people */
+	size_t sizeCount;				/**< Number of sizes */
+	char *backendArgs[MAX_BACKEND_ARGS];	/**< Extra options of the measured backend */
+	size_t backendArgCount;			/**< Number of extra options */
+	char backendRealPath[PATH_MAX];		/**< The absolute path of the backend (see resolvePaths) */
+	char generatorRealPath[PATH_MAX];	/**< The absolute path of the generator */
+	char referenceRealPath[PATH_MAX];	/**< The absolute path of the reference backend */
+	char workRealPath[PATH_MAX];		/**< The absolute path of the work directory */
+} BenchmarkParams;
+
+/**
+ * @brief A struct represents the measurements of a single run.
+ */
+typedef struct _RunResult
+{
+	double seconds;				/**< Wall clock time */
+	double peakRssMegabytes;	/**< Peak resident set size of the child */
+} RunResult;
+
+
+/*
+ * ***********************
+ * 	DECLARATIONS
+ * ***********************
+ */
+/**
+ * @brief A function that runs a program to completion, and measures it.
+ *
+ * @param[in] argv the program and its arguments, NULL terminated.
+ * @param[in] runDir the directory the program runs in. NULL for the current one.
+ * @param[in] runResult receives the measurements. May be NULL.
+ * @return 0 if the program exited with 0, -1 otherwise.
+ */
+int runMeasured(char *const argv[], const char *runDir, RunResult *runResult);
+
+/**
+ * @brief A function that checks whether two files have identical contents.
+ *
+ * @param[in] firstPath the first file.
+ * @param[in] secondPath the second file.
+ * @return 1 if the files are identical, 0 otherwise (or if one can't be read).
+ */
+int filesIdentical(const char *firstPath, const char *secondPath);
+
+/**
+ * @brief A function that runs a backend on the workload in workDir, from runDir.
+ *
+ * @param[in] backendPath the backend.
+ * @param[in] extraArgs extra options of the backend.
+ * @param[in] extraArgCount number of extra options.
+ * @param[in] workDir the directory of People.in and Meetings.in.
+ * @param[in] runDir the directory the output is written in.
+ * @param[in] runResult receives the measurements.
+ * @return 0 on success, -1 otherwise.
+ */
+int runBackend(const char *backendPath, char *const extraArgs[], size_t extraArgCount,
+			   const char *workDir, const char *runDir, RunResult *runResult);
+
+/**
+ * @brief A function that benchmarks a single workload size, and prints its row of the table.
+ *
+ * @param[in] benchmarkParams the parameters of the benchmark.
+ * @param[in] peopleCount the workload size.
+ * @return 0 on success (and matching outputs), -1 otherwise.
+ */
+int benchmarkSize(const BenchmarkParams *benchmarkParams, unsigned long peopleCount);
+
+/**
+ * @brief A function that replaces a path with its absolute path.
+ *
+ * @param[in] path the path to replace. Left as it is if it can't be resolved.
+ * @param[in] realPath receives the absolute path. Must have room for PATH_MAX characters.
+ * @return 0 if the path was resolved, -1 otherwise (and an error is printed).
+ */
+int resolvePath(const char **path, char *realPath);
+
+/**
+ * @brief A function that makes the paths of the programs, and of the work directory, absolute.
+ *
+ * @details The backends run in their own output directories, so a relative path would point elsewhere there.
+ * @param[in] benchmarkParams the parameters of the benchmark. The work directory must exist.
+ * @return 0 if every path was resolved, -1 otherwise.
+ */
+int resolvePaths(BenchmarkParams *benchmarkParams);
+
+/**
+ * @brief A function that parses the command line arguments.
+ *
+ * @param[in] argc number of arguments.
+ * @param[in] argv the arguments.
+ * @param[in] benchmarkParams receives the parameters.
+ * @return 0 if the arguments are valid, -1 otherwise.
+ */
+int parseArguments(int argc, char *argv[], BenchmarkParams *benchmarkParams);
+
+
+/*
+ * ***********************
+ * 	DEFINITIONS
+ * ***********************
+ */
+/**
+ * @brief A function that runs a program to completion, and measures it.
+ * @param[in] argv the program and its arguments, NULL terminated.
+ * @param[in] runDir the directory the program runs in. NULL for the current one.
+ * @param[in] runResult receives the measurements. May be NULL.
+ * @return 0 if the program exited with 0, -1 otherwise.
+ */
+int runMeasured(char *const argv[], const char *runDir, RunResult *runResult)
+{
+	struct timespec startTime, endTime;
+	struct rusage childUsage;
+	int childStatus = 0;
+	clock_gettime(CLOCK_MONOTONIC, &startTime);
+	pid_t childPid = fork();
+	if (childPid < 0)
+	{
+		return -1;
+	}
+	if (childPid == 0)
+	{
+		int nullFd = open("/dev/null", O_WRONLY);
+		if (nullFd >= 0)
+		{
+			dup2(nullFd, STDOUT_FILENO);
+			close(nullFd);
+		}
+		if ((runDir != NULL) && (chdir(runDir) != 0))
+		{
+			_exit(EXIT_FAILURE);
+		}
+		execv(argv[0], argv);
+		_exit(EXIT_FAILURE);
+	}
+	if (wait4(childPid, &childStatus, 0, &childUsage) != childPid)
+	{
+		return -1;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &endTime);
+	
+	if (runResult != NULL)
+	{
+		runResult->seconds = (double) (endTime.tv_sec - startTime.tv_sec) +
+							 (double) (endTime.tv_nsec - startTime.tv_nsec) / NANOSECONDS_IN_SECOND;
+		runResult->peakRssMegabytes = (double) childUsage.ru_maxrss / KILOBYTES_IN_MEGABYTE;
+	}
+	return ((WIFEXITED(childStatus) && (WEXITSTATUS(childStatus) == 0)) ? 0 : -1);
+}
+
+
+/**
+ * @brief A function that checks whether two files have identical contents.
+ * @param[in] firstPath the first file.
+ * @param[in] secondPath the second file.
+ * @return 1 if the files are identical, 0 otherwise (or if one can't be read).
+ */
+int filesIdentical(const char *firstPath, const char *secondPath)
+{
+	static char firstBuffer[COMPARE_BUFFER_SIZE], secondBuffer[COMPARE_BUFFER_SIZE];
+	FILE *firstFile = fopen(firstPath, "rb");
+	FILE *secondFile = fopen(secondPath, "rb");
+	int isIdentical = ((firstFile != NULL) && (secondFile != NULL));
+	while (isIdentical)
+	{
+		size_t firstRead = fread(firstBuffer, 1, COMPARE_BUFFER_SIZE, firstFile);
+		size_t secondRead = fread(secondBuffer, 1, COMPARE_BUFFER_SIZE, secondFile);
+		if ((firstRead != secondRead) || (memcmp(firstBuffer, secondBuffer, firstRead) != 0))
+		{
+			isIdentical = 0;
+		}
+		else if (firstRead == 0)
+		{
+			break;
+		}
+	}
+	if (firstFile != NULL)
+	{
+		fclose(firstFile);
+	}
+	if (secondFile != NULL)
+	{
+		fclose(secondFile);
+	}
+	return isIdentical;
+}
+
+
+/**
+ * @brief A function that runs a backend on the workload in workDir, from runDir.
+ * @param[in] backendPath the backend.
+ * @param[in] extraArgs extra options of the backend.
+ * @param[in] extraArgCount number of extra options.
+ * @param[in] workDir the directory of People.in and Meetings.in.
+ * @param[in] runDir the directory the output is written in.
+ * @param[in] runResult receives the measurements.
+ * @return 0 on success, -1 otherwise.
+ */
+int runBackend(const char *backendPath, char *const extraArgs[], size_t extraArgCount,
+			   const char *workDir, const char *runDir, RunResult *runResult)
+{
+	char peoplePath[MAX_PATH_LEN], meetingsPath[MAX_PATH_LEN];
+	char *backendArgv[MAX_BACKEND_ARGS + 4];
+	size_t argIndex = 0, extraIndex = 0;
+	if (((mkdir(runDir, 0777) != 0) && (access(runDir, W_OK) != 0)) ||
+		(snprintf(peoplePath, MAX_PATH_LEN, "%s/%s", workDir, PEOPLE_FILE_NAME) >= MAX_PATH_LEN) ||
+		(snprintf(meetingsPath, MAX_PATH_LEN, "%s/%s", workDir, MEETINGS_FILE_NAME) >= MAX_PATH_LEN))
+	{
+		return -1;
+	}
+	
+	backendArgv[argIndex++] = (char *) backendPath;
+	for (extraIndex = 0; extraIndex < extraArgCount; extraIndex++)
+	{
+		backendArgv[argIndex++] = extraArgs[extraIndex];
+	}
+	backendArgv[argIndex++] = peoplePath;
+	backendArgv[argIndex++] = meetingsPath;
+	backendArgv[argIndex] = NULL;
+	return runMeasured(backendArgv, runDir, runResult);
+}
+
+
+/**
+ * @brief A function that benchmarks a single workload size, and prints its row of the table.
+ * @param[in] benchmarkParams the parameters of the benchmark.
+ * @param[in] peopleCount the workload size.
+ * @return 0 on success (and matching outputs), -1 otherwise.
+ */
+int benchmarkSize(const BenchmarkParams *benchmarkParams, unsigned long peopleCount)
+{
+	char sizeDir[MAX_PATH_LEN], peoplePath[MAX_PATH_LEN], meetingsPath[MAX_PATH_LEN], countText[32];
+	char candidateDir[MAX_PATH_LEN], referenceDir[MAX_PATH_LEN];
+	char candidateOutput[MAX_PATH_LEN], referenceOutput[MAX_PATH_LEN];
+	RunResult candidateResult, referenceResult;
+	const char *verdict = "-";
+	
+	// ## PREPARE THE DIRECTORIES ##
+	snprintf(countText, sizeof(countText), "%lu", peopleCount);
+	if ((snprintf(sizeDir, MAX_PATH_LEN, "%s/%lu", benchmarkParams->workDir, peopleCount) >= MAX_PATH_LEN) ||
+		(snprintf(peoplePath, MAX_PATH_LEN, "%s/%s", sizeDir, PEOPLE_FILE_NAME) >= MAX_PATH_LEN) ||
+		(snprintf(meetingsPath, MAX_PATH_LEN, "%s/%s", sizeDir, MEETINGS_FILE_NAME) >= MAX_PATH_LEN) ||
+		(snprintf(candidateDir, MAX_PATH_LEN, "%s/%s", sizeDir, CANDIDATE_DIR_NAME) >= MAX_PATH_LEN) ||
+		(snprintf(referenceDir, MAX_PATH_LEN, "%s/%s", sizeDir, REFERENCE_DIR_NAME) >= MAX_PATH_LEN) ||
+		(snprintf(candidateOutput, MAX_PATH_LEN, "%s/%s", candidateDir, OUTPUT_FILE_NAME) >= MAX_PATH_LEN) ||
+		(snprintf(referenceOutput, MAX_PATH_LEN, "%s/%s", referenceDir, OUTPUT_FILE_NAME) >= MAX_PATH_LEN) ||
+		((mkdir(sizeDir, 0777) != 0) && (access(sizeDir, W_OK) != 0)))
+	{
+		fprintf(stderr, ERROR_WORK_DIR);
+		return -1;
+	}
+	
+	// ## GENERATE THE WORKLOAD ##
+	char *generatorArgv[] = {(char *) benchmarkParams->generatorPath, countText,
+							 (char *) benchmarkParams->fanOut, (char *) benchmarkParams->depth,
+							 peoplePath, meetingsPath, NULL};
+	if (runMeasured(generatorArgv, NULL, NULL) != 0)
+	{
+		fprintf(stderr, ERROR_RUN, benchmarkParams->generatorPath, peopleCount);
+		return -1;
+	}
+	
+	// ## RUN THE REFERENCE, THEN THE CANDIDATE ##
+	if (benchmarkParams->referencePath != NULL)
+	{
+		if (runBackend(benchmarkParams->referencePath, NULL, 0, sizeDir, referenceDir, &referenceResult) != 0)
+		{
+			fprintf(stderr, ERROR_RUN, benchmarkParams->referencePath, peopleCount);
+			return -1;
+		}
+	}
+	if (runBackend(benchmarkParams->backendPath, benchmarkParams->backendArgs, benchmarkParams->backendArgCount,
+				   sizeDir, candidateDir, &candidateResult) != 0)
+	{
+		fprintf(stderr, ERROR_RUN, benchmarkParams->backendPath, peopleCount);
+		return -1;
+	}
+	
+	// ## REPORT ##
+	if (benchmarkParams->referencePath != NULL)
+	{
+		verdict = (filesIdentical(candidateOutput, referenceOutput) ? "OK" : "DIFF");
+		printf("%12lu %10.3f %14.0f %12.1f %10.3f %8s\n", peopleCount, candidateResult.seconds,
+			   (double) peopleCount / candidateResult.seconds, candidateResult.peakRssMegabytes,
+			   referenceResult.seconds, verdict);
+	}
+	else
+	{
+		printf("%12lu %10.3f %14.0f %12.1f %10s %8s\n", peopleCount, candidateResult.seconds,
+			   (double) peopleCount / candidateResult.seconds, candidateResult.peakRssMegabytes, "-", verdict);
+	}
+	fflush(stdout);
+	return ((strcmp(verdict, "DIFF") == 0) ? -1 : 0);
+}
+
+
+/**
+ * @brief A function that replaces a path with its absolute path.
+ * @param[in] path the path to replace. Left as it is if it can't be resolved.
+ * @param[in] realPath receives the absolute path. Must have room for PATH_MAX characters.
+ * @return 0 if the path was resolved, -1 otherwise (and an error is printed).
+ */
+int resolvePath(const char **path, char *realPath)
+{
+	if (realpath(*path, realPath) == NULL)
+	{
+		fprintf(stderr, ERROR_PATH, *path);
+		return -1;
+	}
+	*path = realPath;
+	return 0;
+}
+
+
+/**
+ * @brief A function that makes the paths of the programs, and of the work directory, absolute.
+ * @details The backends run in their own output directories, so a relative path would point elsewhere there.
+ * @param[in] benchmarkParams the parameters of the benchmark. The work directory must exist.
+ * @return 0 if every path was resolved, -1 otherwise.
+ */
+int resolvePaths(BenchmarkParams *benchmarkParams)
+{
+	if ((resolvePath(&benchmarkParams->backendPath, benchmarkParams->backendRealPath) != 0) ||
+		(resolvePath(&benchmarkParams->generatorPath, benchmarkParams->generatorRealPath) != 0) ||
+		(resolvePath(&benchmarkParams->workDir, benchmarkParams->workRealPath) != 0))
+	{
+		return -1;
+	}
+	if (benchmarkParams->referencePath != NULL)
+	{
+		return resolvePath(&benchmarkParams->referencePath, benchmarkParams->referenceRealPath);
+	}
+	return 0;
+}
+
+
+/**
+ * @brief A function that parses the command line arguments.
+ * @param[in] argc number of arguments.
+ * @param[in] argv the arguments.
+ * @param[in] benchmarkParams receives the parameters.
+ * @return 0 if the arguments are valid, -1 otherwise.
+ */
+int parseArguments(int argc, char *argv[], BenchmarkParams *benchmarkParams)
+{
+	const char *sizesText = DEFAULT_SIZES;
+	int argIndex = ARG_FIRST_OPTION;
+	if (argc < ARGS_MIN_COUNT)
+	{
+		return -1;
+	}
+	memset(benchmarkParams, 0, sizeof(BenchmarkParams));
+	benchmarkParams->backendPath = argv[ARG_BACKEND];
+	benchmarkParams->generatorPath = argv[ARG_GENERATOR];
+	benchmarkParams->workDir = argv[ARG_WORK_DIR];
+	benchmarkParams->fanOut = DEFAULT_FAN_OUT;
+	benchmarkParams->depth = DEFAULT_DEPTH;
+	
+	// ## OPTIONS ##
+	while (argIndex < argc)
+	{
+		const char *option = argv[argIndex];
+		if (strcmp(option, OPTION_BACKEND_ARGS) == 0)
+		{
+			for (argIndex++; argIndex < argc; argIndex++)
+			{
+				if (benchmarkParams->backendArgCount == MAX_BACKEND_ARGS)
+				{
+					return -1;
+				}
+				benchmarkParams->backendArgs[benchmarkParams->backendArgCount++] = argv[argIndex];
+			}
+			break;
+		}
+		if (argIndex + 1 >= argc)
+		{
+			return -1;
+		}
+		if (strcmp(option, OPTION_SIZES) == 0)
+		{
+			sizesText = argv[argIndex + 1];
+		}
+		else if (strcmp(option, OPTION_FAN_OUT) == 0)
+		{
+			benchmarkParams->fanOut = argv[argIndex + 1];
+		}
+		else if (strcmp(option, OPTION_DEPTH) == 0)
+		{
+			benchmarkParams->depth = argv[argIndex + 1];
+		}
+		else if (strcmp(option, OPTION_REFERENCE) == 0)
+		{
+			benchmarkParams->referencePath = argv[argIndex + 1];
+		}
+		else
+		{
+			return -1;
+		}
+		argIndex += 2;
+	}
+	
+	// ## SIZES ##
+	while (*sizesText != '\0')
+	{
+		char *checkPtr = NULL;
+		unsigned long size = strtoul(sizesText, &checkPtr, 10);
+		if ((checkPtr == sizesText) || (size == 0) || ((*checkPtr != ',') && (*checkPtr != '\0')) ||
+			(benchmarkParams->sizeCount == MAX_SIZES))
+		{
+			return -1;
+		}
+		benchmarkParams->sizes[benchmarkParams->sizeCount++] = size;
+		sizesText = ((*checkPtr == ',') ? checkPtr + 1 : checkPtr);
+	}
+	return ((benchmarkParams->sizeCount > 0) ? 0 : -1);
+}
+
+
+/**
+ * @brief The main function. Runs the benchmark of every size, and prints the results table.
+ * @param[in] argc number of arguments.
+ * @param[in] argv the arguments (see ERROR_ARGS).
+ * @return EXIT_SUCCESS if every run succeeded (and matched the reference), EXIT_FAILURE otherwise.
+ */
+int main(int argc, char *argv[])
+{
+	BenchmarkParams benchmarkParams;
+	int retVal = EXIT_SUCCESS;
+	size_t sizeIndex = 0;
+	if (parseArguments(argc, argv, &benchmarkParams) != 0)
+	{
+		fprintf(stderr, ERROR_ARGS);
+		return EXIT_FAILURE;
+	}
+	if ((mkdir(benchmarkParams.workDir, 0777) != 0) && (access(benchmarkParams.workDir, W_OK) != 0))
+	{
+		fprintf(stderr, ERROR_WORK_DIR);
+		return EXIT_FAILURE;
+	}
+	if (resolvePaths(&benchmarkParams) != 0)
+	{
+		return EXIT_FAILURE;
+	}
+	
+	printf("%12s %10s %14s %12s %10s %8s\n", "people", "seconds", "people/s", "peak RSS MB", "ref sec", "output");
+	for (sizeIndex = 0; sizeIndex < benchmarkParams.sizeCount; sizeIndex++)
+	{
+		if (benchmarkSize(&benchmarkParams, benchmarkParams.sizes[sizeIndex]) != 0)
+		{
+			retVal = EXIT_FAILURE;
+		}
+	}
+	return retVal;
+}
@@ -0,0 +1,148 @@
+#!/bin/bash
+#
+# File Name: SpreaderDetectorCheck.sh
+# Related Files: "../Makefile", "SpreaderDetectorGenerator.c"
+#
+# Purpose:
+# 			The regression check of SpreaderDetectorBackend (make check): runs every engine mode on a few fixed
+# 			inputs - the example of in-out-example and workloads of SpreaderDetectorGenerator with fixed seeds -
+# 			and compares its output with the serial run over the same input.
+#
+# Usage: SpreaderDetectorCheck.sh <Backend> <Generator> <Example Directory>
+#
+# Author's ID: 206174120
+# Author's Name: Oren Kovartovsky
+# University User Name: orenkov
+#
+
+if [ $# -ne 3 ]; then
+	echo "Usage: $0 <Backend> <Generator> <Example Directory>" >&2
+	exit 2
+fi
+BACKEND=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+GENERATOR=$(cd "$(dirname "$2")" && pwd)/$(basename "$2")
+EXAMPLE_DIR=$(cd "$3" && pwd)
+OUTPUT=SpreaderDetectorAnalysis.out
+WORK_DIR=$(mktemp -d "${TMPDIR:-/tmp}/SpreaderDetectorCheck.XXXXXX") || exit 2
+trap 'rm -rf "$WORK_DIR"' EXIT
+cd "$WORK_DIR" || exit 2
+FAILED_COUNT=0
+
+# Prints the result of a check, and counts its failure.
+# $1 - the check, $2 - its exit status (0 - passed).
+report()
+{
+	if [ "$2" -eq 0 ]; then
+		echo "PASS $1"
+	else
+		echo "FAIL $1"
+		FAILED_COUNT=$((FAILED_COUNT + 1))
+	fi
+}
+
+# Runs the backend, and compares its output with an expected file.
+# $1 - the check, $2 - the expected output, and the rest - the arguments of the backend.
+check()
+{
+	local name=$1 expected=$2
+	shift 2
+	rm -f "$OUTPUT"
+	"$BACKEND" "$@" > /dev/null 2> stderr.log && cmp -s "$OUTPUT" "$expected"
+	report "$name" $?
+}
+
+# Runs every mode on one input.
+# $1 - the name of the input, $2 - its People.in, $3 - its Meetings.in.
+check_input()
+{
+	local name=$1 people=$2 meetings=$3
+	mkdir -p "$name" && cd "$name" || exit 2
+
+	# The serial run is the reference of every other mode:
+	"$BACKEND" "$people" "$meetings" > /dev/null 2> stderr.log && cp "$OUTPUT" serial.out
+	report "$name: serial" $?
+	check "$name: threads" serial.out --threads 4 "$people" "$meetings"
+	check "$name: threads (one per CPU)" serial.out --threads 0 "$people" "$meetings"
+	check "$name: graph" serial.out --graph "$people" "$meetings"
+	check "$name: graph + threads" serial.out --graph --threads 4 "$people" "$meetings"
+	check "$name: memory-budget" serial.out --memory-budget 16 "$people" "$meetings"
+	check "$name: stats" serial.out --stats stats.json "$people" "$meetings"
+	rm -f "$OUTPUT"
+	"$BACKEND" --stream 7 "$people" - < "$meetings" > /dev/null 2> stderr.log && cmp -s "$OUTPUT" serial.out
+	report "$name: stream" $?
+
+	# --top K writes the K first lines, and --tiers the same lines (only the urgent ones in order):
+	head -n 5 serial.out > top.out
+	check "$name: top" top.out --top 5 "$people" "$meetings"
+	rm -f "$OUTPUT"
+	"$BACKEND" --tiers "$people" "$meetings" > /dev/null 2> stderr.log &&
+		cmp -s <(grep -v "^No serious" "$OUTPUT") <(grep -v "^No serious" serial.out) &&
+		cmp -s <(sort "$OUTPUT") <(sort serial.out)
+	report "$name: tiers" $?
+
+	# A snapshot of the people, and a table of the meetings:
+	"$BACKEND" --compile-people people.snapshot "$people" > /dev/null 2> stderr.log
+	report "$name: compile-people" $?
+	"$BACKEND" --compile-meetings meetings.table "$meetings" > /dev/null 2> stderr.log
+	report "$name: compile-meetings" $?
+	check "$name: snapshot" serial.out people.snapshot "$meetings"
+	check "$name: table" serial.out "$people" meetings.table
+	check "$name: snapshot + table + graph" serial.out --graph people.snapshot meetings.table
+
+	# Shards: the spreader's row and the first meetings, and the rest in two more shards:
+	local meetingCount shardSize
+	meetingCount=$(wc -l < "$meetings")
+	shardSize=$(((meetingCount + 2) / 3))
+	mkdir -p shards && split -l "$shardSize" -a 1 "$meetings" shards/shard_
+	check "$name: shards" serial.out "$people" shards/shard_*
+	check "$name: shards + threads" serial.out --threads 4 "$people" shards/shard_*
+	check "$name: shards directory" serial.out "$people" shards
+	check "$name: shards reversed + graph" serial.out --graph "$people" $(ls -r shards/shard_*)
+
+	# A delta run over the meetings appended since the state was saved:
+	head -n "$shardSize" "$meetings" > old.in
+	tail -n +"$((shardSize + 1))" "$meetings" > new.in
+	"$BACKEND" --save-state meetings.state "$people" old.in > /dev/null 2> stderr.log
+	report "$name: save-state" $?
+	check "$name: delta" serial.out --delta meetings.state "$people" new.in
+
+	# Compressed inputs, when the backend was compiled with zlib:
+	if command -v gzip > /dev/null; then
+		gzip -c "$people" > people.in.gz && gzip -c "$meetings" > meetings.in.gz
+		rm -f "$OUTPUT"
+		if "$BACKEND" people.in.gz meetings.in.gz > /dev/null 2> stderr.log; then
+			cmp -s "$OUTPUT" serial.out
+			report "$name: gz" $?
+		else
+			echo "SKIP $name: gz (the backend wasn't compiled with SPREADER_DETECTOR_ZLIB)"
+		fi
+	fi
+
+	# The batch manifest which the last check runs:
+	printf '%s\t%s\t%s\n' "$people" "$meetings" "$WORK_DIR/$name/batch.out" >> "$WORK_DIR/manifest"
+	cp serial.out "$WORK_DIR/$name/batch.expected"
+	cd "$WORK_DIR" || exit 2
+}
+
+"$GENERATOR" 3000 4 6 generated_1_people.in generated_1_meetings.in 7 > /dev/null &&
+	"$GENERATOR" 20000 8 4 generated_2_people.in generated_2_meetings.in 11 > /dev/null
+report "generator" $?
+
+check_input example "$EXAMPLE_DIR/3_people.in" "$EXAMPLE_DIR/3_meeting.in"
+cmp -s example/serial.out "$EXAMPLE_DIR/3_sol.out"
+report "example: expected output" $?
+check_input generated_1 "$WORK_DIR/generated_1_people.in" "$WORK_DIR/generated_1_meetings.in"
+check_input generated_2 "$WORK_DIR/generated_2_people.in" "$WORK_DIR/generated_2_meetings.in"
+
+"$BACKEND" --threads 2 --batch manifest > /dev/null 2> stderr.log
+BATCH_STATUS=$?
+for name in example generated_1 generated_2; do
+	[ $BATCH_STATUS -eq 0 ] && cmp -s "$name/batch.out" "$name/batch.expected"
+	report "$name: batch" $?
+done
+
+if [ $FAILED_COUNT -ne 0 ]; then
+	echo "$FAILED_COUNT checks failed."
+	exit 1
+fi
+echo "All checks passed."
@@ -0,0 +1,336 @@
+/*
+ * File Name: SpreaderDetectorGenerator.c
+ * Related Files: "../SpreaderDetectorParams.h"
+ *
+ * Purpose:
+ * 			Generates synthetic People.in / Meetings.in pairs of a configurable size, for measuring the
+ * 			SpreaderDetectorBackend. The meetings form an infection tree, written in the BFS batch layout
+ * 			the backend expects: the spreader first, then the batch of every infector, in BFS order.
+ *
+ * */
+
+#define _POSIX_C_SOURCE 200809L
+
+// ------------------------------ includes ------------------------------
+#include "../SpreaderDetectorParams.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// -------------------------- const definitions -------------------------
+#define ARGS_MIN_COUNT 6
+#define ARGS_MAX_COUNT 7
+#define ARG_PEOPLE_COUNT 1
+#define ARG_FAN_OUT 2
+#define ARG_DEPTH 3
+#define ARG_PEOPLE_PATH 4
+#define ARG_MEETINGS_PATH 5
+#define ARG_SEED 6
+#define DEFAULT_SEED 2020
+
+#define MAX_PEOPLE_COUNT 900000000ul
+#define MIN_ID 100000000ul
+#define ID_RANGE 900000000ul
+#define ID_STRIDE 7919ul		// Prime, and co-prime to ID_RANGE - so IDs never repeat.
+#define OUTPUT_BUFFER_SIZE (1 << 20)
+
+#define MIN_AGE 1.0
+#define MAX_AGE 99.0
+#define MAX_DISTANCE 10.0
+
+#define ERROR_ARGS "Usage: ./SpreaderDetectorGenerator <People Count> <Fan-out> <Depth> <Path to People.in> " \
+				   "<Path to Meetings.in> [Seed]\n"
+#define ERROR_OUTPUT "Error in output file.\n"
+
+/*
+ * ***************************
+ * 	STRUCTS AND ENUMS
+ * ***************************
+ */
+/**
+ * @brief A struct represents the parameters of a generated workload.
+ */
+typedef struct _WorkloadParams
+{
+	unsigned long peopleCount;	/**< Number of people in People.in */
+	unsigned long fanOut;		/**< Maximal number of people each infector meets */
+	unsigned long depth;		/**< Maximal number of levels below the spreader */
+	unsigned long long seed;	/**< Seed of the random generator */
+} WorkloadParams;
+
+
+/*
+ * ***********************
+ * 	DECLARATIONS
+ * ***********************
+ */
+/**
+ * @brief A function that returns the next number of a xorshift64* random generator.
+ *
+ * @param[in] state the state of the generator. Must not be 0.
+ * @return a pseudo random 64 bit number.
+ */
+unsigned long long nextRandom(unsigned long long *state);
+
+/**
+ * @brief A function that returns a pseudo random number in [minValue, maxValue], with one decimal digit.
+ *
+ * @param[in] state the state of the generator.
+ * @param[in] minValue the minimal value.
+ * @param[in] maxValue the maximal value.
+ * @return the number.
+ */
+double nextRandomDecimal(unsigned long long *state, double minValue, double maxValue);
+
+/**
+ * @brief A function that maps a person's index to its (unique, 9 digits) ID.
+ *
+ * @param[in] personIndex the index of the person, below MAX_PEOPLE_COUNT.
+ * @return the ID of the person.
+ */
+unsigned long personID(unsigned long personIndex);
+
+/**
+ * @brief A function that writes People.in.
+ *
+ * @details The people are written in a scrambled order, so the backend has to sort them.
+ * @param[in] peopleFile the opened People.in.
+ * @param[in] workloadParams the parameters of the workload.
+ * @return 0 on success, -1 if writing failed.
+ */
+int writePeople(FILE *peopleFile, const WorkloadParams *workloadParams);
+
+/**
+ * @brief A function that writes Meetings.in.
+ *
+ * @details Person 0 is the spreader. The people are infected in index order: every infector (in BFS
+ * order) meets between 1 and fanOut people who weren't met yet, until everyone was met or the tree is
+ * depth levels deep. The people who weren't met stay with no chance of infection.
+ * @param[in] meetingsFile the opened Meetings.in.
+ * @param[in] workloadParams the parameters of the workload.
+ * @return the number of meetings written, or -1 if writing failed.
+ */
+long writeMeetings(FILE *meetingsFile, const WorkloadParams *workloadParams);
+
+/**
+ * @brief A function that parses the command line arguments.
+ *
+ * @param[in] argc number of arguments.
+ * @param[in] argv the arguments.
+ * @param[in] workloadParams receives the parameters.
+ * @return 0 if the arguments are valid, -1 otherwise.
+ */
+int parseArguments(int argc, char *argv[], WorkloadParams *workloadParams);
+
+
+/*
+ * ***********************
+ * 	DEFINITIONS
+ * ***********************
+ */
+/**
+ * @brief A function that returns the next number of a xorshift64* random generator.
+ * @param[in] state the state of the generator. Must not be 0.
+ * @return a pseudo random 64 bit number.
+ */
+unsigned long long nextRandom(unsigned long long *state)
+{
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+	return (*state * 2685821657736338717ull);
+}
+
+
+/**
+ * @brief A function that returns a pseudo random number in [minValue, maxValue], with one decimal digit.
+ * @param[in] state the state of the generator.
+ * @param[in] minValue the minimal value.
+ * @param[in] maxValue the maximal value.
+ * @return the number.
+ */
+double nextRandomDecimal(unsigned long long *state, double minValue, double maxValue)
+{
+	unsigned long long tenthsRange = (unsigned long long) ((maxValue - minValue) * 10) + 1;
+	return (minValue + ((double) (nextRandom(state) % tenthsRange) / 10));
+}
+
+
+/**
+ * @brief A function that maps a person's index to its (unique, 9 digits) ID.
+ * @param[in] personIndex the index of the person, below MAX_PEOPLE_COUNT.
+ * @return the ID of the person.
+ */
+unsigned long personID(unsigned long personIndex)
+{
+	return (MIN_ID + ((personIndex * ID_STRIDE + 12345) % ID_RANGE));
+}
+
+
+/**
+ * @brief A function that writes People.in.
+ * @details The people are written in a scrambled order, so the backend has to sort them.
+ * @param[in] peopleFile the opened People.in.
+ * @param[in] workloadParams the parameters of the workload.
+ * @return 0 on success, -1 if writing failed.
+ */
+int writePeople(FILE *peopleFile, const WorkloadParams *workloadParams)
+{
+	static const char *names[] = {"Ann", "Bob", "Christopher", "Dana", "Eli", "Frederick", "Gil", "Hadas",
+								  "Ryan", "Dorothy", "Darryl", "Theresa"};
+	unsigned long long state = workloadParams->seed;
+	unsigned long rowIndex = 0;
+	for (rowIndex = 0; rowIndex < workloadParams->peopleCount; rowIndex++)
+	{
+		unsigned long personIndex = (unsigned long) ((rowIndex * (unsigned long long) ID_STRIDE) %
+													 workloadParams->peopleCount);
+		if ((workloadParams->peopleCount % ID_STRIDE) == 0)
+		{
+			personIndex = rowIndex;	// ID_STRIDE doesn't scramble this count.
+		}
+		if (0 > fprintf(peopleFile, "%s %lu %.1f\n", names[nextRandom(&state) % (sizeof(names) / sizeof(*names))],
+						personID(personIndex), nextRandomDecimal(&state, MIN_AGE, MAX_AGE)))
+		{
+			return -1;
+		}
+	}
+	return 0;
+}
+
+
+/**
+ * @brief A function that writes Meetings.in.
+ * @details Person 0 is the spreader. The people are infected in index order: every infector (in BFS
+ * order) meets between 1 and fanOut people who weren't met yet, until everyone was met or the tree is
+ * depth levels deep. The people who weren't met stay with no chance of infection.
+ * @param[in] meetingsFile the opened Meetings.in.
+ * @param[in] workloadParams the parameters of the workload.
+ * @return the number of meetings written, or -1 if writing failed.
+ */
+long writeMeetings(FILE *meetingsFile, const WorkloadParams *workloadParams)
+{
+	unsigned long long state = workloadParams->seed ^ 0x5DEECE66Dull;
+	unsigned long infector = 0, nextInfected = 1, levelEnd = 1, level = 0;
+	long meetingCount = 0;
+	if (workloadParams->peopleCount == 0)
+	{
+		return 0;
+	}
+	if (0 > fprintf(meetingsFile, "%lu\n", personID(0)))
+	{
+		return -1;
+	}
+	
+	//	Infectors in BFS order - the people of each level were met by the level above it:
+	while ((infector < nextInfected) && (nextInfected < workloadParams->peopleCount) &&
+		   (level < workloadParams->depth))
+	{
+		unsigned long metCount = 1 + (unsigned long) (nextRandom(&state) % workloadParams->fanOut);
+		while ((metCount > 0) && (nextInfected < workloadParams->peopleCount))
+		{
+			if (0 > fprintf(meetingsFile, "%lu %lu %.1f %.1f\n", personID(infector), personID(nextInfected),
+							nextRandomDecimal(&state, MIN_DISTANCE, MAX_DISTANCE),
+							nextRandomDecimal(&state, 1.0, MAX_TIME)))
+			{
+				return -1;
+			}
+			nextInfected++;
+			metCount--;
+			meetingCount++;
+		}
+		infector++;
+		if (infector == levelEnd)
+		{
+			levelEnd = nextInfected;
+			level++;
+		}
+	}
+	return meetingCount;
+}
+
+
+/**
+ * @brief A function that parses the command line arguments.
+ * @param[in] argc number of arguments.
+ * @param[in] argv the arguments.
+ * @param[in] workloadParams receives the parameters.
+ * @return 0 if the arguments are valid, -1 otherwise.
+ */
+int parseArguments(int argc, char *argv[], WorkloadParams *workloadParams)
+{
+	char *checkPtr = NULL;
+	if ((argc < ARGS_MIN_COUNT) || (argc > ARGS_MAX_COUNT))
+	{
+		return -1;
+	}
+	workloadParams->peopleCount = strtoul(argv[ARG_PEOPLE_COUNT], &checkPtr, 10);
+	if ((*checkPtr != '\0') || (workloadParams->peopleCount > MAX_PEOPLE_COUNT))
+	{
+		return -1;
+	}
+	workloadParams->fanOut = strtoul(argv[ARG_FAN_OUT], &checkPtr, 10);
+	if ((*checkPtr != '\0') || (workloadParams->fanOut == 0))
+	{
+		return -1;
+	}
+	workloadParams->depth = strtoul(argv[ARG_DEPTH], &checkPtr, 10);
+	if ((*checkPtr != '\0') || (workloadParams->depth == 0))
+	{
+		return -1;
+	}
+	workloadParams->seed = DEFAULT_SEED;
+	if (argc == ARGS_MAX_COUNT)
+	{
+		workloadParams->seed = strtoull(argv[ARG_SEED], &checkPtr, 10);
+		if ((*checkPtr != '\0') || (workloadParams->seed == 0))
+		{
+			return -1;
+		}
+	}
+	return 0;
+}
+
+
+/**
+ * @brief The main function. Generates the workload, and prints its size.
+ * @param[in] argc number of arguments.
+ * @param[in] argv the arguments (see ERROR_ARGS).
+ * @return EXIT_SUCCESS, or EXIT_FAILURE on error.
+ */
+int main(int argc, char *argv[])
+{
+	WorkloadParams workloadParams;
+	if (parseArguments(argc, argv, &workloadParams) != 0)
+	{
+		fprintf(stderr, ERROR_ARGS);
+		return EXIT_FAILURE;
+	}
+	
+	FILE *peopleFile = fopen(argv[ARG_PEOPLE_PATH], "w");
+	FILE *meetingsFile = fopen(argv[ARG_MEETINGS_PATH], "w");
+	if ((peopleFile == NULL) || (meetingsFile == NULL))
+	{
+		if (peopleFile != NULL)
+		{
+			fclose(peopleFile);
+		}
+		if (meetingsFile != NULL)
+		{
+			fclose(meetingsFile);
+		}
+		fprintf(stderr, ERROR_OUTPUT);
+		return EXIT_FAILURE;
+	}
+	setvbuf(peopleFile, NULL, _IOFBF, OUTPUT_BUFFER_SIZE);
+	setvbuf(meetingsFile, NULL, _IOFBF, OUTPUT_BUFFER_SIZE);
+	
+	int retValPeople = writePeople(peopleFile, &workloadParams);
+	long meetingCount = writeMeetings(meetingsFile, &workloadParams);
+	int retValClose = ((EOF == fclose(peopleFile)) | (EOF == fclose(meetingsFile)));
+	if ((retValPeople != 0) || (meetingCount < 0) || retValClose)
+	{
+		fprintf(stderr, ERROR_OUTPUT);
+		return EXIT_FAILURE;
+	}
+	printf("%lu people, %ld meetings\n", workloadParams.peopleCount, meetingCount);
+	return EXIT_SUCCESS;
+}